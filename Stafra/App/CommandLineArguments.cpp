@@ -1,26 +1,68 @@
 #include "CommandLineArguments.hpp"
 #include <iostream>
 #include <regex>
-#include <Windows.h>
+#include <climits>
+#include <cstring>
 
 namespace
 {
 	const uint32_t gDefaultPSize      = 10;
 	const uint32_t gDefaultFinalFrame = 0;
+	const uint32_t gDefaultStartFrame = 0;
 	const uint32_t gDefaultSpawn      = 0;
 
+	const uint32_t gDefaultCpuThreads    = 0;
+	const uint32_t gDefaultCpuTileWidth  = 4096;
+	const uint32_t gDefaultCpuTileHeight = 64;
+
+	const uint32_t gDefaultRuleSearchRadius  = 0;
+	const uint32_t gDefaultRuleSearchSamples = 0;
+
+	const uint32_t gDefaultMemoryBudget = 1024;
+
 	const bool gDefaultSaveVframes = false;
 	const bool gDefaultSmooth      = false;
 
+#if defined(_WIN32)
+	const bool gDefaultCpuCompute = false;
+#else
+	const bool gDefaultCpuCompute = true; //Without Direct3D 11 everything is computed on the CPU
+#endif
+
 	//---------------------------------------
 	const uint32_t gMinimumPSize = 2;
 	const uint32_t gMaximumPSize = 14;
+	const uint32_t gMaximumOutOfCorePSize = 18;
 
 	const uint32_t gMinimumFinalFrame = 1;
 	const uint32_t gMaximumFinalFrame = UINT_MAX;
 
+	const uint32_t gMinimumStartFrame = 1;
+	const uint32_t gMaximumStartFrame = UINT_MAX;
+
 	const uint32_t gMinimumSpawn = 0;
 	const uint32_t gMaximumSpawn = 9999;
+
+	const uint32_t gMinimumCpuThreads = 1;
+	const uint32_t gMaximumCpuThreads = 1024;
+
+	const uint32_t gMinimumCpuTileSize = 1;
+	const uint32_t gMaximumCpuTileSize = 65536;
+
+	const uint32_t gMinimumRuleSearchRadius = 1;
+	const uint32_t gMaximumRuleSearchRadius = 15;
+
+	const uint32_t gMinimumRuleSearchSamples = 1;
+	const uint32_t gMaximumRuleSearchSamples = 16777216;
+
+	const uint32_t gMinimumRoiSize = 1;
+	const uint32_t gMaximumRoiSize = 16383;
+
+	const uint32_t gMinimumMemoryBudget = 16;
+	const uint32_t gMaximumMemoryBudget = 1048576;
+
+	const uint32_t gMinimumSlabCount = 1;
+	const uint32_t gMaximumSlabCount = 256;
 }
 
 CommandLineArguments::CommandLineArguments(int argc, char* argv[]): CommandLineArguments()
@@ -46,9 +88,9 @@ CommandLineArguments::CommandLineArguments(const std::string& cmdArgs): CommandL
 	mCmdLineArgs.push_back(std::string(prevArgEnd, cmdArgs.end()));
 }
 
-CommandLineArguments::CommandLineArguments(): mPowSize(gDefaultPSize), mSaveVideoFrames(gDefaultSaveVframes), mSmoothTransform(gDefaultSmooth), 
-                                              mFinalFrame(gDefaultFinalFrame), mSpawnPeriod(gDefaultSpawn), 
-	                                          mSilentMode(false), mResetMode(CmdResetMode::RESET_4_CORNERS), mHelpOnly(false)
+CommandLineArguments::CommandLineArguments(): mPowSize(gDefaultPSize), mFinalFrame(gDefaultFinalFrame), mStartFrame(gDefaultStartFrame), mSpawnPeriod(gDefaultSpawn), 
+                                              mCpuThreads(gDefaultCpuThreads), mCpuTileWidth(gDefaultCpuTileWidth), mCpuTileHeight(gDefaultCpuTileHeight), mRuleSearchRadius(gDefaultRuleSearchRadius), mRuleSearchSamples(gDefaultRuleSearchSamples), mRoiX(0), mRoiY(0), mRoiWidth(0), mRoiHeight(0), mMemoryBudget(gDefaultMemoryBudget), mSlabIndex(0), mSlabCount(0), 
+	                                          mHelpOnly(false), mSaveVideoFrames(gDefaultSaveVframes), mSmoothTransform(gDefaultSmooth), mSilentMode(false), mCpuCompute(gDefaultCpuCompute), mSaveChangeMap(false), mSaveStats(false), mHashLife(false), mNoEarlyStop(false), mSolvePeriod(false), mResetMode(CmdResetMode::RESET_4_CORNERS), mRuleSymmetry(CmdRuleSymmetry::RULE_SYMMETRY_NONE)
 {
 }
 
@@ -66,16 +108,106 @@ uint32_t CommandLineArguments::FinalFrame() const
 	return mFinalFrame;
 }
 
+uint32_t CommandLineArguments::StartFrame() const
+{
+	return mStartFrame;
+}
+
 uint32_t CommandLineArguments::SpawnPeriod() const
 {
 	return mSpawnPeriod;
 }
 
+uint32_t CommandLineArguments::CpuThreads() const
+{
+	return mCpuThreads;
+}
+
+uint32_t CommandLineArguments::CpuTileWidth() const
+{
+	return mCpuTileWidth;
+}
+
+uint32_t CommandLineArguments::CpuTileHeight() const
+{
+	return mCpuTileHeight;
+}
+
 int CommandLineArguments::GpuIndex() const
 {
 	return mGpuIndex;
 }
 
+std::string CommandLineArguments::RenderFromMap() const
+{
+	return mRenderFromMap;
+}
+
+std::string CommandLineArguments::BatchFolder() const
+{
+	return mBatchFolder;
+}
+
+std::string CommandLineArguments::OutOfCoreFolder() const
+{
+	return mOutOfCoreFolder;
+}
+
+std::string CommandLineArguments::PeriodCacheFile() const
+{
+	return mPeriodCacheFile;
+}
+
+const std::vector<std::string>& CommandLineArguments::SlabAddresses() const
+{
+	return mSlabAddresses;
+}
+
+uint32_t CommandLineArguments::RuleSearchRadius() const
+{
+	return mRuleSearchRadius;
+}
+
+uint32_t CommandLineArguments::RuleSearchSamples() const
+{
+	return mRuleSearchSamples;
+}
+
+uint32_t CommandLineArguments::RoiX() const
+{
+	return mRoiX;
+}
+
+uint32_t CommandLineArguments::RoiY() const
+{
+	return mRoiY;
+}
+
+uint32_t CommandLineArguments::RoiWidth() const
+{
+	return mRoiWidth;
+}
+
+uint32_t CommandLineArguments::RoiHeight() const
+{
+	return mRoiHeight;
+}
+
+uint32_t CommandLineArguments::MemoryBudget() const
+{
+	return mMemoryBudget;
+}
+
+uint32_t CommandLineArguments::SlabIndex() const
+{
+	return mSlabIndex;
+}
+
+uint32_t CommandLineArguments::SlabCount() const
+{
+	return mSlabCount;
+}
+
 bool CommandLineArguments::HelpOnly() const
 {
 	return mHelpOnly;
@@ -96,11 +228,46 @@ bool CommandLineArguments::SilentMode() const
 	return mSilentMode;
 }
 
+bool CommandLineArguments::CpuCompute() const
+{
+	return mCpuCompute;
+}
+
+bool CommandLineArguments::SaveChangeMap() const
+{
+	return mSaveChangeMap;
+}
+
+bool CommandLineArguments::SaveStats() const
+{
+	return mSaveStats;
+}
+
+bool CommandLineArguments::HashLife() const
+{
+	return mHashLife;
+}
+
+bool CommandLineArguments::NoEarlyStop() const
+{
+	return mNoEarlyStop;
+}
+
+bool CommandLineArguments::SolvePeriod() const
+{
+	return mSolvePeriod;
+}
+
 CmdResetMode CommandLineArguments::ResetMode() const
 {
 	return mResetMode;
 }
 
+CmdRuleSymmetry CommandLineArguments::RuleSymmetry() const
+{
+	return mRuleSymmetry;
+}
+
 uint32_t CommandLineArguments::ParseInt(std::string intStr, uint32_t min, uint32_t max)
 {
 	uint32_t parsedNumber = std::strtoul(intStr.c_str(), nullptr, 0);
@@ -134,6 +301,135 @@ CmdParseResult CommandLineArguments::ParseArgs()
 		{
 			mSilentMode = true;
 		}
+		else if(mCmdLineArgs[i] == "-cpu")
+		{
+			mCpuCompute = true;
+		}
+		else if(mCmdLineArgs[i] == "-save_change_map")
+		{
+			mSaveChangeMap = true;
+		}
+		else if(mCmdLineArgs[i] == "-save_stats")
+		{
+			mSaveStats = true;
+		}
+		else if(mCmdLineArgs[i] == "-hashlife")
+		{
+			mHashLife = true;
+		}
+		else if(mCmdLineArgs[i] == "-no_early_stop")
+		{
+			mNoEarlyStop = true;
+		}
+		else if(mCmdLineArgs[i] == "-solve_period")
+		{
+			mSolvePeriod = true;
+		}
+		else if(mCmdLineArgs[i] == "-period_cache")
+		{
+			if((i + 1) >= mCmdLineArgs.size())
+			{
+				res = CmdParseResult::PARSE_WRONG_PERIOD_CACHE;
+				break;
+			}
+			else
+			{
+				mPeriodCacheFile = mCmdLineArgs[++i];
+			}
+		}
+		else if(mCmdLineArgs[i] == "-render_from_map")
+		{
+			if((i + 1) >= mCmdLineArgs.size())
+			{
+				res = CmdParseResult::PARSE_WRONG_CHANGE_MAP;
+				break;
+			}
+			else
+			{
+				mRenderFromMap = mCmdLineArgs[++i];
+			}
+		}
+		else if(mCmdLineArgs[i] == "-batch")
+		{
+			if((i + 1) >= mCmdLineArgs.size())
+			{
+				res = CmdParseResult::PARSE_WRONG_BATCH;
+				break;
+			}
+			else
+			{
+				mBatchFolder = mCmdLineArgs[++i];
+			}
+		}
+		else if(mCmdLineArgs[i] == "-search_rules")
+		{
+			if((i + 1) >= mCmdLineArgs.size())
+			{
+				res = CmdParseResult::PARSE_WRONG_RULE_SEARCH;
+				break;
+			}
+			else
+			{
+				uint32_t radius = ParseInt(mCmdLineArgs[++i], gMinimumRuleSearchRadius, gMaximumRuleSearchRadius);
+				if(radius == 0)
+				{
+					res = CmdParseResult::PARSE_WRONG_RULE_SEARCH;
+				}
+				else
+				{
+					mRuleSearchRadius = radius;
+				}
+			}
+		}
+		else if(mCmdLineArgs[i] == "-rule_samples")
+		{
+			if((i + 1) >= mCmdLineArgs.size())
+			{
+				res = CmdParseResult::PARSE_WRONG_RULE_SEARCH;
+				break;
+			}
+			else
+			{
+				uint32_t samples = ParseInt(mCmdLineArgs[++i], gMinimumRuleSearchSamples, gMaximumRuleSearchSamples);
+				if(samples == 0)
+				{
+					res = CmdParseResult::PARSE_WRONG_RULE_SEARCH;
+				}
+				else
+				{
+					mRuleSearchSamples = samples;
+				}
+			}
+		}
+		else if(mCmdLineArgs[i] == "-rule_symmetry")
+		{
+			if((i + 1) >= mCmdLineArgs.size())
+			{
+				res = CmdParseResult::PARSE_WRONG_RULE_SYMMETRY;
+				break;
+			}
+			else
+			{
+				std::string symmetryStr = mCmdLineArgs[++i];
+				if(symmetryStr == "none")
+				{
+					mRuleSymmetry = CmdRuleSymmetry::RULE_SYMMETRY_NONE;
+				}
+				else if(symmetryStr == "mirror")
+				{
+					mRuleSymmetry = CmdRuleSymmetry::RULE_SYMMETRY_MIRROR;
+				}
+				else if(symmetryStr == "full")
+				{
+					mRuleSymmetry = CmdRuleSymmetry::RULE_SYMMETRY_FULL;
+				}
+				else
+				{
+					res = CmdParseResult::PARSE_WRONG_RULE_SYMMETRY;
+					break;
+				}
+			}
+		}
 		else if(mCmdLineArgs[i] == "-reset_mode")
 		{
 			if((i + 1) >= mCmdLineArgs.size())
@@ -172,7 +468,7 @@ CmdParseResult CommandLineArguments::ParseArgs()
 			}
 			else
 			{
-				uint32_t powSize = ParseInt(mCmdLineArgs[++i], gMinimumPSize, gMaximumPSize);
+				uint32_t powSize = ParseInt(mCmdLineArgs[++i], gMinimumPSize, gMaximumOutOfCorePSize); //The size is checked once -out_of_core is known
 				if(powSize == 0)
 				{
 					res = CmdParseResult::PARSE_WRONG_PSIZE;
@@ -203,6 +499,26 @@ CmdParseResult CommandLineArguments::ParseArgs()
 				}
 			}
 		}
+		else if(mCmdLineArgs[i] == "-start_frame")
+		{
+			if((i + 1) >= mCmdLineArgs.size())
+			{
+				res = CmdParseResult::PARSE_WRONG_START_FRAME;
+				break;
+			}
+			else
+			{
+				uint32_t startFrame = ParseInt(mCmdLineArgs[++i], gMinimumStartFrame, gMaximumStartFrame);
+				if(startFrame == 0)
+				{
+					res = CmdParseResult::PARSE_WRONG_START_FRAME;
+				}
+				else
+				{
+					mStartFrame = startFrame;
+				}
+			}
+		}
 		else if(mCmdLineArgs[i] == "-spawn")
 		{
 			if((i + 1) >= mCmdLineArgs.size())
@@ -216,6 +532,175 @@ CmdParseResult CommandLineArguments::ParseArgs()
 				mSpawnPeriod = spawn;
 			}
 		}
+		else if(mCmdLineArgs[i] == "-threads")
+		{
+			if((i + 1) >= mCmdLineArgs.size())
+			{
+				res = CmdParseResult::PARSE_WRONG_THREADS;
+				break;
+			}
+			else
+			{
+				uint32_t threads = ParseInt(mCmdLineArgs[++i], gMinimumCpuThreads, gMaximumCpuThreads);
+				if(threads == 0)
+				{
+					res = CmdParseResult::PARSE_WRONG_THREADS;
+				}
+				else
+				{
+					mCpuThreads = threads;
+				}
+			}
+		}
+		else if(mCmdLineArgs[i] == "-tile_size")
+		{
+			std::smatch tileSizeMatch;
+			if((i + 1) >= mCmdLineArgs.size())
+			{
+				res = CmdParseResult::PARSE_WRONG_TILE_SIZE;
+				break;
+			}
+			else if(std::regex_match(mCmdLineArgs[i + 1], tileSizeMatch, std::regex("(\\d+)(x|X)(\\d+)")))
+			{
+				uint32_t tileWidth  = ParseInt(tileSizeMatch[1].str(), gMinimumCpuTileSize, gMaximumCpuTileSize);
+				uint32_t tileHeight = ParseInt(tileSizeMatch[3].str(), gMinimumCpuTileSize, gMaximumCpuTileSize);
+				if(tileWidth == 0 || tileHeight == 0)
+				{
+					res = CmdParseResult::PARSE_WRONG_TILE_SIZE;
+				}
+				else
+				{
+					mCpuTileWidth  = tileWidth;
+					mCpuTileHeight = tileHeight;
+				}
+
+				i++;
+			}
+			else
+			{
+				res = CmdParseResult::PARSE_WRONG_TILE_SIZE;
+				i++;
+			}
+		}
+		else if(mCmdLineArgs[i] == "-roi")
+		{
+			std::smatch roiMatch;
+			if((i + 1) >= mCmdLineArgs.size())
+			{
+				res = CmdParseResult::PARSE_WRONG_ROI;
+				break;
+			}
+			else if(std::regex_match(mCmdLineArgs[i + 1], roiMatch, std::regex("(\\d+),(\\d+),(\\d+)(x|X)(\\d+)")))
+			{
+				uint32_t roiWidth  = ParseInt(roiMatch[3].str(), gMinimumRoiSize, gMaximumRoiSize);
+				uint32_t roiHeight = ParseInt(roiMatch[5].str(), gMinimumRoiSize, gMaximumRoiSize);
+				if(roiWidth == 0 || roiHeight == 0)
+				{
+					res = CmdParseResult::PARSE_WRONG_ROI;
+				}
+				else
+				{
+					mRoiX      = std::strtoul(roiMatch[1].str().c_str(), nullptr, 10);
+					mRoiY      = std::strtoul(roiMatch[2].str().c_str(), nullptr, 10);
+					mRoiWidth  = roiWidth;
+					mRoiHeight = roiHeight;
+				}
+
+				i++;
+			}
+			else
+			{
+				res = CmdParseResult::PARSE_WRONG_ROI;
+				i++;
+			}
+		}
+		else if(mCmdLineArgs[i] == "-out_of_core")
+		{
+			if((i + 1) >= mCmdLineArgs.size())
+			{
+				res = CmdParseResult::PARSE_WRONG_OUT_OF_CORE;
+				break;
+			}
+			else
+			{
+				mOutOfCoreFolder = mCmdLineArgs[++i];
+			}
+		}
+		else if(mCmdLineArgs[i] == "-memory_budget")
+		{
+			if((i + 1) >= mCmdLineArgs.size())
+			{
+				res = CmdParseResult::PARSE_WRONG_OUT_OF_CORE;
+				break;
+			}
+			else
+			{
+				uint32_t memoryBudget = ParseInt(mCmdLineArgs[++i], gMinimumMemoryBudget, gMaximumMemoryBudget);
+				if(memoryBudget == 0)
+				{
+					res = CmdParseResult::PARSE_WRONG_OUT_OF_CORE;
+				}
+				else
+				{
+					mMemoryBudget = memoryBudget;
+				}
+			}
+		}
+		else if(mCmdLineArgs[i] == "-slab")
+		{
+			std::smatch slabMatch;
+			if((i + 1) >= mCmdLineArgs.size())
+			{
+				res = CmdParseResult::PARSE_WRONG_SLAB;
+				break;
+			}
+			else if(std::regex_match(mCmdLineArgs[i + 1], slabMatch, std::regex("(\\d+)/(\\d+)")))
+			{
+				uint32_t slabIndex = std::strtoul(slabMatch[1].str().c_str(), nullptr, 10);
+				uint32_t slabCount = ParseInt(slabMatch[2].str(), gMinimumSlabCount, gMaximumSlabCount);
+				if(slabCount == 0 || slabIndex >= slabCount)
+				{
+					res = CmdParseResult::PARSE_WRONG_SLAB;
+				}
+				else
+				{
+					mSlabIndex = slabIndex;
+					mSlabCount = slabCount;
+				}
+
+				i++;
+			}
+			else
+			{
+				res = CmdParseResult::PARSE_WRONG_SLAB;
+				i++;
+			}
+		}
+		else if(mCmdLineArgs[i] == "-slab_peers")
+		{
+			if((i + 1) >= mCmdLineArgs.size())
+			{
+				res = CmdParseResult::PARSE_WRONG_SLAB;
+				break;
+			}
+			else
+			{
+				std::string slabAddresses = mCmdLineArgs[++i];
+
+				mSlabAddresses.clear();
+				for(size_t addressBegin = 0; addressBegin <= slabAddresses.size();)
+				{
+					size_t addressEnd = slabAddresses.find(',', addressBegin);
+					if(addressEnd == std::string::npos)
+					{
+						addressEnd = slabAddresses.size();
+					}
+
+					mSlabAddresses.push_back(slabAddresses.substr(addressBegin, addressEnd - addressBegin));
+					addressBegin = addressEnd + 1;
+				}
+			}
+		}
 		else if(mCmdLineArgs[i] == "-gpu")
 		{
 			if((i + 1) >= mCmdLineArgs.size())
@@ -244,6 +729,18 @@ CmdParseResult CommandLineArguments::ParseArgs()
 		}
 	}
 
+	//Only the out-of-core computations can have the boards bigger than a texture
+	if(mPowSize > gMaximumPSize && mOutOfCoreFolder.empty() && res == CmdParseResult::PARSE_OK)
+	{
+		res = CmdParseResult::PARSE_WRONG_PSIZE;
+	}
+
+	//Every slab has to know all the others
+	if(mSlabCount != 0 && mSlabAddresses.size() != mSlabCount && res == CmdParseResult::PARSE_OK)
+	{
+		res = CmdParseResult::PARSE_WRONG_SLAB;
+	}
+
 	return res;
 }
 
@@ -253,11 +750,31 @@ std::string CommandLineArguments::GetHelpMessage() const
 		   "                                                                                                 \r\n"
 		   "-save_vframes: Save all intermediate states to the ./DiffStabil folder;                          \r\n"
 		   "-smooth:       Use smooth transformation for the spawn-stability;                                \r\n"
-		   "-psize:        The log2 of size of the board. Acceptable range: 2-14;                            \r\n"
+		   "-psize:        The log2 of size of the board. Acceptable range: 2-14, or 2-18 with -out_of_core; \r\n"
 		   "-final_frame:  The frame number that will be saved.                                              \r\n"
+		   "-start_frame:  CPU only: jump to this frame first, the stability starts from there.              \r\n"
 		   "-spawn:        Spawn stability period. Enter 0 for no spawn at all.                              \r\n"
 		   "-reset_mode:   Reset mode. Available values: 4corners | 4sides | center.                         \r\n"
-		   "-gpu:          GPU adapter index for computations. Available values: WARP | Any positive number. \r\n";
+		   "-gpu:          GPU adapter index for computations. Available values: WARP | Any positive number. \r\n"
+		   "-cpu:          Compute on the CPU with the widest SIMD instruction set. Always on without D3D11. \r\n"
+		   "-threads:      The number of CPU threads. Acceptable range: 1-1024. Default: one per core.       \r\n"
+		   "-tile_size:    CPU tile size as WIDTHxHEIGHT, the width is rounded up to 512. Default: 4096x64.  \r\n"
+		   "-hashlife:     CPU only: compute long runs of frames with memoized quadtrees (Hashlife).         \r\n"
+		   "-save_change_map: Save ./ChangeMap.bin, the frame each cell became unstable at. CPU, no spawn.   \r\n"
+		   "-save_stats:   Save ./Stats.csv, the stable/changed/lit counts of every frame. CPU only.         \r\n"
+		   "-no_early_stop: Keep computing after the board repeats. Without -cpu: the initial one, no spawn. \r\n"
+		   "-solve_period: CPU, no spawn: find the final frame from the minimal polynomial of the boards.    \r\n"
+		   "-period_cache: The file to keep the periods found with -solve_period in. Default: none.          \r\n"
+		   "-render_from_map: Render the frames from a saved change map instead of computing them.          \r\n"
+		   "-batch:        CPU: compute all .png boards in the folder, 64 at once, into ./BatchStability.    \r\n"
+		   "-search_rules: CPU: search the click rules of this radius (1-15), save the best to ./RuleSearch. \r\n"
+		   "-rule_symmetry: Symmetry of the searched click rules. Available values: none | mirror | full.    \r\n"
+		   "-rule_samples: The number of random click rules to search. Default: all of them if few enough.   \r\n"
+		   "-roi:          CPU: compute only X,Y,WIDTHxHEIGHT of the final frame and its light cone.         \r\n"
+		   "-out_of_core:  CPU: keep the board in the files of this folder, for the boards beyond -psize 14. \r\n"
+		   "-memory_budget: The memory in MB for -out_of_core. Acceptable range: 16-1048576. Default: 1024.  \r\n"
+		   "-slab:         CPU: compute only the rows of the slab I/N of the board, in step with the others. \r\n"
+		   "-slab_peers:   The addresses of all N slabs, HOST:PORT or unix:PATH, comma-separated.            \r\n";
 }
 
 std::string CommandLineArguments::GetErrorMessage(CmdParseResult parseRes) const
@@ -268,11 +785,33 @@ std::string CommandLineArguments::GetErrorMessage(CmdParseResult parseRes) const
 	case CmdParseResult::PARSE_HELP:
 		return "";
 	case CmdParseResult::PARSE_WRONG_PSIZE:
-		return "Wrong pow size entered. Acceptable range: 2-14";
+		return "Wrong pow size entered. Acceptable range: 2-14, or 2-18 with -out_of_core";
 	case CmdParseResult::PARSE_WRONG_FINAL_FRAME:
 		return "Wrong final frame entered. Enter the number greater than zero.";
+	case CmdParseResult::PARSE_WRONG_START_FRAME:
+		return "Wrong start frame entered. Enter the number greater than zero.";
 	case CmdParseResult::PARSE_WRONG_SPAWN:
 		return "Wrong spawn period entered";
+	case CmdParseResult::PARSE_WRONG_THREADS:
+		return "Wrong thread count entered. Acceptable range: 1-1024";
+	case CmdParseResult::PARSE_WRONG_TILE_SIZE:
+		return "Wrong tile size entered. Use WIDTHxHEIGHT, for example 4096x64";
+	case CmdParseResult::PARSE_WRONG_CHANGE_MAP:
+		return "No change map file entered";
+	case CmdParseResult::PARSE_WRONG_BATCH:
+		return "No batch folder entered";
+	case CmdParseResult::PARSE_WRONG_RULE_SEARCH:
+		return "Wrong click rule search entered. Radius range: 1-15, sample count range: 1-16777216";
+	case CmdParseResult::PARSE_WRONG_RULE_SYMMETRY:
+		return "Wrong click rule symmetry entered. Available values: none | mirror | full";
+	case CmdParseResult::PARSE_WRONG_ROI:
+		return "Wrong region of interest entered. Use X,Y,WIDTHxHEIGHT, for example 4096,4096,1024x1024";
+	case CmdParseResult::PARSE_WRONG_OUT_OF_CORE:
+		return "Wrong out-of-core computing entered. Enter the folder, memory budget range: 16-1048576 MB";
+	case CmdParseResult::PARSE_WRONG_SLAB:
+		return "Wrong slab entered. Use -slab I/N with N up to 256 and -slab_peers with N addresses";
+	case CmdParseResult::PARSE_WRONG_PERIOD_CACHE:
+		return "No period cache file entered";
 	case CmdParseResult::PARSE_UNKNOWN_OPTION:
 		return "Unknown option. Enter -help to get the list of acceptable options";
 	default:
@@ -9,8 +9,19 @@ enum class CmdParseResult
 	PARSE_HELP,
 	PARSE_WRONG_PSIZE,
 	PARSE_WRONG_FINAL_FRAME,
+	PARSE_WRONG_START_FRAME,
 	PARSE_WRONG_SPAWN,
 	PARSE_WRONG_RESET_MODE,
+	PARSE_WRONG_THREADS,
+	PARSE_WRONG_TILE_SIZE,
+	PARSE_WRONG_CHANGE_MAP,
+	PARSE_WRONG_BATCH,
+	PARSE_WRONG_RULE_SEARCH,
+	PARSE_WRONG_RULE_SYMMETRY,
+	PARSE_WRONG_ROI,
+	PARSE_WRONG_OUT_OF_CORE,
+	PARSE_WRONG_SLAB,
+	PARSE_WRONG_PERIOD_CACHE,
 	PARSE_SILENT,
 	PARSE_UNKNOWN_OPTION
 };
@@ -23,6 +34,14 @@ enum class CmdResetMode
 	RESET_CENTER
 };
 
+//Click rule search symmetry from cmd
+enum class CmdRuleSymmetry
+{
+	RULE_SYMMETRY_NONE,
+	RULE_SYMMETRY_MIRROR,
+	RULE_SYMMETRY_FULL
+};
+
 class CommandLineArguments
 {
 public:
@@ -37,16 +56,48 @@ public:
 
 	uint32_t PowSize()     const;
 	uint32_t FinalFrame()  const;
+	uint32_t StartFrame()  const; //The frame to jump to before computing, 0 means no jump
 	uint32_t SpawnPeriod() const;
 
+	uint32_t CpuThreads()    const; //0 means one thread per hardware thread
+	uint32_t CpuTileWidth()  const;
+	uint32_t CpuTileHeight() const;
+
+	uint32_t RuleSearchRadius()  const; //0 means no click rule search
+	uint32_t RuleSearchSamples() const; //0 means every rule of the class if there are few enough of them
+
+	uint32_t RoiX()      const;
+	uint32_t RoiY()      const;
+	uint32_t RoiWidth()  const; //0 means no region of interest
+	uint32_t RoiHeight() const;
+
+	uint32_t MemoryBudget() const; //The memory for the out-of-core computations, in megabytes
+
+	uint32_t SlabIndex() const;
+	uint32_t SlabCount() const; //0 means the board isn't split between processes
+
 	int GpuIndex() const; //Returns a gpu index selected by the u
 
+	std::string RenderFromMap()   const; //The change map file to render the frames from instead of computing them, empty if not set
+	std::string BatchFolder()     const; //The folder with the initial boards to compute at once, empty if not set
+	std::string OutOfCoreFolder() const; //The folder for the board files of the out-of-core computations, empty if not set
+	std::string PeriodCacheFile() const; //The file to cache the solved periods in, empty if not set
+
+	const std::vector<std::string>& SlabAddresses() const; //The addresses of the processes of all slabs, HOST:PORT or unix:PATH each
+
 	bool HelpOnly()        const;
 	bool SaveVideoFrames() const;
 	bool SmoothTransform() const;
 	bool SilentMode()      const;
+	bool CpuCompute()      const;
+	bool SaveChangeMap()   const;
+	bool SaveStats()       const;
+	bool HashLife()        const;
+	bool NoEarlyStop()     const;
+	bool SolvePeriod()     const;
 
-	CmdResetMode ResetMode() const;
+	CmdResetMode    ResetMode()    const;
+	CmdRuleSymmetry RuleSymmetry() const;
 
 private:
 	CommandLineArguments();
@@ -58,14 +109,46 @@ private:
 
 	uint32_t mPowSize;
 	uint32_t mFinalFrame;
+	uint32_t mStartFrame;
 	uint32_t mSpawnPeriod;
 
+	uint32_t mCpuThreads;
+	uint32_t mCpuTileWidth;
+	uint32_t mCpuTileHeight;
+
+	uint32_t mRuleSearchRadius;
+	uint32_t mRuleSearchSamples;
+
+	uint32_t mRoiX;
+	uint32_t mRoiY;
+	uint32_t mRoiWidth;
+	uint32_t mRoiHeight;
+
+	uint32_t mMemoryBudget;
+
+	uint32_t mSlabIndex;
+	uint32_t mSlabCount;
+
 	int mGpuIndex;
 
+	std::string mRenderFromMap;
+	std::string mBatchFolder;
+	std::string mOutOfCoreFolder;
+	std::string mPeriodCacheFile;
+
+	std::vector<std::string> mSlabAddresses;
+
 	bool mHelpOnly;
 	bool mSaveVideoFrames;
 	bool mSmoothTransform;
 	bool mSilentMode;
-
-	CmdResetMode mResetMode;
+	bool mCpuCompute;
+	bool mSaveChangeMap;
+	bool mSaveStats;
+	bool mHashLife;
+	bool mNoEarlyStop;
+	bool mSolvePeriod;
+
+	CmdResetMode    mResetMode;
+	CmdRuleSymmetry mRuleSymmetry;
 };
\ No newline at end of file
@@ -1,9 +1,17 @@
-#include "..\Util.hpp"
+#include "../Util.hpp"
 #include "ConsoleApp.hpp"
 #include "ConsoleLogger.hpp"
+#include "../Computing/ComputeBackend.hpp"
 #include <iostream>
+#include <algorithm>
+#include <filesystem>
 
-ConsoleApp::ConsoleApp(const CommandLineArguments& cmdArgs)
+namespace
+{
+	const uint32_t gMaxStepsPerTick = 64; //Without video frames only the last step has to be transformed and drawn
+}
+
+ConsoleApp::ConsoleApp(const CommandLineArguments& cmdArgs): mBatchFinalFrame(0), mRoiX(0), mRoiY(0), mRoiWidth(0), mRoiHeight(0), mMemoryBudget(0), mSlabIndex(0), mSlabCount(0)
 {
 	Init(cmdArgs);
 }
@@ -19,37 +27,458 @@ void ConsoleApp::ComputeFractal()
 
 	mLogger->WriteToLog(L"Spawn period: " + std::to_wstring(mSpawnPeriod));
 
+	if(mRenderFromChangeMap)
+	{
+		RenderFromChangeMap();
+		return;
+	}
+
+	if(!mBatchFolder.empty())
+	{
+		ComputeBatch();
+		return;
+	}
+
+	if(mRuleSearchParams.Radius != 0)
+	{
+		SearchClickRules();
+		return;
+	}
+
+	if(mOutOfCoreBoardSize != 0)
+	{
+		ComputeOutOfCore();
+		return;
+	}
+
+	if(mSlabCount != 0)
+	{
+		ComputeSlab();
+		return;
+	}
+
+	if(mRoiWidth != 0)
+	{
+		ComputeRegion();
+		return;
+	}
+
 	while(mFractalGen->GetLastFrameNumber() != mFinalFrameNumber)
 	{
-		ComputeFractalTick();
-		if(mRenderer->ConsumeNeedRedraw())
+		if(mSaveVideoFrames)
+		{
+			ComputeFractalTick();
+		}
+		else
 		{
-			mRenderer->DrawPreview(); //Flushes the device context
+			//Hashlife computes 2^k steps in about the same time as 2^(k-1), so it gets all of them at once
+			uint32_t maxStepCount = mUseHashLife ? UINT32_MAX : gMaxStepsPerTick;
+			ComputeFractalSteps(std::min(mFinalFrameNumber - mFractalGen->GetLastFrameNumber(), maxStepCount));
 		}
 
+		FlushPreview();
+
 		if(mSaveVideoFrames)
 		{
 			std::wstring frameNumberStr     = IntermediateStateString(mFractalGen->GetLastFrameNumber());
-			std::wstring videoFrameFilename = L"DiffStabil\\Stabl" + frameNumberStr + L".png";
+			std::wstring videoFrameFilename = L"DiffStabil/Stabl" + frameNumberStr + L".png";
+
+			SaveCurrentVideoFrame(videoFrameFilename);
+		}
+
+		if(mEarlyStop && mFractalGen->GetDetectedPeriod() != 0 && mFractalGen->GetLastFrameNumber() != mFinalFrameNumber && SkipRepeatedFrames())
+		{
+			break;
+		}
+
+		//Without -cpu only the board returning to the initial one is detected, checked once per computed batch of steps. Without spawn every cell that ever changes has changed by then
+		if(mEarlyStop && mSpawnPeriod == 0 && mFractalGen->IsInitialBoardRepeated() && mFractalGen->GetLastFrameNumber() != mFinalFrameNumber)
+		{
+			mLogger->WriteToLog(L"The board repeats the initial one at the frame " + std::to_wstring(mFractalGen->GetLastFrameNumber()) + L", the stability is final");
+			break;
+		}
+	}
+
+	SaveStability(L"Stability.png");
+
+	if(mSaveChangeMap)
+	{
+		SaveChangeMap(L"ChangeMap.bin");
+	}
+
+	if(mSaveStats)
+	{
+		SaveStats(L"Stats.csv");
+	}
+}
+
+void ConsoleApp::RenderFromChangeMap()
+{
+	//Every frame only depends on the map, so video frames don't need the frames before them
+	if(mSaveVideoFrames)
+	{
+		for(uint32_t frame = 1; frame <= mFinalFrameNumber; frame++)
+		{
+			RenderChangeMapFrame(frame);
+			FlushPreview();
+
+			std::wstring frameNumberStr     = IntermediateStateString(frame);
+			std::wstring videoFrameFilename = L"DiffStabil/Stabl" + frameNumberStr + L".png";
 
 			SaveCurrentVideoFrame(videoFrameFilename);
 		}
 	}
 
+	RenderChangeMapFrame(mFinalFrameNumber);
+	FlushPreview();
+
 	SaveStability(L"Stability.png");
 }
 
+bool ConsoleApp::SkipRepeatedFrames()
+{
+	uint32_t period = mFractalGen->GetDetectedPeriod();
+
+	//Confirming the period computes a whole period of frames, which is no faster than computing the rest normally
+	if(mFinalFrameNumber - mFractalGen->GetLastFrameNumber() <= period)
+	{
+		return false;
+	}
+
+	//The cycle is found by the state hashes only, skipping frames on a hash collision would give the wrong final stability
+	if(!mFractalGen->ConfirmDetectedPeriod())
+	{
+		mLogger->WriteToLog(L"The state hash repeated at the frame " + std::to_wstring(mFractalGen->GetLastFrameNumber()) + L" without the state repeating, continuing...");
+		return false;
+	}
+
+	mLogger->WriteToLog(L"The board and the stability repeat with the period " + std::to_wstring(period) + L", skipping to the final frame...");
+
+	//The final frame is the same as the frame with the same position in the cycle
+	uint32_t remainingSteps = (mFinalFrameNumber - mFractalGen->GetLastFrameNumber()) % period;
+	if(remainingSteps != 0)
+	{
+		ComputeFractalSteps(remainingSteps);
+		FlushPreview();
+	}
+
+	return true;
+}
+
+void ConsoleApp::ComputeBatch()
+{
+	std::vector<std::wstring> boardNames = ListBatchBoards();
+	if(boardNames.empty())
+	{
+		mLogger->WriteToLog(L"No .png boards found in " + mBatchFolder + L"!");
+		return;
+	}
+
+	std::filesystem::create_directory(L"BatchStability");
+
+	while(!boardNames.empty())
+	{
+		std::vector<std::wstring> batchNames;
+		std::vector<std::wstring> nextBatchNames; //The boards that don't fit into this batch
+		uint32_t                  finalFrame = mBatchFinalFrame;
+
+		mFractalGen->ClearBatch();
+		for(const std::wstring& boardName: boardNames)
+		{
+			if(mFractalGen->IsBatchFull())
+			{
+				nextBatchNames.push_back(boardName);
+				continue;
+			}
+
+			if(!LoadBoardFromFile(mBatchFolder + L"/" + boardName))
+			{
+				continue;
+			}
+
+			if(batchNames.empty())
+			{
+				mFractalGen->ResetComputingParameters(); //Prepares the final transform and the readback for the size of the batch
+			}
+
+			if(!mFractalGen->AddCurrentBoardToBatch())
+			{
+				nextBatchNames.push_back(boardName);
+				continue;
+			}
+
+			if(mBatchFinalFrame == 0)
+			{
+				finalFrame = std::max(finalFrame, mFractalGen->GetDefaultSolutionPeriod(mFractalGen->GetWidth()));
+			}
+
+			batchNames.push_back(boardName);
+		}
+
+		if(batchNames.empty())
+		{
+			mLogger->WriteToLog(L"Can't compute the boards left in the batch, their size differs from the restriction!");
+			break;
+		}
+
+		mLogger->WriteToLog(L"Computing the batch of " + std::to_wstring(batchNames.size()) + L" boards up to the frame " + std::to_wstring(finalFrame) + L"...");
+		for(uint32_t frame = 0; frame < finalFrame; frame += gMaxStepsPerTick)
+		{
+			uint32_t stepCount = std::min(finalFrame - frame, gMaxStepsPerTick);
+			mLogger->WriteToLog(L"Computing the frames up to " + std::to_wstring(frame + stepCount) + L"/" + std::to_wstring(finalFrame) + L"...");
+
+			mFractalGen->TickBatchSteps(stepCount);
+		}
+
+		for(uint32_t boardIndex = 0; boardIndex < (uint32_t)batchNames.size(); boardIndex++)
+		{
+			std::wstring stabilityFilename = L"BatchStability/" + batchNames[boardIndex];
+			mLogger->WriteToLog(L"Saving the stability state " + stabilityFilename + L"...");
+
+			mFractalGen->SaveBatchStability(boardIndex, stabilityFilename);
+			FlushPreview();
+		}
+
+		boardNames.swap(nextBatchNames);
+	}
+}
+
+void ConsoleApp::SearchClickRules()
+{
+	mLogger->WriteToLog(L"Searching the click rules of radius " + std::to_wstring(mRuleSearchParams.Radius) + L"...");
+
+	uint32_t ruleCount  = mFractalGen->SearchClickRules(mRuleSearchParams);
+	uint32_t foundCount = mFractalGen->GetFoundClickRuleCount();
+
+	mLogger->WriteToLog(L"Evaluated " + std::to_wstring(ruleCount) + L" distinct click rules, " + std::to_wstring(foundCount) + L" of them are kept");
+	if(foundCount == 0)
+	{
+		return;
+	}
+
+	std::filesystem::create_directory(L"RuleSearch");
+	for(uint32_t ruleIndex = 0; ruleIndex < foundCount; ruleIndex++)
+	{
+		const CpuClickRuleSearchResult& foundRule = mFractalGen->GetFoundClickRule(ruleIndex);
+
+		std::wstring ruleFilename = L"RuleSearch/Rule" + IntermediateStateString(ruleIndex) + L".png";
+		mLogger->WriteToLog(ruleFilename + L": score " + std::to_wstring(foundRule.Score) + L", stable " + std::to_wstring(foundRule.StableFraction) + L", symmetry " + std::to_wstring(foundRule.Symmetry)
+		                  + L", repeats at " + std::to_wstring(foundRule.RepeatFrame) + L" with the period " + std::to_wstring(foundRule.Period));
+
+		mFractalGen->UseFoundClickRule(ruleIndex);
+		mFractalGen->SaveClickRule(ruleFilename);
+	}
+}
+
+void ConsoleApp::ComputeRegion()
+{
+	if(!mFractalGen->PrepareRegion(mRoiX, mRoiY, mRoiWidth, mRoiHeight, mFinalFrameNumber))
+	{
+		mLogger->WriteToLog(L"The region of interest is outside the board!");
+		return;
+	}
+
+	while(mFractalGen->GetRegionFrameNumber() != mFinalFrameNumber)
+	{
+		uint32_t stepCount = std::min(mFinalFrameNumber - mFractalGen->GetRegionFrameNumber(), gMaxStepsPerTick);
+		mLogger->WriteToLog(L"Computing the region frames up to " + IntermediateStateString(mFractalGen->GetRegionFrameNumber() + stepCount) + L"/" + std::to_wstring(mFinalFrameNumber) + L"...");
+
+		mFractalGen->TickRegionSteps(stepCount);
+	}
+
+	//The full board would compute every cell of it every frame
+	uint64_t fullBoardCellCount = (uint64_t)mFractalGen->GetWidth() * mFractalGen->GetHeight() * mFinalFrameNumber;
+	uint64_t regionCellCount    = mFractalGen->GetRegionComputedCellCount();
+	mLogger->WriteToLog(L"Computed " + std::to_wstring(regionCellCount) + L" cells instead of " + std::to_wstring(fullBoardCellCount));
+
+	mLogger->WriteToLog(L"Saving the stability state Stability.png...");
+	mFractalGen->SaveRegionStability(L"Stability.png");
+	FlushPreview();
+}
+
+void ConsoleApp::ComputeOutOfCore()
+{
+	BoardClearMode clearMode = BoardClearMode::FOUR_CORNERS;
+	switch(mResetMode)
+	{
+	case ResetBoardModeApp::RESET_4_SIDES:
+		clearMode = BoardClearMode::FOUR_SIDES;
+		break;
+	case ResetBoardModeApp::RESET_CENTER:
+		clearMode = BoardClearMode::CENTER;
+		break;
+	default:
+		break;
+	}
+
+	if(mSpawnPeriod != 0)
+	{
+		mLogger->WriteToLog(L"Spawn is not supported with -out_of_core, computing without it!");
+	}
+
+	if(mFractalGen->HasRestriction())
+	{
+		mLogger->WriteToLog(L"Restrictions are not supported with -out_of_core, computing without the loaded one!");
+	}
+
+	std::filesystem::create_directory(mOutOfCoreFolder);
+	if(!mFractalGen->PrepareOutOfCore(mOutOfCoreFolder, mOutOfCoreBoardSize, mOutOfCoreBoardSize, clearMode, mMemoryBudget))
+	{
+		mLogger->WriteToLog(L"Cannot create the board files in " + mOutOfCoreFolder + L"!");
+		return;
+	}
+
+	uint32_t stepsPerPass = mFractalGen->GetOutOfCoreStepsPerPass();
+	mLogger->WriteToLog(L"Computing the " + std::to_wstring(mOutOfCoreBoardSize) + L"x" + std::to_wstring(mOutOfCoreBoardSize) + L" board in " + mOutOfCoreFolder + L", " + std::to_wstring(stepsPerPass) + L" frames per pass over the files...");
+
+	while(mFractalGen->GetOutOfCoreFrameNumber() != mFinalFrameNumber)
+	{
+		uint32_t stepCount = std::min(mFinalFrameNumber - mFractalGen->GetOutOfCoreFrameNumber(), stepsPerPass);
+		mLogger->WriteToLog(L"Computing the frames up to " + IntermediateStateString(mFractalGen->GetOutOfCoreFrameNumber() + stepCount) + L"/" + std::to_wstring(mFinalFrameNumber) + L"...");
+
+		if(!mFractalGen->TickOutOfCoreSteps(stepCount))
+		{
+			mLogger->WriteToLog(L"Cannot access the board files!");
+			return;
+		}
+	}
+
+	mLogger->WriteToLog(L"The unstable cells of the final frame are in " + mFractalGen->GetOutOfCoreStabilityFile());
+
+	mLogger->WriteToLog(L"Saving the stability preview Stability.png...");
+	if(!mFractalGen->SaveOutOfCorePreview(L"Stability.png"))
+	{
+		mLogger->WriteToLog(L"Cannot read the stability file!");
+		return;
+	}
+
+	FlushPreview();
+}
+
+void ConsoleApp::ComputeSlab()
+{
+	if(mSpawnPeriod != 0)
+	{
+		mLogger->WriteToLog(L"Spawn is not supported with -slab, computing without it!");
+	}
+
+	if(mFractalGen->HasRestriction())
+	{
+		mLogger->WriteToLog(L"Restrictions are not supported with -slab, computing without the loaded one!");
+	}
+
+	mLogger->WriteToLog(L"Connecting the slab " + std::to_wstring(mSlabIndex) + L"/" + std::to_wstring(mSlabCount) + L" to its neighbors...");
+	if(!mFractalGen->PrepareSlab(mSlabIndex, mSlabCount, mSlabAddresses))
+	{
+		mLogger->WriteToLog(L"Cannot connect to the neighbor slabs or the slabs are thinner than the click rule!");
+		return;
+	}
+
+	uint32_t rowBegin = mFractalGen->GetSlabRowBegin();
+	uint32_t rowEnd   = rowBegin + mFractalGen->GetSlabRowCount();
+	mLogger->WriteToLog(L"Computing the rows " + std::to_wstring(rowBegin) + L"-" + std::to_wstring(rowEnd - 1) + L" of the board...");
+
+	while(mFractalGen->GetSlabFrameNumber() != mFinalFrameNumber)
+	{
+		uint32_t stepCount = std::min(mFinalFrameNumber - mFractalGen->GetSlabFrameNumber(), gMaxStepsPerTick);
+		mLogger->WriteToLog(L"Computing the frames up to " + IntermediateStateString(mFractalGen->GetSlabFrameNumber() + stepCount) + L"/" + std::to_wstring(mFinalFrameNumber) + L"...");
+
+		if(!mFractalGen->TickSlabSteps(stepCount))
+		{
+			mLogger->WriteToLog(L"Lost the connection to the neighbor slabs!");
+			return;
+		}
+	}
+
+	mLogger->WriteToLog(L"Exchanged " + std::to_wstring(mFractalGen->GetSlabExchangedBytes()) + L" bytes of halo rows");
+
+	//Each slab saves its own rows, the full board is never gathered in one process
+	std::wstring stabilityFilename = L"StabilitySlab" + std::to_wstring(mSlabIndex) + L".png";
+	mLogger->WriteToLog(L"Saving the stability state " + stabilityFilename + L"...");
+
+	mFractalGen->SaveSlabStability(stabilityFilename);
+	FlushPreview();
+}
+
+std::vector<std::wstring> ConsoleApp::ListBatchBoards() const
+{
+	std::vector<std::wstring> boardNames;
+
+	std::error_code findError;
+	for(const std::filesystem::directory_entry& entry: std::filesystem::directory_iterator(mBatchFolder, findError))
+	{
+		if(entry.is_regular_file() && entry.path().extension() == L".png")
+		{
+			boardNames.push_back(entry.path().filename().wstring());
+		}
+	}
+
+	std::sort(boardNames.begin(), boardNames.end());
+	return boardNames;
+}
+
 void ConsoleApp::Init(const CommandLineArguments& cmdArgs)
 {
 	StafraApp::Init(cmdArgs);
+
+	std::string batchFolder = cmdArgs.BatchFolder();
+	mBatchFolder     = std::wstring(batchFolder.begin(), batchFolder.end());
+	mBatchFinalFrame = cmdArgs.FinalFrame();
+
+	mRuleSearchParams.Radius      = (int32_t)cmdArgs.RuleSearchRadius();
+	mRuleSearchParams.SampleCount = cmdArgs.RuleSearchSamples();
+	switch(cmdArgs.RuleSymmetry())
+	{
+	case CmdRuleSymmetry::RULE_SYMMETRY_NONE:
+		mRuleSearchParams.Symmetry = CpuRuleSymmetry::None;
+		break;
+	case CmdRuleSymmetry::RULE_SYMMETRY_MIRROR:
+		mRuleSearchParams.Symmetry = CpuRuleSymmetry::Mirror;
+		break;
+	case CmdRuleSymmetry::RULE_SYMMETRY_FULL:
+		mRuleSearchParams.Symmetry = CpuRuleSymmetry::Full;
+		break;
+	default:
+		break;
+	}
+
+	std::string outOfCoreFolder = cmdArgs.OutOfCoreFolder();
+	mOutOfCoreFolder = std::wstring(outOfCoreFolder.begin(), outOfCoreFolder.end());
+	mMemoryBudget    = (uint64_t)cmdArgs.MemoryBudget() * 1024 * 1024;
+
+	mSlabIndex     = cmdArgs.SlabIndex();
+	mSlabCount     = cmdArgs.SlabCount();
+	mSlabAddresses = cmdArgs.SlabAddresses();
+
+	if(mRuleSearchParams.Radius != 0 || mOutOfCoreBoardSize != 0 || mSlabCount != 0)
+	{
+		mFractalGen->SetCpuThreadCount(cmdArgs.CpuThreads());
+	}
+
+	mRoiX      = cmdArgs.RoiX();
+	mRoiY      = cmdArgs.RoiY();
+	mRoiWidth  = cmdArgs.RoiWidth();
+	mRoiHeight = cmdArgs.RoiHeight();
+}
+
+void ConsoleApp::FlushPreview()
+{
+#if defined(_WIN32)
+	if(mRenderer->ConsumeNeedRedraw())
+	{
+		mRenderer->DrawPreview(); //Flushes the device context
+	}
+#endif
 }
 
-void ConsoleApp::InitRenderer(const CommandLineArguments& args)
+void ConsoleApp::InitRenderer([[maybe_unused]] const CommandLineArguments& args)
 {
+#if defined(_WIN32)
 	mRenderer = std::make_unique<Renderer>(args.GpuIndex());
+#endif
 }
 
-void ConsoleApp::InitLogger(const CommandLineArguments& args)
+void ConsoleApp::InitLogger([[maybe_unused]] const CommandLineArguments& args)
 {
 	mLogger = std::make_unique<ConsoleLogger>();
 }
\ No newline at end of file
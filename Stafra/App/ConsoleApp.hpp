@@ -1,10 +1,10 @@
 #pragma once
 
-#define OEMRESOURCE
-
-#include <Windows.h>
 #include <memory>
+#include <string>
+#include <vector>
 #include "StafraApp.hpp"
+#include "../CpuComputing/CpuClickRuleSearch.hpp"
 
 class ConsoleApp: public StafraApp
 {
@@ -16,7 +16,37 @@ public:
 
 private:
 	void Init(const CommandLineArguments& cmdArgs);
+	void RenderFromChangeMap(); //Renders the frames from the change map instead of computing them
+	bool SkipRepeatedFrames();  //Computes only the frames left up to the final one modulo the detected period once it's confirmed, false if nothing was skipped
+
+	void                      ComputeBatch();     //Computes every board of the batch folder, up to 64 boards at once
+	std::vector<std::wstring> ListBatchBoards() const;
+
+	void SearchClickRules(); //Searches the click rules on the CPU and saves the best ones
+	void ComputeRegion();    //Computes only the region of interest at the final frame
+	void ComputeOutOfCore(); //Computes the board in the files of the out-of-core folder
+	void ComputeSlab();      //Computes the rows of this process's slab in step with the processes of the other slabs
+
+	void FlushPreview(); //Draws the preview if the backend changed it, there's no preview without a GPU
 
 	void InitRenderer(const CommandLineArguments& args) override;
 	void InitLogger(const CommandLineArguments& args)   override;
+
+private:
+	std::wstring mBatchFolder;     //Empty if there's no batch
+	uint32_t     mBatchFinalFrame; //0 means the latest solution period of the boards in the batch
+
+	CpuClickRuleSearchParams mRuleSearchParams; //Radius 0 if there's no click rule search
+
+	uint32_t mRoiX;
+	uint32_t mRoiY;
+	uint32_t mRoiWidth; //0 if there's no region of interest
+	uint32_t mRoiHeight;
+
+	std::wstring mOutOfCoreFolder;
+	uint64_t     mMemoryBudget; //In bytes
+
+	uint32_t                 mSlabIndex;
+	uint32_t                 mSlabCount; //0 if the board isn't split between processes
+	std::vector<std::string> mSlabAddresses;
 };
\ No newline at end of file
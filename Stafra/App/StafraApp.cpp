@@ -1,10 +1,21 @@
 #include "StafraApp.hpp"
 #include <sstream>
-#include "..\Util.hpp"
-
-StafraApp::StafraApp(): mSaveVideoFrames(false), mFinalFrameNumber(1), mSpawnPeriod(0), mResetMode(ResetBoardModeApp::RESET_4_CORNERS)
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include "../Util.hpp"
+
+#if defined(_WIN32)
+	#include "../Computing/D3D11ComputeBackend.hpp"
+#else
+	#include "../Computing/CpuComputeBackend.hpp"
+#endif
+
+StafraApp::StafraApp(): mResetMode(ResetBoardModeApp::RESET_4_CORNERS), mSaveVideoFrames(false), mUseSmoothTransform(false), mSaveChangeMap(false), mSaveStats(false), mRenderFromChangeMap(false), mUseHashLife(false), mEarlyStop(false), mSolvePeriod(false), mFinalFrameNumber(1), mSpawnPeriod(0), mOutOfCoreBoardSize(0)
 {
+#if defined(_WIN32)
 	ThrowIfFailed(CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED)); //Shell functions (file save/open dialogs) don't like multithreaded environment, so use COINIT_APARTMENTTHREADED instead of COINIT_MULTITHREADED
+#endif
 }
 
 StafraApp::~StafraApp()
@@ -16,9 +27,15 @@ void StafraApp::Init(const CommandLineArguments& cmdArgs)
 	InitRenderer(cmdArgs);
 	InitLogger(cmdArgs);
 
-	mLogger->WriteToLog(L"GPU Adapter: " + mRenderer->GetAdapterName());
+#if defined(_WIN32)
+	std::unique_ptr<ComputeBackend> computeBackend = std::make_unique<D3D11ComputeBackend>(mRenderer.get());
+#else
+	std::unique_ptr<ComputeBackend> computeBackend = std::make_unique<CpuComputeBackend>(cmdArgs.CpuThreads()); //No GPU, the steps and the transform run on the CPU threads
+#endif
+
+	mFractalGen = std::make_unique<FractalGen>(std::move(computeBackend));
+	mLogger->WriteToLog(L"Compute device: " + mFractalGen->GetComputeDeviceName());
 
-	mFractalGen = std::make_unique<FractalGen>(mRenderer.get());
 	mFractalGen->SetVideoFrameWidth(1024);
 	mFractalGen->SetVideoFrameHeight(1024);
 
@@ -28,7 +45,35 @@ void StafraApp::Init(const CommandLineArguments& cmdArgs)
 
 	if(mFinalFrameNumber == 0)
 	{
-		mFinalFrameNumber = mFractalGen->GetDefaultSolutionPeriod(mFractalGen->GetWidth());
+		if(mRenderFromChangeMap)
+		{
+			mFinalFrameNumber = mFractalGen->GetChangeMapLastFrame();
+		}
+		else if(mOutOfCoreBoardSize != 0)
+		{
+			mFinalFrameNumber = mFractalGen->GetDefaultSolutionPeriod(mOutOfCoreBoardSize);
+			mLogger->WriteToLog(L"Final frame: " + std::to_wstring(mFinalFrameNumber));
+		}
+		else if(mSolvePeriod)
+		{
+			mFinalFrameNumber = mFractalGen->ComputeSolutionPeriod(mPeriodCacheFile);
+			mLogger->WriteToLog(L"Final frame: " + std::to_wstring(mFinalFrameNumber));
+		}
+		else
+		{
+			mFinalFrameNumber = mFractalGen->GetDefaultSolutionPeriod(mFractalGen->GetWidth());
+		}
+	}
+
+	if(cmdArgs.StartFrame() != 0 && !mRenderFromChangeMap && mOutOfCoreBoardSize == 0)
+	{
+		uint32_t startFrame = std::min(cmdArgs.StartFrame(), mFinalFrameNumber);
+		mLogger->WriteToLog(L"Jumping to the frame " + std::to_wstring(startFrame) + L"...");
+
+		if(!mFractalGen->JumpToFrame(startFrame))
+		{
+			mLogger->WriteToLog(L"Jumping to a frame is only supported with -cpu!");
+		}
 	}
 }
 
@@ -48,6 +93,12 @@ void StafraApp::ParseCmdArgs(const CommandLineArguments& cmdArgs)
 {
 	uint32_t powSize   = cmdArgs.PowSize();
 	uint32_t boardSize = (1 << powSize) - 1;
+	if(!cmdArgs.OutOfCoreFolder().empty())
+	{
+		//The board only exists in the files, the GPU keeps the click rule and the downscaled stability
+		mOutOfCoreBoardSize = boardSize;
+		boardSize           = 3;
+	}
 
 	switch (cmdArgs.ResetMode())
 	{
@@ -64,13 +115,53 @@ void StafraApp::ParseCmdArgs(const CommandLineArguments& cmdArgs)
 
 	mFinalFrameNumber = cmdArgs.FinalFrame();
 	mSpawnPeriod      = cmdArgs.SpawnPeriod();
+	mFractalGen->SetSpawnPeriod(mSpawnPeriod);
+
+	//The solver computes the board sequence once more on the CPU without spawn. The batch, the click rule search and the slabs compute many boards or only a part of one
+	mSolvePeriod = cmdArgs.SolvePeriod() && cmdArgs.CpuCompute() && mSpawnPeriod == 0 && cmdArgs.BatchFolder().empty() && cmdArgs.RuleSearchRadius() == 0 && cmdArgs.OutOfCoreFolder().empty() && cmdArgs.SlabCount() == 0;
+	if(cmdArgs.SolvePeriod() && !mSolvePeriod)
+	{
+		mLogger->WriteToLog(L"Solving the period is only supported with -cpu, without spawn, -batch, -search_rules, -out_of_core and -slab!");
+	}
+
+	std::string periodCacheFile = cmdArgs.PeriodCacheFile();
+	mPeriodCacheFile = std::wstring(periodCacheFile.begin(), periodCacheFile.end());
 
 	mSaveVideoFrames    = cmdArgs.SaveVideoFrames();
 	mUseSmoothTransform = cmdArgs.SmoothTransform();
 
+	mUseHashLife   = cmdArgs.HashLife() && cmdArgs.CpuCompute();
+	mSaveChangeMap = cmdArgs.SaveChangeMap() && cmdArgs.CpuCompute();
+	if(cmdArgs.SaveChangeMap() && !cmdArgs.CpuCompute())
+	{
+		mLogger->WriteToLog(L"Saving the change map is only supported with -cpu!");
+	}
+
+	mSaveStats = cmdArgs.SaveStats() && cmdArgs.CpuCompute();
+	if(cmdArgs.SaveStats() && !cmdArgs.CpuCompute())
+	{
+		mLogger->WriteToLog(L"Saving the stats is only supported with -cpu!");
+	}
+
+	mFractalGen->SetUseCpuCompute(cmdArgs.CpuCompute() || !cmdArgs.RenderFromMap().empty() || !cmdArgs.BatchFolder().empty() || cmdArgs.RoiWidth() != 0 || !cmdArgs.OutOfCoreFolder().empty() || cmdArgs.SlabCount() != 0); //Rendering from the change map uploads the stability the same way CPU compute does, the batch, the region of interest, the out-of-core board and the slabs are CPU-only
+	mFractalGen->SetTrackChangeMap(mSaveChangeMap);
+	mFractalGen->SetTrackStats(mSaveStats);
+
+	//Every frame is needed for the video frames, the change map and the stats, so they can't skip the repeated ones
+	mEarlyStop = !cmdArgs.NoEarlyStop() && !mSaveVideoFrames && !mSaveChangeMap && !mSaveStats;
+	mFractalGen->SetDetectCycles(mEarlyStop && cmdArgs.CpuCompute());
+	if(cmdArgs.CpuCompute())
+	{
+		mFractalGen->SetCpuThreadCount(cmdArgs.CpuThreads());
+		mFractalGen->SetCpuTileSize(cmdArgs.CpuTileWidth(), cmdArgs.CpuTileHeight());
+		mFractalGen->SetUseHashLife(cmdArgs.HashLife());
+
+		mLogger->WriteToLog(L"CPU instruction set: " + mFractalGen->GetCpuInstructionSetName());
+	}
+
 	if(mSaveVideoFrames)
 	{
-		CreateDirectory(L"DiffStabil", nullptr);
+		std::filesystem::create_directory(L"DiffStabil");
 	}
 
 	if(!LoadClickRuleFromFile(L"ClickRule.png"))
@@ -87,6 +178,12 @@ void StafraApp::ParseCmdArgs(const CommandLineArguments& cmdArgs)
 	{
 		InitDefaultRestriction();
 	}
+
+	std::string changeMapFile = cmdArgs.RenderFromMap();
+	if(!changeMapFile.empty())
+	{
+		mRenderFromChangeMap = LoadChangeMapFromFile(std::wstring(changeMapFile.begin(), changeMapFile.end()));
+	}
 }
 
 void StafraApp::ComputeFractalTick()
@@ -97,6 +194,14 @@ void StafraApp::ComputeFractalTick()
 	mFractalGen->Tick();
 }
 
+void StafraApp::ComputeFractalSteps(uint32_t stepCount)
+{
+	std::wstring lastFrameNumberStr = IntermediateStateString(mFractalGen->GetLastFrameNumber() + stepCount);
+	mLogger->WriteToLog(L"Computing the frames up to " + lastFrameNumberStr + L"/" + std::to_wstring(mFinalFrameNumber) + L"...");
+
+	mFractalGen->TickSteps(stepCount);
+}
+
 void StafraApp::SaveCurrentVideoFrame(const std::wstring& filename)
 {
 	mLogger->WriteToLog(L"Saving the video frame " + filename + L"...");
@@ -109,6 +214,44 @@ void StafraApp::SaveStability(const std::wstring& filename)
 	mFractalGen->SaveCurrentStep(filename);
 }
 
+void StafraApp::SaveChangeMap(const std::wstring& filename)
+{
+	mLogger->WriteToLog(L"Saving the change map " + filename + L"...");
+	if(!mFractalGen->SaveChangeMap(filename))
+	{
+		mLogger->WriteToLog(L"Cannot write file!");
+	}
+}
+
+void StafraApp::SaveStats(const std::wstring& filename)
+{
+	mLogger->WriteToLog(L"Saving the stats " + filename + L"...");
+	if(!mFractalGen->SaveStats(filename))
+	{
+		mLogger->WriteToLog(L"Cannot write file!");
+	}
+}
+
+bool StafraApp::LoadChangeMapFromFile(const std::wstring& filename)
+{
+	mLogger->WriteToLog(L"Loading the change map from " + filename + L"...");
+	if(!mFractalGen->LoadChangeMap(filename))
+	{
+		mLogger->WriteToLog(L"Cannot read the change map!");
+		return false;
+	}
+
+	return true;
+}
+
+void StafraApp::RenderChangeMapFrame(uint32_t frameNumber)
+{
+	std::wstring frameNumberStr = IntermediateStateString(frameNumber);
+	mLogger->WriteToLog(L"Rendering the frame " + frameNumberStr + L"/" + std::to_wstring(mFinalFrameNumber) + L" from the change map...");
+
+	mFractalGen->RenderChangeMapFrame(frameNumber);
+}
+
 bool StafraApp::LoadBoardFromFile(const std::wstring& filename)
 {
 	mLogger->WriteToLog(L"Loading the board from " + filename + L"...");
@@ -1,14 +1,17 @@
 #pragma once
 
-#define OEMRESOURCE
-
-#include <Windows.h>
 #include <memory>
-#include "Renderer.hpp"
 #include "CommandLineArguments.hpp"
-#include "..\Computing\FractalGen.hpp"
+#include "../Computing/FractalGen.hpp"
 #include "Logger.hpp"
 
+#if defined(_WIN32)
+	#define OEMRESOURCE
+
+	#include <Windows.h>
+	#include "Renderer.hpp"
+#endif
+
 enum class ResetBoardModeApp
 {
 	RESET_4_CORNERS,
@@ -32,8 +35,14 @@ protected:
 	std::wstring IntermediateStateString(uint32_t frameNumber) const;
 
 	void ComputeFractalTick();
+	void ComputeFractalSteps(uint32_t stepCount);
 	void SaveCurrentVideoFrame(const std::wstring& filename);
 	void SaveStability(const std::wstring& filename);
+	void SaveChangeMap(const std::wstring& filename);
+	void SaveStats(const std::wstring& filename);
+
+	bool LoadChangeMapFromFile(const std::wstring& filename);
+	void RenderChangeMapFrame(uint32_t frameNumber);
 
 	bool LoadBoardFromFile(const std::wstring& filename);
 	void InitBoard(uint32_t boardWidth, uint32_t boardHeight);
@@ -49,14 +58,26 @@ private:
 
 protected:
 	std::unique_ptr<FractalGen> mFractalGen;
-	std::unique_ptr<Renderer>   mRenderer;
 	std::unique_ptr<Logger>     mLogger;
 
+#if defined(_WIN32)
+	std::unique_ptr<Renderer> mRenderer;
+#endif
+
 	ResetBoardModeApp mResetMode;
 
 	bool mSaveVideoFrames;
 	bool mUseSmoothTransform;
+	bool mSaveChangeMap;
+	bool mSaveStats;
+	bool mRenderFromChangeMap;
+	bool mUseHashLife;
+	bool mEarlyStop;   //Stops computing once the board and the stability repeat and skips to the final frame
+	bool mSolvePeriod; //Finds the final frame from the minimal polynomial of the board sequence instead of using the default solution period
 
 	uint32_t mFinalFrameNumber;
 	uint32_t mSpawnPeriod;
+	uint32_t mOutOfCoreBoardSize; //0 if the board fits into a texture
+
+	std::wstring mPeriodCacheFile; //The file with the solved periods, empty for no file
 };
\ No newline at end of file
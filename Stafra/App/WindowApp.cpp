@@ -619,6 +619,7 @@ void WindowApp::RenderThreadFunc()
 		}
 		case RENDER_THREAD_REDRAW:
 		{
+			mFractalGen->UpdateTransform();
 			mRenderer->DrawPreview();
 			break;
 		}
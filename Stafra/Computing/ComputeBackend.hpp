@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../Util.hpp"
+
+/*
+The interface of the device the boards are stored and computed on.
+Input#1:             Initial board, click rule and restriction (default ones or loaded from files)
+Output#1:            Stability computed from them step by step
+Input#2:             Stability computed elsewhere (CPU calculators, change maps), uploaded to the device
+Output#2:            8-bit grayscale images of the stability after the final transform, full size and downscaled to video frames. The cells of the initial board, the click rule and the restriction read back to the CPU
+Possible expansions: More devices
+*/
+
+enum class BoardClearMode
+{
+	FOUR_CORNERS,
+	FOUR_SIDES,
+	CENTER
+};
+
+class ComputeBackend
+{
+public:
+	virtual ~ComputeBackend() {}
+
+	virtual std::wstring GetDeviceName() const = 0;
+
+	virtual void                  InitBoard(uint32_t width, uint32_t height, BoardClearMode clearMode) = 0;
+	virtual Utils::BoardLoadError LoadBoardFromFile(const std::wstring& boardFile)                     = 0; //The board should be a square with the size of 2^n - 1
+	virtual void                  ChangeBoardSize(uint32_t newWidth, uint32_t newHeight)               = 0; //Keeps the initial board centered, resets the restriction
+
+	virtual void                  InitDefaultRestriction()                                     = 0; //No restriction
+	virtual Utils::BoardLoadError LoadRestrictionFromFile(const std::wstring& restrictionFile) = 0; //The restriction should have the same size as the board
+
+	virtual uint32_t GetBoardWidth()  const = 0;
+	virtual uint32_t GetBoardHeight() const = 0;
+	virtual bool     HasRestriction() const = 0;
+
+	virtual void                  InitDefaultClickRule()                                                        = 0; //The "cross" click rule
+	virtual Utils::BoardLoadError LoadClickRuleFromFile(const std::wstring& clickRuleFile)                      = 0; //The click rule should be 32x32
+	virtual void                  InitClickRuleFromCells(const uint8_t* cells, uint32_t width, uint32_t height) = 0; //Cells are tightly packed
+	virtual void                  EditClickRule(uint32_t x, uint32_t y)                                         = 0; //Toggles the click rule cell on/off
+
+	virtual uint32_t GetClickRuleWidth()  const = 0;
+	virtual uint32_t GetClickRuleHeight() const = 0;
+	virtual bool     IsDefaultClickRule() const = 0;
+
+	virtual void     PrepareForCalculations(uint32_t videoFrameWidth, uint32_t videoFrameHeight) = 0; //Restarts the stability from the initial board with the current click rule and restriction, the transform gets the board size
+	virtual void     StabilityNextSteps(uint32_t stepCount, uint32_t spawnPeriod)                = 0;
+	virtual uint32_t GetCurrentStep() const                                                      = 0;
+	virtual bool     IsBoardInitial()                                                            = 0; //True if the last computed board is equal to the initial one
+
+	virtual void PrepareForUpload(uint32_t width, uint32_t height)                   = 0; //The transform gets the size of the uploaded stability
+	virtual void UploadStability(const std::vector<uint16_t>& stabilityCells)        = 0; //Cells are tightly packed, same values as the computed stability has
+	virtual void UploadStability(std::vector<uint16_t>&& stabilityCells)             = 0; //Same, but the backend may take the cells over instead of copying them. The vector is handed back with the same size and any values, ready for the next cells
+	virtual void InvalidateTransform()                                               = 0; //The stability changed, the transform is computed again once the preview or a save needs it
+	virtual void ComputeTransform(uint32_t spawnPeriod, bool useSmooth)              = 0; //Transforms the last computed stability
+	virtual void ComputeUploadedTransform(uint32_t spawnPeriod, bool useSmooth)      = 0; //Transforms the last uploaded stability
+	virtual void DownscaleTransform()                                                = 0; //Downscales the last transform to the video frame size
+
+	virtual void ReadbackInitialBoard(std::vector<uint8_t>& outCells) = 0; //Cells are tightly packed, 0 or 1 each
+	virtual void ReadbackClickRule(std::vector<uint8_t>& outCells)    = 0;
+	virtual void ReadbackRestriction(std::vector<uint8_t>& outCells)  = 0; //Empty if there's no restriction
+
+	virtual void ReadbackTransform(std::vector<uint8_t>& outImage, uint32_t& outWidth, uint32_t& outHeight)  = 0; //Pixels are tightly packed, 255 is stable
+	virtual void ReadbackDownscaled(std::vector<uint8_t>& outImage, uint32_t& outWidth, uint32_t& outHeight) = 0;
+};
@@ -0,0 +1,622 @@
+#include "CpuComputeBackend.hpp"
+#include "../CpuComputing/CpuStabilityCalculator.hpp"
+#include "../CpuComputing/CpuClickRule.hpp"
+#include "../CpuComputing/BitBoard.hpp"
+#include "../CpuComputing/ThreadPool.hpp"
+#include "../FileMgmt/PNGOpener.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace
+{
+	const uint32_t gRowsPerTask     = 32; //The transform, the downscaling and the comparison split the rows into tasks of this size
+	const uint32_t gClickRuleSize   = 32; //Same as BoardLoader accepts
+	const float    gLitLuminance    = 0.15f;
+
+	inline float TransformedValue(uint16_t stability, uint32_t spawnPeriod, bool useSmooth)
+	{
+		if(spawnPeriod == 0 || !useSmooth)
+		{
+			return stability >= 2 ? 0.0f : (float)stability;
+		}
+		else
+		{
+			return (float)((stability + spawnPeriod - 1) % (spawnPeriod + 1)) / (float)spawnPeriod;
+		}
+	}
+}
+
+CpuComputeBackend::CpuComputeBackend(uint32_t threadCount): mTransformStabilityCells(nullptr), mBoardWidth(0), mBoardHeight(0), mClickRuleWidth(0), mClickRuleHeight(0), mTransformWidth(0), mTransformHeight(0), mTransformSpawnPeriod(0), mDownscaledWidth(0), mDownscaledHeight(0), mbDefaultClickRule(true), mbTransformSmooth(false), mbTransformedValuesOutdated(false), mbCalculatorOutdated(true)
+{
+	mStabilityCalculator = std::make_unique<CpuStabilityCalculator>();
+	mStabilityCalculator->SetThreadCount(threadCount);
+
+	mThreadPool = std::make_unique<ThreadPool>(threadCount);
+
+	mClickRule    = std::make_unique<CpuClickRule>();
+	mRestriction  = std::make_unique<BitBoard>();
+	mInitialBoard = std::make_unique<BitBoard>();
+}
+
+CpuComputeBackend::~CpuComputeBackend()
+{
+}
+
+std::wstring CpuComputeBackend::GetDeviceName() const
+{
+	std::string instructionSetName = CpuFeatures::InstructionSetName(mStabilityCalculator->GetInstructionSet());
+	return L"CPU, " + std::to_wstring(mThreadPool->GetThreadCount()) + L" threads, " + std::wstring(instructionSetName.begin(), instructionSetName.end());
+}
+
+void CpuComputeBackend::InitBoard(uint32_t width, uint32_t height, BoardClearMode clearMode)
+{
+	if(width != mBoardWidth || height != mBoardHeight)
+	{
+		mRestrictionCells.clear(); //Restriction is invalid for the new size
+	}
+
+	mBoardWidth  = width;
+	mBoardHeight = height;
+	mInitialBoardCells.assign((size_t)width * height, 0);
+
+	//Same cells as the default board shaders light up
+	switch(clearMode)
+	{
+	case BoardClearMode::FOUR_CORNERS:
+		mInitialBoardCells[0]                                        = 1;
+		mInitialBoardCells[width - 1]                                = 1;
+		mInitialBoardCells[(size_t)(height - 1) * width]             = 1;
+		mInitialBoardCells[(size_t)(height - 1) * width + width - 1] = 1;
+		break;
+	case BoardClearMode::FOUR_SIDES:
+		mInitialBoardCells[(size_t)(height / 2) * width]             = 1;
+		mInitialBoardCells[(size_t)(height / 2) * width + width - 1] = 1;
+		mInitialBoardCells[width / 2]                                = 1;
+		mInitialBoardCells[(size_t)(height - 1) * width + width / 2] = 1;
+		break;
+	case BoardClearMode::CENTER:
+		mInitialBoardCells[(size_t)(height / 2) * width + width / 2] = 1;
+		break;
+	default:
+		break;
+	}
+}
+
+Utils::BoardLoadError CpuComputeBackend::LoadBoardFromFile(const std::wstring& boardFile)
+{
+	std::vector<uint8_t> boardCells;
+	uint32_t boardWidth  = 0;
+	uint32_t boardHeight = 0;
+
+	Utils::BoardLoadError loadErr = LoadCellsFromFile(boardFile, boardCells, boardWidth, boardHeight);
+	if(loadErr != Utils::BoardLoadError::LOAD_SUCCESS)
+	{
+		return loadErr;
+	}
+
+	if(boardWidth != boardHeight                 //Check if board is a square
+	|| ((boardWidth  + 1) & boardWidth)  != 0    //Check if width is power of 2 minus 1
+	|| ((boardHeight + 1) & boardHeight) != 0)   //Check if height is power of 2 minus 1
+	{
+		return Utils::BoardLoadError::ERROR_WRONG_SIZE;
+	}
+
+	if(boardWidth != mBoardWidth || boardHeight != mBoardHeight)
+	{
+		mRestrictionCells.clear(); //Restriction is invalid for the new size
+	}
+
+	mBoardWidth  = boardWidth;
+	mBoardHeight = boardHeight;
+	mInitialBoardCells.swap(boardCells);
+
+	return Utils::BoardLoadError::LOAD_SUCCESS;
+}
+
+void CpuComputeBackend::ChangeBoardSize(uint32_t newWidth, uint32_t newHeight)
+{
+	mRestrictionCells.clear(); //Restriction is invalid for the new size
+
+	//Copy the board to the center of the bigger/smaller one, the rest of the cells are zero
+	int32_t offsetX = ((int32_t)newWidth  - (int32_t)mBoardWidth)  / 2;
+	int32_t offsetY = ((int32_t)newHeight - (int32_t)mBoardHeight) / 2;
+
+	std::vector<uint8_t> newBoardCells((size_t)newWidth * newHeight, 0);
+	for(uint32_t y = 0; y < newHeight; y++)
+	{
+		int32_t oldY = (int32_t)y - offsetY;
+		if(oldY < 0 || oldY >= (int32_t)mBoardHeight)
+		{
+			continue;
+		}
+
+		for(uint32_t x = 0; x < newWidth; x++)
+		{
+			int32_t oldX = (int32_t)x - offsetX;
+			if(oldX >= 0 && oldX < (int32_t)mBoardWidth)
+			{
+				newBoardCells[(size_t)y * newWidth + x] = mInitialBoardCells[(size_t)oldY * mBoardWidth + oldX];
+			}
+		}
+	}
+
+	mBoardWidth  = newWidth;
+	mBoardHeight = newHeight;
+	mInitialBoardCells.swap(newBoardCells);
+}
+
+void CpuComputeBackend::InitDefaultRestriction()
+{
+	mRestrictionCells.clear();
+}
+
+Utils::BoardLoadError CpuComputeBackend::LoadRestrictionFromFile(const std::wstring& restrictionFile)
+{
+	std::vector<uint8_t> restrictionCells;
+	uint32_t restrictionWidth  = 0;
+	uint32_t restrictionHeight = 0;
+
+	Utils::BoardLoadError loadErr = LoadCellsFromFile(restrictionFile, restrictionCells, restrictionWidth, restrictionHeight);
+	if(loadErr != Utils::BoardLoadError::LOAD_SUCCESS)
+	{
+		return loadErr;
+	}
+
+	if(restrictionWidth != mBoardWidth || restrictionHeight != mBoardHeight) //Restriction should be the same size as board
+	{
+		return Utils::BoardLoadError::ERROR_WRONG_SIZE;
+	}
+
+	mRestrictionCells.swap(restrictionCells);
+	return Utils::BoardLoadError::LOAD_SUCCESS;
+}
+
+uint32_t CpuComputeBackend::GetBoardWidth() const
+{
+	return mBoardWidth;
+}
+
+uint32_t CpuComputeBackend::GetBoardHeight() const
+{
+	return mBoardHeight;
+}
+
+bool CpuComputeBackend::HasRestriction() const
+{
+	return !mRestrictionCells.empty();
+}
+
+void CpuComputeBackend::InitDefaultClickRule()
+{
+	mClickRuleWidth  = gClickRuleSize;
+	mClickRuleHeight = gClickRuleSize;
+	mClickRuleCells.assign((size_t)mClickRuleWidth * mClickRuleHeight, 0);
+
+	//Same cross as ClickRules::InitDefault()
+	const uint32_t centralCellX = (mClickRuleWidth  - 1) / 2;
+	const uint32_t centralCellY = (mClickRuleHeight - 1) / 2;
+
+	mClickRuleCells[(centralCellY + 0) * mClickRuleWidth + (centralCellX + 0)] = 1;
+	mClickRuleCells[(centralCellY - 1) * mClickRuleWidth + (centralCellX + 0)] = 1;
+	mClickRuleCells[(centralCellY + 1) * mClickRuleWidth + (centralCellX + 0)] = 1;
+	mClickRuleCells[(centralCellY + 0) * mClickRuleWidth + (centralCellX - 1)] = 1;
+	mClickRuleCells[(centralCellY + 0) * mClickRuleWidth + (centralCellX + 1)] = 1;
+
+	mbDefaultClickRule = true;
+}
+
+Utils::BoardLoadError CpuComputeBackend::LoadClickRuleFromFile(const std::wstring& clickRuleFile)
+{
+	std::vector<uint8_t> clickRuleCells;
+	uint32_t clickRuleWidth  = 0;
+	uint32_t clickRuleHeight = 0;
+
+	Utils::BoardLoadError loadErr = LoadCellsFromFile(clickRuleFile, clickRuleCells, clickRuleWidth, clickRuleHeight);
+	if(loadErr != Utils::BoardLoadError::LOAD_SUCCESS)
+	{
+		return loadErr;
+	}
+
+	if(clickRuleWidth != gClickRuleSize || clickRuleHeight != gClickRuleSize)
+	{
+		return Utils::BoardLoadError::ERROR_WRONG_SIZE;
+	}
+
+	InitClickRuleFromCells(clickRuleCells.data(), clickRuleWidth, clickRuleHeight);
+	return Utils::BoardLoadError::LOAD_SUCCESS;
+}
+
+void CpuComputeBackend::InitClickRuleFromCells(const uint8_t* cells, uint32_t width, uint32_t height)
+{
+	mClickRuleWidth  = width;
+	mClickRuleHeight = height;
+	mClickRuleCells.assign(cells, cells + (size_t)width * height);
+
+	mbDefaultClickRule = false;
+}
+
+void CpuComputeBackend::EditClickRule(uint32_t x, uint32_t y)
+{
+	if(x >= mClickRuleWidth || y >= mClickRuleHeight)
+	{
+		return;
+	}
+
+	uint8_t& clickRuleCell = mClickRuleCells[(size_t)y * mClickRuleWidth + x];
+	clickRuleCell = (clickRuleCell + 1) % 2;
+
+	mbDefaultClickRule = false;
+}
+
+uint32_t CpuComputeBackend::GetClickRuleWidth() const
+{
+	return mClickRuleWidth;
+}
+
+uint32_t CpuComputeBackend::GetClickRuleHeight() const
+{
+	return mClickRuleHeight;
+}
+
+bool CpuComputeBackend::IsDefaultClickRule() const
+{
+	return mbDefaultClickRule;
+}
+
+void CpuComputeBackend::PrepareForCalculations(uint32_t videoFrameWidth, uint32_t videoFrameHeight)
+{
+	mClickRule->InitFromCells(mClickRuleCells.data(), mClickRuleWidth, mClickRuleHeight, mClickRuleWidth);
+
+	mRestriction->Resize(0, 0);
+	if(!mRestrictionCells.empty())
+	{
+		mRestriction->Resize(mBoardWidth, mBoardHeight);
+		mRestriction->FromCells(mRestrictionCells.data(), mBoardWidth);
+	}
+
+	mInitialBoard->Resize(mBoardWidth, mBoardHeight);
+	mInitialBoard->FromCells(mInitialBoardCells.data(), mBoardWidth);
+
+	mbCalculatorOutdated = true;
+
+	mTransformWidth  = mBoardWidth;
+	mTransformHeight = mBoardHeight;
+
+	mDownscaledWidth  = videoFrameWidth;
+	mDownscaledHeight = videoFrameHeight;
+}
+
+void CpuComputeBackend::StabilityNextSteps(uint32_t stepCount, uint32_t spawnPeriod)
+{
+	PrepareStabilityCalculator();
+	mStabilityCalculator->StabilityNextSteps(stepCount, GetCpuClickRule(), GetCpuRestriction(), spawnPeriod);
+}
+
+uint32_t CpuComputeBackend::GetCurrentStep() const
+{
+	if(mbCalculatorOutdated)
+	{
+		return 0;
+	}
+
+	return mStabilityCalculator->GetCurrentStep();
+}
+
+bool CpuComputeBackend::IsBoardInitial()
+{
+	PrepareStabilityCalculator();
+
+	const BitBoard& lastBoard    = mStabilityCalculator->GetLastBoardState();
+	const BitBoard* initialBoard = mInitialBoard.get();
+
+	//If only a part of the board is simulated, the rest of it mirrors that part in both boards
+	BitBoard initialBoardPart;
+	if(lastBoard.GetWidth() != initialBoard->GetWidth() || lastBoard.GetHeight() != initialBoard->GetHeight())
+	{
+		initialBoardPart.Resize(lastBoard.GetWidth(), lastBoard.GetHeight());
+		initialBoardPart.CropFrom(*initialBoard);
+		initialBoard = &initialBoardPart;
+	}
+
+	const size_t    wordsPerRow = lastBoard.GetWordsPerRow();
+	const uint64_t* columnMask  = lastBoard.GetColumnMask();
+
+	std::atomic<bool> boardsEqual(true);
+
+	uint32_t taskCount = (lastBoard.GetHeight() + gRowsPerTask - 1) / gRowsPerTask;
+	mThreadPool->ParallelFor(taskCount, [&](uint32_t taskIndex, uint32_t /*threadIndex*/)
+	{
+		uint32_t rowBegin = taskIndex * gRowsPerTask;
+		uint32_t rowEnd   = std::min(rowBegin + gRowsPerTask, lastBoard.GetHeight());
+		for(uint32_t y = rowBegin; y < rowEnd && boardsEqual.load(std::memory_order_relaxed); y++)
+		{
+			const uint64_t* lastRow    = lastBoard.Row((int32_t)y);
+			const uint64_t* initialRow = initialBoard->Row((int32_t)y);
+			for(size_t i = 0; i < wordsPerRow; i++)
+			{
+				if(((lastRow[i] ^ initialRow[i]) & columnMask[i]) != 0)
+				{
+					boardsEqual.store(false, std::memory_order_relaxed);
+					return;
+				}
+			}
+		}
+	});
+
+	return boardsEqual.load();
+}
+
+void CpuComputeBackend::PrepareForUpload(uint32_t width, uint32_t height)
+{
+	mTransformWidth  = width;
+	mTransformHeight = height;
+}
+
+void CpuComputeBackend::UploadStability(const std::vector<uint16_t>& stabilityCells)
+{
+	if(stabilityCells.size() < (size_t)mTransformWidth * mTransformHeight)
+	{
+		return;
+	}
+
+	mUploadedStabilityCells.assign(stabilityCells.begin(), stabilityCells.begin() + (size_t)mTransformWidth * mTransformHeight);
+}
+
+void CpuComputeBackend::UploadStability(std::vector<uint16_t>&& stabilityCells)
+{
+	if(stabilityCells.size() < (size_t)mTransformWidth * mTransformHeight)
+	{
+		return;
+	}
+
+	//The transform only reads the first mTransformWidth * mTransformHeight cells. The previous ones are only storage for the caller now, and may be empty before the first upload
+	size_t cellCount = stabilityCells.size();
+	mUploadedStabilityCells.swap(stabilityCells);
+	stabilityCells.resize(cellCount);
+}
+
+void CpuComputeBackend::InvalidateTransform()
+{
+	//Nothing to redraw, the stability is only transformed once a save asks for it in ComputeTransform() or ComputeUploadedTransform()
+}
+
+void CpuComputeBackend::ComputeTransform(uint32_t spawnPeriod, bool useSmooth)
+{
+	PrepareStabilityCalculator();
+
+	mTransformWidth  = mStabilityCalculator->GetBoardWidth();
+	mTransformHeight = mStabilityCalculator->GetBoardHeight();
+
+	mComputedStabilityCells.resize((size_t)mTransformWidth * mTransformHeight);
+	mStabilityCalculator->CopyStabilityCells(mComputedStabilityCells.data(), mTransformWidth);
+
+	//The values themselves are computed by the consumer, straight to the format it needs
+	mTransformStabilityCells    = &mComputedStabilityCells;
+	mTransformSpawnPeriod       = spawnPeriod;
+	mbTransformSmooth           = useSmooth;
+	mbTransformedValuesOutdated = true;
+}
+
+void CpuComputeBackend::ComputeUploadedTransform(uint32_t spawnPeriod, bool useSmooth)
+{
+	mTransformStabilityCells    = &mUploadedStabilityCells;
+	mTransformSpawnPeriod       = spawnPeriod;
+	mbTransformSmooth           = useSmooth;
+	mbTransformedValuesOutdated = true;
+}
+
+void CpuComputeBackend::DownscaleTransform()
+{
+	UpdateTransformedValues();
+
+	mDownscaledValues.assign((size_t)mDownscaledWidth * mDownscaledHeight, 0.0f);
+	if(mTransformedValues.empty() || mDownscaledValues.empty())
+	{
+		return;
+	}
+
+	const uint32_t srcWidth  = mTransformWidth;
+	const uint32_t srcHeight = mTransformHeight;
+
+	//Same as the sampler of Downscaler: linear filtering when the picture is minified, point filtering when it's magnified, clamped at the edges
+	const bool minified = std::max((float)srcWidth / mDownscaledWidth, (float)srcHeight / mDownscaledHeight) > 1.0f;
+
+	uint32_t taskCount = (mDownscaledHeight + gRowsPerTask - 1) / gRowsPerTask;
+	mThreadPool->ParallelFor(taskCount, [&](uint32_t taskIndex, uint32_t /*threadIndex*/)
+	{
+		uint32_t rowBegin = taskIndex * gRowsPerTask;
+		uint32_t rowEnd   = std::min(rowBegin + gRowsPerTask, mDownscaledHeight);
+		for(uint32_t y = rowBegin; y < rowEnd; y++)
+		{
+			float v = (y + 0.5f) / mDownscaledHeight;
+			for(uint32_t x = 0; x < mDownscaledWidth; x++)
+			{
+				float u = (x + 0.5f) / mDownscaledWidth;
+
+				float sampledValue = 0.0f;
+				if(minified)
+				{
+					float texelX = u * srcWidth  - 0.5f;
+					float texelY = v * srcHeight - 0.5f;
+
+					float floorX = std::floor(texelX);
+					float floorY = std::floor(texelY);
+					float fracX  = texelX - floorX;
+					float fracY  = texelY - floorY;
+
+					int32_t x0 = std::clamp((int32_t)floorX,     0, (int32_t)srcWidth  - 1);
+					int32_t x1 = std::clamp((int32_t)floorX + 1, 0, (int32_t)srcWidth  - 1);
+					int32_t y0 = std::clamp((int32_t)floorY,     0, (int32_t)srcHeight - 1);
+					int32_t y1 = std::clamp((int32_t)floorY + 1, 0, (int32_t)srcHeight - 1);
+
+					float topValue    = mTransformedValues[(size_t)y0 * srcWidth + x0] * (1.0f - fracX) + mTransformedValues[(size_t)y0 * srcWidth + x1] * fracX;
+					float bottomValue = mTransformedValues[(size_t)y1 * srcWidth + x0] * (1.0f - fracX) + mTransformedValues[(size_t)y1 * srcWidth + x1] * fracX;
+					sampledValue      = topValue * (1.0f - fracY) + bottomValue * fracY;
+				}
+				else
+				{
+					uint32_t srcX = std::min((uint32_t)(u * srcWidth),  srcWidth  - 1);
+					uint32_t srcY = std::min((uint32_t)(v * srcHeight), srcHeight - 1);
+					sampledValue  = mTransformedValues[(size_t)srcY * srcWidth + srcX];
+				}
+
+				mDownscaledValues[(size_t)y * mDownscaledWidth + x] = sampledValue;
+			}
+		}
+	});
+}
+
+void CpuComputeBackend::ReadbackInitialBoard(std::vector<uint8_t>& outCells)
+{
+	outCells = mInitialBoardCells;
+}
+
+void CpuComputeBackend::ReadbackClickRule(std::vector<uint8_t>& outCells)
+{
+	outCells = mClickRuleCells;
+}
+
+void CpuComputeBackend::ReadbackRestriction(std::vector<uint8_t>& outCells)
+{
+	outCells = mRestrictionCells;
+}
+
+void CpuComputeBackend::ReadbackTransform(std::vector<uint8_t>& outImage, uint32_t& outWidth, uint32_t& outHeight)
+{
+	outWidth  = mTransformWidth;
+	outHeight = mTransformHeight;
+
+	if(mbTransformedValuesOutdated)
+	{
+		TransformToImage(outImage);
+	}
+	else
+	{
+		ConvertToImage(mTransformedValues, outImage);
+	}
+}
+
+void CpuComputeBackend::ReadbackDownscaled(std::vector<uint8_t>& outImage, uint32_t& outWidth, uint32_t& outHeight)
+{
+	outWidth  = mDownscaledWidth;
+	outHeight = mDownscaledHeight;
+	ConvertToImage(mDownscaledValues, outImage);
+}
+
+const CpuClickRule* CpuComputeBackend::GetCpuClickRule() const
+{
+	return mbDefaultClickRule ? nullptr : mClickRule.get();
+}
+
+const BitBoard* CpuComputeBackend::GetCpuRestriction() const
+{
+	return mRestrictionCells.empty() ? nullptr : mRestriction.get();
+}
+
+void CpuComputeBackend::PrepareStabilityCalculator()
+{
+	if(!mbCalculatorOutdated)
+	{
+		return;
+	}
+
+	mbCalculatorOutdated = false;
+
+	mStabilityCalculator->PrepareForCalculations(mInitialBoardCells.data(), mBoardWidth, mBoardHeight, mBoardWidth);
+	mStabilityCalculator->ReduceBySymmetry(GetCpuClickRule(), GetCpuRestriction());
+}
+
+Utils::BoardLoadError CpuComputeBackend::LoadCellsFromFile(const std::wstring& filename, std::vector<uint8_t>& outCells, uint32_t& outWidth, uint32_t& outHeight)
+{
+	PngOpener pngOpener;
+	if(!pngOpener)
+	{
+		return Utils::BoardLoadError::ERROR_INVALID_ARGUMENT;
+	}
+
+	size_t imageWidth  = 0;
+	size_t imageHeight = 0;
+	std::vector<uint8_t> rgbaData;
+	if(!pngOpener.ReadRgbaImage(filename, imageWidth, imageHeight, rgbaData))
+	{
+		return Utils::BoardLoadError::ERROR_CANT_READ_FILE;
+	}
+
+	outWidth  = (uint32_t)imageWidth;
+	outHeight = (uint32_t)imageHeight;
+
+	outCells.resize(imageWidth * imageHeight);
+	for(size_t i = 0; i < outCells.size(); i++)
+	{
+		float luminance = 0.2126f * rgbaData[i * 4 + 0] / 255.0f + 0.7152f * rgbaData[i * 4 + 1] / 255.0f + 0.0722f * rgbaData[i * 4 + 2] / 255.0f;
+		outCells[i]     = luminance > gLitLuminance;
+	}
+
+	return Utils::BoardLoadError::LOAD_SUCCESS;
+}
+
+void CpuComputeBackend::UpdateTransformedValues()
+{
+	if(!mbTransformedValuesOutdated)
+	{
+		return;
+	}
+
+	mbTransformedValuesOutdated = false;
+
+	mTransformedValues.resize((size_t)mTransformWidth * mTransformHeight);
+	if(mTransformStabilityCells->size() < mTransformedValues.size())
+	{
+		std::fill(mTransformedValues.begin(), mTransformedValues.end(), 0.0f);
+		return;
+	}
+
+	const uint16_t* stabilityCells = mTransformStabilityCells->data();
+
+	uint32_t taskCount = (mTransformHeight + gRowsPerTask - 1) / gRowsPerTask;
+	mThreadPool->ParallelFor(taskCount, [&](uint32_t taskIndex, uint32_t /*threadIndex*/)
+	{
+		size_t cellBegin = (size_t)taskIndex * gRowsPerTask * mTransformWidth;
+		size_t cellEnd   = std::min(cellBegin + (size_t)gRowsPerTask * mTransformWidth, mTransformedValues.size());
+		for(size_t i = cellBegin; i < cellEnd; i++)
+		{
+			mTransformedValues[i] = TransformedValue(stabilityCells[i], mTransformSpawnPeriod, mbTransformSmooth);
+		}
+	});
+}
+
+void CpuComputeBackend::TransformToImage(std::vector<uint8_t>& outImage)
+{
+	outImage.assign((size_t)mTransformWidth * mTransformHeight, 0);
+	if(mTransformStabilityCells->size() < outImage.size())
+	{
+		return;
+	}
+
+	const uint16_t* stabilityCells = mTransformStabilityCells->data();
+
+	uint32_t taskCount = (mTransformHeight + gRowsPerTask - 1) / gRowsPerTask;
+	mThreadPool->ParallelFor(taskCount, [&](uint32_t taskIndex, uint32_t /*threadIndex*/)
+	{
+		size_t cellBegin = (size_t)taskIndex * gRowsPerTask * mTransformWidth;
+		size_t cellEnd   = std::min(cellBegin + (size_t)gRowsPerTask * mTransformWidth, outImage.size());
+		for(size_t i = cellBegin; i < cellEnd; i++)
+		{
+			outImage[i] = (uint8_t)(TransformedValue(stabilityCells[i], mTransformSpawnPeriod, mbTransformSmooth) * 255.0f);
+		}
+	});
+}
+
+void CpuComputeBackend::ConvertToImage(const std::vector<float>& values, std::vector<uint8_t>& outImage)
+{
+	outImage.resize(values.size());
+
+	uint32_t taskCount = (uint32_t)((values.size() + gRowsPerTask * 1024 - 1) / (gRowsPerTask * 1024));
+	mThreadPool->ParallelFor(taskCount, [&](uint32_t taskIndex, uint32_t /*threadIndex*/)
+	{
+		size_t valueBegin = (size_t)taskIndex * gRowsPerTask * 1024;
+		size_t valueEnd   = std::min(valueBegin + gRowsPerTask * 1024, values.size());
+		std::transform(values.begin() + valueBegin, values.begin() + valueEnd, outImage.begin() + valueBegin, [](float val) {return (uint8_t)(val * 255.0f); });
+	});
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <memory>
+#include "ComputeBackend.hpp"
+
+class CpuStabilityCalculator;
+class CpuClickRule;
+class BitBoard;
+class ThreadPool;
+
+/*
+The class for computing the stability on the CPU only, for the hosts without a GPU.
+Input:               Thread count, the boards, the click rule and the restriction
+Output:              Same as ComputeBackend. The steps are computed by CpuStabilityCalculator, the final transform and the downscaling are split between the same number of threads.
+                     The float transform is only stored for the downscaling, the full-size readback transforms the stability straight to 8-bit pixels
+Possible expansions: None ATM
+*/
+
+class CpuComputeBackend: public ComputeBackend
+{
+public:
+	CpuComputeBackend(uint32_t threadCount); //0 means one thread per hardware thread
+	~CpuComputeBackend();
+
+	std::wstring GetDeviceName() const override;
+
+	void                  InitBoard(uint32_t width, uint32_t height, BoardClearMode clearMode) override;
+	Utils::BoardLoadError LoadBoardFromFile(const std::wstring& boardFile)                     override;
+	void                  ChangeBoardSize(uint32_t newWidth, uint32_t newHeight)               override;
+
+	void                  InitDefaultRestriction()                                     override;
+	Utils::BoardLoadError LoadRestrictionFromFile(const std::wstring& restrictionFile) override;
+
+	uint32_t GetBoardWidth()  const override;
+	uint32_t GetBoardHeight() const override;
+	bool     HasRestriction() const override;
+
+	void                  InitDefaultClickRule()                                                        override;
+	Utils::BoardLoadError LoadClickRuleFromFile(const std::wstring& clickRuleFile)                      override;
+	void                  InitClickRuleFromCells(const uint8_t* cells, uint32_t width, uint32_t height) override;
+	void                  EditClickRule(uint32_t x, uint32_t y)                                         override;
+
+	uint32_t GetClickRuleWidth()  const override;
+	uint32_t GetClickRuleHeight() const override;
+	bool     IsDefaultClickRule() const override;
+
+	void     PrepareForCalculations(uint32_t videoFrameWidth, uint32_t videoFrameHeight) override;
+	void     StabilityNextSteps(uint32_t stepCount, uint32_t spawnPeriod)                override;
+	uint32_t GetCurrentStep() const                                                      override;
+	bool     IsBoardInitial()                                                            override;
+
+	void PrepareForUpload(uint32_t width, uint32_t height)              override;
+	void UploadStability(const std::vector<uint16_t>& stabilityCells)   override;
+	void UploadStability(std::vector<uint16_t>&& stabilityCells)        override; //Swaps the cells with the previously uploaded ones, resized to the same size
+	void InvalidateTransform()                                          override;
+	void ComputeTransform(uint32_t spawnPeriod, bool useSmooth)         override;
+	void ComputeUploadedTransform(uint32_t spawnPeriod, bool useSmooth) override;
+	void DownscaleTransform()                                           override;
+
+	void ReadbackInitialBoard(std::vector<uint8_t>& outCells) override;
+	void ReadbackClickRule(std::vector<uint8_t>& outCells)    override;
+	void ReadbackRestriction(std::vector<uint8_t>& outCells)  override;
+
+	void ReadbackTransform(std::vector<uint8_t>& outImage, uint32_t& outWidth, uint32_t& outHeight)  override;
+	void ReadbackDownscaled(std::vector<uint8_t>& outImage, uint32_t& outWidth, uint32_t& outHeight) override;
+
+private:
+	const CpuClickRule* GetCpuClickRule()   const; //Null for the default click rule
+	const BitBoard*     GetCpuRestriction() const; //Null if there's no restriction
+
+	void PrepareStabilityCalculator(); //Prepares the calculator on the first step, the FractalGen's own CPU calculator is used with -cpu instead
+
+	Utils::BoardLoadError LoadCellsFromFile(const std::wstring& filename, std::vector<uint8_t>& outCells, uint32_t& outWidth, uint32_t& outHeight); //Same luminance threshold as InitialStateTransformCS
+
+	void UpdateTransformedValues();                          //Transforms the stability to floats if it changed since, same values as FinalStateTransformCS and FinalStateTransformSmoothCS
+	void TransformToImage(std::vector<uint8_t>& outImage); //Transforms the stability straight to 8-bit pixels, same as reading back the float transform
+	void ConvertToImage(const std::vector<float>& values, std::vector<uint8_t>& outImage);
+
+private:
+	std::unique_ptr<CpuStabilityCalculator> mStabilityCalculator;
+	std::unique_ptr<ThreadPool>             mThreadPool; //For everything besides the steps
+
+	std::unique_ptr<CpuClickRule> mClickRule;
+	std::unique_ptr<BitBoard>     mRestriction;
+	std::unique_ptr<BitBoard>     mInitialBoard;
+
+	std::vector<uint8_t> mInitialBoardCells;
+	std::vector<uint8_t> mRestrictionCells; //Empty if there's no restriction
+	std::vector<uint8_t> mClickRuleCells;
+
+	std::vector<uint16_t> mComputedStabilityCells;
+	std::vector<uint16_t> mUploadedStabilityCells;
+
+	const std::vector<uint16_t>* mTransformStabilityCells; //Either the computed or the uploaded ones, null before the first transform
+
+	std::vector<float> mTransformedValues;
+	std::vector<float> mDownscaledValues;
+
+	uint32_t mBoardWidth;
+	uint32_t mBoardHeight;
+
+	uint32_t mClickRuleWidth;
+	uint32_t mClickRuleHeight;
+
+	uint32_t mTransformWidth;
+	uint32_t mTransformHeight;
+	uint32_t mTransformSpawnPeriod;
+
+	uint32_t mDownscaledWidth;
+	uint32_t mDownscaledHeight;
+
+	bool mbDefaultClickRule;
+	bool mbTransformSmooth;
+	bool mbTransformedValuesOutdated;
+	bool mbCalculatorOutdated;
+};
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "CpuEngineAdapters.hpp"
+#include "ComputeBackend.hpp"
+#include "../CpuComputing/CpuBatchCalculator.hpp"
+#include "../CpuComputing/CpuRegionCalculator.hpp"
+#include "../CpuComputing/CpuSlabCalculator.hpp"
+#include <algorithm>
+
+namespace
+{
+	const uint32_t gMaxOutOfCorePreviewSize = 4095; //The out-of-core stability is saved downscaled to at most this size
+}
+
+std::vector<CpuCellPosition> CpuEngineAdapters::GetClearModeLitCells(BoardClearMode clearMode, uint32_t width, uint32_t height)
+{
+	switch(clearMode)
+	{
+	case BoardClearMode::FOUR_CORNERS:
+		return {{0, 0}, {width - 1, 0}, {0, height - 1}, {width - 1, height - 1}};
+	case BoardClearMode::FOUR_SIDES:
+		return {{0, height / 2}, {width - 1, height / 2}, {width / 2, 0}, {width / 2, height - 1}};
+	case BoardClearMode::CENTER:
+		return {{width / 2, height / 2}};
+	default:
+		return {};
+	}
+}
+
+void CpuEngineAdapters::GetRegionImageSize(const CpuRegionCalculator& calculator, uint32_t& outWidth, uint32_t& outHeight)
+{
+	const CpuRegion& region = calculator.GetRegion();
+
+	outWidth  = region.Width;
+	outHeight = region.Height;
+}
+
+void CpuEngineAdapters::GetOutOfCoreImageSize(const CpuOutOfCoreCalculator& calculator, uint32_t& outWidth, uint32_t& outHeight)
+{
+	outWidth  = std::min(calculator.GetBoardWidth(),  gMaxOutOfCorePreviewSize);
+	outHeight = std::min(calculator.GetBoardHeight(), gMaxOutOfCorePreviewSize);
+}
+
+void CpuEngineAdapters::GetSlabImageSize(const CpuSlabCalculator& calculator, uint32_t& outWidth, uint32_t& outHeight)
+{
+	outWidth  = calculator.GetBoardWidth();
+	outHeight = calculator.GetRowCount();
+}
+
+void CpuEngineAdapters::CopyBatchStability(const CpuBatchCalculator& calculator, uint32_t boardIndex, std::vector<uint16_t>& outCells)
+{
+	outCells.resize((size_t)calculator.GetBoardWidth() * calculator.GetBoardHeight());
+	calculator.CopyStabilityCells(boardIndex, outCells.data(), calculator.GetBoardWidth());
+}
+
+void CpuEngineAdapters::CopyRegionStability(const CpuRegionCalculator& calculator, std::vector<uint16_t>& outCells)
+{
+	uint32_t width  = 0;
+	uint32_t height = 0;
+	GetRegionImageSize(calculator, width, height);
+
+	outCells.resize((size_t)width * height);
+	calculator.CopyStabilityCells(outCells.data(), width);
+}
+
+bool CpuEngineAdapters::CopyOutOfCoreStability(CpuOutOfCoreCalculator& calculator, std::vector<uint16_t>& outCells)
+{
+	uint32_t width  = 0;
+	uint32_t height = 0;
+	GetOutOfCoreImageSize(calculator, width, height);
+
+	outCells.resize((size_t)width * height);
+	return calculator.CopyStabilityPreview(outCells.data(), width, height, width);
+}
+
+void CpuEngineAdapters::CopySlabStability(const CpuSlabCalculator& calculator, std::vector<uint16_t>& outCells)
+{
+	uint32_t width  = 0;
+	uint32_t height = 0;
+	GetSlabImageSize(calculator, width, height);
+
+	outCells.resize((size_t)width * height);
+	calculator.CopyStabilityCells(outCells.data(), width);
+}
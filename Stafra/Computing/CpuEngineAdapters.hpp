@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "../CpuComputing/CpuOutOfCoreCalculator.hpp"
+
+class CpuBatchCalculator;
+class CpuRegionCalculator;
+class CpuSlabCalculator;
+
+enum class BoardClearMode;
+
+/*
+The functions for handing the results of the CPU engines to the final transform, as if each engine computed the whole board.
+Input:               The CPU engine (the batch, the region, the out-of-core or the slab calculator)
+Output:              The size of the image the engine shows, its stability cells (tightly packed, 16 bits per cell)
+Possible expansions: The change maps and the stats of the engines
+*/
+
+namespace CpuEngineAdapters
+{
+	std::vector<CpuCellPosition> GetClearModeLitCells(BoardClearMode clearMode, uint32_t width, uint32_t height); //Same cells as the default board shaders light up, for the boards that would never fit into a texture
+
+	void GetRegionImageSize(const CpuRegionCalculator& calculator, uint32_t& outWidth, uint32_t& outHeight);       //The region only
+	void GetOutOfCoreImageSize(const CpuOutOfCoreCalculator& calculator, uint32_t& outWidth, uint32_t& outHeight); //The preview, downscaled to fit into a texture
+	void GetSlabImageSize(const CpuSlabCalculator& calculator, uint32_t& outWidth, uint32_t& outHeight);           //The rows of the slab only
+
+	void CopyBatchStability(const CpuBatchCalculator& calculator, uint32_t boardIndex, std::vector<uint16_t>& outCells); //Every function resizes outCells to the image size
+	void CopyRegionStability(const CpuRegionCalculator& calculator, std::vector<uint16_t>& outCells);
+	bool CopyOutOfCoreStability(CpuOutOfCoreCalculator& calculator, std::vector<uint16_t>& outCells); //Each preview cell is stable if most of its board cells are. False if the files can't be accessed
+	void CopySlabStability(const CpuSlabCalculator& calculator, std::vector<uint16_t>& outCells);
+}
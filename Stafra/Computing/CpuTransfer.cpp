@@ -0,0 +1,127 @@
+#include "CpuTransfer.hpp"
+#include "..\Util.hpp"
+#include <algorithm>
+
+CpuTransfer::CpuTransfer(): mUploadWidth(0), mUploadHeight(0)
+{
+}
+
+CpuTransfer::~CpuTransfer()
+{
+}
+
+void CpuTransfer::PrepareForUpload(ID3D11Device* device, uint32_t width, uint32_t height)
+{
+	mStabilityTex.Reset();
+	mStabilitySRV.Reset();
+
+	mUploadWidth  = width;
+	mUploadHeight = height;
+
+	D3D11_TEXTURE2D_DESC stabilityTexDesc;
+	stabilityTexDesc.Width              = width;
+	stabilityTexDesc.Height             = height;
+	stabilityTexDesc.Format             = DXGI_FORMAT_R16_UINT;
+	stabilityTexDesc.Usage              = D3D11_USAGE_DEFAULT;
+	stabilityTexDesc.BindFlags          = D3D11_BIND_SHADER_RESOURCE;
+	stabilityTexDesc.CPUAccessFlags     = 0;
+	stabilityTexDesc.ArraySize          = 1;
+	stabilityTexDesc.MipLevels          = 1;
+	stabilityTexDesc.SampleDesc.Count   = 1;
+	stabilityTexDesc.SampleDesc.Quality = 0;
+	stabilityTexDesc.MiscFlags          = 0;
+
+	ThrowIfFailed(device->CreateTexture2D(&stabilityTexDesc, nullptr, mStabilityTex.GetAddressOf()));
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC stabilitySrvDesc;
+	stabilitySrvDesc.Format                    = DXGI_FORMAT_R16_UINT;
+	stabilitySrvDesc.ViewDimension             = D3D11_SRV_DIMENSION_TEXTURE2D;
+	stabilitySrvDesc.Texture2D.MipLevels       = 1;
+	stabilitySrvDesc.Texture2D.MostDetailedMip = 0;
+
+	ThrowIfFailed(device->CreateShaderResourceView(mStabilityTex.Get(), &stabilitySrvDesc, mStabilitySRV.GetAddressOf()));
+}
+
+void CpuTransfer::ReadbackCells(ID3D11Device* device, ID3D11DeviceContext* dc, ID3D11Texture2D* cellTex, std::vector<uint8_t>& outCells)
+{
+	outCells.clear();
+	if(!cellTex)
+	{
+		return;
+	}
+
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> stagingTex;
+	CreateStagingCopy(device, dc, cellTex, stagingTex.GetAddressOf());
+
+	D3D11_TEXTURE2D_DESC stagingTexDesc;
+	stagingTex->GetDesc(&stagingTexDesc);
+
+	D3D11_MAPPED_SUBRESOURCE mappedTex;
+	ThrowIfFailed(dc->Map(stagingTex.Get(), 0, D3D11_MAP_READ, 0, &mappedTex));
+
+	outCells.resize((size_t)stagingTexDesc.Width * stagingTexDesc.Height);
+	for(uint32_t y = 0; y < stagingTexDesc.Height; y++)
+	{
+		const uint8_t* rowData = reinterpret_cast<const uint8_t*>(mappedTex.pData) + (size_t)y * mappedTex.RowPitch;
+		std::copy(rowData, rowData + stagingTexDesc.Width, outCells.begin() + (size_t)y * stagingTexDesc.Width);
+	}
+
+	dc->Unmap(stagingTex.Get(), 0);
+}
+
+void CpuTransfer::ReadbackImage(ID3D11Device* device, ID3D11DeviceContext* dc, ID3D11Texture2D* imageTex, std::vector<uint8_t>& outImage)
+{
+	outImage.clear();
+	if(!imageTex)
+	{
+		return;
+	}
+
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> stagingTex;
+	CreateStagingCopy(device, dc, imageTex, stagingTex.GetAddressOf());
+
+	D3D11_TEXTURE2D_DESC stagingTexDesc;
+	stagingTex->GetDesc(&stagingTexDesc);
+
+	D3D11_MAPPED_SUBRESOURCE mappedTex;
+	ThrowIfFailed(dc->Map(stagingTex.Get(), 0, D3D11_MAP_READ, 0, &mappedTex));
+
+	outImage.resize((size_t)stagingTexDesc.Width * stagingTexDesc.Height);
+	for(uint32_t y = 0; y < stagingTexDesc.Height; y++)
+	{
+		const float* rowData = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(mappedTex.pData) + (size_t)y * mappedTex.RowPitch);
+		std::transform(rowData, rowData + stagingTexDesc.Width, outImage.begin() + (size_t)y * stagingTexDesc.Width, [](float val) {return (uint8_t)(val * 255.0f); });
+	}
+
+	dc->Unmap(stagingTex.Get(), 0);
+}
+
+void CpuTransfer::UploadStability(ID3D11DeviceContext* dc, const std::vector<uint16_t>& stabilityCells)
+{
+	if(stabilityCells.size() < (size_t)mUploadWidth * mUploadHeight)
+	{
+		return;
+	}
+
+	dc->UpdateSubresource(mStabilityTex.Get(), 0, nullptr, stabilityCells.data(), mUploadWidth * sizeof(uint16_t), 0);
+}
+
+ID3D11ShaderResourceView* CpuTransfer::GetStabilitySRV() const
+{
+	return mStabilitySRV.Get();
+}
+
+
+void CpuTransfer::CreateStagingCopy(ID3D11Device* device, ID3D11DeviceContext* dc, ID3D11Texture2D* tex, ID3D11Texture2D** outStagingTex)
+{
+	D3D11_TEXTURE2D_DESC stagingTexDesc;
+	tex->GetDesc(&stagingTexDesc);
+	stagingTexDesc.Usage          = D3D11_USAGE_STAGING;
+	stagingTexDesc.BindFlags      = 0;
+	stagingTexDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+	stagingTexDesc.MiscFlags      = 0;
+
+	ThrowIfFailed(device->CreateTexture2D(&stagingTexDesc, nullptr, outStagingTex));
+
+	dc->CopyResource(*outStagingTex, tex);
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <cstdint>
+#include <vector>
+
+/*
+The class for moving boards between the GPU and the CPU computing path.
+Input#1:             ID3D11Texture2D with R8_UINT cell values (initial board, restriction, click rule)
+Output#1:            Tightly packed cell values in the CPU memory
+Input#2:             Stability values computed on the CPU
+Output#2:            ID3D11ShaderResourceView with R16_UINT stability values (spawn values don't fit into 8 bits), suitable for FinalTransformer
+Input#3:             ID3D11Texture2D with R32_FLOAT values after FinalTransformer or Downscaler
+Output#3:            Tightly packed 8-bit grayscale image in the CPU memory
+Possible expansions: None ATM
+*/
+
+class CpuTransfer
+{
+public:
+	CpuTransfer();
+	~CpuTransfer();
+
+	void PrepareForUpload(ID3D11Device* device, uint32_t width, uint32_t height);
+
+	void ReadbackCells(ID3D11Device* device, ID3D11DeviceContext* dc, ID3D11Texture2D* cellTex, std::vector<uint8_t>& outCells); //Cells are tightly packed, the row pitch is the texture width
+	void ReadbackImage(ID3D11Device* device, ID3D11DeviceContext* dc, ID3D11Texture2D* imageTex, std::vector<uint8_t>& outImage); //Pixels are tightly packed, 1.0f is 255
+	void UploadStability(ID3D11DeviceContext* dc, const std::vector<uint16_t>& stabilityCells);                                  //Cells are tightly packed, the row pitch is the upload width
+
+	ID3D11ShaderResourceView* GetStabilitySRV() const;
+
+private:
+	void CreateStagingCopy(ID3D11Device* device, ID3D11DeviceContext* dc, ID3D11Texture2D* tex, ID3D11Texture2D** outStagingTex);
+
+private:
+	Microsoft::WRL::ComPtr<ID3D11Texture2D>          mStabilityTex;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> mStabilitySRV;
+
+	uint32_t mUploadWidth;
+	uint32_t mUploadHeight;
+};
@@ -0,0 +1,321 @@
+#include "D3D11ComputeBackend.hpp"
+#include "../Util.hpp"
+#include "EqualityChecker.hpp"
+#include "StabilityCalculator.hpp"
+#include "Downscaler.hpp"
+#include "FinalTransform.hpp"
+#include "ClickRules.hpp"
+#include "Boards.hpp"
+#include "BoardLoader.hpp"
+#include "CpuTransfer.hpp"
+#include "../App/Renderer.hpp"
+
+D3D11ComputeBackend::D3D11ComputeBackend(Renderer* renderer): mRenderer(renderer)
+{
+	ID3D11Device* device = mRenderer->GetDevice();
+
+	mStabilityCalculator = std::make_unique<StabilityCalculator>(device);
+
+	mDownscaler       = std::make_unique<Downscaler>(device);
+	mFinalTransformer = std::make_unique<FinalTransformer>(device);
+	mEqualityChecker  = std::make_unique<EqualityChecker>(device);
+
+	mBoards      = std::make_unique<Boards>(device);
+	mClickRules  = std::make_unique<ClickRules>(device);
+	mBoardLoader = std::make_unique<BoardLoader>(device);
+	mCpuTransfer = std::make_unique<CpuTransfer>();
+}
+
+D3D11ComputeBackend::~D3D11ComputeBackend()
+{
+}
+
+std::wstring D3D11ComputeBackend::GetDeviceName() const
+{
+	return mRenderer->GetAdapterName();
+}
+
+void D3D11ComputeBackend::InitBoard(uint32_t width, uint32_t height, BoardClearMode clearMode)
+{
+	switch(clearMode)
+	{
+	case BoardClearMode::FOUR_CORNERS:
+		mBoards->Init4CornersBoard(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), width, height);
+		break;
+	case BoardClearMode::FOUR_SIDES:
+		mBoards->Init4SidesBoard(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), width, height);
+		break;
+	case BoardClearMode::CENTER:
+		mBoards->InitCenterBoard(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), width, height);
+		break;
+	default:
+		break;
+	}
+}
+
+Utils::BoardLoadError D3D11ComputeBackend::LoadBoardFromFile(const std::wstring& boardFile)
+{
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> initialBoardTex;
+	Utils::BoardLoadError loadErr = mBoardLoader->LoadBoardFromFile(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), boardFile, initialBoardTex.GetAddressOf());
+
+	if(loadErr == Utils::BoardLoadError::LOAD_SUCCESS)
+	{
+		mBoards->InitBoardFromTexture(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), initialBoardTex.Get());
+	}
+
+	return loadErr;
+}
+
+void D3D11ComputeBackend::ChangeBoardSize(uint32_t newWidth, uint32_t newHeight)
+{
+	mBoards->ChangeBoardSize(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), newWidth, newHeight);
+}
+
+void D3D11ComputeBackend::InitDefaultRestriction()
+{
+	mBoards->InitDefaultRestriction(mRenderer->GetDevice(), mRenderer->GetDeviceContext());
+}
+
+Utils::BoardLoadError D3D11ComputeBackend::LoadRestrictionFromFile(const std::wstring& restrictionFile)
+{
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> restrictionTex;
+	Utils::BoardLoadError loadErr = mBoardLoader->LoadBoardFromFile(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), restrictionFile, restrictionTex.GetAddressOf());
+	
+	if(loadErr == Utils::BoardLoadError::LOAD_SUCCESS)
+	{
+		D3D11_TEXTURE2D_DESC restrictionTexDesc;
+		restrictionTex->GetDesc(&restrictionTexDesc);
+
+		if(restrictionTexDesc.Width != GetBoardWidth() || restrictionTexDesc.Height != GetBoardHeight()) //Restriction size is more restricted (Ha!), it should be the same size as board 
+		{
+			return Utils::BoardLoadError::ERROR_WRONG_SIZE;
+		}
+
+		mBoards->InitRestrictionFromTexture(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), restrictionTex.Get());
+	}
+
+	return loadErr;
+}
+
+uint32_t D3D11ComputeBackend::GetBoardWidth() const
+{
+	return mBoards->GetWidth();
+}
+
+uint32_t D3D11ComputeBackend::GetBoardHeight() const
+{
+	return mBoards->GetHeight();
+}
+
+bool D3D11ComputeBackend::HasRestriction() const
+{
+	return mBoards->GetRestrictionSRV() != nullptr;
+}
+
+void D3D11ComputeBackend::InitDefaultClickRule()
+{
+	mClickRules->InitDefault(mRenderer->GetDevice());
+	UpdateCurrentClickRule();
+}
+
+Utils::BoardLoadError D3D11ComputeBackend::LoadClickRuleFromFile(const std::wstring& clickRuleFile)
+{
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> clickRuleTex;
+	Utils::BoardLoadError loadErr = mBoardLoader->LoadClickRuleFromFile(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), clickRuleFile, clickRuleTex.GetAddressOf());
+
+	if(loadErr == Utils::BoardLoadError::LOAD_SUCCESS)
+	{
+		mClickRules->CreateFromTexture(mRenderer->GetDevice(), clickRuleTex.Get());
+		UpdateCurrentClickRule();
+	}
+
+	return loadErr;
+}
+
+void D3D11ComputeBackend::InitClickRuleFromCells(const uint8_t* cells, uint32_t width, uint32_t height)
+{
+	D3D11_TEXTURE2D_DESC clickRuleTexDesc;
+	clickRuleTexDesc.Usage              = D3D11_USAGE_DEFAULT;
+	clickRuleTexDesc.Width              = width;
+	clickRuleTexDesc.Height             = height;
+	clickRuleTexDesc.Format             = DXGI_FORMAT_R8_UINT;
+	clickRuleTexDesc.ArraySize          = 1;
+	clickRuleTexDesc.BindFlags          = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+	clickRuleTexDesc.CPUAccessFlags     = 0;
+	clickRuleTexDesc.MipLevels          = 1;
+	clickRuleTexDesc.SampleDesc.Count   = 1;
+	clickRuleTexDesc.SampleDesc.Quality = 0;
+	clickRuleTexDesc.MiscFlags          = 0;
+
+	D3D11_SUBRESOURCE_DATA clickRuleTexData;
+	clickRuleTexData.pSysMem          = cells;
+	clickRuleTexData.SysMemPitch      = width * sizeof(uint8_t);
+	clickRuleTexData.SysMemSlicePitch = width * height * sizeof(uint8_t);
+
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> clickRuleTex;
+	ThrowIfFailed(mRenderer->GetDevice()->CreateTexture2D(&clickRuleTexDesc, &clickRuleTexData, clickRuleTex.GetAddressOf()));
+
+	mClickRules->CreateFromTexture(mRenderer->GetDevice(), clickRuleTex.Get());
+	UpdateCurrentClickRule();
+}
+
+void D3D11ComputeBackend::EditClickRule(uint32_t x, uint32_t y)
+{
+	mClickRules->EditCellState(mRenderer->GetDeviceContext(), x, y);
+	UpdateCurrentClickRule();
+}
+
+uint32_t D3D11ComputeBackend::GetClickRuleWidth() const
+{
+	return mClickRules->GetWidth();
+}
+
+uint32_t D3D11ComputeBackend::GetClickRuleHeight() const
+{
+	return mClickRules->GetHeight();
+}
+
+bool D3D11ComputeBackend::IsDefaultClickRule() const
+{
+	return mClickRules->IsDefault();
+}
+
+void D3D11ComputeBackend::PrepareForCalculations(uint32_t videoFrameWidth, uint32_t videoFrameHeight)
+{
+	mClickRules->Bake(mRenderer->GetDeviceContext());
+	mStabilityCalculator->PrepareForCalculations(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), mBoards->GetInitialBoardTex());
+
+	uint32_t boardWidth  = mStabilityCalculator->GetBoardWidth();
+	uint32_t boardHeight = mStabilityCalculator->GetBoardHeight();
+
+	mDownscaler->PrepareForDownscaling(mRenderer->GetDevice(), videoFrameWidth, videoFrameHeight);
+	mFinalTransformer->PrepareForTransform(mRenderer->GetDevice(), boardWidth, boardHeight);
+	mEqualityChecker->PrepareForCalculations(mRenderer->GetDevice(), boardWidth, boardHeight);
+
+	UpdateCurrentClickRule();
+}
+
+void D3D11ComputeBackend::StabilityNextSteps(uint32_t stepCount, uint32_t spawnPeriod)
+{
+	ID3D11ShaderResourceView* clickRuleBufferSRV  = nullptr;
+	ID3D11ShaderResourceView* clickRuleCounterSRV = nullptr;
+	if(!mClickRules->IsDefault())
+	{
+		clickRuleBufferSRV  = mClickRules->GetClickRuleBufferSRV();
+		clickRuleCounterSRV = mClickRules->GetClickRuleBufferCounterSRV();
+	}
+
+	for(uint32_t i = 0; i < stepCount; i++)
+	{
+		mStabilityCalculator->StabilityNextStep(mRenderer->GetDeviceContext(), clickRuleBufferSRV, clickRuleCounterSRV, mBoards->GetRestrictionSRV(), spawnPeriod);
+	}
+}
+
+uint32_t D3D11ComputeBackend::GetCurrentStep() const
+{
+	return mStabilityCalculator->GetCurrentStep();
+}
+
+bool D3D11ComputeBackend::IsBoardInitial()
+{
+	return mEqualityChecker->CheckEquality(mRenderer->GetDeviceContext(), mStabilityCalculator->GetLastBoardState(), mBoards->GetInitialBoardSRV());
+}
+
+void D3D11ComputeBackend::PrepareForUpload(uint32_t width, uint32_t height)
+{
+	mFinalTransformer->PrepareForTransform(mRenderer->GetDevice(), width, height);
+	mCpuTransfer->PrepareForUpload(mRenderer->GetDevice(), width, height);
+}
+
+void D3D11ComputeBackend::UploadStability(const std::vector<uint16_t>& stabilityCells)
+{
+	mCpuTransfer->UploadStability(mRenderer->GetDeviceContext(), stabilityCells);
+}
+
+void D3D11ComputeBackend::UploadStability(std::vector<uint16_t>&& stabilityCells)
+{
+	mCpuTransfer->UploadStability(mRenderer->GetDeviceContext(), stabilityCells); //Copied to the texture either way
+}
+
+void D3D11ComputeBackend::InvalidateTransform()
+{
+	mRenderer->NeedRedraw(); //The preview asks for the new transform before drawing
+}
+
+void D3D11ComputeBackend::ComputeTransform(uint32_t spawnPeriod, bool useSmooth)
+{
+	mFinalTransformer->ComputeTransform(mRenderer->GetDeviceContext(), mStabilityCalculator->GetLastStabilityState(), spawnPeriod, useSmooth);
+	UpdateCurrentBoard();
+}
+
+void D3D11ComputeBackend::ComputeUploadedTransform(uint32_t spawnPeriod, bool useSmooth)
+{
+	mFinalTransformer->ComputeTransform(mRenderer->GetDeviceContext(), mCpuTransfer->GetStabilitySRV(), spawnPeriod, useSmooth);
+	UpdateCurrentBoard();
+}
+
+void D3D11ComputeBackend::DownscaleTransform()
+{
+	mDownscaler->DownscalePicture(mRenderer->GetDeviceContext(), mFinalTransformer->GetTransformedSRV());
+}
+
+void D3D11ComputeBackend::ReadbackInitialBoard(std::vector<uint8_t>& outCells)
+{
+	mCpuTransfer->ReadbackCells(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), mBoards->GetInitialBoardTex(), outCells);
+}
+
+void D3D11ComputeBackend::ReadbackClickRule(std::vector<uint8_t>& outCells)
+{
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> clickRuleTex;
+	mClickRules->GetClickRuleImageSRV()->GetResource(reinterpret_cast<ID3D11Resource**>(clickRuleTex.GetAddressOf()));
+
+	mCpuTransfer->ReadbackCells(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), clickRuleTex.Get(), outCells);
+}
+
+void D3D11ComputeBackend::ReadbackRestriction(std::vector<uint8_t>& outCells)
+{
+	outCells.clear();
+	if(!mBoards->GetRestrictionSRV())
+	{
+		return;
+	}
+
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> restrictionTex;
+	mBoards->GetRestrictionSRV()->GetResource(reinterpret_cast<ID3D11Resource**>(restrictionTex.GetAddressOf()));
+
+	mCpuTransfer->ReadbackCells(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), restrictionTex.Get(), outCells);
+}
+
+void D3D11ComputeBackend::ReadbackTransform(std::vector<uint8_t>& outImage, uint32_t& outWidth, uint32_t& outHeight)
+{
+	ReadbackTextureImage(mFinalTransformer->GetTransformedSRV(), outImage, outWidth, outHeight);
+}
+
+void D3D11ComputeBackend::ReadbackDownscaled(std::vector<uint8_t>& outImage, uint32_t& outWidth, uint32_t& outHeight)
+{
+	ReadbackTextureImage(mDownscaler->GetDownscaledSRV(), outImage, outWidth, outHeight);
+}
+
+void D3D11ComputeBackend::UpdateCurrentBoard()
+{
+	mRenderer->SetCurrentBoard(mFinalTransformer->GetTransformedSRV()); //Only points the preview to the new transform, the preview is drawn by the redraw InvalidateTransform() requested
+}
+
+void D3D11ComputeBackend::UpdateCurrentClickRule()
+{
+	mRenderer->SetCurrentClickRule(mClickRules->GetClickRuleImageSRV());
+	mRenderer->NeedRedrawClickRule();
+}
+
+void D3D11ComputeBackend::ReadbackTextureImage(ID3D11ShaderResourceView* srv, std::vector<uint8_t>& outImage, uint32_t& outWidth, uint32_t& outHeight)
+{
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> imageTex;
+	srv->GetResource(reinterpret_cast<ID3D11Resource**>(imageTex.GetAddressOf()));
+
+	D3D11_TEXTURE2D_DESC imageTexDesc;
+	imageTex->GetDesc(&imageTexDesc);
+
+	outWidth  = imageTexDesc.Width;
+	outHeight = imageTexDesc.Height;
+	mCpuTransfer->ReadbackImage(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), imageTex.Get(), outImage);
+}
\ No newline at end of file
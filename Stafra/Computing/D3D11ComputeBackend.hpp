@@ -0,0 +1,95 @@
+#pragma once
+
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <memory>
+#include "ComputeBackend.hpp"
+
+class Renderer;
+
+class StabilityCalculator;
+class EqualityChecker;
+class Downscaler;
+class FinalTransformer;
+
+class Boards;
+class ClickRules;
+class BoardLoader;
+class CpuTransfer;
+
+/*
+The class for computing the stability on the GPU with Direct3D 11.
+Input:               Renderer with the device, the boards, the click rule and the restriction
+Output:              Same as ComputeBackend. The transformed stability and the click rule are also shown by the renderer
+Possible expansions: None ATM
+*/
+
+class D3D11ComputeBackend: public ComputeBackend
+{
+public:
+	D3D11ComputeBackend(Renderer* renderer);
+	~D3D11ComputeBackend();
+
+	std::wstring GetDeviceName() const override;
+
+	void                  InitBoard(uint32_t width, uint32_t height, BoardClearMode clearMode) override;
+	Utils::BoardLoadError LoadBoardFromFile(const std::wstring& boardFile)                     override;
+	void                  ChangeBoardSize(uint32_t newWidth, uint32_t newHeight)               override;
+
+	void                  InitDefaultRestriction()                                     override;
+	Utils::BoardLoadError LoadRestrictionFromFile(const std::wstring& restrictionFile) override;
+
+	uint32_t GetBoardWidth()  const override;
+	uint32_t GetBoardHeight() const override;
+	bool     HasRestriction() const override;
+
+	void                  InitDefaultClickRule()                                                        override;
+	Utils::BoardLoadError LoadClickRuleFromFile(const std::wstring& clickRuleFile)                      override;
+	void                  InitClickRuleFromCells(const uint8_t* cells, uint32_t width, uint32_t height) override;
+	void                  EditClickRule(uint32_t x, uint32_t y)                                         override;
+
+	uint32_t GetClickRuleWidth()  const override;
+	uint32_t GetClickRuleHeight() const override;
+	bool     IsDefaultClickRule() const override;
+
+	void     PrepareForCalculations(uint32_t videoFrameWidth, uint32_t videoFrameHeight) override;
+	void     StabilityNextSteps(uint32_t stepCount, uint32_t spawnPeriod)                override;
+	uint32_t GetCurrentStep() const                                                      override;
+	bool     IsBoardInitial()                                                            override;
+
+	void PrepareForUpload(uint32_t width, uint32_t height)              override;
+	void UploadStability(const std::vector<uint16_t>& stabilityCells)   override;
+	void UploadStability(std::vector<uint16_t>&& stabilityCells)        override;
+	void InvalidateTransform()                                          override;
+	void ComputeTransform(uint32_t spawnPeriod, bool useSmooth)         override;
+	void ComputeUploadedTransform(uint32_t spawnPeriod, bool useSmooth) override;
+	void DownscaleTransform()                                           override;
+
+	void ReadbackInitialBoard(std::vector<uint8_t>& outCells) override;
+	void ReadbackClickRule(std::vector<uint8_t>& outCells)    override;
+	void ReadbackRestriction(std::vector<uint8_t>& outCells)  override;
+
+	void ReadbackTransform(std::vector<uint8_t>& outImage, uint32_t& outWidth, uint32_t& outHeight)  override;
+	void ReadbackDownscaled(std::vector<uint8_t>& outImage, uint32_t& outWidth, uint32_t& outHeight) override;
+
+private:
+	void UpdateCurrentBoard();     //Shows the last transform in the renderer
+	void UpdateCurrentClickRule(); //Shows the click rule in the renderer
+
+	void ReadbackTextureImage(ID3D11ShaderResourceView* srv, std::vector<uint8_t>& outImage, uint32_t& outWidth, uint32_t& outHeight);
+
+private:
+	Renderer* mRenderer; //Non-owning observer pointer
+
+	std::unique_ptr<StabilityCalculator> mStabilityCalculator;
+
+	std::unique_ptr<Downscaler>       mDownscaler;
+	std::unique_ptr<FinalTransformer> mFinalTransformer;
+	std::unique_ptr<EqualityChecker>  mEqualityChecker;
+
+	std::unique_ptr<ClickRules> mClickRules;
+	std::unique_ptr<Boards>     mBoards;
+
+	std::unique_ptr<BoardLoader> mBoardLoader;
+	std::unique_ptr<CpuTransfer> mCpuTransfer;
+};
\ No newline at end of file
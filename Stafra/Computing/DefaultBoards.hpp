@@ -4,6 +4,7 @@
 #include <DirectXMath.h>
 #include <wrl/client.h>
 #include <string>
+#include "ComputeBackend.hpp"
 
 /*
 The class for creating initial states.
@@ -12,13 +13,6 @@ Output:              ID3D11Texture2D with initial board and D3D11_BIND_SHADER_RE
 Possible expansions: More different initial state configurations (1 mClear*Shader shader, 1 enum entry and 1 private InitialState*() method for each one)
 */
 
-enum class BoardClearMode
-{
-	FOUR_CORNERS,
-	FOUR_SIDES,
-	CENTER
-};
-
 class DefaultBoards
 {
 	struct CBParamsStruct
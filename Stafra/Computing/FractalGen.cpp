@@ -1,38 +1,48 @@
 #include "FractalGen.hpp"
 #include "../Util.hpp"
 #include <iostream>
-#include <d3dcompiler.h>
 #include <vector>
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
-#include "EqualityChecker.hpp"
-#include "StabilityCalculator.hpp"
-#include "Downscaler.hpp"
-#include "FinalTransform.hpp"
-#include "ClickRules.hpp"
-#include "Boards.hpp"
-#include "BoardLoader.hpp"
+#include "ComputeBackend.hpp"
 #include "BoardSaver.hpp"
-#include "../App/Renderer.hpp"
-
-FractalGen::FractalGen(Renderer* renderer): mRenderer(renderer), mVideoFrameWidth(1), mVideoFrameHeight(1), mSpawnPeriod(0), mbUseSmoothTransform(false)
+#include "CpuEngineAdapters.hpp"
+#include "../CpuComputing/CpuStabilityCalculator.hpp"
+#include "../CpuComputing/CpuBatchCalculator.hpp"
+#include "../CpuComputing/CpuClickRuleSearch.hpp"
+#include "../CpuComputing/CpuRegionCalculator.hpp"
+#include "../CpuComputing/CpuOutOfCoreCalculator.hpp"
+#include "../CpuComputing/CpuSlabCalculator.hpp"
+#include "../CpuComputing/CpuSocketTransport.hpp"
+#include "../CpuComputing/CpuClickRule.hpp"
+#include "../CpuComputing/CpuChangeMap.hpp"
+#include "../CpuComputing/CpuPeriodSolver.hpp"
+
+namespace
 {
-	ID3D11Device*    device = mRenderer->GetDevice();
-	ID3D11DeviceContext* dc = mRenderer->GetDeviceContext();
+	const uint32_t gSolverFramesPerPeriod = 4; //The period solver gives up after this many default solution periods. The cross rule needs 2 of them
+}
 
-	mStabilityCalculator = std::make_unique<StabilityCalculator>(device);
+FractalGen::FractalGen(std::unique_ptr<ComputeBackend> computeBackend): mComputeBackend(std::move(computeBackend)), mVideoFrameWidth(1), mVideoFrameHeight(1), mSpawnPeriod(0), mTransformSource(TransformSource::BACKEND_STEPS), mTransformSpawnPeriod(0), mbUseSmoothTransform(false), mbUseCpuCompute(false), mbTransformOutdated(false)
+{
+	mCpuStabilityCalculator = std::make_unique<CpuStabilityCalculator>();
+	mCpuBatchCalculator     = std::make_unique<CpuBatchCalculator>();
+	mCpuClickRuleSearch     = std::make_unique<CpuClickRuleSearch>();
+	mCpuRegionCalculator    = std::make_unique<CpuRegionCalculator>();
+	mCpuOutOfCoreCalculator = std::make_unique<CpuOutOfCoreCalculator>();
+	mCpuSlabCalculator      = std::make_unique<CpuSlabCalculator>();
+	mCpuSlabTransport       = std::make_unique<CpuSocketTransport>();
 
-	mDownscaler       = std::make_unique<Downscaler>(device);
-	mFinalTransformer = std::make_unique<FinalTransformer>(device);
-	mEqualityChecker  = std::make_unique<EqualityChecker>(device);
+	mBoardSaver = std::make_unique<BoardSaver>();
 
-	mBoards        = std::make_unique<Boards>(device);
-	mClickRules    = std::make_unique<ClickRules>(device);
-	mBoardLoader   = std::make_unique<BoardLoader>(device);
-	mBoardSaver    = std::make_unique<BoardSaver>();
+	mCpuClickRule   = std::make_unique<CpuClickRule>();
+	mCpuRestriction = std::make_unique<BitBoard>();
+	mCpuChangeMap   = std::make_unique<CpuChangeMap>();
 
 	Init4CornersBoard(1023, 1023);
-	mBoards->InitDefaultRestriction(mRenderer->GetDevice(), mRenderer->GetDeviceContext());
+	mComputeBackend->InitDefaultRestriction();
 	InitDefaultClickRule();
 }
 
@@ -60,181 +70,681 @@ void FractalGen::SetUseSmooth(bool smooth)
 	mbUseSmoothTransform = smooth;
 }
 
+void FractalGen::SetUseCpuCompute(bool cpuCompute)
+{
+	mbUseCpuCompute = cpuCompute;
+}
+
+void FractalGen::SetCpuThreadCount(uint32_t threadCount)
+{
+	mCpuStabilityCalculator->SetThreadCount(threadCount);
+	mCpuBatchCalculator->SetThreadCount(threadCount);
+	mCpuClickRuleSearch->SetThreadCount(threadCount);
+	mCpuRegionCalculator->SetThreadCount(threadCount);
+	mCpuOutOfCoreCalculator->SetThreadCount(threadCount);
+	mCpuSlabCalculator->SetThreadCount(threadCount);
+}
+
+void FractalGen::SetCpuTileSize(uint32_t width, uint32_t height)
+{
+	mCpuStabilityCalculator->SetTileSize(width, height);
+}
+
+void FractalGen::SetTrackChangeMap(bool track)
+{
+	mCpuStabilityCalculator->SetTrackChangeMap(track);
+}
+
+void FractalGen::SetTrackStats(bool track)
+{
+	mCpuStabilityCalculator->SetTrackStats(track);
+}
+
+void FractalGen::SetUseHashLife(bool hashLife)
+{
+	mCpuStabilityCalculator->SetUseHashLife(hashLife);
+}
+
+void FractalGen::SetDetectCycles(bool detect)
+{
+	mCpuStabilityCalculator->SetTrackStateHashes(detect);
+}
+
 void FractalGen::ChangeSize(uint32_t newWidth, uint32_t newHeight)
 {
-	mBoards->ChangeBoardSize(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), newWidth, newHeight);
+	mComputeBackend->ChangeBoardSize(newWidth, newHeight);
 }
 
 void FractalGen::InitDefaultClickRule()
 {
-	mClickRules->InitDefault(mRenderer->GetDevice());
-	mRenderer->SetCurrentClickRule(mClickRules->GetClickRuleImageSRV());
-	mRenderer->NeedRedrawClickRule();
+	mComputeBackend->InitDefaultClickRule();
 }
 
 Utils::BoardLoadError FractalGen::LoadClickRuleFromFile(const std::wstring& clickRuleFile)
 {
-	Microsoft::WRL::ComPtr<ID3D11Texture2D> clickRuleTex;
-	Utils::BoardLoadError loadErr = mBoardLoader->LoadClickRuleFromFile(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), clickRuleFile, clickRuleTex.GetAddressOf());
+	return mComputeBackend->LoadClickRuleFromFile(clickRuleFile);
+}
 
-	if(loadErr == Utils::BoardLoadError::LOAD_SUCCESS)
+uint32_t FractalGen::GetLastFrameNumber() const
+{
+	if(IsCpuComputeActive())
 	{
-		mClickRules->CreateFromTexture(mRenderer->GetDevice(), clickRuleTex.Get());
-		mRenderer->SetCurrentClickRule(mClickRules->GetClickRuleImageSRV());
-		mRenderer->NeedRedrawClickRule();
+		return mCpuStabilityCalculator->GetCurrentStep();
 	}
 
-	return loadErr;
+	return mComputeBackend->GetCurrentStep();
 }
 
-uint32_t FractalGen::GetLastFrameNumber() const
+uint32_t FractalGen::GetDetectedPeriod() const
 {
-	return mStabilityCalculator->GetCurrentStep();
+	if(!IsCpuComputeActive())
+	{
+		return 0;
+	}
+
+	return mCpuStabilityCalculator->GetCycleDetector().GetPeriod();
+}
+
+bool FractalGen::ConfirmDetectedPeriod()
+{
+	uint32_t period = GetDetectedPeriod();
+	if(period == 0)
+	{
+		return false;
+	}
+
+	std::vector<uint64_t> periodStartState;
+	mCpuStabilityCalculator->CopyLastState(periodStartState);
+
+	TickSteps(period);
+
+	std::vector<uint64_t> periodEndState;
+	mCpuStabilityCalculator->CopyLastState(periodEndState);
+	if(periodEndState != periodStartState)
+	{
+		mCpuStabilityCalculator->RestartCycleDetection();
+		return false;
+	}
+
+	return true;
+}
+
+bool FractalGen::IsInitialBoardRepeated()
+{
+	if(IsCpuComputeActive())
+	{
+		return false;
+	}
+
+	return mComputeBackend->IsBoardInitial();
+}
+
+bool FractalGen::SaveChangeMap(const std::wstring& changeMapFile)
+{
+	if(!IsCpuComputeActive())
+	{
+		return false;
+	}
+
+	mCpuStabilityCalculator->CopyChangeMap(*mCpuChangeMap);
+
+	std::ofstream changeMapStream(std::filesystem::path(changeMapFile), std::ios::binary);
+	return changeMapStream && mCpuChangeMap->Write(changeMapStream);
+}
+
+bool FractalGen::SaveStats(const std::wstring& statsFile)
+{
+	if(!IsCpuComputeActive())
+	{
+		return false;
+	}
+
+	std::ofstream statsStream{std::filesystem::path(statsFile)};
+	return statsStream && mCpuStabilityCalculator->GetGenerationStats().WriteCsv(statsStream);
+}
+
+bool FractalGen::LoadChangeMap(const std::wstring& changeMapFile)
+{
+	std::ifstream changeMapStream(std::filesystem::path(changeMapFile), std::ios::binary);
+	if(!changeMapStream || !mCpuChangeMap->Read(changeMapStream))
+	{
+		return false;
+	}
+
+	if(mCpuChangeMap->GetWidth() != GetWidth() || mCpuChangeMap->GetHeight() != GetHeight())
+	{
+		ChangeSize(mCpuChangeMap->GetWidth(), mCpuChangeMap->GetHeight());
+	}
+
+	return true;
+}
+
+void FractalGen::RenderChangeMapFrame(uint32_t frame)
+{
+	//The upload is prepared for the size of the board, the map has to match it
+	if(!IsCpuComputeActive() || mCpuChangeMap->GetWidth() != mCpuStabilityCalculator->GetBoardWidth() || mCpuChangeMap->GetHeight() != mCpuStabilityCalculator->GetBoardHeight())
+	{
+		return;
+	}
+
+	mCpuStabilityCells.resize((size_t)mCpuChangeMap->GetWidth() * mCpuChangeMap->GetHeight());
+	mCpuStabilityCalculator->RenderChangeMap(*mCpuChangeMap, frame, mCpuStabilityCells.data(), mCpuChangeMap->GetWidth());
+	InvalidateTransform(TransformSource::CPU_CELLS, 0);
+}
+
+uint32_t FractalGen::GetChangeMapLastFrame() const
+{
+	return mCpuChangeMap->GetLastFrame();
+}
+
+void FractalGen::ClearBatch()
+{
+	mCpuBatchCalculator->PrepareForCalculations(0, 0);
+}
+
+bool FractalGen::AddCurrentBoardToBatch()
+{
+	if(!IsCpuComputeActive())
+	{
+		return false;
+	}
+
+	uint32_t boardWidth  = GetWidth();
+	uint32_t boardHeight = GetHeight();
+	if(mCpuBatchCalculator->GetBoardCount() == 0)
+	{
+		mCpuBatchCalculator->PrepareForCalculations(boardWidth, boardHeight);
+	}
+	else if(boardWidth != mCpuBatchCalculator->GetBoardWidth() || boardHeight != mCpuBatchCalculator->GetBoardHeight())
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> initialBoardCells;
+	ReadbackCpuParameters(initialBoardCells);
+
+	const BitBoard* restriction = GetCpuRestriction();
+	if(restriction && (restriction->GetWidth() != boardWidth || restriction->GetHeight() != boardHeight))
+	{
+		return false;
+	}
+
+	return mCpuBatchCalculator->AddBoard(initialBoardCells.data(), boardWidth) != CpuBatchCalculator::MaxBoards;
+}
+
+bool FractalGen::IsBatchFull() const
+{
+	return mCpuBatchCalculator->GetBoardCount() == CpuBatchCalculator::MaxBoards;
+}
+
+uint32_t FractalGen::GetBatchSize() const
+{
+	return mCpuBatchCalculator->GetBoardCount();
+}
+
+void FractalGen::TickBatchSteps(uint32_t stepCount)
+{
+	mCpuBatchCalculator->StabilityNextSteps(stepCount, GetCpuClickRule(), GetCpuRestriction(), mSpawnPeriod);
+}
+
+void FractalGen::SaveBatchStability(uint32_t boardIndex, const std::wstring& stabilityFile)
+{
+	//The transform and the upload have to be prepared for the batch board size, ResetComputingParameters() does that
+	CpuEngineAdapters::CopyBatchStability(*mCpuBatchCalculator, boardIndex, mCpuStabilityCells);
+	InvalidateTransform(TransformSource::CPU_CELLS, mSpawnPeriod);
+
+	SaveCurrentStep(stabilityFile);
+}
+
+uint32_t FractalGen::SearchClickRules(const CpuClickRuleSearchParams& params)
+{
+	return mCpuClickRuleSearch->Search(params);
+}
+
+uint32_t FractalGen::GetFoundClickRuleCount() const
+{
+	return (uint32_t)mCpuClickRuleSearch->GetResults().size();
+}
+
+const CpuClickRuleSearchResult& FractalGen::GetFoundClickRule(uint32_t index) const
+{
+	return mCpuClickRuleSearch->GetResults()[index];
+}
+
+void FractalGen::UseFoundClickRule(uint32_t index)
+{
+	const std::vector<uint8_t>& clickRuleCells = mCpuClickRuleSearch->GetResults()[index].Cells;
+	mComputeBackend->InitClickRuleFromCells(clickRuleCells.data(), CpuClickRuleSearch::ClickRuleSize, CpuClickRuleSearch::ClickRuleSize);
+}
+
+bool FractalGen::PrepareRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t finalFrame)
+{
+	std::vector<uint8_t> initialBoardCells;
+	ReadbackCpuParameters(initialBoardCells);
+
+	CpuRegion region = {x, y, width, height};
+	if(!mCpuRegionCalculator->PrepareForCalculations(initialBoardCells.data(), GetWidth(), GetHeight(), GetWidth(), region, finalFrame, GetCpuClickRule(), GetCpuRestriction()))
+	{
+		return false;
+	}
+
+	//Everything after the computation only sees the region, as if it was the whole board
+	uint32_t regionWidth  = 0;
+	uint32_t regionHeight = 0;
+	CpuEngineAdapters::GetRegionImageSize(*mCpuRegionCalculator, regionWidth, regionHeight);
+	mComputeBackend->PrepareForUpload(regionWidth, regionHeight);
+	return true;
+}
+
+void FractalGen::TickRegionSteps(uint32_t stepCount)
+{
+	mCpuRegionCalculator->StabilityNextSteps(stepCount, GetCpuClickRule(), mSpawnPeriod);
+}
+
+uint32_t FractalGen::GetRegionFrameNumber() const
+{
+	return mCpuRegionCalculator->GetCurrentStep();
+}
+
+uint64_t FractalGen::GetRegionComputedCellCount() const
+{
+	return mCpuRegionCalculator->GetComputedCellCount();
+}
+
+void FractalGen::SaveRegionStability(const std::wstring& stabilityFile)
+{
+	CpuEngineAdapters::CopyRegionStability(*mCpuRegionCalculator, mCpuStabilityCells);
+	InvalidateTransform(TransformSource::CPU_CELLS, mSpawnPeriod);
+
+	SaveCurrentStep(stabilityFile);
+}
+
+bool FractalGen::PrepareOutOfCore(const std::wstring& folder, uint32_t width, uint32_t height, BoardClearMode clearMode, uint64_t memoryBudget)
+{
+	std::vector<uint8_t> initialBoardCells;
+	ReadbackCpuParameters(initialBoardCells);
+
+	std::vector<CpuCellPosition> litCells = CpuEngineAdapters::GetClearModeLitCells(clearMode, width, height);
+	if(!mCpuOutOfCoreCalculator->PrepareForCalculations(folder, width, height, litCells, GetCpuClickRule(), memoryBudget))
+	{
+		return false;
+	}
+
+	uint32_t previewWidth  = 0;
+	uint32_t previewHeight = 0;
+	CpuEngineAdapters::GetOutOfCoreImageSize(*mCpuOutOfCoreCalculator, previewWidth, previewHeight);
+	mComputeBackend->PrepareForUpload(previewWidth, previewHeight);
+	return true;
+}
+
+bool FractalGen::TickOutOfCoreSteps(uint32_t stepCount)
+{
+	return mCpuOutOfCoreCalculator->StabilityNextSteps(stepCount, GetCpuClickRule());
+}
+
+uint32_t FractalGen::GetOutOfCoreFrameNumber() const
+{
+	return mCpuOutOfCoreCalculator->GetCurrentStep();
+}
+
+uint32_t FractalGen::GetOutOfCoreStepsPerPass() const
+{
+	return mCpuOutOfCoreCalculator->GetStepsPerPass();
+}
+
+std::wstring FractalGen::GetOutOfCoreStabilityFile() const
+{
+	return mCpuOutOfCoreCalculator->GetStabilityFile();
+}
+
+bool FractalGen::SaveOutOfCorePreview(const std::wstring& stabilityFile)
+{
+	if(!CpuEngineAdapters::CopyOutOfCoreStability(*mCpuOutOfCoreCalculator, mCpuStabilityCells))
+	{
+		return false;
+	}
+
+	InvalidateTransform(TransformSource::CPU_CELLS, 0);
+
+	SaveCurrentStep(stabilityFile);
+	return true;
+}
+
+bool FractalGen::PrepareSlab(uint32_t slabIndex, uint32_t slabCount, const std::vector<std::string>& slabAddresses)
+{
+	std::vector<uint8_t> initialBoardCells;
+	ReadbackCpuParameters(initialBoardCells);
+
+	if(!mCpuSlabCalculator->PrepareForCalculations(initialBoardCells.data(), GetWidth(), GetHeight(), GetWidth(), slabIndex, slabCount, GetCpuClickRule()))
+	{
+		return false;
+	}
+
+	if(!mCpuSlabTransport->Connect(slabIndex, slabAddresses))
+	{
+		return false;
+	}
+
+	//Everything after the computation only sees the slab, as if it was the whole board
+	uint32_t slabWidth  = 0;
+	uint32_t slabHeight = 0;
+	CpuEngineAdapters::GetSlabImageSize(*mCpuSlabCalculator, slabWidth, slabHeight);
+	mComputeBackend->PrepareForUpload(slabWidth, slabHeight);
+	return true;
+}
+
+bool FractalGen::TickSlabSteps(uint32_t stepCount)
+{
+	return mCpuSlabCalculator->StabilityNextSteps(stepCount, GetCpuClickRule(), mCpuSlabTransport.get());
+}
+
+uint32_t FractalGen::GetSlabFrameNumber() const
+{
+	return mCpuSlabCalculator->GetCurrentStep();
+}
+
+uint32_t FractalGen::GetSlabRowBegin() const
+{
+	return mCpuSlabCalculator->GetRowBegin();
+}
+
+uint32_t FractalGen::GetSlabRowCount() const
+{
+	return mCpuSlabCalculator->GetRowCount();
+}
+
+uint64_t FractalGen::GetSlabExchangedBytes() const
+{
+	return mCpuSlabCalculator->GetExchangedBytes();
+}
+
+void FractalGen::SaveSlabStability(const std::wstring& stabilityFile)
+{
+	CpuEngineAdapters::CopySlabStability(*mCpuSlabCalculator, mCpuStabilityCells);
+	InvalidateTransform(TransformSource::CPU_CELLS, 0);
+
+	SaveCurrentStep(stabilityFile);
+}
+
+uint32_t FractalGen::ComputeSolutionPeriod(const std::wstring& cacheFile)
+{
+	//The spawn stability keeps changing with its own period after the board settles
+	if(mSpawnPeriod != 0)
+	{
+		return GetDefaultSolutionPeriod(GetWidth());
+	}
+
+	std::vector<uint8_t> initialBoardCells;
+	ReadbackCpuParameters(initialBoardCells);
+
+	BitBoard initialBoard(GetWidth(), GetHeight());
+	initialBoard.FromCells(initialBoardCells.data(), GetWidth());
+
+	uint64_t periodKey = CpuPeriodSolver::ComputeKey(initialBoard, GetCpuClickRule(), GetCpuRestriction());
+
+	CpuSolutionPeriodCache periodCache;
+	if(!cacheFile.empty())
+	{
+		std::ifstream cacheInStream{std::filesystem::path(cacheFile)};
+		if(cacheInStream)
+		{
+			periodCache.Read(cacheInStream);
+		}
+	}
+
+	CpuSolutionPeriod solutionPeriod;
+	if(periodCache.Find(periodKey, solutionPeriod))
+	{
+		return solutionPeriod.GetFinalFrame();
+	}
+
+	CpuPeriodSolver periodSolver;
+	periodSolver.SetThreadCount(mCpuStabilityCalculator->GetThreadCount());
+	periodSolver.SetMaxFrames(GetDefaultSolutionPeriod(GetWidth()) * gSolverFramesPerPeriod); //Never much longer than computing the default solution period itself
+	if(!periodSolver.Solve(initialBoard, GetCpuClickRule(), GetCpuRestriction(), solutionPeriod))
+	{
+		return GetDefaultSolutionPeriod(GetWidth());
+	}
+
+	if(!cacheFile.empty())
+	{
+		periodCache.Add(periodKey, solutionPeriod);
+
+		std::ofstream cacheOutStream{std::filesystem::path(cacheFile)};
+		periodCache.Write(cacheOutStream);
+	}
+
+	return solutionPeriod.GetFinalFrame();
 }
 
 uint32_t FractalGen::GetDefaultSolutionPeriod(uint32_t boardSize) const
 {
-	return mStabilityCalculator->GetDefaultSolutionPeriod(boardSize);
+	//For any normal Lights Out game of size (2^n - 1) x (2^n - 1), the solution period is 2^(n - 1).  
+	//For example, for the normal 127 x 127 Lights Out the period is 64, for the normal 255 x 255 Lights Out the period is 128 and so on.
+	//However, for the custom click rules, spawn stability and many other things this formula doesn't work anymore. 
+	//But since we need the default solution period anyway, part of it stays. To control the larger periods, I added enlonging multiplier.
+	return ((boardSize + 1) / 2);
+}
+
+std::wstring FractalGen::GetCpuInstructionSetName() const
+{
+	std::string instructionSetName = CpuFeatures::InstructionSetName(mCpuStabilityCalculator->GetInstructionSet());
+	return std::wstring(instructionSetName.begin(), instructionSetName.end());
+}
+
+std::wstring FractalGen::GetComputeDeviceName() const
+{
+	return mComputeBackend->GetDeviceName();
 }
 
 uint32_t FractalGen::GetWidth() const
 {
-	return mBoards->GetWidth();
+	return mComputeBackend->GetBoardWidth();
 }
 
 uint32_t FractalGen::GetHeight() const
 {
-	return mBoards->GetHeight();
+	return mComputeBackend->GetBoardHeight();
 }
 
 void FractalGen::EditClickRule(float normalizedX, float normalizedY)
 {
-	uint32_t clickRuleWidth  = mClickRules->GetWidth();
-	uint32_t clickRuleHeight = mClickRules->GetHeight();
+	uint32_t clickRuleWidth  = mComputeBackend->GetClickRuleWidth();
+	uint32_t clickRuleHeight = mComputeBackend->GetClickRuleHeight();
 
-	mClickRules->EditCellState(mRenderer->GetDeviceContext(), (uint32_t)(clickRuleWidth * normalizedX), (uint32_t)(clickRuleHeight * normalizedY));
-	mRenderer->SetCurrentClickRule(mClickRules->GetClickRuleImageSRV());
-	mRenderer->NeedRedrawClickRule();
+	mComputeBackend->EditClickRule((uint32_t)(clickRuleWidth * normalizedX), (uint32_t)(clickRuleHeight * normalizedY));
 }
 
 void FractalGen::Init4CornersBoard(uint32_t width, uint32_t height)
 {
-	mBoards->Init4CornersBoard(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), width, height);
+	mComputeBackend->InitBoard(width, height, BoardClearMode::FOUR_CORNERS);
 }
 
 void FractalGen::Init4SidesBoard(uint32_t width, uint32_t height)
 {
-	mBoards->Init4SidesBoard(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), width, height);
+	mComputeBackend->InitBoard(width, height, BoardClearMode::FOUR_SIDES);
 }
 
 void FractalGen::InitCenterBoard(uint32_t width, uint32_t height)
 {
-	mBoards->InitCenterBoard(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), width, height);
+	mComputeBackend->InitBoard(width, height, BoardClearMode::CENTER);
 }
 
 Utils::BoardLoadError FractalGen::LoadBoardFromFile(const std::wstring& boardFile)
 {
-	Microsoft::WRL::ComPtr<ID3D11Texture2D> initialBoardTex;
-	Utils::BoardLoadError loadErr = mBoardLoader->LoadBoardFromFile(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), boardFile, initialBoardTex.GetAddressOf());
-
-	if(loadErr == Utils::BoardLoadError::LOAD_SUCCESS)
-	{
-		mBoards->InitBoardFromTexture(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), initialBoardTex.Get());
-	}
-
-	return loadErr;
+	return mComputeBackend->LoadBoardFromFile(boardFile);
 }
 
 void FractalGen::InitDefaultRestriction()
 {
-	mBoards->InitDefaultRestriction(mRenderer->GetDevice(), mRenderer->GetDeviceContext());
+	mComputeBackend->InitDefaultRestriction();
 }
 
 Utils::BoardLoadError FractalGen::LoadRestrictionFromFile(const std::wstring& restrictionFile)
 {
-	Microsoft::WRL::ComPtr<ID3D11Texture2D> restrictionTex;
-	Utils::BoardLoadError loadErr = mBoardLoader->LoadBoardFromFile(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), restrictionFile, restrictionTex.GetAddressOf());
-	
-	if(loadErr == Utils::BoardLoadError::LOAD_SUCCESS)
+	return mComputeBackend->LoadRestrictionFromFile(restrictionFile);
+}
+
+bool FractalGen::HasRestriction() const
+{
+	return mComputeBackend->HasRestriction();
+}
+
+void FractalGen::ResetComputingParameters()
+{
+	mComputeBackend->PrepareForCalculations(mVideoFrameWidth, mVideoFrameHeight);
+
+	if(mbUseCpuCompute)
 	{
-		D3D11_TEXTURE2D_DESC restrictionTexDesc;
-		restrictionTex->GetDesc(&restrictionTexDesc);
+		uint32_t boardWidth  = GetWidth();
+		uint32_t boardHeight = GetHeight();
 
-		if(restrictionTexDesc.Width != GetWidth() || restrictionTexDesc.Height != GetHeight()) //Restriction size is more restricted (Ha!), it should be the same size as board 
-		{
-			return Utils::BoardLoadError::ERROR_WRONG_SIZE;
-		}
+		std::vector<uint8_t> initialBoardCells;
+		ReadbackCpuParameters(initialBoardCells);
+
+		mCpuStabilityCalculator->PrepareForCalculations(initialBoardCells.data(), boardWidth, boardHeight, boardWidth);
+		mComputeBackend->PrepareForUpload(boardWidth, boardHeight);
 
-		mBoards->InitRestrictionFromTexture(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), restrictionTex.Get());
+		mCpuStabilityCalculator->ReduceBySymmetry(GetCpuClickRule(), GetCpuRestriction());
+		mCpuStabilityCells.resize((size_t)boardWidth * boardHeight);
 	}
 
-	return loadErr;
+	InvalidateTransform(IsCpuComputeActive() ? TransformSource::CPU_STEPS : TransformSource::BACKEND_STEPS, mSpawnPeriod);
 }
 
-void FractalGen::ResetComputingParameters()
+void FractalGen::Tick()
 {
-	mClickRules->Bake(mRenderer->GetDeviceContext());
-	mStabilityCalculator->PrepareForCalculations(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), mBoards->GetInitialBoardTex());
-
-	uint32_t boardWidth  = mStabilityCalculator->GetBoardWidth();
-	uint32_t boardHeight = mStabilityCalculator->GetBoardHeight();
-
-	uint32_t clickRuleWidth  = mClickRules->GetWidth();
-	uint32_t clickRuleHeight = mClickRules->GetHeight();
+	TickSteps(1);
+}
 
-	mDownscaler->PrepareForDownscaling(mRenderer->GetDevice(), mVideoFrameWidth, mVideoFrameHeight);
-	mFinalTransformer->PrepareForTransform(mRenderer->GetDevice(), boardWidth, boardHeight);
-	mEqualityChecker->PrepareForCalculations(mRenderer->GetDevice(), boardWidth, boardHeight);
+void FractalGen::TickSteps(uint32_t stepCount)
+{
+	if(IsCpuComputeActive())
+	{
+		mCpuStabilityCalculator->StabilityNextSteps(stepCount, GetCpuClickRule(), GetCpuRestriction(), mSpawnPeriod);
+		InvalidateTransform(TransformSource::CPU_STEPS, mSpawnPeriod);
+	}
+	else
+	{
+		mComputeBackend->StabilityNextSteps(stepCount, mSpawnPeriod);
+		InvalidateTransform(TransformSource::BACKEND_STEPS, mSpawnPeriod);
+	}
+}
 
-	mBoardSaver->PrepareStagingTextures(mRenderer->GetDevice(), boardWidth, boardHeight, mVideoFrameWidth, mVideoFrameHeight, clickRuleWidth, clickRuleHeight);
+void FractalGen::UpdateTransform()
+{
+	if(!mbTransformOutdated)
+	{
+		return;
+	}
 
-	mRenderer->SetCurrentClickRule(mClickRules->GetClickRuleImageSRV());
-	mRenderer->NeedRedrawClickRule();
+	switch(mTransformSource)
+	{
+	case TransformSource::BACKEND_STEPS:
+		mComputeBackend->ComputeTransform(mTransformSpawnPeriod, mbUseSmoothTransform);
+		break;
+	case TransformSource::CPU_STEPS:
+		mCpuStabilityCells.resize((size_t)mCpuStabilityCalculator->GetBoardWidth() * mCpuStabilityCalculator->GetBoardHeight()); //The backend hands the storage back, but the board size may have changed since
+		mCpuStabilityCalculator->CopyStabilityCells(mCpuStabilityCells.data(), mCpuStabilityCalculator->GetBoardWidth());
+		mComputeBackend->UploadStability(std::move(mCpuStabilityCells));
+		mComputeBackend->ComputeUploadedTransform(mTransformSpawnPeriod, mbUseSmoothTransform);
+		break;
+	case TransformSource::CPU_CELLS:
+		mComputeBackend->UploadStability(mCpuStabilityCells);
+		mComputeBackend->ComputeUploadedTransform(mTransformSpawnPeriod, mbUseSmoothTransform);
+		break;
+	default:
+		break;
+	}
 
-	mFinalTransformer->ComputeTransform(mRenderer->GetDeviceContext(), mStabilityCalculator->GetLastStabilityState(), mSpawnPeriod, mbUseSmoothTransform);
-	mRenderer->SetCurrentBoard(mFinalTransformer->GetTransformedSRV());
-	mRenderer->NeedRedraw();
+	mbTransformOutdated = false;
 }
 
-void FractalGen::Tick()
+bool FractalGen::JumpToFrame(uint32_t frame)
 {
-	ID3D11ShaderResourceView* clickRuleBufferSRV  = nullptr;
-	ID3D11ShaderResourceView* clickRuleCounterSRV = nullptr;
-	if(!mClickRules->IsDefault())
+	if(!IsCpuComputeActive())
 	{
-		clickRuleBufferSRV  = mClickRules->GetClickRuleBufferSRV();
-		clickRuleCounterSRV = mClickRules->GetClickRuleBufferCounterSRV();
+		return false;
 	}
 
-	mStabilityCalculator->StabilityNextStep(mRenderer->GetDeviceContext(), clickRuleBufferSRV, clickRuleCounterSRV, mBoards->GetRestrictionSRV(), mSpawnPeriod);
-	mFinalTransformer->ComputeTransform(mRenderer->GetDeviceContext(), mStabilityCalculator->GetLastStabilityState(), mSpawnPeriod, mbUseSmoothTransform);
+	mCpuStabilityCalculator->JumpToStep(frame, GetCpuClickRule(), GetCpuRestriction());
 
-	mRenderer->SetCurrentBoard(mFinalTransformer->GetTransformedSRV());
-	mRenderer->NeedRedraw();
+	InvalidateTransform(TransformSource::CPU_STEPS, mSpawnPeriod);
+	return true;
 }
 
 void FractalGen::SaveCurrentVideoFrame(const std::wstring& videoFrameFile)
 {
-	mDownscaler->DownscalePicture(mRenderer->GetDeviceContext(), mFinalTransformer->GetTransformedSRV());
+	UpdateTransform();
+	mComputeBackend->DownscaleTransform();
 
-	Microsoft::WRL::ComPtr<ID3D11Texture2D> downscaledTex;
-	mDownscaler->GetDownscaledSRV()->GetResource(reinterpret_cast<ID3D11Resource**>(downscaledTex.GetAddressOf()));
+	std::vector<uint8_t> videoFrameImage;
+	uint32_t videoFrameWidth  = 0;
+	uint32_t videoFrameHeight = 0;
+	mComputeBackend->ReadbackDownscaled(videoFrameImage, videoFrameWidth, videoFrameHeight);
 
-	mBoardSaver->SaveVideoFrameToFile(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), downscaledTex.Get(), videoFrameFile);
+	mBoardSaver->SaveBoardToFile(videoFrameImage, videoFrameWidth, videoFrameHeight, videoFrameFile);
 }
 
 void FractalGen::SaveCurrentStep(const std::wstring& stabilityFile)
 {
-	Microsoft::WRL::ComPtr<ID3D11Texture2D> stabilityTex;
-	mFinalTransformer->GetTransformedSRV()->GetResource(reinterpret_cast<ID3D11Resource**>(stabilityTex.GetAddressOf()));
+	UpdateTransform();
+
+	std::vector<uint8_t> stabilityImage;
+	uint32_t stabilityWidth  = 0;
+	uint32_t stabilityHeight = 0;
+	mComputeBackend->ReadbackTransform(stabilityImage, stabilityWidth, stabilityHeight);
 
-	mBoardSaver->SaveBoardToFile(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), stabilityTex.Get(), stabilityFile);
+	mBoardSaver->SaveBoardToFile(stabilityImage, stabilityWidth, stabilityHeight, stabilityFile);
 }
 
 void FractalGen::SaveClickRule(const std::wstring& clickRuleFile)
 {
-	Microsoft::WRL::ComPtr<ID3D11Texture2D> clickRuleTex;
-	mClickRules->GetClickRuleImageSRV()->GetResource(reinterpret_cast<ID3D11Resource**>(clickRuleTex.GetAddressOf()));
+	std::vector<uint8_t> clickRuleCells;
+	mComputeBackend->ReadbackClickRule(clickRuleCells);
 
-	mBoardSaver->SaveClickRuleToFile(mRenderer->GetDevice(), mRenderer->GetDeviceContext(), clickRuleTex.Get(), clickRuleFile);
+	mBoardSaver->SaveClickRuleToFile(clickRuleCells, mComputeBackend->GetClickRuleWidth(), mComputeBackend->GetClickRuleHeight(), clickRuleFile);
+}
+
+bool FractalGen::IsCpuComputeActive() const
+{
+	return mbUseCpuCompute;
+}
+
+void FractalGen::ReadbackCpuParameters(std::vector<uint8_t>& outInitialBoardCells)
+{
+	mComputeBackend->ReadbackInitialBoard(outInitialBoardCells);
+
+	std::vector<uint8_t> clickRuleCells;
+	mComputeBackend->ReadbackClickRule(clickRuleCells);
+	mCpuClickRule->InitFromCells(clickRuleCells.data(), mComputeBackend->GetClickRuleWidth(), mComputeBackend->GetClickRuleHeight(), mComputeBackend->GetClickRuleWidth());
+
+	mCpuRestriction->Resize(0, 0);
+	if(mComputeBackend->HasRestriction())
+	{
+		std::vector<uint8_t> restrictionCells;
+		mComputeBackend->ReadbackRestriction(restrictionCells);
+
+		mCpuRestriction->Resize(GetWidth(), GetHeight());
+		mCpuRestriction->FromCells(restrictionCells.data(), GetWidth());
+	}
+}
+
+void FractalGen::InvalidateTransform(TransformSource source, uint32_t spawnPeriod)
+{
+	mTransformSource      = source;
+	mTransformSpawnPeriod = spawnPeriod;
+	mbTransformOutdated   = true;
+
+	mComputeBackend->InvalidateTransform();
+}
+
+const CpuClickRule* FractalGen::GetCpuClickRule() const
+{
+	return mComputeBackend->IsDefaultClickRule() ? nullptr : mCpuClickRule.get();
+}
+
+const BitBoard* FractalGen::GetCpuRestriction() const
+{
+	return mComputeBackend->HasRestriction() ? mCpuRestriction.get() : nullptr;
 }
@@ -2,32 +2,43 @@
 
 //http://lightstrout.com/index.php/2019/05/31/stability-fractal/
 
-#include <d3d11.h>
-
-#include <Windows.h>
-#include <wrl/client.h>
 #include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
-#include "..\Util.hpp"
+#include "../Util.hpp"
 
-class Renderer;
+class ComputeBackend;
 
-class StabilityCalculator;
-class EqualityChecker;
-class Downscaler;
-class FinalTransformer;
+class CpuStabilityCalculator;
+class CpuBatchCalculator;
+class CpuClickRuleSearch;
+class CpuRegionCalculator;
+class CpuOutOfCoreCalculator;
+class CpuSlabCalculator;
+class CpuSocketTransport;
 
-class Boards;
-class ClickRules;
-class BoardLoader;
 class BoardSaver;
+class CpuClickRule;
+class CpuChangeMap;
+class BitBoard;
+
+struct CpuClickRuleSearchParams;
+struct CpuClickRuleSearchResult;
+
+enum class BoardClearMode;
+
+enum class TransformSource
+{
+	BACKEND_STEPS, //The stability computed by the compute backend
+	CPU_STEPS,     //The stability computed by the CPU calculator, not copied out of it yet
+	CPU_CELLS      //The stability copied to the CPU cells
+};
 
 class FractalGen
 {
 public:
-	FractalGen(Renderer* renderer);
+	FractalGen(std::unique_ptr<ComputeBackend> computeBackend);
 	~FractalGen();
 
 	void SetVideoFrameWidth(uint32_t width);   //Sets the width of downscaled video frames
@@ -35,6 +46,13 @@ public:
 
 	void SetSpawnPeriod(uint32_t spawn);
 	void SetUseSmooth(bool smooth);
+	void SetUseCpuCompute(bool cpuCompute); //Computes the steps on the CPU with 1 bit per cell instead of the GPU
+	void SetCpuThreadCount(uint32_t threadCount);         //The number of threads for CPU computations, 0 means one per hardware thread
+	void SetCpuTileSize(uint32_t width, uint32_t height); //The size of the board part a single CPU thread computes at once
+	void SetTrackChangeMap(bool track);                   //Records the frame each cell first became unstable at, CPU compute without spawn only
+	void SetTrackStats(bool track);                       //Counts the stable, changed and lit cells of every computed frame, CPU compute only
+	void SetUseHashLife(bool hashLife);                   //Computes long runs of steps with memoized quadtrees while it pays off, CPU compute without spawn only
+	void SetDetectCycles(bool detect);                    //Hashes the board and the stability of every frame to find the first repeated state, CPU compute only
 
 	void ChangeSize(uint32_t newWidth, uint32_t newHeight); //Change the board size while keeping the initial state centered
 
@@ -49,39 +67,106 @@ public:
 
 	void                  InitDefaultRestriction();                                     //Changes the restriction to the default one (non-restricted)
 	Utils::BoardLoadError LoadRestrictionFromFile(const std::wstring& restrictionFile); //Loads a restriction from file
+	bool                  HasRestriction() const;                                       //False if the restriction is the default one
 
 	void ResetComputingParameters(); //Prepares all data for the simulation
-	void Tick();                     //A single step of the simulation
+	void Tick();                                //A single step of the simulation
+	void TickSteps(uint32_t stepCount);         //Several steps of the simulation, the final transform is only marked outdated
+	void UpdateTransform();                     //Computes the final transform of the last step if it's outdated. The preview calls it before drawing, the saves call it themselves
+	bool JumpToFrame(uint32_t frame);           //CPU compute only. Computes the board at the frame without the frames in between when possible, the stability restarts from there
 
 	void SaveCurrentVideoFrame(const std::wstring& videoFrameFile); //Saves small image optimized for a video frame
 	void SaveCurrentStep(const std::wstring& stabilityFile);        //Saves full image, without downscaling
 	void SaveClickRule(const std::wstring& clickRuleFile);          //Saves click rule
 
+	bool     SaveChangeMap(const std::wstring& changeMapFile); //Saves the frames each cell first became unstable at, up to the current one
+	bool     SaveStats(const std::wstring& statsFile);         //Saves the counts of every computed frame as CSV
+	bool     LoadChangeMap(const std::wstring& changeMapFile); //Loads the change map for rendering, changes the board size to the size of the map
+	void     RenderChangeMapFrame(uint32_t frame);             //CPU compute only. Shows the stability of the frame computed from the loaded change map, without simulating anything
+	uint32_t GetChangeMapLastFrame() const;                    //The last frame the loaded change map was recorded up to
+
+	void     ClearBatch();                                                               //Removes all boards from the batch
+	bool     AddCurrentBoardToBatch();                                                   //CPU compute only. Adds the current initial board to the batch, false if it's full or the board size differs from the first board
+	bool     IsBatchFull()  const;
+	uint32_t GetBatchSize() const;
+	void     TickBatchSteps(uint32_t stepCount);                                         //Several steps of every board of the batch at once, with the same click rule, restriction and spawn
+	void     SaveBatchStability(uint32_t boardIndex, const std::wstring& stabilityFile); //Saves the full image of one board of the batch, same as SaveCurrentStep()
+
+	uint32_t                        SearchClickRules(const CpuClickRuleSearchParams& params); //Simulates the click rules of the class on the CPU, returns the number of distinct rules evaluated
+	uint32_t                        GetFoundClickRuleCount()         const;                   //The number of the best rules kept by the last search
+	const CpuClickRuleSearchResult& GetFoundClickRule(uint32_t index) const;                  //Best first
+	void                            UseFoundClickRule(uint32_t index);                        //Changes the click rule to the found one, same as loading it from file
+
+	bool     PrepareRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t finalFrame); //CPU compute only. Prepares to compute only the stability of the region at the final frame, false if the region is outside the board
+	void     TickRegionSteps(uint32_t stepCount);                                                         //Several steps of the light cone of the region, up to the final frame
+	uint32_t GetRegionFrameNumber() const;
+	uint64_t GetRegionComputedCellCount() const;                                                          //The cells computed for the region so far, to compare with the full board
+	void     SaveRegionStability(const std::wstring& stabilityFile);                                      //Saves the full image of the region, same as SaveCurrentStep()
+
+	bool         PrepareOutOfCore(const std::wstring& folder, uint32_t width, uint32_t height, BoardClearMode clearMode, uint64_t memoryBudget); //CPU compute only. Prepares to compute a board too big for the memory in the files of the folder, with the current click rule. No restriction and no spawn. False if the files can't be created
+	bool         TickOutOfCoreSteps(uint32_t stepCount);                                                                                          //Several steps of the out-of-core board, false if the files can't be accessed
+	uint32_t     GetOutOfCoreFrameNumber()    const;
+	uint32_t     GetOutOfCoreStepsPerPass()   const;                                                                                              //The most frames a single pass over the files computes
+	std::wstring GetOutOfCoreStabilityFile()  const;                                                                                              //The raw file with the unstable cells, 1 bit per cell
+	bool         SaveOutOfCorePreview(const std::wstring& stabilityFile);                                                                         //Saves the stability downscaled to fit into a texture, each pixel is stable if most of its cells are
+
+	bool     PrepareSlab(uint32_t slabIndex, uint32_t slabCount, const std::vector<std::string>& slabAddresses); //CPU compute only. Connects to the processes of the neighbor slabs and prepares to compute the rows of this one, with the current click rule. No restriction and no spawn. False if the neighbors can't be reached
+	bool     TickSlabSteps(uint32_t stepCount);                                                                 //Several steps of the slab in lockstep with the other slabs, false if the connection is lost
+	uint32_t GetSlabFrameNumber()    const;
+	uint32_t GetSlabRowBegin()       const;
+	uint32_t GetSlabRowCount()       const;
+	uint64_t GetSlabExchangedBytes() const;
+	void     SaveSlabStability(const std::wstring& stabilityFile);                                              //Saves the full image of the rows of the slab only, same as SaveCurrentStep()
+
 	uint32_t GetLastFrameNumber()                         const; //Returns the number of the last frame
 	uint32_t GetDefaultSolutionPeriod(uint32_t boardSize) const; //Returns the (fake) solution period (if boardSize is 2^p - 1, then this function retuns 2^(p-1))
+	uint32_t GetDetectedPeriod()                          const; //Returns the period the board and the stability started repeating with, 0 if no repeat was found yet
+	bool     ConfirmDetectedPeriod();                            //Computes the detected period of frames and compares the state with the one before them. On a hash collision restarts the detection and returns false
+	bool     IsInitialBoardRepeated();                           //Returns true if the last computed board is the same as the initial one
+	uint32_t ComputeSolutionPeriod(const std::wstring& cacheFile); //Returns the frame the stability stops changing at, found from the minimal polynomial of the board sequence and cached in the file (none if empty). The default solution period with spawn or if it isn't found within a few default periods of frames
+
+	std::wstring GetCpuInstructionSetName() const; //Returns the name of the instruction set used by the CPU computations
+	std::wstring GetComputeDeviceName()     const; //Returns the name of the device the compute backend runs on
 
 	uint32_t GetWidth()  const; //Returns the width of the board
 	uint32_t GetHeight() const; //Returns the height of the board
 
 private:
-	Renderer* mRenderer; //Non-owning observer pointer
+	bool IsCpuComputeActive() const;
+
+	void ReadbackCpuParameters(std::vector<uint8_t>& outInitialBoardCells); //Copies the initial board, the click rule and the restriction to the CPU
+	void InvalidateTransform(TransformSource source, uint32_t spawnPeriod); //The final transform is computed from the source once something needs it
 
-	std::unique_ptr<StabilityCalculator> mStabilityCalculator;
+	const CpuClickRule* GetCpuClickRule()   const; //Null for the default click rule
+	const BitBoard*     GetCpuRestriction() const; //Null if there's no restriction
 
-	std::unique_ptr<Downscaler>       mDownscaler;
-	std::unique_ptr<FinalTransformer> mFinalTransformer;
-	std::unique_ptr<EqualityChecker>  mEqualityChecker;
+private:
+	std::unique_ptr<ComputeBackend> mComputeBackend;
 
-	std::unique_ptr<ClickRules> mClickRules;
-	std::unique_ptr<Boards>     mBoards;
+	std::unique_ptr<CpuStabilityCalculator> mCpuStabilityCalculator;
+	std::unique_ptr<CpuBatchCalculator>     mCpuBatchCalculator;
+	std::unique_ptr<CpuClickRuleSearch>     mCpuClickRuleSearch;
+	std::unique_ptr<CpuRegionCalculator>    mCpuRegionCalculator;
+	std::unique_ptr<CpuOutOfCoreCalculator> mCpuOutOfCoreCalculator;
+	std::unique_ptr<CpuSlabCalculator>      mCpuSlabCalculator;
+	std::unique_ptr<CpuSocketTransport>     mCpuSlabTransport;
 
-	std::unique_ptr<BoardLoader> mBoardLoader;
-	std::unique_ptr<BoardSaver>  mBoardSaver;
+	std::unique_ptr<BoardSaver> mBoardSaver;
+
+	std::unique_ptr<CpuClickRule> mCpuClickRule;
+	std::unique_ptr<BitBoard>     mCpuRestriction;
+	std::vector<uint16_t>         mCpuStabilityCells; //Resized before every write, the backend may swap its own storage in
+	std::unique_ptr<CpuChangeMap> mCpuChangeMap;
 
 	uint32_t mVideoFrameWidth;
 	uint32_t mVideoFrameHeight;
 
 	uint32_t mSpawnPeriod;
 
+	TransformSource mTransformSource;
+	uint32_t        mTransformSpawnPeriod;
+
 	bool mbUseSmoothTransform;
+	bool mbUseCpuCompute;
+	bool mbTransformOutdated;
 };
\ No newline at end of file
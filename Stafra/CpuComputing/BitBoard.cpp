@@ -0,0 +1,237 @@
+#include "BitBoard.hpp"
+#include <algorithm>
+
+BitBoard::BitBoard(): mWidth(0), mHeight(0), mWordsPerRow(0), mRowStride(0)
+{
+}
+
+BitBoard::BitBoard(uint32_t width, uint32_t height): BitBoard()
+{
+	Resize(width, height);
+}
+
+BitBoard::~BitBoard()
+{
+}
+
+void BitBoard::Resize(uint32_t width, uint32_t height)
+{
+	mWidth  = width;
+	mHeight = height;
+
+	size_t cellWords = ((size_t)width + 63) / 64;
+	mWordsPerRow     = (cellWords + RowWordAlignment - 1) / RowWordAlignment * RowWordAlignment;
+	mRowStride       = mWordsPerRow + 2; //Left and right guard words
+
+	mWords.assign(mRowStride * ((size_t)height + 2), 0); //Top and bottom guard rows
+
+	mColumnMask.assign(mWordsPerRow, 0);
+	for(size_t i = 0; i < cellWords; i++)
+	{
+		size_t cellsInWord = std::min<size_t>(64, (size_t)width - i * 64);
+		mColumnMask[i]     = (cellsInWord == 64) ? ~0ull : ((1ull << cellsInWord) - 1);
+	}
+}
+
+uint32_t BitBoard::GetWidth() const
+{
+	return mWidth;
+}
+
+uint32_t BitBoard::GetHeight() const
+{
+	return mHeight;
+}
+
+size_t BitBoard::GetWordsPerRow() const
+{
+	return mWordsPerRow;
+}
+
+size_t BitBoard::GetRowStride() const
+{
+	return mRowStride;
+}
+
+uint64_t* BitBoard::Row(int32_t y)
+{
+	return mWords.data() + (ptrdiff_t)mRowStride * (y + 1) + 1;
+}
+
+const uint64_t* BitBoard::Row(int32_t y) const
+{
+	return mWords.data() + (ptrdiff_t)mRowStride * (y + 1) + 1;
+}
+
+const uint64_t* BitBoard::GetColumnMask() const
+{
+	return mColumnMask.data();
+}
+
+bool BitBoard::GetCell(uint32_t x, uint32_t y) const
+{
+	return (Row(y)[x / 64] >> (x % 64)) & 1;
+}
+
+void BitBoard::SetCell(uint32_t x, uint32_t y, bool value)
+{
+	uint64_t& word = Row(y)[x / 64];
+	uint64_t  bit  = 1ull << (x % 64);
+
+	word = value ? (word | bit) : (word & ~bit);
+}
+
+void BitBoard::Clear()
+{
+	std::fill(mWords.begin(), mWords.end(), 0);
+}
+
+void BitBoard::Fill(bool value)
+{
+	Clear();
+	if(!value)
+	{
+		return;
+	}
+
+	for(uint32_t y = 0; y < mHeight; y++)
+	{
+		std::copy(mColumnMask.begin(), mColumnMask.end(), Row(y));
+	}
+}
+
+void BitBoard::FromCells(const uint8_t* cells, size_t rowPitch)
+{
+	Clear();
+	for(uint32_t y = 0; y < mHeight; y++)
+	{
+		const uint8_t* cellRow = cells + y * rowPitch;
+		uint64_t*      row     = Row(y);
+
+		for(uint32_t x = 0; x < mWidth; x++)
+		{
+			row[x / 64] |= (uint64_t)(cellRow[x] != 0) << (x % 64);
+		}
+	}
+}
+
+void BitBoard::ToCells(uint8_t* outCells, size_t rowPitch) const
+{
+	for(uint32_t y = 0; y < mHeight; y++)
+	{
+		uint8_t*        cellRow = outCells + y * rowPitch;
+		const uint64_t* row     = Row(y);
+
+		for(uint32_t x = 0; x < mWidth; x++)
+		{
+			cellRow[x] = (uint8_t)((row[x / 64] >> (x % 64)) & 1);
+		}
+	}
+}
+
+void BitBoard::CropFrom(const BitBoard& other)
+{
+	for(uint32_t y = 0; y < mHeight; y++)
+	{
+		const uint64_t* otherRow = other.Row(y);
+		uint64_t*       row      = Row(y);
+
+		for(size_t i = 0; i < mWordsPerRow; i++)
+		{
+			row[i] = otherRow[i] & mColumnMask[i];
+		}
+	}
+}
+
+bool BitBoard::IsMirrorSymmetricX() const
+{
+	for(uint32_t y = 0; y < mHeight; y++)
+	{
+		for(uint32_t x = 0; x < mWidth / 2; x++)
+		{
+			if(GetCell(x, y) != GetCell(mWidth - 1 - x, y))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool BitBoard::IsMirrorSymmetricY() const
+{
+	for(uint32_t y = 0; y < mHeight / 2; y++)
+	{
+		if(!std::equal(Row(y), Row(y) + mWordsPerRow, Row(mHeight - 1 - y)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool BitBoard::IsTransposeSymmetric() const
+{
+	if(mWidth != mHeight)
+	{
+		return false;
+	}
+
+	//Each 64x64 block on and above the diagonal is compared with the transposed one below it. The cells outside of the board are 0 in both
+	uint32_t blockCount = (mHeight + 63) / 64;
+	uint64_t block[64];
+	for(uint32_t blockY = 0; blockY < blockCount; blockY++)
+	{
+		for(uint32_t blockX = blockY; blockX < blockCount; blockX++)
+		{
+			for(uint32_t i = 0; i < 64; i++)
+			{
+				uint32_t y = blockY * 64 + i;
+				block[i] = (y < mHeight) ? Row((int32_t)y)[blockX] : 0;
+			}
+
+			TransposeBlock(block);
+
+			for(uint32_t i = 0; i < 64; i++)
+			{
+				uint32_t y = blockX * 64 + i;
+				if(block[i] != ((y < mHeight) ? Row((int32_t)y)[blockY] : 0))
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+void BitBoard::TransposeBlock(uint64_t* block)
+{
+	//Each pass swaps the off-diagonal quarters of all shift x shift sub-blocks. The inner loop is contiguous, so it vectorizes
+	uint64_t mask = 0x00000000ffffffffull;
+	for(uint32_t shift = 32; shift != 0; shift >>= 1, mask ^= (mask << shift))
+	{
+		for(uint32_t first = 0; first < 64; first += 2 * shift)
+		{
+			for(uint32_t i = first; i < first + shift; i++)
+			{
+				uint64_t swapped = ((block[i] >> shift) ^ block[i + shift]) & mask;
+				block[i]         ^= swapped << shift;
+				block[i + shift] ^= swapped;
+			}
+		}
+	}
+}
+
+void BitBoard::Swap(BitBoard& other)
+{
+	std::swap(mWords,       other.mWords);
+	std::swap(mColumnMask,  other.mColumnMask);
+	std::swap(mWidth,       other.mWidth);
+	std::swap(mHeight,      other.mHeight);
+	std::swap(mWordsPerRow, other.mWordsPerRow);
+	std::swap(mRowStride,   other.mRowStride);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/*
+The class for storing a board with 1 bit per cell.
+Input:               Board width and height, optionally the cell values (1 byte per cell)
+Output:              Rows of 64-bit words, bit (x % 64) of word (x / 64) is the cell x. Each row has a zero guard word on both sides, and the board has a zero guard row on both sides
+Possible expansions: None ATM
+*/
+
+class BitBoard
+{
+public:
+	static const size_t RowWordAlignment = 8; //Words per row are padded to this value, so the widest SIMD kernel never needs a tail loop
+
+	BitBoard();
+	BitBoard(uint32_t width, uint32_t height);
+	~BitBoard();
+
+	void Resize(uint32_t width, uint32_t height); //Also clears the board
+
+	uint32_t GetWidth()  const;
+	uint32_t GetHeight() const;
+
+	size_t GetWordsPerRow() const; //The number of words in a row, without the guard words
+	size_t GetRowStride()   const; //The distance between two rows, in words
+
+	uint64_t*       Row(int32_t y);       //Valid for y from -1 to height (both are zero guard rows)
+	const uint64_t* Row(int32_t y) const;
+
+	const uint64_t* GetColumnMask() const; //Words with bits set for every valid cell of a row
+
+	bool GetCell(uint32_t x, uint32_t y) const;
+	void SetCell(uint32_t x, uint32_t y, bool value);
+
+	void Clear();
+	void Fill(bool value);
+
+	void FromCells(const uint8_t* cells, size_t rowPitch);  //Any non-zero cell value is 1
+	void ToCells(uint8_t* outCells, size_t rowPitch) const; //Writes 0 or 1 for each cell
+
+	void CropFrom(const BitBoard& other); //Copies the top left width x height cells of a board at least as big as this one
+
+	bool IsMirrorSymmetricX() const; //Cell (x, y) is equal to the cell (width - 1 - x, y)
+	bool IsMirrorSymmetricY() const; //Cell (x, y) is equal to the cell (x, height - 1 - y)
+	bool IsTransposeSymmetric() const; //Cell (x, y) is equal to the cell (y, x). Only square boards can be
+
+	void Swap(BitBoard& other);
+
+	static void TransposeBlock(uint64_t* block); //64 words of 64 cells, bit x of the word y goes to the bit y of the word x
+
+private:
+	std::vector<uint64_t> mWords;
+	std::vector<uint64_t> mColumnMask;
+
+	uint32_t mWidth;
+	uint32_t mHeight;
+
+	size_t mWordsPerRow;
+	size_t mRowStride;
+};
@@ -0,0 +1,338 @@
+#include "CpuBatchCalculator.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	const uint32_t gRowsPerTask = 16;
+
+	size_t AlignWords(size_t wordCount)
+	{
+		return (wordCount + BitBoard::RowWordAlignment - 1) / BitBoard::RowWordAlignment * BitBoard::RowWordAlignment;
+	}
+}
+
+CpuBatchCalculator::CpuBatchCalculator(): mStabilityPlaneCount(1), mLastRestriction(nullptr), mbRestrictionValid(false), mBoardWidth(0), mBoardHeight(0), mBoardCount(0),
+                                          mRowWords(0), mGuardWords(0), mGuardRows(0), mRowStride(0), mCurrentStep(0)
+{
+	SetInstructionSet(CpuFeatures::DetectInstructionSet());
+	SetThreadCount(0);
+}
+
+CpuBatchCalculator::~CpuBatchCalculator()
+{
+}
+
+void CpuBatchCalculator::SetInstructionSet(CpuInstructionSet instructionSet)
+{
+	mInstructionSet = std::min(instructionSet, CpuFeatures::DetectInstructionSet());
+	mKernels        = CpuKernels::SelectKernels(mInstructionSet);
+}
+
+void CpuBatchCalculator::SetThreadCount(uint32_t threadCount)
+{
+	mThreadPool.reset();
+	mThreadPool = std::make_unique<ThreadPool>(threadCount);
+}
+
+void CpuBatchCalculator::PrepareForCalculations(uint32_t width, uint32_t height)
+{
+	mBoardWidth  = width;
+	mBoardHeight = height;
+	mBoardCount  = 0;
+	mCurrentStep = 0;
+
+	mRowWords   = AlignWords(width);
+	mGuardWords = 0;
+	mGuardRows  = 0;
+	mRowStride  = mRowWords;
+
+	mPrevBoard.assign(mRowStride * mBoardHeight, 0);
+	mCurrBoard.assign(mRowStride * mBoardHeight, 0);
+	mPrevRestrictedBoard.clear();
+	mCurrRestrictedBoard.clear();
+
+	//Every cell starts stable, the same as CpuStabilityCalculator
+	mStabilityPlaneCount = 1;
+	mPrevStability.assign(mRowWords * mBoardHeight, 0);
+	mCurrStability.assign(mRowWords * mBoardHeight, 0);
+	for(uint32_t y = 0; y < mBoardHeight; y++)
+	{
+		std::fill(mPrevStability.begin() + y * mRowWords, mPrevStability.begin() + y * mRowWords + mBoardWidth, ~0ull);
+	}
+
+	mRestriction.assign(mRowWords * mBoardHeight, 0);
+	mLastRestriction   = nullptr;
+	mbRestrictionValid = false;
+
+	ResizeGuard(mDefaultClickRule.GetRadius());
+}
+
+uint32_t CpuBatchCalculator::AddBoard(const uint8_t* initialBoard, size_t rowPitch)
+{
+	if(mBoardCount == MaxBoards || mCurrentStep != 0)
+	{
+		return MaxBoards;
+	}
+
+	const uint32_t boardIndex = mBoardCount;
+	const uint64_t boardBit   = 1ull << boardIndex;
+	for(uint32_t y = 0; y < mBoardHeight; y++)
+	{
+		uint64_t*      boardRow = BoardRow(mPrevBoard, y);
+		const uint8_t* cellRow  = initialBoard + y * rowPitch;
+		for(uint32_t x = 0; x < mBoardWidth; x++)
+		{
+			if(cellRow[x] != 0)
+			{
+				boardRow[x] |= boardBit;
+			}
+		}
+	}
+
+	mbRestrictionValid = false; //The restricted board has to include the new board too
+	mBoardCount++;
+	return boardIndex;
+}
+
+void CpuBatchCalculator::StabilityNextSteps(uint32_t stepCount, const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t spawnPeriod)
+{
+	if(!clickRule)
+	{
+		clickRule = &mDefaultClickRule;
+	}
+
+	ResizeGuard(clickRule->GetRadius());
+	UpdateRestriction(restriction);
+
+	//The values go up to spawnPeriod + 1, the same plane count as CpuStabilityCalculator uses
+	uint32_t planeCount = 1;
+	if(spawnPeriod != 0)
+	{
+		while(planeCount < 32 && ((spawnPeriod + 1) >> planeCount) != 0)
+		{
+			planeCount++;
+		}
+
+		planeCount = std::max(planeCount, mStabilityPlaneCount);
+	}
+
+	ResizeStabilityPlanes(planeCount);
+
+	uint32_t taskCount = (mBoardHeight + gRowsPerTask - 1) / gRowsPerTask;
+	for(uint32_t step = 0; step < stepCount; step++)
+	{
+		mThreadPool->ParallelFor(taskCount, [this, clickRule, spawnPeriod](uint32_t taskIndex, uint32_t /*threadIndex*/)
+		{
+			uint32_t rowBegin = taskIndex * gRowsPerTask;
+			uint32_t rowEnd   = std::min(rowBegin + gRowsPerTask, mBoardHeight);
+
+			for(uint32_t y = rowBegin; y < rowEnd; y++)
+			{
+				NextStepRow((int32_t)y, clickRule, spawnPeriod);
+			}
+		});
+
+		std::swap(mPrevBoard,           mCurrBoard);
+		std::swap(mPrevRestrictedBoard, mCurrRestrictedBoard);
+		std::swap(mPrevStability,       mCurrStability);
+
+		mCurrentStep++;
+	}
+}
+
+uint32_t CpuBatchCalculator::GetBoardWidth() const
+{
+	return mBoardWidth;
+}
+
+uint32_t CpuBatchCalculator::GetBoardHeight() const
+{
+	return mBoardHeight;
+}
+
+uint32_t CpuBatchCalculator::GetBoardCount() const
+{
+	return mBoardCount;
+}
+
+uint32_t CpuBatchCalculator::GetCurrentStep() const
+{
+	return mCurrentStep;
+}
+
+void CpuBatchCalculator::CopyStabilityCells(uint32_t boardIndex, uint16_t* outCells, size_t rowPitch) const
+{
+	uint32_t taskCount = (mBoardHeight + gRowsPerTask - 1) / gRowsPerTask;
+	mThreadPool->ParallelFor(taskCount, [this, boardIndex, outCells, rowPitch](uint32_t taskIndex, uint32_t /*threadIndex*/)
+	{
+		uint32_t rowBegin = taskIndex * gRowsPerTask;
+		uint32_t rowEnd   = std::min(rowBegin + gRowsPerTask, mBoardHeight);
+
+		const size_t planeRowPitch = mStabilityPlaneCount * mRowWords;
+		for(uint32_t y = rowBegin; y < rowEnd; y++)
+		{
+			const uint64_t* planes = mPrevStability.data() + y * planeRowPitch;
+			uint16_t*       outRow = outCells + y * rowPitch;
+
+			for(uint32_t x = 0; x < mBoardWidth; x++)
+			{
+				uint16_t value = 0;
+				for(uint32_t plane = 0; plane < mStabilityPlaneCount; plane++)
+				{
+					value |= (uint16_t)(((planes[plane * mRowWords + x] >> boardIndex) & 1) << plane);
+				}
+
+				outRow[x] = value;
+			}
+		}
+	});
+}
+
+void CpuBatchCalculator::ResizeGuard(int32_t radius)
+{
+	if(radius <= mGuardRows)
+	{
+		return;
+	}
+
+	const size_t guardWords = AlignWords((size_t)radius);
+	const size_t rowStride  = mRowWords + 2 * guardWords;
+	const size_t boardWords = rowStride * (mBoardHeight + 2 * radius);
+
+	std::vector<uint64_t> board(boardWords, 0);
+	for(uint32_t y = 0; y < mBoardHeight; y++)
+	{
+		memcpy(board.data() + (y + radius) * rowStride + guardWords, BoardRow(mPrevBoard, y), mRowWords * sizeof(uint64_t));
+	}
+
+	mPrevBoard.swap(board);
+	mCurrBoard.assign(boardWords, 0);
+	mPrevRestrictedBoard.clear();
+	mCurrRestrictedBoard.clear();
+
+	mGuardWords = guardWords;
+	mGuardRows  = radius;
+	mRowStride  = rowStride;
+
+	mbRestrictionValid = false;
+}
+
+void CpuBatchCalculator::ResizeStabilityPlanes(uint32_t planeCount)
+{
+	if(planeCount == mStabilityPlaneCount)
+	{
+		return;
+	}
+
+	const size_t oldPlaneRowPitch = mStabilityPlaneCount * mRowWords;
+	const size_t newPlaneRowPitch = planeCount * mRowWords;
+
+	std::vector<uint64_t> planes(newPlaneRowPitch * mBoardHeight, 0);
+	for(uint32_t y = 0; y < mBoardHeight; y++)
+	{
+		const uint64_t* oldRow = mPrevStability.data() + y * oldPlaneRowPitch;
+		uint64_t*       newRow = planes.data() + y * newPlaneRowPitch;
+
+		if(planeCount == 1)
+		{
+			//Non-zero values are stable
+			for(uint32_t plane = 0; plane < mStabilityPlaneCount; plane++)
+			{
+				for(size_t i = 0; i < mRowWords; i++)
+				{
+					newRow[i] |= oldRow[plane * mRowWords + i];
+				}
+			}
+		}
+		else
+		{
+			memcpy(newRow, oldRow, std::min(oldPlaneRowPitch, newPlaneRowPitch) * sizeof(uint64_t));
+		}
+	}
+
+	mPrevStability.swap(planes);
+	mCurrStability.assign(newPlaneRowPitch * mBoardHeight, 0);
+	mStabilityPlaneCount = planeCount;
+}
+
+void CpuBatchCalculator::UpdateRestriction(const BitBoard* restriction)
+{
+	if(mbRestrictionValid && restriction == mLastRestriction)
+	{
+		return;
+	}
+
+	//Without the restriction the click rule reads the board itself, and mRestriction is only the column mask
+	mPrevRestrictedBoard.assign(restriction ? mPrevBoard.size() : 0, 0);
+	mCurrRestrictedBoard.assign(restriction ? mPrevBoard.size() : 0, 0);
+
+	for(uint32_t y = 0; y < mBoardHeight; y++)
+	{
+		uint64_t* restrictionRow = mRestriction.data() + y * mRowWords;
+		for(uint32_t x = 0; x < mBoardWidth; x++)
+		{
+			restrictionRow[x] = (!restriction || restriction->GetCell(x, y)) ? ~0ull : 0ull;
+		}
+
+		if(restriction)
+		{
+			mKernels.AndRow(BoardRow(mPrevRestrictedBoard, y), BoardRow(mPrevBoard, y), restrictionRow, mRowWords);
+		}
+	}
+
+	mLastRestriction   = restriction;
+	mbRestrictionValid = true;
+}
+
+void CpuBatchCalculator::NextStepRow(int32_t y, const CpuClickRule* clickRule, uint32_t spawnPeriod)
+{
+	uint64_t*       nextRow        = BoardRow(mCurrBoard, y);
+	const uint64_t* thisRow        = BoardRow(mPrevBoard, y);
+	const uint64_t* restrictionRow = mRestriction.data() + y * mRowWords;
+
+	//Every board reads the same offsets, so the cell (x + offset) of all 64 boards is a single word
+	const std::vector<uint64_t>& sourceBoard = mLastRestriction ? mPrevRestrictedBoard : mPrevBoard;
+	memset(nextRow, 0, mRowWords * sizeof(uint64_t));
+	for(const CpuClickRuleRow& clickRuleRow: clickRule->GetRows())
+	{
+		const uint64_t* sourceRow = BoardRow(sourceBoard, y + clickRuleRow.OffsetY);
+		for(int32_t offsetX: clickRuleRow.OffsetsX)
+		{
+			mKernels.XorRow(nextRow, sourceRow + offsetX, mRowWords);
+		}
+	}
+
+	//The padding words get the cells across the right border, the restriction row zeroes them for the next step and the stability
+	if(mLastRestriction)
+	{
+		mKernels.AndRow(BoardRow(mCurrRestrictedBoard, y), nextRow, restrictionRow, mRowWords);
+	}
+	else
+	{
+		mKernels.AndRow(nextRow, nextRow, restrictionRow, mRowWords);
+	}
+
+	const size_t planeRowPitch = mStabilityPlaneCount * mRowWords;
+	uint64_t*       nextPlanes = mCurrStability.data() + y * planeRowPitch;
+	const uint64_t* prevPlanes = mPrevStability.data() + y * planeRowPitch;
+	if(spawnPeriod == 0)
+	{
+		mKernels.StabilityRow(nextPlanes, prevPlanes, thisRow, nextRow, restrictionRow, mRowWords);
+	}
+	else
+	{
+		mKernels.SpawnStabilityRow(nextPlanes, prevPlanes, mRowWords, mStabilityPlaneCount, thisRow, nextRow, restrictionRow, spawnPeriod, mRowWords);
+	}
+}
+
+uint64_t* CpuBatchCalculator::BoardRow(std::vector<uint64_t>& board, int32_t y)
+{
+	return board.data() + (y + mGuardRows) * mRowStride + mGuardWords;
+}
+
+const uint64_t* CpuBatchCalculator::BoardRow(const std::vector<uint64_t>& board, int32_t y) const
+{
+	return board.data() + (y + mGuardRows) * mRowStride + mGuardWords;
+}
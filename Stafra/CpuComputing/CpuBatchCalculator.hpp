@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include "BitBoard.hpp"
+#include "CpuClickRule.hpp"
+#include "CpuFeatures.hpp"
+#include "NextStepKernels.hpp"
+
+class ThreadPool;
+
+/*
+The class for computing the stability of up to 64 boards of the same size at once, with the same click rule and restriction.
+Input:               Initial boards (1 byte per cell), click rule, restriction
+Output:              Last computed stability iteration of each board
+Possible expansions: Temporal blocking, change maps and stats per board
+
+The boards are bit-sliced: each cell is a 64-bit word, and the bit i of it is the cell of the board i.
+The click rule then only XORs whole words at whole-word offsets, the same instructions step all boards at once.
+*/
+
+class CpuBatchCalculator
+{
+public:
+	static const uint32_t MaxBoards = 64;
+
+	CpuBatchCalculator();
+	~CpuBatchCalculator();
+
+	void SetInstructionSet(CpuInstructionSet instructionSet); //Clamped to the one supported by the CPU
+	void SetThreadCount(uint32_t threadCount);                //0 means one thread per hardware thread
+
+	void     PrepareForCalculations(uint32_t width, uint32_t height); //Removes all boards
+	uint32_t AddBoard(const uint8_t* initialBoard, size_t rowPitch); //Before the first step only. Returns the index of the board, MaxBoards if the batch is full
+
+	void StabilityNextSteps(uint32_t stepCount, const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t spawnPeriod); //Null click rule is the default one, null restriction is no restriction
+
+	uint32_t GetBoardWidth()  const;
+	uint32_t GetBoardHeight() const;
+	uint32_t GetBoardCount()  const;
+	uint32_t GetCurrentStep() const;
+
+	void CopyStabilityCells(uint32_t boardIndex, uint16_t* outCells, size_t rowPitch) const; //Same values CpuStabilityCalculator::CopyStabilityCells() gives for that board alone
+
+private:
+	void ResizeGuard(int32_t radius);               //Makes the zero border around the boards wide enough for the click rule, keeps the boards
+	void ResizeStabilityPlanes(uint32_t planeCount); //Keeps the values that fit, more planes are added as zeros. A single plane is the 0/1 stability
+	void UpdateRestriction(const BitBoard* restriction);
+
+	void NextStepRow(int32_t y, const CpuClickRule* clickRule, uint32_t spawnPeriod);
+
+	uint64_t*       BoardRow(std::vector<uint64_t>& board, int32_t y);             //Valid for y from -radius to height + radius - 1, and radius words to the left and to the right
+	const uint64_t* BoardRow(const std::vector<uint64_t>& board, int32_t y) const;
+
+private:
+	std::unique_ptr<ThreadPool> mThreadPool;
+
+	NextStepKernels   mKernels;
+	CpuInstructionSet mInstructionSet;
+
+	CpuClickRule mDefaultClickRule;
+
+	//Rows of mRowWords words with mGuardWords zero words on both sides and mGuardRows zero rows above and below
+	std::vector<uint64_t> mPrevBoard;
+	std::vector<uint64_t> mCurrBoard;
+	std::vector<uint64_t> mPrevRestrictedBoard; //Board AND restriction, the only cells the click rule reads. Empty without the restriction
+	std::vector<uint64_t> mCurrRestrictedBoard;
+
+	//The stability as mStabilityPlaneCount bit planes per row (the plane p holds the bit p of each value), without the guard words
+	std::vector<uint64_t> mPrevStability;
+	std::vector<uint64_t> mCurrStability;
+	uint32_t              mStabilityPlaneCount;
+
+	std::vector<uint64_t> mRestriction;     //All ones for the cells of the restriction, all zeros for the rest and for the padding words. Without the guard words
+	const BitBoard*       mLastRestriction; //The restriction mRestriction was expanded from
+	bool                  mbRestrictionValid;
+
+	uint32_t mBoardWidth;
+	uint32_t mBoardHeight;
+	uint32_t mBoardCount;
+
+	size_t  mRowWords;   //Board width rounded up to BitBoard::RowWordAlignment
+	size_t  mGuardWords; //Click rule radius rounded up to BitBoard::RowWordAlignment, so every row starts aligned
+	int32_t mGuardRows;  //Click rule radius
+	size_t  mRowStride;
+
+	uint32_t mCurrentStep;
+};
@@ -0,0 +1,244 @@
+#include "CpuBoardSymmetry.hpp"
+#include "CpuClickRule.hpp"
+#include "CpuSpawnPlanes.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+namespace
+{
+	const uint32_t gTransposeGroupBlocks = 8; //64x64 blocks are transposed in groups of 8x8, so each row of a group is a whole cache line
+}
+
+CpuBoardSymmetry::CpuBoardSymmetry(): mBoardWidth(0), mBoardHeight(0), mSimWidth(0), mSimHeight(0), mFundamentalWidth(0), mFundamentalHeight(0),
+                                      mbMirroredX(false), mbMirroredY(false), mbMirroredDiagonal(false), mClickRule(nullptr), mRestriction(nullptr)
+{
+}
+
+CpuBoardSymmetry::~CpuBoardSymmetry()
+{
+}
+
+void CpuBoardSymmetry::Reset(uint32_t width, uint32_t height)
+{
+	mBoardWidth  = width;
+	mBoardHeight = height;
+
+	mSimWidth          = width;
+	mSimHeight         = height;
+	mFundamentalWidth  = width;
+	mFundamentalHeight = height;
+	mbMirroredX        = false;
+	mbMirroredY        = false;
+	mbMirroredDiagonal = false;
+
+	mReducedRestriction.Resize(0, 0);
+	mClickRule   = nullptr;
+	mRestriction = nullptr;
+}
+
+bool CpuBoardSymmetry::Detect(const BitBoard& board, const CpuClickRule* clickRule, const BitBoard* restriction, int32_t halo)
+{
+	bool mirrorX = board.IsMirrorSymmetricX() && (!clickRule || clickRule->IsMirrorSymmetricX()) && (!restriction || restriction->IsMirrorSymmetricX());
+	bool mirrorY = board.IsMirrorSymmetricY() && (!clickRule || clickRule->IsMirrorSymmetricY()) && (!restriction || restriction->IsMirrorSymmetricY());
+	if(!mirrorX && !mirrorY)
+	{
+		return false;
+	}
+
+	//The transposed board steps the same way with a transposed click rule and restriction. Only used together with both mirrors, so the quarter is transposed into itself
+	bool mirrorDiagonal = mirrorX && mirrorY && board.IsTransposeSymmetric() && (!clickRule || clickRule->IsTransposeSymmetric()) && (!restriction || restriction->IsTransposeSymmetric());
+
+	if(mirrorX)
+	{
+		mFundamentalWidth = (mBoardWidth + 1) / 2;
+		mSimWidth         = std::min(mFundamentalWidth + halo, mBoardWidth);
+	}
+
+	if(mirrorY)
+	{
+		mFundamentalHeight = (mBoardHeight + 1) / 2;
+		mSimHeight         = std::min(mFundamentalHeight + halo, mBoardHeight);
+	}
+
+	if(restriction)
+	{
+		mReducedRestriction.Resize(mSimWidth, mSimHeight);
+		mReducedRestriction.CropFrom(*restriction);
+	}
+
+	mbMirroredX        = mirrorX;
+	mbMirroredY        = mirrorY;
+	mbMirroredDiagonal = mirrorDiagonal;
+	mClickRule         = clickRule;
+	mRestriction       = restriction;
+	return true;
+}
+
+bool CpuBoardSymmetry::IsDetectedFor(const CpuClickRule* clickRule, const BitBoard* restriction) const
+{
+	return clickRule == mClickRule && restriction == mRestriction;
+}
+
+const BitBoard* CpuBoardSymmetry::GetReducedRestriction() const
+{
+	return mRestriction ? &mReducedRestriction : nullptr;
+}
+
+uint32_t CpuBoardSymmetry::GetBoardWidth() const
+{
+	return mBoardWidth;
+}
+
+uint32_t CpuBoardSymmetry::GetBoardHeight() const
+{
+	return mBoardHeight;
+}
+
+uint32_t CpuBoardSymmetry::GetSimWidth() const
+{
+	return mSimWidth;
+}
+
+uint32_t CpuBoardSymmetry::GetSimHeight() const
+{
+	return mSimHeight;
+}
+
+uint32_t CpuBoardSymmetry::GetFundamentalWidth() const
+{
+	return mFundamentalWidth;
+}
+
+uint32_t CpuBoardSymmetry::GetFundamentalHeight() const
+{
+	return mFundamentalHeight;
+}
+
+bool CpuBoardSymmetry::IsMirrored() const
+{
+	return mbMirroredX || mbMirroredY;
+}
+
+bool CpuBoardSymmetry::IsMirroredX() const
+{
+	return mbMirroredX;
+}
+
+bool CpuBoardSymmetry::IsMirroredY() const
+{
+	return mbMirroredY;
+}
+
+bool CpuBoardSymmetry::IsMirroredDiagonal() const
+{
+	return mbMirroredDiagonal;
+}
+
+uint32_t CpuBoardSymmetry::MirroredX(uint32_t x) const
+{
+	return (x < mFundamentalWidth) ? x : (mBoardWidth - 1 - x);
+}
+
+uint32_t CpuBoardSymmetry::MirroredY(uint32_t y) const
+{
+	return (y < mFundamentalHeight) ? y : (mBoardHeight - 1 - y);
+}
+
+void CpuBoardSymmetry::FillHalo(BitBoard& simBoard) const
+{
+	if(mbMirroredX)
+	{
+		for(uint32_t y = 0; y < mFundamentalHeight; y++)
+		{
+			for(uint32_t x = mFundamentalWidth; x < mSimWidth; x++)
+			{
+				simBoard.SetCell(x, y, simBoard.GetCell(MirroredX(x), y));
+			}
+		}
+	}
+
+	for(uint32_t y = mFundamentalHeight; y < mSimHeight; y++)
+	{
+		std::copy(simBoard.Row((int32_t)MirroredY(y)), simBoard.Row((int32_t)MirroredY(y)) + simBoard.GetWordsPerRow(), simBoard.Row((int32_t)y));
+	}
+}
+
+void CpuBoardSymmetry::FillDiagonal(ThreadPool* threadPool, uint64_t* rows, size_t rowPitch, const std::function<bool(uint32_t blockX, uint32_t blockY)>& isBlockChanged) const
+{
+	//Each task writes the blocks of one group row below the diagonal, and only reads the blocks above it
+	uint32_t blockCount = (mFundamentalHeight + 63) / 64;
+	uint32_t groupCount = (blockCount + gTransposeGroupBlocks - 1) / gTransposeGroupBlocks;
+	threadPool->ParallelFor(groupCount, [this, rows, rowPitch, blockCount, &isBlockChanged](uint32_t groupY, uint32_t /*threadIndex*/)
+	{
+		uint32_t blockBeginY = groupY * gTransposeGroupBlocks;
+		uint32_t blockEndY   = std::min(blockBeginY + gTransposeGroupBlocks, blockCount);
+
+		uint64_t block[64];
+		for(uint32_t blockBeginX = 0; blockBeginX <= blockBeginY; blockBeginX += gTransposeGroupBlocks)
+		{
+			for(uint32_t blockY = blockBeginY; blockY < blockEndY; blockY++)
+			{
+				uint32_t rowBegin = blockY * 64;
+				uint32_t rowEnd   = std::min(rowBegin + 64, mFundamentalHeight);
+
+				uint32_t blockEndX = std::min(blockBeginX + gTransposeGroupBlocks, blockY + 1);
+				for(uint32_t blockX = blockBeginX; blockX < blockEndX; blockX++)
+				{
+					if(!isBlockChanged(blockX, blockY))
+					{
+						continue;
+					}
+
+					for(uint32_t i = 0; i < 64; i++)
+					{
+						uint32_t sourceY = blockX * 64 + i;
+						block[i] = (sourceY < mFundamentalHeight) ? rows[sourceY * rowPitch + blockY] : 0;
+					}
+
+					BitBoard::TransposeBlock(block);
+
+					for(uint32_t y = rowBegin; y < rowEnd; y++)
+					{
+						//The diagonal block keeps its cells on and above the diagonal
+						uint64_t  belowMask = (blockX < blockY) ? ~0ull : ((1ull << (y % 64)) - 1);
+						uint64_t& word      = rows[y * rowPitch + blockX];
+						word = (word & ~belowMask) | (block[y - rowBegin] & belowMask);
+					}
+				}
+			}
+		}
+	});
+}
+
+void CpuBoardSymmetry::ExpandBoard(const BitBoard& simBoard, BitBoard& outBoard) const
+{
+	outBoard.Resize(mBoardWidth, mBoardHeight);
+	for(uint32_t y = 0; y < mBoardHeight; y++)
+	{
+		for(uint32_t x = 0; x < mBoardWidth; x++)
+		{
+			outBoard.SetCell(x, y, simBoard.GetCell(MirroredX(x), MirroredY(y)));
+		}
+	}
+}
+
+void CpuBoardSymmetry::ExpandPlanes(const CpuSpawnPlanes& simPlanes, size_t wordsPerRow, CpuSpawnPlanes& outPlanes) const
+{
+	const uint32_t planeCount     = simPlanes.GetPlaneCount();
+	const size_t   simWordsPerRow = simPlanes.GetWordsPerRow();
+
+	outPlanes.Resize(planeCount, wordsPerRow, mBoardHeight);
+	for(uint32_t y = 0; y < mBoardHeight; y++)
+	{
+		for(uint32_t plane = 0; plane < planeCount; plane++)
+		{
+			uint64_t*       outPlaneRow = outPlanes.PrevRow((int32_t)y) + plane * wordsPerRow;
+			const uint64_t* planeRow    = simPlanes.PrevRow((int32_t)MirroredY(y)) + plane * simWordsPerRow;
+			for(uint32_t x = 0; x < mBoardWidth; x++)
+			{
+				uint32_t simX = MirroredX(x);
+				outPlaneRow[x / 64] |= ((planeRow[simX / 64] >> (simX % 64)) & 1) << (x % 64);
+			}
+		}
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include "BitBoard.hpp"
+
+class CpuClickRule;
+class CpuSpawnPlanes;
+class ThreadPool;
+
+/*
+The class for simulating only a part of a mirror symmetric board.
+Input:               The whole board, the click rule and the restriction
+Output:              The size of the simulated part, the cells of the whole board it holds, the halo and the cells below the diagonal mirrored from its fundamental region
+Possible expansions: Rotational symmetry
+
+With symmetry reduction only the top left part of the board is simulated: the fundamental region and a halo mirrored from it after each pass.
+With the diagonal symmetry the fundamental region is the cells on and above the diagonal of that part, the cells below it are transposed from the ones above.
+The next step of a symmetric board is symmetric if the click rule and the restriction are symmetric too, so the symmetry holds while they don't change
+*/
+
+class CpuBoardSymmetry
+{
+public:
+	CpuBoardSymmetry();
+	~CpuBoardSymmetry();
+
+	void Reset(uint32_t width, uint32_t height);                                                                  //No symmetry, the whole board is simulated
+	bool Detect(const BitBoard& board, const CpuClickRule* clickRule, const BitBoard* restriction, int32_t halo); //Reduces the simulated part if the whole board is symmetric together with the click rule and the restriction. Null click rule is the default one
+
+	bool            IsDetectedFor(const CpuClickRule* clickRule, const BitBoard* restriction) const; //The click rule and the restriction are the ones the symmetry was detected for
+	const BitBoard* GetReducedRestriction() const;                                                  //The restriction the symmetry was detected for, cropped to the simulated part. Null if there was none
+
+	uint32_t GetBoardWidth()        const;
+	uint32_t GetBoardHeight()       const;
+	uint32_t GetSimWidth()          const; //The fundamental region and the halo
+	uint32_t GetSimHeight()         const;
+	uint32_t GetFundamentalWidth()  const;
+	uint32_t GetFundamentalHeight() const;
+
+	bool IsMirrored()         const; //Either in X or in Y
+	bool IsMirroredX()        const; //True if only the left part of the board is simulated
+	bool IsMirroredY()        const; //True if only the top part of the board is simulated
+	bool IsMirroredDiagonal() const; //True if only the cells on and above the diagonal of the top left quarter are computed
+
+	uint32_t MirroredX(uint32_t x) const; //The column of the fundamental region the column of the whole board is the image of
+	uint32_t MirroredY(uint32_t y) const;
+
+	void FillHalo(BitBoard& simBoard) const; //Mirrors the fundamental region into the halo
+	void FillDiagonal(ThreadPool* threadPool, uint64_t* rows, size_t rowPitch, const std::function<bool(uint32_t blockX, uint32_t blockY)>& isBlockChanged) const; //Transposes the cells above the diagonal of the fundamental region to the ones below it, only into the 64x64 blocks whose transposed cells changed. rowPitch is in words
+
+	void ExpandBoard(const BitBoard& simBoard, BitBoard& outBoard) const;                                   //The whole board from the simulated part
+	void ExpandPlanes(const CpuSpawnPlanes& simPlanes, size_t wordsPerRow, CpuSpawnPlanes& outPlanes) const; //The current spawn planes of the whole board from the simulated part, wordsPerRow is the one of the whole board
+
+private:
+	uint32_t mBoardWidth;
+	uint32_t mBoardHeight;
+
+	uint32_t mSimWidth;
+	uint32_t mSimHeight;
+	uint32_t mFundamentalWidth;
+	uint32_t mFundamentalHeight;
+
+	bool mbMirroredX;
+	bool mbMirroredY;
+	bool mbMirroredDiagonal;
+
+	BitBoard            mReducedRestriction;
+	const CpuClickRule* mClickRule;   //The click rule and the restriction the symmetry was detected for
+	const BitBoard*     mRestriction;
+};
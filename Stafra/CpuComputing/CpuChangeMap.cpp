@@ -0,0 +1,109 @@
+#include "CpuChangeMap.hpp"
+#include <algorithm>
+#include <istream>
+#include <ostream>
+
+namespace
+{
+	const uint32_t gChangeMapMagic   = 0x4D435453; //"STCM"
+	const uint32_t gChangeMapVersion = 1;
+
+	const uint32_t gMaxChangeMapSize = 65536;
+}
+
+const uint32_t CpuChangeMap::NeverChanged;
+
+CpuChangeMap::CpuChangeMap(): mWidth(0), mHeight(0), mLastFrame(0)
+{
+}
+
+CpuChangeMap::~CpuChangeMap()
+{
+}
+
+void CpuChangeMap::Resize(uint32_t width, uint32_t height)
+{
+	mWidth     = width;
+	mHeight    = height;
+	mLastFrame = 0;
+
+	mFrames.assign((size_t)width * height, NeverChanged);
+}
+
+uint32_t CpuChangeMap::GetWidth() const
+{
+	return mWidth;
+}
+
+uint32_t CpuChangeMap::GetHeight() const
+{
+	return mHeight;
+}
+
+uint32_t CpuChangeMap::GetLastFrame() const
+{
+	return mLastFrame;
+}
+
+void CpuChangeMap::SetLastFrame(uint32_t frame)
+{
+	mLastFrame = frame;
+}
+
+uint32_t* CpuChangeMap::Row(uint32_t y)
+{
+	return mFrames.data() + (size_t)y * mWidth;
+}
+
+const uint32_t* CpuChangeMap::Row(uint32_t y) const
+{
+	return mFrames.data() + (size_t)y * mWidth;
+}
+
+void CpuChangeMap::StabilityRow(uint16_t* outRow, uint32_t y, uint32_t frame) const
+{
+	const uint32_t* frameRow = Row(y);
+	for(uint32_t x = 0; x < mWidth; x++)
+	{
+		outRow[x] = (frameRow[x] == NeverChanged || frameRow[x] > frame) ? 1 : 0;
+	}
+}
+
+bool CpuChangeMap::Write(std::ostream& stream) const
+{
+	const uint32_t header[] = {gChangeMapMagic, gChangeMapVersion, mWidth, mHeight, mLastFrame};
+	stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+	stream.write(reinterpret_cast<const char*>(mFrames.data()), mFrames.size() * sizeof(uint32_t));
+
+	return stream.good();
+}
+
+bool CpuChangeMap::Read(std::istream& stream)
+{
+	uint32_t header[5] = {0};
+	if(!stream.read(reinterpret_cast<char*>(header), sizeof(header)))
+	{
+		return false;
+	}
+
+	if(header[0] != gChangeMapMagic || header[1] != gChangeMapVersion || header[2] > gMaxChangeMapSize || header[3] > gMaxChangeMapSize)
+	{
+		return false;
+	}
+
+	Resize(header[2], header[3]);
+	if(!stream.read(reinterpret_cast<char*>(mFrames.data()), mFrames.size() * sizeof(uint32_t)))
+	{
+		Resize(0, 0);
+		return false;
+	}
+
+	mLastFrame = header[4];
+	return true;
+}
+
+void CpuChangeMap::Clear()
+{
+	std::fill(mFrames.begin(), mFrames.end(), NeverChanged);
+	mLastFrame = 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <iosfwd>
+
+/*
+The class for storing the frame each cell of the board first changed at.
+Input:               Frames of the first change for each cell, or a stream with a saved map
+Output:              Stability values of any frame up to the last recorded one, without recomputing the board
+Possible expansions: Spawn stability
+*/
+
+class CpuChangeMap
+{
+public:
+	static const uint32_t NeverChanged = 0; //Cells that stayed stable up to the last recorded frame
+
+	CpuChangeMap();
+	~CpuChangeMap();
+
+	void Resize(uint32_t width, uint32_t height); //Also clears the map
+
+	uint32_t GetWidth()  const;
+	uint32_t GetHeight() const;
+
+	uint32_t GetLastFrame() const; //The last frame the map was recorded up to
+	void     SetLastFrame(uint32_t frame);
+
+	uint32_t*       Row(uint32_t y);
+	const uint32_t* Row(uint32_t y) const;
+
+	void StabilityRow(uint16_t* outRow, uint32_t y, uint32_t frame) const; //1 for the cells that didn't change up to the frame, 0 for the rest. Same values as the non-spawn stability of that frame
+
+	bool Write(std::ostream& stream) const;
+	bool Read(std::istream& stream);
+
+	void Clear();
+
+private:
+	std::vector<uint32_t> mFrames;
+
+	uint32_t mWidth;
+	uint32_t mHeight;
+	uint32_t mLastFrame;
+};
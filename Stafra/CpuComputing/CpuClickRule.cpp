@@ -0,0 +1,239 @@
+#include "CpuClickRule.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+namespace
+{
+	const uint32_t gConvolvePassCost = 4; //The cost of a click rule row pass, in plain row XOR passes
+}
+
+CpuClickRule::CpuClickRule(): mCellCount(0), mRadius(0), mbIsCross(false), mbIsSeparable(false)
+{
+	InitDefault();
+}
+
+CpuClickRule::~CpuClickRule()
+{
+}
+
+void CpuClickRule::InitDefault()
+{
+	const uint32_t width  = 32;
+	const uint32_t height = 32;
+
+	const uint32_t centralCellX = (width  - 1) / 2;
+	const uint32_t centralCellY = (height - 1) / 2;
+
+	std::vector<uint8_t> cells(width * height, 0);
+	cells[(centralCellY + 0) * width + (centralCellX + 0)] = 1;
+	cells[(centralCellY - 1) * width + (centralCellX + 0)] = 1;
+	cells[(centralCellY + 1) * width + (centralCellX + 0)] = 1;
+	cells[(centralCellY + 0) * width + (centralCellX - 1)] = 1;
+	cells[(centralCellY + 0) * width + (centralCellX + 1)] = 1;
+
+	InitFromCells(cells.data(), width, height, width);
+}
+
+void CpuClickRule::InitFromCells(const uint8_t* cells, uint32_t width, uint32_t height, size_t rowPitch)
+{
+	mRows.clear();
+	mCellCount = 0;
+	mRadius    = 0;
+
+	//Same as BakeClickRuleCS: the click rule cell (x, y) makes the board cell (x0, y0) read the cell (x0 - (x - centerX), y0 + (y - centerY))
+	const int32_t centerX = (int32_t)(width  - 1) / 2;
+	const int32_t centerY = (int32_t)(height - 1) / 2;
+
+	for(uint32_t y = 0; y < height; y++)
+	{
+		CpuClickRuleRow clickRuleRow;
+		clickRuleRow.OffsetY    = (int32_t)y - centerY;
+		clickRuleRow.MaskX      = 0;
+		clickRuleRow.MinOffsetX = centerX - (int32_t)(width - 1);
+
+		for(uint32_t x = 0; x < width; x++)
+		{
+			if(cells[y * rowPitch + x] != 0)
+			{
+				int32_t offsetX = centerX - (int32_t)x;
+				clickRuleRow.OffsetsX.push_back(offsetX);
+
+				mRadius = std::max(mRadius, std::max(std::abs(offsetX), std::abs(clickRuleRow.OffsetY)));
+			}
+		}
+
+		if(!clickRuleRow.OffsetsX.empty())
+		{
+			//Click rules are at most 32 cells wide, so the whole row fits into a single mask
+			clickRuleRow.MinOffsetX = clickRuleRow.OffsetsX.back();
+			for(int32_t offsetX: clickRuleRow.OffsetsX)
+			{
+				clickRuleRow.MaskX |= 1ull << (offsetX - clickRuleRow.MinOffsetX);
+			}
+
+			mCellCount += (uint32_t)clickRuleRow.OffsetsX.size();
+			mRows.push_back(clickRuleRow);
+		}
+	}
+
+	mbIsCross = mCellCount == 5 && mRows.size() == 3
+	         && mRows[0].OffsetY == -1 && mRows[0].OffsetsX == std::vector<int32_t>{0}
+	         && mRows[1].OffsetY ==  0 && mRows[1].OffsetsX == std::vector<int32_t>{1, 0, -1}
+	         && mRows[2].OffsetY ==  1 && mRows[2].OffsetsX == std::vector<int32_t>{0};
+
+	InitFactors(centerX - (int32_t)(width - 1));
+}
+
+const std::vector<CpuClickRuleRow>& CpuClickRule::GetRows() const
+{
+	return mRows;
+}
+
+uint32_t CpuClickRule::GetCellCount() const
+{
+	return mCellCount;
+}
+
+int32_t CpuClickRule::GetRadius() const
+{
+	return mRadius;
+}
+
+bool CpuClickRule::IsCross() const
+{
+	return mbIsCross;
+}
+
+const std::vector<CpuClickRuleFactor>& CpuClickRule::GetFactors() const
+{
+	return mFactors;
+}
+
+bool CpuClickRule::IsSeparable() const
+{
+	return mbIsSeparable;
+}
+
+bool CpuClickRule::IsMirrorSymmetricX() const
+{
+	for(const CpuClickRuleRow& clickRuleRow: mRows)
+	{
+		std::vector<int32_t> mirroredOffsets(clickRuleRow.OffsetsX.size());
+		std::transform(clickRuleRow.OffsetsX.rbegin(), clickRuleRow.OffsetsX.rend(), mirroredOffsets.begin(), [](int32_t offsetX) {return -offsetX;});
+
+		//The offsets of a row are sorted in descending order, so the mirrored ones are too
+		if(mirroredOffsets != clickRuleRow.OffsetsX)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool CpuClickRule::IsMirrorSymmetricY() const
+{
+	//The rows are sorted by OffsetY
+	for(size_t i = 0; i < mRows.size(); i++)
+	{
+		const CpuClickRuleRow& clickRuleRow = mRows[i];
+		const CpuClickRuleRow& mirroredRow  = mRows[mRows.size() - 1 - i];
+		if(clickRuleRow.OffsetY != -mirroredRow.OffsetY || clickRuleRow.OffsetsX != mirroredRow.OffsetsX)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool CpuClickRule::IsTransposeSymmetric() const
+{
+	std::vector<std::pair<int32_t, int32_t>> offsets;
+	std::vector<std::pair<int32_t, int32_t>> transposedOffsets;
+	for(const CpuClickRuleRow& clickRuleRow: mRows)
+	{
+		for(int32_t offsetX: clickRuleRow.OffsetsX)
+		{
+			offsets.push_back({offsetX, clickRuleRow.OffsetY});
+			transposedOffsets.push_back({clickRuleRow.OffsetY, offsetX});
+		}
+	}
+
+	std::sort(offsets.begin(), offsets.end());
+	std::sort(transposedOffsets.begin(), transposedOffsets.end());
+	return offsets == transposedOffsets;
+}
+
+void CpuClickRule::InitFactors(int32_t minOffsetX)
+{
+	mFactors.clear();
+
+	//Gaussian elimination over GF(2) on the row masks. Linearly independent rows become the factors,
+	//every other row is the XOR of some of them. Each echelon row is zero in the pivots of all the previous ones
+	struct EchelonRow
+	{
+		uint64_t Bits;
+		uint64_t Factors; //Which factors Bits is the XOR of
+	};
+
+	std::vector<EchelonRow> echelonRows;
+	std::vector<uint64_t>   basisRows;
+	std::vector<uint64_t>   rowFactors(mRows.size(), 0);
+	for(size_t i = 0; i < mRows.size(); i++)
+	{
+		uint64_t rowBits = mRows[i].MaskX << (mRows[i].MinOffsetX - minOffsetX);
+
+		uint64_t bits    = rowBits;
+		uint64_t factors = 0;
+		for(const EchelonRow& echelonRow: echelonRows)
+		{
+			uint64_t pivot = echelonRow.Bits & (~echelonRow.Bits + 1);
+			if(bits & pivot)
+			{
+				bits    ^= echelonRow.Bits;
+				factors ^= echelonRow.Factors;
+			}
+		}
+
+		if(bits == 0)
+		{
+			rowFactors[i] = factors;
+		}
+		else
+		{
+			uint64_t newFactor = 1ull << basisRows.size();
+			echelonRows.push_back({bits, factors ^ newFactor});
+			basisRows.push_back(rowBits);
+
+			rowFactors[i] = newFactor;
+		}
+	}
+
+	uint32_t separableCost = 0;
+	for(size_t factorIndex = 0; factorIndex < basisRows.size(); factorIndex++)
+	{
+		CpuClickRuleFactor factor;
+		factor.MaskX      = basisRows[factorIndex];
+		factor.MinOffsetX = minOffsetX;
+		while(!(factor.MaskX & 1))
+		{
+			factor.MaskX >>= 1;
+			factor.MinOffsetX++;
+		}
+
+		for(size_t i = 0; i < mRows.size(); i++)
+		{
+			if(rowFactors[i] & (1ull << factorIndex))
+			{
+				factor.OffsetsY.push_back(mRows[i].OffsetY);
+			}
+		}
+
+		separableCost += gConvolvePassCost + (uint32_t)factor.OffsetsY.size();
+		mFactors.push_back(factor);
+	}
+
+	mbIsSeparable = separableCost < gConvolvePassCost * (uint32_t)mRows.size();
+}
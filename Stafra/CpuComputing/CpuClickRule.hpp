@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+//A single row of the click rule: the next state of the cell (x, y) gets XORed with the cells (x + OffsetsX[i], y + OffsetY)
+struct CpuClickRuleRow
+{
+	int32_t              OffsetY;
+	std::vector<int32_t> OffsetsX;
+
+	uint64_t MaskX;      //The same offsets as a bit mask: bit i is the offset (MinOffsetX + i)
+	int32_t  MinOffsetX;
+};
+
+//A rank 1 part of the click rule over GF(2): the next state of the cell (x, y) gets XORed with the cells (x + MinOffsetX + i, y + OffsetsY[j]) for every set bit i of MaskX.
+//The click rule is the XOR of all of its factors
+struct CpuClickRuleFactor
+{
+	std::vector<int32_t> OffsetsY;
+
+	uint64_t MaskX;
+	int32_t  MinOffsetX;
+};
+
+/*
+The class for storing a click rule on the CPU, as the offsets of the cells it reads.
+Input:               Click rule image (1 byte per cell)
+Output:              Click rule offsets grouped by rows, in the same order as BakeClickRuleCS appends them. Also the minimal rank decomposition of the click rule into separable factors
+Possible expansions: None ATM
+*/
+
+class CpuClickRule
+{
+public:
+	CpuClickRule();
+	~CpuClickRule();
+
+	void InitDefault();                                                                          //The "cross" click rule
+	void InitFromCells(const uint8_t* cells, uint32_t width, uint32_t height, size_t rowPitch); //Any non-zero cell is enabled
+
+	const std::vector<CpuClickRuleRow>& GetRows() const;
+
+	uint32_t GetCellCount() const;
+	int32_t  GetRadius()    const; //The largest absolute offset in any direction
+
+	bool IsCross() const; //True if the rule is exactly the default "cross" one, so the specialized kernel can be used
+
+	bool IsMirrorSymmetricX() const; //True if the offset (x, y) is in the rule whenever (-x, y) is
+	bool IsMirrorSymmetricY() const; //True if the offset (x, y) is in the rule whenever (x, -y) is
+	bool IsTransposeSymmetric() const; //True if the offset (x, y) is in the rule whenever (y, x) is
+
+	const std::vector<CpuClickRuleFactor>& GetFactors() const; //As many factors as the GF(2) rank of the click rule
+
+	bool IsSeparable() const; //True if applying the rule factor by factor (a horizontal pass, then a vertical one) is cheaper than row by row
+
+private:
+	void InitFactors(int32_t minOffsetX);
+
+private:
+	std::vector<CpuClickRuleRow>    mRows;
+	std::vector<CpuClickRuleFactor> mFactors;
+
+	uint32_t mCellCount;
+	int32_t  mRadius;
+
+	bool mbIsCross;
+	bool mbIsSeparable;
+};
@@ -0,0 +1,360 @@
+#include "CpuClickRuleSearch.hpp"
+#include "CpuStabilityCalculator.hpp"
+#include "CpuClickRule.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <set>
+
+namespace
+{
+	const uint32_t gMaxEnumeratedOrbits = 20;   //Up to about a million rules, more than that get sampled
+	const uint32_t gDefaultSampleCount  = 4096; //For the classes too big to enumerate
+	const uint32_t gSampleAttempts      = 8;    //Random rules tried per requested sample, the duplicates get skipped
+
+	const uint32_t gStepsPerCheck = 16; //Steps between the checks for the repeated or dead state
+
+	const int32_t gOffsetBias   = 16; //Packed offsets are (y + bias) * stride + (x + bias)
+	const int32_t gOffsetStride = 64;
+
+	int32_t PackOffset(int32_t x, int32_t y)
+	{
+		return (y + gOffsetBias) * gOffsetStride + (x + gOffsetBias);
+	}
+
+	int32_t UnpackOffsetX(int32_t packedOffset)
+	{
+		return packedOffset % gOffsetStride - gOffsetBias;
+	}
+
+	int32_t UnpackOffsetY(int32_t packedOffset)
+	{
+		return packedOffset / gOffsetStride - gOffsetBias;
+	}
+
+	//The symmetry i of the square: bit 0 negates x, bit 1 negates y, bit 2 swaps x and y
+	int32_t TransformOffset(int32_t packedOffset, uint32_t symmetryIndex)
+	{
+		int32_t x = UnpackOffsetX(packedOffset);
+		int32_t y = UnpackOffsetY(packedOffset);
+
+		if(symmetryIndex & 1)
+		{
+			x = -x;
+		}
+
+		if(symmetryIndex & 2)
+		{
+			y = -y;
+		}
+
+		if(symmetryIndex & 4)
+		{
+			std::swap(x, y);
+		}
+
+		return PackOffset(x, y);
+	}
+
+	uint32_t SymmetryCount(CpuRuleSymmetry symmetry)
+	{
+		switch(symmetry)
+		{
+		case CpuRuleSymmetry::Mirror:
+			return 4;
+		case CpuRuleSymmetry::Full:
+			return 8;
+		default:
+			break;
+		}
+
+		return 1;
+	}
+
+	bool IsBoardEmpty(const BitBoard& board)
+	{
+		for(uint32_t y = 0; y < board.GetHeight(); y++)
+		{
+			const uint64_t* row = board.Row((int32_t)y);
+			for(size_t i = 0; i < board.GetWordsPerRow(); i++)
+			{
+				if(row[i] != 0)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+}
+
+CpuClickRuleSearchParams::CpuClickRuleSearchParams(): Radius(1), Symmetry(CpuRuleSymmetry::None), SampleCount(0), BoardSize(63), MaxFrames(1024), ResultCount(16), Seed(1)
+{
+}
+
+CpuClickRuleSearch::CpuClickRuleSearch()
+{
+	SetThreadCount(0);
+}
+
+CpuClickRuleSearch::~CpuClickRuleSearch()
+{
+}
+
+void CpuClickRuleSearch::SetThreadCount(uint32_t threadCount)
+{
+	mThreadPool.reset();
+	mThreadPool = std::make_unique<ThreadPool>(threadCount);
+
+	//The boards are small, so each rule gets a whole thread instead of the tiles of a board
+	mCalculators.clear();
+	for(uint32_t i = 0; i < mThreadPool->GetThreadCount(); i++)
+	{
+		mCalculators.push_back(std::make_unique<CpuStabilityCalculator>());
+		mCalculators.back()->SetThreadCount(1);
+		mCalculators.back()->SetTrackStateHashes(true);
+	}
+}
+
+uint32_t CpuClickRuleSearch::Search(const CpuClickRuleSearchParams& params)
+{
+	mResults.clear();
+
+	std::vector<RuleKey> rules;
+	GenerateRules(params, rules);
+
+	std::vector<std::vector<CpuClickRuleSearchResult>> threadResults(mThreadPool->GetThreadCount());
+	mThreadPool->ParallelFor((uint32_t)rules.size(), [this, &rules, &params, &threadResults](uint32_t taskIndex, uint32_t threadIndex)
+	{
+		CpuClickRuleSearchResult result;
+		if(!EvaluateRule(rules[taskIndex], params, mCalculators[threadIndex].get(), result))
+		{
+			return;
+		}
+
+		//Each thread only keeps its best rules, so the memory doesn't grow with the sample count
+		std::vector<CpuClickRuleSearchResult>& bestResults = threadResults[threadIndex];
+		bestResults.push_back(std::move(result));
+		if(bestResults.size() >= 2 * (size_t)params.ResultCount + 1)
+		{
+			std::sort(bestResults.begin(), bestResults.end(), [](const CpuClickRuleSearchResult& left, const CpuClickRuleSearchResult& right)
+			{
+				return left.Score > right.Score;
+			});
+
+			bestResults.resize(params.ResultCount);
+		}
+	});
+
+	for(std::vector<CpuClickRuleSearchResult>& bestResults: threadResults)
+	{
+		std::move(bestResults.begin(), bestResults.end(), std::back_inserter(mResults));
+	}
+
+	std::stable_sort(mResults.begin(), mResults.end(), [](const CpuClickRuleSearchResult& left, const CpuClickRuleSearchResult& right)
+	{
+		return left.Score > right.Score;
+	});
+
+	if(mResults.size() > params.ResultCount)
+	{
+		mResults.resize(params.ResultCount);
+	}
+
+	return (uint32_t)rules.size();
+}
+
+const std::vector<CpuClickRuleSearchResult>& CpuClickRuleSearch::GetResults() const
+{
+	return mResults;
+}
+
+void CpuClickRuleSearch::GenerateRules(const CpuClickRuleSearchParams& params, std::vector<RuleKey>& outRules) const
+{
+	outRules.clear();
+
+	const int32_t radius = std::min(std::max(params.Radius, 1), (int32_t)ClickRuleSize / 2 - 1);
+
+	//The rules of the class are the unions of the orbits of the offsets under its symmetries
+	const uint32_t       symmetryCount = SymmetryCount(params.Symmetry);
+	std::vector<RuleKey> orbits;
+	std::set<int32_t>    visitedOffsets;
+	for(int32_t y = -radius; y <= radius; y++)
+	{
+		for(int32_t x = -radius; x <= radius; x++)
+		{
+			int32_t offset = PackOffset(x, y);
+			if(visitedOffsets.count(offset))
+			{
+				continue;
+			}
+
+			RuleKey orbit;
+			for(uint32_t symmetryIndex = 0; symmetryIndex < symmetryCount; symmetryIndex++)
+			{
+				int32_t image = TransformOffset(offset, symmetryIndex);
+				if(visitedOffsets.insert(image).second)
+				{
+					orbit.push_back(image);
+				}
+			}
+
+			orbits.push_back(orbit);
+		}
+	}
+
+	std::set<RuleKey> canonicalRules;
+	auto addRule = [&orbits, &canonicalRules](const std::vector<bool>& orbitSelection)
+	{
+		RuleKey rule;
+		for(size_t i = 0; i < orbits.size(); i++)
+		{
+			if(orbitSelection[i])
+			{
+				rule.insert(rule.end(), orbits[i].begin(), orbits[i].end());
+			}
+		}
+
+		if(!rule.empty())
+		{
+			std::sort(rule.begin(), rule.end());
+			canonicalRules.insert(CanonicalRule(rule));
+		}
+	};
+
+	std::vector<bool> orbitSelection(orbits.size(), false);
+	if(params.SampleCount == 0 && orbits.size() <= gMaxEnumeratedOrbits)
+	{
+		for(uint32_t selectionMask = 1; selectionMask < (1u << orbits.size()); selectionMask++)
+		{
+			for(size_t i = 0; i < orbits.size(); i++)
+			{
+				orbitSelection[i] = (selectionMask >> i) & 1;
+			}
+
+			addRule(orbitSelection);
+		}
+	}
+	else
+	{
+		//A random density per sample, so both the sparse and the dense rules get sampled
+		std::mt19937_64                        randomGenerator(params.Seed);
+		std::uniform_real_distribution<double> densityDistribution(0.0, 1.0);
+
+		uint32_t sampleCount = (params.SampleCount == 0) ? gDefaultSampleCount : params.SampleCount;
+		for(uint64_t attempt = 0; attempt < (uint64_t)sampleCount * gSampleAttempts && canonicalRules.size() < sampleCount; attempt++)
+		{
+			double density = densityDistribution(randomGenerator);
+			for(size_t i = 0; i < orbits.size(); i++)
+			{
+				orbitSelection[i] = densityDistribution(randomGenerator) < density;
+			}
+
+			addRule(orbitSelection);
+		}
+	}
+
+	outRules.assign(canonicalRules.begin(), canonicalRules.end());
+}
+
+bool CpuClickRuleSearch::EvaluateRule(const RuleKey& rule, const CpuClickRuleSearchParams& params, CpuStabilityCalculator* calculator, CpuClickRuleSearchResult& outResult) const
+{
+	//Same layout as CpuClickRule::InitFromCells() reads: the cell (x, y) is the offset (center - x, y - center)
+	const int32_t clickRuleCenter = (int32_t)(ClickRuleSize - 1) / 2;
+
+	outResult.Cells.assign(ClickRuleSize * ClickRuleSize, 0);
+	for(int32_t offset: rule)
+	{
+		int32_t cellX = clickRuleCenter - UnpackOffsetX(offset);
+		int32_t cellY = clickRuleCenter + UnpackOffsetY(offset);
+		outResult.Cells[cellY * ClickRuleSize + cellX] = 1;
+	}
+
+	CpuClickRule clickRule;
+	clickRule.InitFromCells(outResult.Cells.data(), ClickRuleSize, ClickRuleSize, ClickRuleSize);
+
+	const uint32_t boardSize = params.BoardSize;
+
+	std::vector<uint8_t> initialBoard((size_t)boardSize * boardSize, 0);
+	initialBoard[0]                                                   = 1;
+	initialBoard[boardSize - 1]                                       = 1;
+	initialBoard[(size_t)(boardSize - 1) * boardSize]                 = 1;
+	initialBoard[(size_t)(boardSize - 1) * boardSize + boardSize - 1] = 1;
+
+	calculator->PrepareForCalculations(initialBoard.data(), boardSize, boardSize, boardSize);
+	calculator->ReduceBySymmetry(&clickRule, nullptr);
+
+	const CpuCycleDetector& cycleDetector = calculator->GetCycleDetector();
+	while(calculator->GetCurrentStep() < params.MaxFrames && !cycleDetector.IsCycleFound())
+	{
+		calculator->StabilityNextSteps(std::min(gStepsPerCheck, params.MaxFrames - calculator->GetCurrentStep()), &clickRule, nullptr, 0);
+
+		//A dead board or a board with no stable cells left can't give anything but a blank image
+		if(IsBoardEmpty(calculator->GetLastBoardState()) || IsBoardEmpty(calculator->GetLastStabilityState()))
+		{
+			return false;
+		}
+	}
+
+	outResult.RepeatFrame = cycleDetector.IsCycleFound() ? cycleDetector.GetRepeatFrame() : calculator->GetCurrentStep();
+	outResult.Period      = cycleDetector.GetPeriod();
+
+	std::vector<uint16_t> stabilityCells((size_t)boardSize * boardSize);
+	calculator->CopyStabilityCells(stabilityCells.data(), boardSize);
+
+	uint64_t stableCount          = 0;
+	uint64_t mirrorMatchCounts[4] = {0, 0, 0, 0}; //Mirrored along x, along y, along the diagonal and along the antidiagonal, so the images of the rule get the same symmetry
+	for(uint32_t y = 0; y < boardSize; y++)
+	{
+		for(uint32_t x = 0; x < boardSize; x++)
+		{
+			if(stabilityCells[y * boardSize + x] == 0)
+			{
+				continue;
+			}
+
+			stableCount++;
+			mirrorMatchCounts[0] += (stabilityCells[y * boardSize + (boardSize - 1 - x)] != 0);
+			mirrorMatchCounts[1] += (stabilityCells[(boardSize - 1 - y) * boardSize + x] != 0);
+			mirrorMatchCounts[2] += (stabilityCells[x * boardSize + y] != 0);
+			mirrorMatchCounts[3] += (stabilityCells[(boardSize - 1 - x) * boardSize + (boardSize - 1 - y)] != 0);
+		}
+	}
+
+	const uint64_t cellCount = (uint64_t)boardSize * boardSize;
+	if(stableCount == 0 || stableCount == cellCount)
+	{
+		return false;
+	}
+
+	outResult.StableFraction = (float)((double)stableCount / (double)cellCount);
+	outResult.Symmetry       = (float)((double)(mirrorMatchCounts[0] + mirrorMatchCounts[1] + mirrorMatchCounts[2] + mirrorMatchCounts[3]) / (4.0 * (double)stableCount));
+
+	//The frame the state started repeating from, the rules that settle later have more to show
+	uint32_t settleFrame = outResult.RepeatFrame - outResult.Period;
+
+	double balance  = 1.0 - std::abs(2.0 * outResult.StableFraction - 1.0);
+	outResult.Score = (float)(balance * std::log2(2.0 + settleFrame) * outResult.Symmetry);
+	return true;
+}
+
+CpuClickRuleSearch::RuleKey CpuClickRuleSearch::CanonicalRule(const RuleKey& rule)
+{
+	RuleKey canonicalRule = rule;
+	for(uint32_t symmetryIndex = 1; symmetryIndex < 8; symmetryIndex++)
+	{
+		RuleKey image(rule.size());
+		std::transform(rule.begin(), rule.end(), image.begin(), [symmetryIndex](int32_t offset)
+		{
+			return TransformOffset(offset, symmetryIndex);
+		});
+
+		std::sort(image.begin(), image.end());
+		canonicalRule = std::min(canonicalRule, image);
+	}
+
+	return canonicalRule;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+class CpuStabilityCalculator;
+class ThreadPool;
+
+//The symmetry every searched click rule has
+enum class CpuRuleSymmetry
+{
+	None,   //Any rule
+	Mirror, //The offset (x, y) is in the rule whenever (-x, y) and (x, -y) are
+	Full    //Symmetric under all 8 symmetries of the square
+};
+
+struct CpuClickRuleSearchParams
+{
+	CpuClickRuleSearchParams();
+
+	int32_t         Radius;      //The rules only use the offsets within the radius, from 1 to 15
+	CpuRuleSymmetry Symmetry;
+	uint32_t        SampleCount; //The number of random rules to evaluate, 0 means every rule of the class if there are few enough of them
+	uint32_t        BoardSize;   //The rules are evaluated on the "4 corners" board of this size
+	uint32_t        MaxFrames;   //The rules that don't repeat by this frame are scored at it
+	uint32_t        ResultCount; //The number of the best rules to keep
+	uint64_t        Seed;
+};
+
+struct CpuClickRuleSearchResult
+{
+	std::vector<uint8_t> Cells; //ClickRuleSize x ClickRuleSize, 1 for the enabled cells. The same layout ClickRule.png is loaded into
+
+	uint32_t RepeatFrame;    //The frame the board and the stability repeated at, MaxFrames if they didn't
+	uint32_t Period;         //0 if they didn't repeat
+	float    StableFraction; //The fraction of the stable cells at the last frame
+	float    Symmetry;       //The fraction of the stable cells that match their mirror images, averaged over the mirrors of the square
+	float    Score;
+};
+
+/*
+The class for finding click rules with interesting stability fractals.
+Input:               Radius and symmetry class of the rules, number of samples
+Output:              The best rules with their scores
+Possible expansions: Scoring by the fractal dimension of the stability, searching around a given rule
+
+Every rule is stored in the canonical form: the smallest of its 8 images under the symmetries of the square, since the "4 corners" board
+has all of them and the image of the rule gives the same image of the fractal. Each distinct rule is then simulated once on its own thread.
+The simulation stops as soon as the board and the stability repeat or the board dies out. The rules with no stable cells or no unstable cells
+are dropped, the rest are ordered by the score: the balance of stable and unstable cells, times the log of the frames it took to settle, times the symmetry
+*/
+
+class CpuClickRuleSearch
+{
+	typedef std::vector<int32_t> RuleKey; //The sorted packed offsets of the rule
+
+public:
+	static const uint32_t ClickRuleSize = 32;
+
+	CpuClickRuleSearch();
+	~CpuClickRuleSearch();
+
+	void SetThreadCount(uint32_t threadCount); //0 means one thread per hardware thread
+
+	uint32_t Search(const CpuClickRuleSearchParams& params); //Returns the number of distinct rules evaluated
+
+	const std::vector<CpuClickRuleSearchResult>& GetResults() const; //Best first
+
+private:
+	void GenerateRules(const CpuClickRuleSearchParams& params, std::vector<RuleKey>& outRules) const;
+	bool EvaluateRule(const RuleKey& rule, const CpuClickRuleSearchParams& params, CpuStabilityCalculator* calculator, CpuClickRuleSearchResult& outResult) const; //False if the rule is trivial
+
+	static RuleKey CanonicalRule(const RuleKey& rule);
+
+private:
+	std::unique_ptr<ThreadPool>                          mThreadPool;
+	std::vector<std::unique_ptr<CpuStabilityCalculator>> mCalculators; //One single-threaded calculator per thread
+
+	std::vector<CpuClickRuleSearchResult> mResults;
+};
@@ -0,0 +1,70 @@
+#include "CpuCycleDetector.hpp"
+
+CpuCycleDetector::CpuCycleDetector()
+{
+	Reset();
+}
+
+CpuCycleDetector::~CpuCycleDetector()
+{
+}
+
+void CpuCycleDetector::Reset()
+{
+	mSavedHash  = 0;
+	mSavedFrame = 0;
+	mLastFrame  = 0;
+	mPower      = 1;
+	mbHasState  = false;
+
+	mPeriod      = 0;
+	mRepeatFrame = 0;
+}
+
+void CpuCycleDetector::AddState(uint32_t frame, uint64_t stateHash)
+{
+	if(mPeriod != 0)
+	{
+		return;
+	}
+
+	if(!mbHasState || frame != mLastFrame + 1)
+	{
+		mSavedHash  = stateHash;
+		mSavedFrame = frame;
+		mLastFrame  = frame;
+		mPower      = 1;
+		mbHasState  = true;
+		return;
+	}
+
+	mLastFrame = frame;
+	if(stateHash == mSavedHash)
+	{
+		mPeriod      = frame - mSavedFrame;
+		mRepeatFrame = frame;
+		return;
+	}
+
+	if(frame - mSavedFrame == mPower)
+	{
+		mSavedHash  = stateHash;
+		mSavedFrame = frame;
+		mPower     *= 2;
+	}
+}
+
+bool CpuCycleDetector::IsCycleFound() const
+{
+	return mPeriod != 0;
+}
+
+uint32_t CpuCycleDetector::GetPeriod() const
+{
+	return mPeriod;
+}
+
+uint32_t CpuCycleDetector::GetRepeatFrame() const
+{
+	return mRepeatFrame;
+}
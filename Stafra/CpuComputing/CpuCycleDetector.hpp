@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+The class for finding the first repeated state in a sequence of state hashes, with the Brent's cycle detection.
+Input:               The hash of each frame, in order
+Output:              The period of the sequence once a state hash repeats
+Possible expansions: Storing several hashes to find the cycle sooner
+
+Only one hash is stored: it's replaced with the current one whenever the distance to it reaches the next power of 2.
+A cycle is found within about 4 * max(preperiod, period) frames from the first one, and the first match is at the distance of the period exactly.
+A repeated hash can also be a collision: the found period has to be confirmed by comparing the states themselves before relying on it
+*/
+
+class CpuCycleDetector
+{
+public:
+	CpuCycleDetector();
+	~CpuCycleDetector();
+
+	void Reset();
+	void AddState(uint32_t frame, uint64_t stateHash); //A frame that doesn't follow the previous one restarts the detection from it
+
+	bool     IsCycleFound()   const;
+	uint32_t GetPeriod()      const; //0 if no state repeated yet
+	uint32_t GetRepeatFrame() const; //The frame the repeated state was found at
+
+private:
+	uint64_t mSavedHash;
+	uint32_t mSavedFrame;
+	uint32_t mLastFrame;
+	uint32_t mPower;
+	bool     mbHasState;
+
+	uint32_t mPeriod;
+	uint32_t mRepeatFrame;
+};
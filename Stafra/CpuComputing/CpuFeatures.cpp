@@ -0,0 +1,114 @@
+#include "CpuFeatures.hpp"
+#include <cstdint>
+
+#if defined(STAFRA_CPU_X86)
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+namespace
+{
+#if defined(STAFRA_CPU_X86)
+	void CpuId(uint32_t leaf, uint32_t subleaf, uint32_t outRegs[4])
+	{
+#if defined(_MSC_VER)
+		int regs[4];
+		__cpuidex(regs, (int)leaf, (int)subleaf);
+
+		for(int i = 0; i < 4; i++)
+		{
+			outRegs[i] = (uint32_t)regs[i];
+		}
+#else
+		__cpuid_count(leaf, subleaf, outRegs[0], outRegs[1], outRegs[2], outRegs[3]);
+#endif
+	}
+
+	uint64_t ReadXCR0()
+	{
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		uint32_t eax = 0;
+		uint32_t edx = 0;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0)); //Not _xgetbv(), it needs -mxsave for the whole file
+		return ((uint64_t)edx << 32) | eax;
+#endif
+	}
+#endif
+}
+
+CpuInstructionSet CpuFeatures::DetectInstructionSet()
+{
+#if defined(STAFRA_CPU_X86)
+	uint32_t regs[4] = {0, 0, 0, 0};
+
+	CpuId(0, 0, regs);
+	uint32_t maxLeaf = regs[0];
+	if(maxLeaf < 1)
+	{
+		return CpuInstructionSet::SCALAR;
+	}
+
+	CpuId(1, 0, regs);
+	bool sse2    = (regs[3] & (1u << 26)) != 0;
+	bool pclmul  = (regs[2] & (1u <<  1)) != 0;
+	bool osxsave = (regs[2] & (1u << 27)) != 0;
+	bool avx     = (regs[2] & (1u << 28)) != 0;
+
+	if(!sse2)
+	{
+		return CpuInstructionSet::SCALAR;
+	}
+
+	if(!osxsave || !avx || maxLeaf < 7)
+	{
+		return CpuInstructionSet::SSE2;
+	}
+
+	//The OS has to save the YMM (and ZMM) registers on context switches, otherwise the wide kernels will crash
+	uint64_t xcr0       = ReadXCR0();
+	bool     osYmmState = (xcr0 & 0x06) == 0x06;
+	bool     osZmmState = (xcr0 & 0xe6) == 0xe6;
+
+	CpuId(7, 0, regs);
+	bool avx2     = (regs[1] & (1u <<  5)) != 0;
+	bool avx512f  = (regs[1] & (1u << 16)) != 0;
+	bool avx512bw = (regs[1] & (1u << 30)) != 0;
+
+	if(avx2 && pclmul && avx512f && avx512bw && osZmmState)
+	{
+		return CpuInstructionSet::AVX512;
+	}
+	else if(avx2 && pclmul && osYmmState)
+	{
+		return CpuInstructionSet::AVX2;
+	}
+
+	return CpuInstructionSet::SSE2;
+#else
+	return CpuInstructionSet::SCALAR;
+#endif
+}
+
+std::string CpuFeatures::InstructionSetName(CpuInstructionSet instructionSet)
+{
+	switch(instructionSet)
+	{
+	case CpuInstructionSet::SCALAR:
+		return "Scalar";
+	case CpuInstructionSet::SSE2:
+		return "SSE2";
+	case CpuInstructionSet::AVX2:
+		return "AVX2";
+	case CpuInstructionSet::AVX512:
+		return "AVX-512";
+	default:
+		break;
+	}
+
+	return "";
+}
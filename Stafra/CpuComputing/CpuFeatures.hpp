@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define STAFRA_CPU_X86 1
+#endif
+
+//The instruction sets the CPU kernels are compiled for, from the slowest to the fastest
+enum class CpuInstructionSet
+{
+	SCALAR,
+	SSE2,
+	AVX2,
+	AVX512
+};
+
+namespace CpuFeatures
+{
+	CpuInstructionSet DetectInstructionSet(); //Returns the widest instruction set supported both by the CPU and the OS
+
+	std::string InstructionSetName(CpuInstructionSet instructionSet);
+}
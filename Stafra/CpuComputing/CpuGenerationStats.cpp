@@ -0,0 +1,108 @@
+#include "CpuGenerationStats.hpp"
+#include <algorithm>
+#include <ostream>
+
+const uint32_t CpuGenerationCounts::NoCell;
+
+CpuGenerationCounts::CpuGenerationCounts()
+{
+	Reset();
+}
+
+void CpuGenerationCounts::Reset()
+{
+	StableCount  = 0;
+	ChangedCount = 0;
+	LitCount     = 0;
+
+	StableMinX = NoCell;
+	StableMinY = NoCell;
+	StableMaxX = NoCell;
+	StableMaxY = NoCell;
+
+	StateHash = 0;
+}
+
+void CpuGenerationCounts::Merge(const CpuGenerationCounts& other)
+{
+	StableCount  += other.StableCount;
+	ChangedCount += other.ChangedCount;
+	LitCount     += other.LitCount;
+	StateHash    ^= other.StateHash;
+
+	if(other.StableMinX == NoCell)
+	{
+		return;
+	}
+
+	if(StableMinX == NoCell)
+	{
+		StableMinX = other.StableMinX;
+		StableMinY = other.StableMinY;
+		StableMaxX = other.StableMaxX;
+		StableMaxY = other.StableMaxY;
+		return;
+	}
+
+	StableMinX = std::min(StableMinX, other.StableMinX);
+	StableMinY = std::min(StableMinY, other.StableMinY);
+	StableMaxX = std::max(StableMaxX, other.StableMaxX);
+	StableMaxY = std::max(StableMaxY, other.StableMaxY);
+}
+
+void CpuGenerationCounts::AddStableSpan(uint32_t minX, uint32_t maxX, uint32_t y)
+{
+	CpuGenerationCounts spanCounts;
+	spanCounts.StableMinX = minX;
+	spanCounts.StableMinY = y;
+	spanCounts.StableMaxX = maxX;
+	spanCounts.StableMaxY = y;
+	Merge(spanCounts);
+}
+
+CpuGenerationStats::CpuGenerationStats()
+{
+}
+
+CpuGenerationStats::~CpuGenerationStats()
+{
+}
+
+void CpuGenerationStats::Append(uint32_t frame, const CpuGenerationCounts& counts)
+{
+	mFrames.push_back(frame);
+	mCounts.push_back(counts);
+}
+
+void CpuGenerationStats::Clear()
+{
+	mFrames.clear();
+	mCounts.clear();
+}
+
+size_t CpuGenerationStats::GetGenerationCount() const
+{
+	return mFrames.size();
+}
+
+bool CpuGenerationStats::WriteCsv(std::ostream& stream) const
+{
+	stream << "Frame,Stable,Changed,Lit,StableMinX,StableMinY,StableMaxX,StableMaxY\n";
+	for(size_t i = 0; i < mFrames.size(); i++)
+	{
+		const CpuGenerationCounts& counts = mCounts[i];
+		stream << mFrames[i] << ',' << counts.StableCount << ',' << counts.ChangedCount << ',' << counts.LitCount;
+
+		//An empty stable region has no bounding box
+		if(counts.StableMinX == CpuGenerationCounts::NoCell)
+		{
+			stream << ",,,,\n";
+		}
+		else
+		{
+			stream << ',' << counts.StableMinX << ',' << counts.StableMinY << ',' << counts.StableMaxX << ',' << counts.StableMaxY << '\n';
+		}
+	}
+
+	return (bool)stream;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <iosfwd>
+
+//Counts of a single generation, accumulated row by row while the generation is computed
+struct CpuGenerationCounts
+{
+	static const uint32_t NoCell = UINT32_MAX; //The bounding box of the stable cells when there are none
+
+	CpuGenerationCounts();
+
+	void Reset();
+	void Merge(const CpuGenerationCounts& other);
+
+	void AddStableSpan(uint32_t minX, uint32_t maxX, uint32_t y); //Extends the bounding box of the stable cells
+
+	uint64_t StableCount;  //Cells with the stability of 1
+	uint64_t ChangedCount; //Cells that flipped in this generation
+	uint64_t LitCount;     //Cells that are 1 on the board after this generation
+
+	uint32_t StableMinX; //The bounding box of the stable cells, inclusive
+	uint32_t StableMinY;
+	uint32_t StableMaxX;
+	uint32_t StableMaxY;
+
+	uint64_t StateHash; //XOR of the hashes of the board and stability words together with their positions, so it doesn't depend on the order the rows are added in
+};
+
+/*
+The class for storing the statistics of every computed generation.
+Input:               Counts of each generation
+Output:              A CSV table with a line per generation
+Possible expansions: Binary output, histograms of spawn stability values
+*/
+
+class CpuGenerationStats
+{
+public:
+	CpuGenerationStats();
+	~CpuGenerationStats();
+
+	void Append(uint32_t frame, const CpuGenerationCounts& counts);
+	void Clear();
+
+	size_t GetGenerationCount() const;
+
+	bool WriteCsv(std::ostream& stream) const;
+
+private:
+	std::vector<uint32_t>            mFrames;
+	std::vector<CpuGenerationCounts> mCounts;
+};
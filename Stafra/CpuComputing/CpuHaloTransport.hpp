@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+//The slabs next to the current one, the upper one owns the rows above it
+enum class CpuSlabNeighbor
+{
+	Upper,
+	Lower
+};
+
+/*
+The interface for exchanging the halo rows between the slabs of a board split into several processes.
+Input:               The rows to send to a neighbor slab
+Output:              The rows received from a neighbor slab
+Possible expansions: Shared memory transport, MPI transport
+
+Both calls block until all of the data is sent or received.
+*/
+
+class CpuHaloTransport
+{
+public:
+	CpuHaloTransport()          = default;
+	virtual ~CpuHaloTransport() = default;
+
+	virtual bool Send(CpuSlabNeighbor neighbor, const void* data, size_t size) = 0; //False if the connection is lost
+	virtual bool Receive(CpuSlabNeighbor neighbor, void* data, size_t size)    = 0; //False if the connection is lost
+};
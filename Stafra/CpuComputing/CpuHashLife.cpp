@@ -0,0 +1,626 @@
+#include "CpuHashLife.hpp"
+#include "CpuClickRule.hpp"
+#include <algorithm>
+
+namespace
+{
+	const uint32_t gLeafLevel = 3; //8x8 cells, one 64-bit word
+	const uint32_t gBaseLevel = 4; //The smallest node that is computed directly, from its 4 leaves
+
+	const int32_t gMaxRadius = 1 << (gBaseLevel - 2); //The smallest node has to be computed at least one step ahead
+
+	const size_t   gMaxNodeCount        = 1 << 22; //Everything but the current state is freed after that many nodes
+	const uint64_t gMinHitRateLookups   = 1 << 16; //Fewer lookups are too few to judge the hit rate
+	const uint64_t gMinHitRateDivisor   = 2;       //The steps are left to the flat computations once less than half of the results get reused. Even chaotic boards reuse about a third
+
+	uint64_t MixHash(uint64_t value)
+	{
+		value ^= value >> 33;
+		value *= 0xff51afd7ed558ccdull;
+		value ^= value >> 33;
+		value *= 0xc4ceb9fe1a85ec53ull;
+		value ^= value >> 33;
+		return value;
+	}
+
+	uint32_t LeafRow(uint64_t cells, uint32_t y)
+	{
+		return (uint32_t)(cells >> (y * 8)) & 0xff;
+	}
+}
+
+bool CpuHashLife::NodeKey::operator==(const NodeKey& other) const
+{
+	return std::equal(Children, Children + 4, other.Children);
+}
+
+bool CpuHashLife::ResultKey::operator==(const ResultKey& other) const
+{
+	return Board == other.Board && Restriction == other.Restriction && Log2Steps == other.Log2Steps;
+}
+
+size_t CpuHashLife::KeyHash::operator()(const NodeKey& key) const
+{
+	uint64_t upperHalf = ((uint64_t)key.Children[0] << 32) | key.Children[1];
+	uint64_t lowerHalf = ((uint64_t)key.Children[2] << 32) | key.Children[3];
+	return (size_t)MixHash(upperHalf ^ MixHash(lowerHalf));
+}
+
+size_t CpuHashLife::KeyHash::operator()(const ResultKey& key) const
+{
+	uint64_t nodes = ((uint64_t)key.Board << 32) | key.Restriction;
+	return (size_t)MixHash(nodes ^ MixHash(key.Log2Steps));
+}
+
+CpuHashLife::CpuHashLife(): mRadiusLog2(0), mWidth(0), mHeight(0), mBoardRoot(0), mRestrictionRoot(0), mStabilityRoot(0), mRootLevel(gBaseLevel), mOrigin(0),
+                            mResultLookups(0), mResultHits(0), mbOutOfMemory(false), mbGaveUp(false)
+{
+}
+
+CpuHashLife::~CpuHashLife()
+{
+}
+
+bool CpuHashLife::IsSupported(const CpuClickRule* clickRule)
+{
+	return !clickRule || clickRule->GetRadius() <= gMaxRadius;
+}
+
+void CpuHashLife::Init(const BitBoard& board, const BitBoard& stability, const CpuClickRule* clickRule, const BitBoard* restriction)
+{
+	mRuleOffsets.clear();
+	if(clickRule)
+	{
+		for(const CpuClickRuleRow& clickRuleRow: clickRule->GetRows())
+		{
+			for(int32_t offsetX: clickRuleRow.OffsetsX)
+			{
+				mRuleOffsets.push_back({offsetX, clickRuleRow.OffsetY});
+			}
+		}
+	}
+	else
+	{
+		mRuleOffsets = {{0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+	}
+
+	int32_t radius = clickRule ? std::max(clickRule->GetRadius(), 1) : 1;
+
+	mRadiusLog2 = 0;
+	while((1 << mRadiusLog2) < radius)
+	{
+		mRadiusLog2++;
+	}
+
+	mWidth  = board.GetWidth();
+	mHeight = board.GetHeight();
+
+	Clear();
+
+	mRootLevel = gBaseLevel;
+	while((1ull << mRootLevel) < std::max(mWidth, mHeight))
+	{
+		mRootLevel++;
+	}
+
+	mOrigin          = 0;
+	mBoardRoot       = ImportPlane(&board,      mRootLevel, 0, 0);
+	mStabilityRoot   = ImportPlane(&stability,  mRootLevel, 0, 0);
+	mRestrictionRoot = ImportPlane(restriction, mRootLevel, 0, 0);
+}
+
+uint32_t CpuHashLife::Advance(uint32_t stepCount)
+{
+	uint32_t doneSteps = 0;
+	for(uint32_t log2Steps = 0; log2Steps < 32; log2Steps++)
+	{
+		if(((stepCount >> log2Steps) & 1) == 0)
+		{
+			continue;
+		}
+
+		if(mNodes.size() > gMaxNodeCount)
+		{
+			Rebuild();
+		}
+
+		//The root is computed as the center of a twice as large node, which has to be large enough for the steps
+		while(MaxLog2Steps(mRootLevel + 1) < log2Steps)
+		{
+			mBoardRoot       = ExpandNode(mBoardRoot);
+			mRestrictionRoot = ExpandNode(mRestrictionRoot);
+			mStabilityRoot   = ExpandNode(mStabilityRoot);
+
+			mOrigin += 1ull << (mRootLevel - 1);
+			mRootLevel++;
+		}
+
+		mResultLookups = 0;
+		mResultHits    = 0;
+
+		NodeResult result = AdvanceNode(ExpandNode(mBoardRoot), ExpandNode(mRestrictionRoot), log2Steps);
+		if(mbOutOfMemory)
+		{
+			mbOutOfMemory = false;
+			Rebuild();
+			return doneSteps;
+		}
+
+		if(mbGaveUp)
+		{
+			mbGaveUp = false;
+			return doneSteps;
+		}
+
+		mBoardRoot     = result.Board;
+		mStabilityRoot = AndNodes(mStabilityRoot, result.Stability);
+		doneSteps     += 1u << log2Steps;
+	}
+
+	return doneSteps;
+}
+
+void CpuHashLife::GetBoard(BitBoard& outBoard) const
+{
+	outBoard.Clear();
+	ExportPlane(mBoardRoot, 0, 0, outBoard);
+}
+
+void CpuHashLife::GetStability(BitBoard& outStability) const
+{
+	outStability.Clear();
+	ExportPlane(mStabilityRoot, 0, 0, outStability);
+}
+
+size_t CpuHashLife::GetNodeCount() const
+{
+	return mNodes.size();
+}
+
+void CpuHashLife::Clear()
+{
+	mNodes.clear();
+	mZeroNodes.clear();
+	mOnesNodes.clear();
+
+	mLeafIndices.clear();
+	mNodeIndices.clear();
+	mResults.clear();
+	mAndResults.clear();
+}
+
+void CpuHashLife::Rebuild()
+{
+	BitBoard board(mWidth, mHeight);
+	BitBoard stability(mWidth, mHeight);
+	BitBoard restriction(mWidth, mHeight);
+	GetBoard(board);
+	GetStability(stability);
+	ExportPlane(mRestrictionRoot, 0, 0, restriction);
+
+	Clear();
+
+	mRootLevel = gBaseLevel;
+	while((1ull << mRootLevel) < std::max(mWidth, mHeight))
+	{
+		mRootLevel++;
+	}
+
+	mOrigin          = 0;
+	mBoardRoot       = ImportPlane(&board,       mRootLevel, 0, 0);
+	mStabilityRoot   = ImportPlane(&stability,   mRootLevel, 0, 0);
+	mRestrictionRoot = ImportPlane(&restriction, mRootLevel, 0, 0);
+}
+
+uint32_t CpuHashLife::MakeLeaf(uint64_t cells)
+{
+	auto leafIt = mLeafIndices.find(cells);
+	if(leafIt != mLeafIndices.end())
+	{
+		return leafIt->second;
+	}
+
+	QuadNode leaf = {{0, 0, 0, 0}, cells, gLeafLevel};
+	mNodes.push_back(leaf);
+
+	uint32_t leafIndex = (uint32_t)(mNodes.size() - 1);
+	mLeafIndices[cells] = leafIndex;
+	return leafIndex;
+}
+
+uint32_t CpuHashLife::MakeNode(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se)
+{
+	NodeKey key = {{nw, ne, sw, se}};
+
+	auto nodeIt = mNodeIndices.find(key);
+	if(nodeIt != mNodeIndices.end())
+	{
+		return nodeIt->second;
+	}
+
+	QuadNode node = {{nw, ne, sw, se}, 0, mNodes[nw].Level + 1};
+	mNodes.push_back(node);
+
+	uint32_t nodeIndex = (uint32_t)(mNodes.size() - 1);
+	mNodeIndices[key] = nodeIndex;
+	return nodeIndex;
+}
+
+uint32_t CpuHashLife::ZeroNode(uint32_t level)
+{
+	if(level >= mZeroNodes.size())
+	{
+		mZeroNodes.resize(level + 1, UINT32_MAX);
+	}
+
+	if(mZeroNodes[level] == UINT32_MAX)
+	{
+		uint32_t zeroNode = 0;
+		if(level == gLeafLevel)
+		{
+			zeroNode = MakeLeaf(0);
+		}
+		else
+		{
+			uint32_t zeroChild = ZeroNode(level - 1);
+			zeroNode = MakeNode(zeroChild, zeroChild, zeroChild, zeroChild);
+		}
+
+		mZeroNodes[level] = zeroNode;
+	}
+
+	return mZeroNodes[level];
+}
+
+uint32_t CpuHashLife::OnesNode(uint32_t level)
+{
+	if(level >= mOnesNodes.size())
+	{
+		mOnesNodes.resize(level + 1, UINT32_MAX);
+	}
+
+	if(mOnesNodes[level] == UINT32_MAX)
+	{
+		uint32_t onesNode = 0;
+		if(level == gLeafLevel)
+		{
+			onesNode = MakeLeaf(~0ull);
+		}
+		else
+		{
+			uint32_t onesChild = OnesNode(level - 1);
+			onesNode = MakeNode(onesChild, onesChild, onesChild, onesChild);
+		}
+
+		mOnesNodes[level] = onesNode;
+	}
+
+	return mOnesNodes[level];
+}
+
+uint32_t CpuHashLife::ExpandNode(uint32_t node)
+{
+	const QuadNode quadNode = mNodes[node];
+
+	uint32_t zero = ZeroNode(quadNode.Level - 1);
+	uint32_t nw   = MakeNode(zero, zero, zero, quadNode.Children[0]);
+	uint32_t ne   = MakeNode(zero, zero, quadNode.Children[1], zero);
+	uint32_t sw   = MakeNode(zero, quadNode.Children[2], zero, zero);
+	uint32_t se   = MakeNode(quadNode.Children[3], zero, zero, zero);
+	return MakeNode(nw, ne, sw, se);
+}
+
+uint32_t CpuHashLife::CenterNode(uint32_t node)
+{
+	const QuadNode quadNode = mNodes[node];
+
+	const QuadNode& nw = mNodes[quadNode.Children[0]];
+	const QuadNode& ne = mNodes[quadNode.Children[1]];
+	const QuadNode& sw = mNodes[quadNode.Children[2]];
+	const QuadNode& se = mNodes[quadNode.Children[3]];
+	if(quadNode.Level == gBaseLevel)
+	{
+		//Rows 4-7 of the upper leaves and rows 0-3 of the lower ones, columns 4-7 of the left leaves and columns 0-3 of the right ones
+		uint64_t cells = 0;
+		for(uint32_t y = 0; y < 4; y++)
+		{
+			uint64_t upperRow = (LeafRow(nw.Cells, y + 4) >> 4) | ((LeafRow(ne.Cells, y + 4) & 0x0f) << 4);
+			uint64_t lowerRow = (LeafRow(sw.Cells, y)     >> 4) | ((LeafRow(se.Cells, y)     & 0x0f) << 4);
+
+			cells |= upperRow << (y * 8);
+			cells |= lowerRow << ((y + 4) * 8);
+		}
+
+		return MakeLeaf(cells);
+	}
+
+	return MakeNode(nw.Children[3], ne.Children[2], sw.Children[1], se.Children[0]);
+}
+
+uint32_t CpuHashLife::AndNodes(uint32_t a, uint32_t b)
+{
+	const QuadNode nodeA = mNodes[a];
+	const QuadNode nodeB = mNodes[b];
+	if(a == b || b == OnesNode(nodeA.Level) || a == ZeroNode(nodeA.Level))
+	{
+		return a;
+	}
+
+	if(a == OnesNode(nodeA.Level) || b == ZeroNode(nodeA.Level))
+	{
+		return b;
+	}
+
+	if(nodeA.Level == gLeafLevel)
+	{
+		return MakeLeaf(nodeA.Cells & nodeB.Cells);
+	}
+
+	uint64_t andKey = ((uint64_t)std::min(a, b) << 32) | std::max(a, b);
+
+	auto andIt = mAndResults.find(andKey);
+	if(andIt != mAndResults.end())
+	{
+		return andIt->second;
+	}
+
+	uint32_t children[4];
+	for(int i = 0; i < 4; i++)
+	{
+		children[i] = AndNodes(nodeA.Children[i], nodeB.Children[i]);
+	}
+
+	uint32_t andNode = MakeNode(children[0], children[1], children[2], children[3]);
+	mAndResults[andKey] = andNode;
+	return andNode;
+}
+
+CpuHashLife::NodeResult CpuHashLife::AdvanceNode(uint32_t board, uint32_t restriction, uint32_t log2Steps)
+{
+	const uint32_t level = mNodes[board].Level;
+	if(mbOutOfMemory || mbGaveUp)
+	{
+		return {ZeroNode(level - 1), ZeroNode(level - 1)};
+	}
+
+	//Nothing outside the restriction is ever read, so the board becomes empty after the first step
+	if(restriction == ZeroNode(level))
+	{
+		return {ZeroNode(level - 1), ZeroNode(level - 1)};
+	}
+
+	ResultKey key = {board, restriction, log2Steps};
+
+	mResultLookups++;
+	auto resultIt = mResults.find(key);
+	if(resultIt != mResults.end())
+	{
+		mResultHits++;
+		return resultIt->second;
+	}
+
+	if(mResultLookups >= gMinHitRateLookups && mResultHits * gMinHitRateDivisor < mResultLookups)
+	{
+		mbGaveUp = true;
+		return {ZeroNode(level - 1), ZeroNode(level - 1)};
+	}
+
+	if(level == gBaseLevel)
+	{
+		NodeResult result = AdvanceLeaves(board, restriction, log2Steps);
+		mResults[key] = result;
+		return result;
+	}
+
+	//9 overlapping nodes of half the size, made of the grandchildren
+	uint32_t boardGrid[4][4];
+	uint32_t restrictionGrid[4][4];
+	for(uint32_t y = 0; y < 4; y++)
+	{
+		for(uint32_t x = 0; x < 4; x++)
+		{
+			uint32_t childIndex      = (y / 2) * 2 + (x / 2);
+			uint32_t grandchildIndex = (y % 2) * 2 + (x % 2);
+
+			boardGrid[y][x]       = mNodes[mNodes[board].Children[childIndex]].Children[grandchildIndex];
+			restrictionGrid[y][x] = mNodes[mNodes[restriction].Children[childIndex]].Children[grandchildIndex];
+		}
+	}
+
+	//Either both halves of the steps are done, each by a node of half the size, or the first half is skipped and the whole steps are done by the second one
+	const bool bothHalves = (log2Steps == MaxLog2Steps(level));
+
+	NodeResult firstResults[3][3];
+	uint32_t   restrictionCenters[3][3];
+	for(uint32_t y = 0; y < 3; y++)
+	{
+		for(uint32_t x = 0; x < 3; x++)
+		{
+			uint32_t boardPart       = MakeNode(boardGrid[y][x],       boardGrid[y][x + 1],       boardGrid[y + 1][x],       boardGrid[y + 1][x + 1]);
+			uint32_t restrictionPart = MakeNode(restrictionGrid[y][x], restrictionGrid[y][x + 1], restrictionGrid[y + 1][x], restrictionGrid[y + 1][x + 1]);
+			if(bothHalves)
+			{
+				firstResults[y][x] = AdvanceNode(boardPart, restrictionPart, log2Steps - 1);
+			}
+			else
+			{
+				firstResults[y][x] = {CenterNode(boardPart), OnesNode(level - 2)};
+			}
+
+			restrictionCenters[y][x] = CenterNode(restrictionPart);
+		}
+	}
+
+	uint32_t secondBoards[4];
+	uint32_t secondStabilities[4];
+	for(uint32_t quadrant = 0; quadrant < 4; quadrant++)
+	{
+		uint32_t y = quadrant / 2;
+		uint32_t x = quadrant % 2;
+
+		uint32_t boardPart       = MakeNode(firstResults[y][x].Board,   firstResults[y][x + 1].Board,   firstResults[y + 1][x].Board,   firstResults[y + 1][x + 1].Board);
+		uint32_t restrictionPart = MakeNode(restrictionCenters[y][x],   restrictionCenters[y][x + 1],   restrictionCenters[y + 1][x],   restrictionCenters[y + 1][x + 1]);
+
+		NodeResult secondResult = AdvanceNode(boardPart, restrictionPart, bothHalves ? log2Steps - 1 : log2Steps);
+		secondBoards[quadrant]      = secondResult.Board;
+		secondStabilities[quadrant] = secondResult.Stability;
+		if(bothHalves)
+		{
+			uint32_t firstStability = MakeNode(firstResults[y][x].Stability, firstResults[y][x + 1].Stability, firstResults[y + 1][x].Stability, firstResults[y + 1][x + 1].Stability);
+			secondStabilities[quadrant] = AndNodes(secondResult.Stability, CenterNode(firstStability));
+		}
+	}
+
+	NodeResult result;
+	result.Board     = MakeNode(secondBoards[0],      secondBoards[1],      secondBoards[2],      secondBoards[3]);
+	result.Stability = MakeNode(secondStabilities[0], secondStabilities[1], secondStabilities[2], secondStabilities[3]);
+
+	if(mNodes.size() > 2 * gMaxNodeCount)
+	{
+		mbOutOfMemory = true;
+		return result;
+	}
+
+	mResults[key] = result;
+	return result;
+}
+
+CpuHashLife::NodeResult CpuHashLife::AdvanceLeaves(uint32_t board, uint32_t restriction, uint32_t log2Steps)
+{
+	//16 rows of 16 cells, stepped in place. The cells near the edges become invalid after each step, but the center 8x8 stays valid for the allowed steps
+	uint32_t boardRows[16];
+	uint32_t restrictionRows[16];
+	uint32_t stabilityRows[16];
+	for(uint32_t y = 0; y < 8; y++)
+	{
+		const QuadNode& boardNode       = mNodes[board];
+		const QuadNode& restrictionNode = mNodes[restriction];
+
+		boardRows[y]           = LeafRow(mNodes[boardNode.Children[0]].Cells,       y) | (LeafRow(mNodes[boardNode.Children[1]].Cells,       y) << 8);
+		boardRows[y + 8]       = LeafRow(mNodes[boardNode.Children[2]].Cells,       y) | (LeafRow(mNodes[boardNode.Children[3]].Cells,       y) << 8);
+		restrictionRows[y]     = LeafRow(mNodes[restrictionNode.Children[0]].Cells, y) | (LeafRow(mNodes[restrictionNode.Children[1]].Cells, y) << 8);
+		restrictionRows[y + 8] = LeafRow(mNodes[restrictionNode.Children[2]].Cells, y) | (LeafRow(mNodes[restrictionNode.Children[3]].Cells, y) << 8);
+	}
+
+	std::fill(stabilityRows, stabilityRows + 16, 0xffff);
+	for(uint32_t step = 0; step < (1u << log2Steps); step++)
+	{
+		uint32_t sourceRows[16];
+		for(int32_t y = 0; y < 16; y++)
+		{
+			sourceRows[y] = boardRows[y] & restrictionRows[y];
+		}
+
+		for(int32_t y = 0; y < 16; y++)
+		{
+			uint32_t nextRow = 0;
+			for(const RuleOffset& offset: mRuleOffsets)
+			{
+				int32_t sourceY = y + offset.Y;
+				if(sourceY < 0 || sourceY >= 16)
+				{
+					continue;
+				}
+
+				nextRow ^= (offset.X >= 0) ? (sourceRows[sourceY] >> offset.X) : (sourceRows[sourceY] << (-offset.X));
+			}
+
+			nextRow &= 0xffff;
+
+			stabilityRows[y] &= ~(boardRows[y] ^ nextRow) & restrictionRows[y];
+			boardRows[y]      = nextRow;
+		}
+	}
+
+	uint64_t boardCells     = 0;
+	uint64_t stabilityCells = 0;
+	for(uint32_t y = 0; y < 8; y++)
+	{
+		boardCells     |= (uint64_t)((boardRows[y + 4]     >> 4) & 0xff) << (y * 8);
+		stabilityCells |= (uint64_t)((stabilityRows[y + 4] >> 4) & 0xff) << (y * 8);
+	}
+
+	return {MakeLeaf(boardCells), MakeLeaf(stabilityCells)};
+}
+
+uint32_t CpuHashLife::MaxLog2Steps(uint32_t level) const
+{
+	//The center of the node is 2^(level - 2) cells away from its edges, and every step reaches radius cells further
+	return level - 2 - mRadiusLog2;
+}
+
+uint32_t CpuHashLife::ImportPlane(const BitBoard* plane, uint32_t level, uint64_t x, uint64_t y)
+{
+	if(x >= mWidth || y >= mHeight)
+	{
+		return ZeroNode(level);
+	}
+
+	if(level == gLeafLevel)
+	{
+		uint64_t cells = 0;
+		for(uint32_t leafY = 0; leafY < 8 && y + leafY < mHeight; leafY++)
+		{
+			uint64_t rowCells = 0;
+			if(plane)
+			{
+				size_t wordIndex = (size_t)(x / 64);
+				rowCells = ((plane->Row((int32_t)(y + leafY))[wordIndex] & plane->GetColumnMask()[wordIndex]) >> (x % 64)) & 0xff;
+			}
+			else
+			{
+				uint64_t cellCount = std::min<uint64_t>(mWidth - x, 8);
+				rowCells = (1ull << cellCount) - 1;
+			}
+
+			cells |= rowCells << (leafY * 8);
+		}
+
+		return MakeLeaf(cells);
+	}
+
+	uint64_t halfSize = 1ull << (level - 1);
+
+	uint32_t nw = ImportPlane(plane, level - 1, x,            y);
+	uint32_t ne = ImportPlane(plane, level - 1, x + halfSize, y);
+	uint32_t sw = ImportPlane(plane, level - 1, x,            y + halfSize);
+	uint32_t se = ImportPlane(plane, level - 1, x + halfSize, y + halfSize);
+	return MakeNode(nw, ne, sw, se);
+}
+
+void CpuHashLife::ExportPlane(uint32_t node, uint64_t x, uint64_t y, BitBoard& outPlane) const
+{
+	const QuadNode& quadNode = mNodes[node];
+
+	uint64_t size = 1ull << quadNode.Level;
+	if(x >= mOrigin + mWidth || y >= mOrigin + mHeight || x + size <= mOrigin || y + size <= mOrigin)
+	{
+		return;
+	}
+
+	if(quadNode.Level < mZeroNodes.size() && node == mZeroNodes[quadNode.Level])
+	{
+		return;
+	}
+
+	if(quadNode.Level == gLeafLevel)
+	{
+		//The origin is a multiple of the leaf size, so the leaf is always inside a single word
+		uint64_t boardX    = x - mOrigin;
+		uint64_t boardY    = y - mOrigin;
+		size_t   wordIndex = (size_t)(boardX / 64);
+		for(uint32_t leafY = 0; leafY < 8 && boardY + leafY < mHeight; leafY++)
+		{
+			uint64_t rowCells = (uint64_t)LeafRow(quadNode.Cells, leafY) << (boardX % 64);
+			outPlane.Row((int32_t)(boardY + leafY))[wordIndex] |= rowCells & outPlane.GetColumnMask()[wordIndex];
+		}
+
+		return;
+	}
+
+	uint64_t halfSize = size / 2;
+	ExportPlane(quadNode.Children[0], x,            y,            outPlane);
+	ExportPlane(quadNode.Children[1], x + halfSize, y,            outPlane);
+	ExportPlane(quadNode.Children[2], x,            y + halfSize, outPlane);
+	ExportPlane(quadNode.Children[3], x + halfSize, y + halfSize, outPlane);
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+#include "BitBoard.hpp"
+
+class CpuClickRule;
+
+/*
+The class for computing many steps at once on boards with large repeated or uniform regions (Hashlife).
+Input:               Board, stability, click rule, restriction
+Output:              Board and stability after the steps
+Possible expansions: Spawn stability, garbage collection that keeps the results of the live nodes
+
+The board, the restriction and the stability are quadtrees of 8x8 leaves. Equal subtrees are stored once (hash-consing), so a self-similar board takes little memory.
+A node of size 2^k knows its center of size 2^(k-1) after up to 2^(k-2) / radius steps: it is computed from 9 overlapping half-size nodes twice, and memoized.
+The stability is carried as a second plane of the result: the cells of the center that didn't change during these steps.
+The cells outside the board have zero restriction, so they are never read, the same as the zero guard cells of the flat board
+*/
+
+class CpuHashLife
+{
+	struct QuadNode
+	{
+		uint32_t Children[4]; //NW, NE, SW, SE
+		uint64_t Cells;       //Leaves only, bit (y * 8 + x) is the cell (x, y)
+		uint32_t Level;       //The node is 2^Level cells in size, leaves are level 3
+	};
+
+	struct NodeKey
+	{
+		uint32_t Children[4];
+
+		bool operator==(const NodeKey& other) const;
+	};
+
+	struct ResultKey
+	{
+		uint32_t Board;
+		uint32_t Restriction;
+		uint32_t Log2Steps;
+
+		bool operator==(const ResultKey& other) const;
+	};
+
+	struct NodeResult
+	{
+		uint32_t Board;
+		uint32_t Stability; //1 for the cells that didn't change during the steps
+	};
+
+	struct KeyHash
+	{
+		size_t operator()(const NodeKey& key)   const;
+		size_t operator()(const ResultKey& key) const;
+	};
+
+	struct RuleOffset
+	{
+		int32_t X;
+		int32_t Y;
+	};
+
+public:
+	CpuHashLife();
+	~CpuHashLife();
+
+	static bool IsSupported(const CpuClickRule* clickRule); //The click rule radius has to fit into the margins of the smallest computed node
+
+	void Init(const BitBoard& board, const BitBoard& stability, const CpuClickRule* clickRule, const BitBoard* restriction); //Null click rule is the default one, null restriction is no restriction
+
+	uint32_t Advance(uint32_t stepCount); //Returns the number of steps actually computed, less than stepCount if the memoized results stopped being reused
+
+	void GetBoard(BitBoard& outBoard)         const; //outBoard has to be of the board size
+	void GetStability(BitBoard& outStability) const;
+
+	size_t GetNodeCount() const;
+
+private:
+	void Clear();
+	void Rebuild(); //Frees everything except the current state
+
+	uint32_t MakeLeaf(uint64_t cells);
+	uint32_t MakeNode(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+	uint32_t ZeroNode(uint32_t level);
+	uint32_t OnesNode(uint32_t level);
+
+	uint32_t ExpandNode(uint32_t node); //The node in the center of a twice as large one, with zeros around
+	uint32_t CenterNode(uint32_t node); //The center half of the node
+	uint32_t AndNodes(uint32_t a, uint32_t b);
+
+	NodeResult AdvanceNode(uint32_t board, uint32_t restriction, uint32_t log2Steps); //The center of the node after 2^log2Steps steps
+	NodeResult AdvanceLeaves(uint32_t board, uint32_t restriction, uint32_t log2Steps);
+	uint32_t   MaxLog2Steps(uint32_t level) const;
+
+	uint32_t ImportPlane(const BitBoard* plane, uint32_t level, uint64_t x, uint64_t y); //Null plane is 1 for every cell of the board
+	void     ExportPlane(uint32_t node, uint64_t x, uint64_t y, BitBoard& outPlane) const;
+
+private:
+	std::vector<QuadNode> mNodes;
+	std::vector<uint32_t> mZeroNodes; //Per level
+	std::vector<uint32_t> mOnesNodes;
+
+	std::unordered_map<uint64_t, uint32_t>             mLeafIndices;
+	std::unordered_map<NodeKey, uint32_t, KeyHash>     mNodeIndices;
+	std::unordered_map<ResultKey, NodeResult, KeyHash> mResults;
+	std::unordered_map<uint64_t, uint32_t>             mAndResults; //AND of two nodes, by the pair of node indices
+
+	std::vector<RuleOffset> mRuleOffsets;
+	uint32_t                mRadiusLog2; //The click rule radius rounded up to a power of 2
+
+	uint32_t mWidth;
+	uint32_t mHeight;
+
+	//The state: the board is at (mOrigin, mOrigin) of the root nodes
+	uint32_t mBoardRoot;
+	uint32_t mRestrictionRoot;
+	uint32_t mStabilityRoot;
+	uint32_t mRootLevel;
+	uint64_t mOrigin;
+
+	uint64_t mResultLookups;
+	uint64_t mResultHits;
+	bool     mbOutOfMemory; //Too many nodes were created during the step, it's abandoned
+	bool     mbGaveUp;      //Too few memoized results were reused during the step, it's abandoned
+};
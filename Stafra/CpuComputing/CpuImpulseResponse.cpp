@@ -0,0 +1,249 @@
+#include "CpuImpulseResponse.hpp"
+#include "CpuBoardSymmetry.hpp"
+#include "CpuClickRule.hpp"
+#include "CpuJumpAhead.hpp"
+#include "NextStepKernels.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const size_t  gMaxImpulseCells = 64;                                             //Boards with more lit cells are stepped as usual from the start
+	const int32_t gImpulseMargin   = 64 * (int32_t)(BitBoard::RowWordAlignment + 1); //Zero cells around the impulse response, so its rows can be read in whole SIMD rows at any shift
+}
+
+CpuImpulseResponse::CpuImpulseResponse(): mCenter(0), mCapacity(0), mRadius(0), mStepCount(0), mClickRule(nullptr), mbActive(false)
+{
+}
+
+CpuImpulseResponse::~CpuImpulseResponse()
+{
+}
+
+bool CpuImpulseResponse::Start(const BitBoard& board)
+{
+	Stop();
+
+	for(uint32_t y = 0; y < board.GetHeight(); y++)
+	{
+		const uint64_t* row = board.Row((int32_t)y);
+		for(size_t i = 0; i < board.GetWordsPerRow(); i++)
+		{
+			uint64_t cellBits = row[i];
+			for(int32_t x = (int32_t)(i * 64); cellBits != 0; x++)
+			{
+				if(cellBits & 1)
+				{
+					mCells.push_back({x, (int32_t)y});
+				}
+
+				cellBits >>= 1;
+			}
+
+			if(mCells.size() > gMaxImpulseCells)
+			{
+				mCells.clear();
+				return false;
+			}
+		}
+	}
+
+	mbActive = true;
+	return true;
+}
+
+void CpuImpulseResponse::Stop()
+{
+	mCells.clear();
+	mImages.clear();
+	mPrevResponse.Resize(0, 0);
+	mCurrResponse.Resize(0, 0);
+
+	mCenter    = 0;
+	mCapacity  = 0;
+	mRadius    = 0;
+	mStepCount = 0;
+	mClickRule = nullptr;
+	mbActive   = false;
+}
+
+bool CpuImpulseResponse::IsActive() const
+{
+	return mbActive;
+}
+
+bool CpuImpulseResponse::BeginStep(const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t spawnPeriod, const CpuBoardSymmetry& symmetry)
+{
+	if(!mbActive)
+	{
+		return false;
+	}
+
+	const double simArea = (double)symmetry.GetSimWidth() * symmetry.GetSimHeight();
+
+	//The images only work where the jump ahead works: the mirrored board has to evolve the same way on the torus
+	bool canUseImpulse = !restriction && spawnPeriod == 0 && CpuJumpAhead::CanJump(clickRule, nullptr) && (mStepCount == 0 || clickRule == mClickRule);
+	if(canUseImpulse && mStepCount == 0)
+	{
+		//A response wider than that is more expensive than a regular step even for a single image. It also must not wrap around the mirrored board
+		double maxResponseSize = std::sqrt(simArea);
+		mCapacity = std::min((int32_t)((maxResponseSize - 1.0) / 2.0), (int32_t)std::min(symmetry.GetBoardWidth(), symmetry.GetBoardHeight()));
+		mCenter   = gImpulseMargin + mCapacity;
+
+		uint32_t responseSize = 2 * (uint32_t)mCenter + 1;
+		mPrevResponse.Resize(responseSize, responseSize);
+		mCurrResponse.Resize(responseSize, responseSize);
+		mPrevResponse.SetCell((uint32_t)mCenter, (uint32_t)mCenter, true);
+
+		mClickRule = clickRule;
+	}
+
+	const int32_t radius     = clickRule ? std::max(clickRule->GetRadius(), 1) : 1;
+	const int32_t nextRadius = (int32_t)(mStepCount + 1) * radius;
+	if(canUseImpulse && nextRadius <= mCapacity)
+	{
+		UpdateImages(nextRadius, symmetry);
+
+		double imageArea = (double)mImages.size() * (2.0 * nextRadius + 1.0) * (2.0 * nextRadius + 1.0);
+		canUseImpulse = imageArea < simArea; //Building an image costs about as much per cell as a regular step
+	}
+	else
+	{
+		canUseImpulse = false;
+	}
+
+	if(!canUseImpulse)
+	{
+		Stop();
+		return false;
+	}
+
+	mRadius = nextRadius;
+	return true;
+}
+
+void CpuImpulseResponse::EndStep()
+{
+	mCurrResponse.Swap(mPrevResponse);
+	mStepCount++;
+}
+
+int32_t CpuImpulseResponse::GetCenter() const
+{
+	return mCenter;
+}
+
+int32_t CpuImpulseResponse::GetRadius() const
+{
+	return mRadius;
+}
+
+const BitBoard& CpuImpulseResponse::GetPrevResponse() const
+{
+	return mPrevResponse;
+}
+
+BitBoard& CpuImpulseResponse::GetCurrResponse()
+{
+	return mCurrResponse;
+}
+
+bool CpuImpulseResponse::BoardRow(uint64_t* nextRow, int32_t y, size_t wordsPerRow, uint32_t simWidth, const NextStepKernels& kernels, size_t& outWordBegin, size_t& outWordEnd) const
+{
+	const size_t  alignment = BitBoard::RowWordAlignment;
+	const int32_t radius    = mRadius;
+
+	//Whole SIMD rows around the cells [x - radius, x + radius] of an image, inside the simulated board
+	auto imageWordRange = [alignment, wordsPerRow, simWidth, radius](int32_t imageX, size_t& outImageWordBegin, size_t& outImageWordEnd)
+	{
+		int32_t cellBegin = std::max(imageX - radius, 0);
+		int32_t cellEnd   = std::min(imageX + radius, (int32_t)simWidth - 1);
+
+		outImageWordBegin = (size_t)cellBegin / 64 / alignment * alignment;
+		outImageWordEnd   = std::min(((size_t)cellEnd / 64 + alignment) / alignment * alignment, wordsPerRow);
+	};
+
+	size_t wordBegin = wordsPerRow;
+	size_t wordEnd   = 0;
+	for(const ImpulseCell& image: mImages)
+	{
+		if(std::abs(y - image.Y) <= radius)
+		{
+			size_t imageWordBegin = 0;
+			size_t imageWordEnd   = 0;
+			imageWordRange(image.X, imageWordBegin, imageWordEnd);
+
+			wordBegin = std::min(wordBegin, imageWordBegin);
+			wordEnd   = std::max(wordEnd,   imageWordEnd);
+		}
+	}
+
+	if(wordBegin >= wordEnd)
+	{
+		return false;
+	}
+
+	std::fill(nextRow + wordBegin, nextRow + wordEnd, 0);
+	for(const ImpulseCell& image: mImages)
+	{
+		if(std::abs(y - image.Y) > radius)
+		{
+			continue;
+		}
+
+		size_t imageWordBegin = 0;
+		size_t imageWordEnd   = 0;
+		imageWordRange(image.X, imageWordBegin, imageWordEnd);
+
+		//The cell x of the board gets the cell (x + shift) of the response
+		int32_t shift     = mCenter - image.X;
+		int32_t wordShift = (shift >= 0) ? (shift / 64) : -((63 - shift) / 64);
+		int32_t bitShift  = shift - wordShift * 64;
+
+		const uint64_t* responseRow = mCurrResponse.Row(mCenter + y - image.Y);
+		kernels.XorShiftedRow(nextRow + imageWordBegin, responseRow + (ptrdiff_t)imageWordBegin + wordShift, bitShift, imageWordEnd - imageWordBegin);
+	}
+
+	outWordBegin = wordBegin;
+	outWordEnd   = wordEnd;
+	return true;
+}
+
+void CpuImpulseResponse::UpdateImages(int32_t radius, const CpuBoardSymmetry& symmetry)
+{
+	const int32_t boardWidth  = (int32_t)symmetry.GetBoardWidth();
+	const int32_t boardHeight = (int32_t)symmetry.GetBoardHeight();
+	const int32_t simWidth    = (int32_t)symmetry.GetSimWidth();
+	const int32_t simHeight   = (int32_t)symmetry.GetSimHeight();
+
+	//Mirroring around the zero rows -1 and size makes the board periodic with the period of (2 * size + 2)
+	const int32_t periodX = 2 * boardWidth  + 2;
+	const int32_t periodY = 2 * boardHeight + 2;
+
+	mImages.clear();
+	for(const ImpulseCell& cell: mCells)
+	{
+		const int32_t mirroredX = 2 * boardWidth  - cell.X;
+		const int32_t mirroredY = 2 * boardHeight - cell.Y;
+
+		const int32_t imageXs[] = {cell.X - periodX, cell.X, cell.X + periodX, mirroredX - periodX, mirroredX, mirroredX + periodX};
+		const int32_t imageYs[] = {cell.Y - periodY, cell.Y, cell.Y + periodY, mirroredY - periodY, mirroredY, mirroredY + periodY};
+		for(int32_t imageY: imageYs)
+		{
+			if(imageY + radius < 0 || imageY - radius >= simHeight)
+			{
+				continue;
+			}
+
+			for(int32_t imageX: imageXs)
+			{
+				if(imageX + radius < 0 || imageX - radius >= simWidth)
+				{
+					continue;
+				}
+
+				mImages.push_back({imageX, imageY});
+			}
+		}
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "BitBoard.hpp"
+
+class CpuClickRule;
+class CpuBoardSymmetry;
+struct NextStepKernels;
+
+/*
+The class for computing the boards with only a few lit cells from the impulse response of the click rule.
+Input:               The initial board, the click rule of each step
+Output:              The rows of the next board, built from the images of the response
+Possible expansions: Restrictions, boards with more lit cells split into separate parts
+
+A board with a few lit cells is the XOR of the impulse responses of its lit cells and their mirror images around the zero rows and columns -1 and size.
+The response of a single cell is stepped in free space, it only covers (2 * step * radius + 1)^2 cells, and the board is only touched around the images
+*/
+
+class CpuImpulseResponse
+{
+	struct ImpulseCell
+	{
+		int32_t X;
+		int32_t Y;
+	};
+
+public:
+	CpuImpulseResponse();
+	~CpuImpulseResponse();
+
+	bool Start(const BitBoard& board); //Starts with the lit cells of the board, false if it has too many of them
+	void Stop();
+	bool IsActive() const;
+
+	bool BeginStep(const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t spawnPeriod, const CpuBoardSymmetry& symmetry); //Finds the images for the next step. Returns false and stops if the response can't be used or isn't cheaper than a regular step anymore
+	void EndStep();                                                                                                                   //After GetCurrResponse() got the next step of GetPrevResponse()
+
+	int32_t GetCenter() const; //The cell of the impulse, in both directions
+	int32_t GetRadius() const; //The radius of the response in the next step
+
+	const BitBoard& GetPrevResponse() const;
+	BitBoard&       GetCurrResponse();
+
+	bool BoardRow(uint64_t* nextRow, int32_t y, size_t wordsPerRow, uint32_t simWidth, const NextStepKernels& kernels, size_t& outWordBegin, size_t& outWordEnd) const; //Builds the next board row from the images, only the words [outWordBegin, outWordEnd) are written. False if no image reaches the row
+
+private:
+	void UpdateImages(int32_t radius, const CpuBoardSymmetry& symmetry);
+
+private:
+	std::vector<ImpulseCell> mCells;
+	std::vector<ImpulseCell> mImages; //The images that reach the simulated part of the board at the current radius
+	BitBoard                 mPrevResponse;
+	BitBoard                 mCurrResponse;
+	int32_t                  mCenter;
+	int32_t                  mCapacity; //The largest radius the response buffers can hold
+	int32_t                  mRadius;
+	uint32_t                 mStepCount;
+	const CpuClickRule*      mClickRule;
+	bool                     mbActive;
+};
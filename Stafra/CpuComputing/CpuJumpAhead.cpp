@@ -0,0 +1,197 @@
+#include "CpuJumpAhead.hpp"
+#include "CpuClickRule.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	struct JumpOffset
+	{
+		int32_t X;
+		int32_t Y;
+	};
+
+	//The board mirrored to the period of (2 * width + 2) x (2 * height + 2). Each row holds its period twice, so any cyclic shift of a row is a read at a bit offset
+	struct PeriodicBoard
+	{
+		uint32_t PeriodX;
+		uint32_t PeriodY;
+		size_t   RowWords;
+
+		std::vector<uint64_t> Words;
+
+		uint64_t* Row(uint32_t y)
+		{
+			return Words.data() + y * RowWords;
+		}
+	};
+
+	uint64_t ReadBits(const uint64_t* words, size_t bitIndex)
+	{
+		size_t   wordIndex = bitIndex / 64;
+		uint32_t bitShift  = bitIndex % 64;
+		if(bitShift == 0)
+		{
+			return words[wordIndex];
+		}
+
+		return (words[wordIndex] >> bitShift) | (words[wordIndex + 1] << (64 - bitShift));
+	}
+
+	//Bits [dstBit, dstBit + bitCount) of dst ^= bits [srcBit, srcBit + bitCount) of src. Reads one word past the last source bit
+	void XorBits(uint64_t* dst, size_t dstBit, const uint64_t* src, size_t srcBit, size_t bitCount)
+	{
+		while(bitCount > 0)
+		{
+			size_t   wordIndex = dstBit / 64;
+			uint32_t bitShift  = dstBit % 64;
+
+			size_t   chunkBits = std::min<size_t>(64 - bitShift, bitCount);
+			uint64_t chunkMask = (chunkBits == 64) ? ~0ull : ((1ull << chunkBits) - 1);
+			dst[wordIndex] ^= (ReadBits(src, srcBit) & chunkMask) << bitShift;
+
+			dstBit   += chunkBits;
+			srcBit   += chunkBits;
+			bitCount -= chunkBits;
+		}
+	}
+
+	uint64_t ReverseBits(uint64_t word)
+	{
+		word = ((word >>  1) & 0x5555555555555555ull) | ((word & 0x5555555555555555ull) <<  1);
+		word = ((word >>  2) & 0x3333333333333333ull) | ((word & 0x3333333333333333ull) <<  2);
+		word = ((word >>  4) & 0x0f0f0f0f0f0f0f0full) | ((word & 0x0f0f0f0f0f0f0f0full) <<  4);
+		word = ((word >>  8) & 0x00ff00ff00ff00ffull) | ((word & 0x00ff00ff00ff00ffull) <<  8);
+		word = ((word >> 16) & 0x0000ffff0000ffffull) | ((word & 0x0000ffff0000ffffull) << 16);
+		return (word >> 32) | (word << 32);
+	}
+
+	void ResizePeriodicBoard(PeriodicBoard& periodicBoard, uint32_t periodX, uint32_t periodY)
+	{
+		periodicBoard.PeriodX  = periodX;
+		periodicBoard.PeriodY  = periodY;
+		periodicBoard.RowWords = (2 * (size_t)periodX + 63) / 64 + 1; //One spare word for ReadBits()
+
+		periodicBoard.Words.assign(periodicBoard.RowWords * periodY, 0);
+	}
+
+	void RepeatPeriod(PeriodicBoard& periodicBoard, uint32_t y)
+	{
+		uint64_t* row = periodicBoard.Row(y);
+		XorBits(row, periodicBoard.PeriodX, row, 0, periodicBoard.PeriodX);
+	}
+
+	void InitPeriodicBoard(PeriodicBoard& periodicBoard, const BitBoard& board)
+	{
+		const uint32_t width  = board.GetWidth();
+		const uint32_t height = board.GetHeight();
+		ResizePeriodicBoard(periodicBoard, 2 * width + 2, 2 * height + 2);
+
+		const size_t wordsPerRow = board.GetWordsPerRow();
+		std::vector<uint64_t> reversedRow(wordsPerRow + 1, 0);
+
+		//Rows and columns size and (2 * size + 1) stay zero, the rest is the board mirrored around them
+		for(uint32_t y = 0; y < periodicBoard.PeriodY; y++)
+		{
+			int32_t boardY = (y < height) ? (int32_t)y : (2 * (int32_t)height - (int32_t)y);
+			if(y == height || boardY < 0)
+			{
+				continue;
+			}
+
+			const uint64_t* boardRow = board.Row(boardY);
+			for(size_t i = 0; i < wordsPerRow; i++)
+			{
+				reversedRow[i] = ReverseBits(boardRow[wordsPerRow - 1 - i]);
+			}
+
+			uint64_t* row = periodicBoard.Row(y);
+			XorBits(row, 0,         boardRow,           0,                        width);
+			XorBits(row, width + 1, reversedRow.data(), wordsPerRow * 64 - width, width);
+			RepeatPeriod(periodicBoard, y);
+		}
+	}
+
+	int64_t PositiveModulo(int64_t value, int64_t modulo)
+	{
+		int64_t remainder = value % modulo;
+		return (remainder < 0) ? remainder + modulo : remainder;
+	}
+
+	void ConvolveScaled(PeriodicBoard& nextBoard, PeriodicBoard& thisBoard, const std::vector<JumpOffset>& offsets, uint64_t scaleX, uint64_t scaleY)
+	{
+		const uint32_t periodX = thisBoard.PeriodX;
+		const uint32_t periodY = thisBoard.PeriodY;
+
+		std::fill(nextBoard.Words.begin(), nextBoard.Words.end(), 0);
+		for(const JumpOffset& offset: offsets)
+		{
+			uint32_t shiftX = (uint32_t)PositiveModulo(offset.X * (int64_t)scaleX, periodX);
+			uint32_t shiftY = (uint32_t)PositiveModulo(offset.Y * (int64_t)scaleY, periodY);
+			for(uint32_t y = 0; y < periodY; y++)
+			{
+				XorBits(nextBoard.Row(y), 0, thisBoard.Row((y + shiftY) % periodY), shiftX, periodX);
+			}
+		}
+
+		for(uint32_t y = 0; y < periodY; y++)
+		{
+			RepeatPeriod(nextBoard, y);
+		}
+	}
+}
+
+bool CpuJumpAhead::CanJump(const CpuClickRule* clickRule, const BitBoard* restriction)
+{
+	if(restriction)
+	{
+		return false;
+	}
+
+	return !clickRule || (clickRule->GetRadius() <= 1 && clickRule->IsMirrorSymmetricX() && clickRule->IsMirrorSymmetricY());
+}
+
+void CpuJumpAhead::JumpBoard(const BitBoard& board, const CpuClickRule* clickRule, uint64_t stepCount, BitBoard& outBoard)
+{
+	std::vector<JumpOffset> offsets;
+	if(clickRule)
+	{
+		for(const CpuClickRuleRow& clickRuleRow: clickRule->GetRows())
+		{
+			for(int32_t offsetX: clickRuleRow.OffsetsX)
+			{
+				offsets.push_back({offsetX, clickRuleRow.OffsetY});
+			}
+		}
+	}
+	else
+	{
+		offsets = {{0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+	}
+
+	PeriodicBoard thisBoard;
+	PeriodicBoard nextBoard;
+	InitPeriodicBoard(thisBoard, board);
+	ResizePeriodicBoard(nextBoard, thisBoard.PeriodX, thisBoard.PeriodY);
+
+	//The click rule raised to the power 2^k has the same offsets multiplied by 2^k
+	uint64_t scaleX = 1;
+	uint64_t scaleY = 1;
+	for(uint64_t remainingSteps = stepCount; remainingSteps != 0; remainingSteps >>= 1)
+	{
+		if(remainingSteps & 1)
+		{
+			ConvolveScaled(nextBoard, thisBoard, offsets, scaleX, scaleY);
+			std::swap(thisBoard, nextBoard);
+		}
+
+		scaleX = (scaleX * 2) % thisBoard.PeriodX;
+		scaleY = (scaleY * 2) % thisBoard.PeriodY;
+	}
+
+	outBoard.Resize(board.GetWidth(), board.GetHeight());
+	for(uint32_t y = 0; y < board.GetHeight(); y++)
+	{
+		XorBits(outBoard.Row((int32_t)y), 0, thisBoard.Row(y), 0, board.GetWidth());
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include "BitBoard.hpp"
+
+class CpuClickRule;
+
+/*
+The functions for computing the board many steps ahead without computing the steps in between.
+Input:               Board, click rule, the number of steps
+Output:              The board after that many steps
+Possible expansions: Restrictions, asymmetric and larger click rules
+
+Without a restriction a step is a convolution over GF(2) with the click rule, so N steps are a convolution with the rule raised to the power N.
+Squaring a GF(2) polynomial only spreads its terms (p(x, y)^2 = p(x^2, y^2)), so each set bit k of N is one convolution with the click rule offsets multiplied by 2^k.
+The zero cells outside the board are handled by mirroring the board around the rows and columns -1 and size: for a mirror symmetric click rule of radius 1
+these rows and columns stay zero forever, and the mirrored board is periodic, so the offsets can be taken modulo the period
+*/
+
+namespace CpuJumpAhead
+{
+	bool CanJump(const CpuClickRule* clickRule, const BitBoard* restriction); //Null click rule is the default one
+
+	void JumpBoard(const BitBoard& board, const CpuClickRule* clickRule, uint64_t stepCount, BitBoard& outBoard); //outBoard gets resized to the size of board
+}
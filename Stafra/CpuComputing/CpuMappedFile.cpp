@@ -0,0 +1,198 @@
+#include "CpuMappedFile.hpp"
+
+#if defined(_WIN32)
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+#endif
+
+#if defined(_WIN32)
+
+CpuMappedFile::CpuMappedFile(): mFile(INVALID_HANDLE_VALUE), mMapping(nullptr), mSize(0)
+{
+}
+
+#else
+
+CpuMappedFile::CpuMappedFile(): mFile(-1), mSize(0)
+{
+}
+
+#endif
+
+CpuMappedFile::~CpuMappedFile()
+{
+	Close();
+}
+
+bool CpuMappedFile::Create(const std::wstring& path, uint64_t size)
+{
+	Close();
+
+#if defined(_WIN32)
+	mFile = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(mFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	//A mapping can't be empty
+	LARGE_INTEGER fileSize;
+	fileSize.QuadPart = (LONGLONG)(size != 0 ? size : 1);
+	if(!SetFilePointerEx(mFile, fileSize, nullptr, FILE_BEGIN) || !SetEndOfFile(mFile))
+	{
+		Close();
+		return false;
+	}
+
+	mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READWRITE, fileSize.HighPart, fileSize.LowPart, nullptr);
+	if(mMapping == nullptr)
+	{
+		Close();
+		return false;
+	}
+#else
+	mFile = open(std::string(path.begin(), path.end()).c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(mFile < 0)
+	{
+		return false;
+	}
+
+	if(ftruncate(mFile, (off_t)size) != 0)
+	{
+		Close();
+		return false;
+	}
+#endif
+
+	mSize = size;
+	return true;
+}
+
+void CpuMappedFile::Close()
+{
+#if defined(_WIN32)
+	if(mMapping != nullptr)
+	{
+		CloseHandle(mMapping);
+		mMapping = nullptr;
+	}
+
+	if(mFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(mFile);
+		mFile = INVALID_HANDLE_VALUE;
+	}
+#else
+	if(mFile >= 0)
+	{
+		close(mFile);
+		mFile = -1;
+	}
+#endif
+
+	mSize = 0;
+}
+
+uint64_t CpuMappedFile::GetSize() const
+{
+	return mSize;
+}
+
+bool CpuMappedFile::MapView(uint64_t offset, size_t size, CpuMappedView& outView)
+{
+	outView.Data    = nullptr;
+	outView.MapBase = nullptr;
+	outView.MapSize = 0;
+
+	if(size == 0 || offset + size > mSize)
+	{
+		return false;
+	}
+
+	//The mapping has to start at a multiple of the granularity
+	const uint64_t granularity = GetMappingGranularity();
+	const uint64_t mapOffset   = offset / granularity * granularity;
+	const size_t   mapSize     = (size_t)(offset - mapOffset) + size;
+
+#if defined(_WIN32)
+	void* mapBase = MapViewOfFile(mMapping, FILE_MAP_READ | FILE_MAP_WRITE, (DWORD)(mapOffset >> 32), (DWORD)(mapOffset & 0xffffffff), mapSize);
+	if(mapBase == nullptr)
+	{
+		return false;
+	}
+#else
+	void* mapBase = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFile, (off_t)mapOffset);
+	if(mapBase == MAP_FAILED)
+	{
+		return false;
+	}
+#endif
+
+	outView.Data    = (uint8_t*)mapBase + (offset - mapOffset);
+	outView.MapBase = mapBase;
+	outView.MapSize = mapSize;
+	return true;
+}
+
+void CpuMappedFile::UnmapView(CpuMappedView& view)
+{
+	if(view.MapBase == nullptr)
+	{
+		return;
+	}
+
+#if defined(_WIN32)
+	UnmapViewOfFile(view.MapBase);
+#else
+	munmap(view.MapBase, view.MapSize);
+#endif
+
+	view.Data    = nullptr;
+	view.MapBase = nullptr;
+	view.MapSize = 0;
+}
+
+void CpuMappedFile::PrefetchView(const CpuMappedView& view) const
+{
+	if(view.MapBase == nullptr)
+	{
+		return;
+	}
+
+#if defined(_WIN32)
+	WIN32_MEMORY_RANGE_ENTRY range;
+	range.VirtualAddress = view.MapBase;
+	range.NumberOfBytes  = view.MapSize;
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+	madvise(view.MapBase, view.MapSize, MADV_WILLNEED);
+#endif
+}
+
+void CpuMappedFile::FlushView(const CpuMappedView& view) const
+{
+	if(view.MapBase == nullptr)
+	{
+		return;
+	}
+
+#if defined(_WIN32)
+	FlushViewOfFile(view.MapBase, view.MapSize); //Only starts the writes, FlushFileBuffers() would wait for them
+#else
+	msync(view.MapBase, view.MapSize, MS_ASYNC);
+#endif
+}
+
+uint64_t CpuMappedFile::GetMappingGranularity()
+{
+#if defined(_WIN32)
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	return systemInfo.dwAllocationGranularity;
+#else
+	return (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+}
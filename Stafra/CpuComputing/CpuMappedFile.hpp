@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+//A part of the file mapped to memory
+struct CpuMappedView
+{
+	uint8_t* Data;    //The first byte of the part, null if the view isn't mapped
+	void*    MapBase; //The start of the mapping, aligned down to the mapping granularity
+	size_t   MapSize;
+};
+
+/*
+The class for accessing a file bigger than the memory through mapped views of its parts.
+Input:               File path and size, the parts of the file to access
+Output:              Mapped views of the parts, readahead and writeback hints for them
+Possible expansions: Unbuffered I/O with explicit overlapped reads and writes
+
+Only the mapped views take up the address space, so the memory used stays bounded by the views kept mapped at once.
+*/
+
+class CpuMappedFile
+{
+public:
+	CpuMappedFile();
+	~CpuMappedFile();
+
+	bool Create(const std::wstring& path, uint64_t size); //Creates the file or truncates an existing one, all bytes are zero
+	void Close();
+
+	uint64_t GetSize() const;
+
+	bool MapView(uint64_t offset, size_t size, CpuMappedView& outView);
+	void UnmapView(CpuMappedView& view);
+
+	void PrefetchView(const CpuMappedView& view) const; //Starts reading the view in the background, so the first access doesn't wait for the disk
+	void FlushView(const CpuMappedView& view)    const; //Starts writing the changes of the view back to the file without waiting for the writes to finish
+
+private:
+	static uint64_t GetMappingGranularity();
+
+private:
+#if defined(_WIN32)
+	void* mFile;
+	void* mMapping;
+#else
+	int mFile;
+#endif
+
+	uint64_t mSize;
+};
@@ -0,0 +1,399 @@
+#include "CpuOutOfCoreCalculator.hpp"
+#include "BitBoard.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	const uint32_t gBlockRows       = 32;  //Rows streamed in and out of the files at once
+	const uint32_t gRowsPerTask     = 4;
+	const uint32_t gMaxStepsPerPass = 256;
+
+	const uint32_t gInputViewCount  = 4; //The board and the stability of the current block and of the prefetched next one
+	const uint32_t gOutputViewCount = 2;
+
+	size_t AlignWords(size_t wordCount)
+	{
+		return (wordCount + BitBoard::RowWordAlignment - 1) / BitBoard::RowWordAlignment * BitBoard::RowWordAlignment;
+	}
+
+	//The number of 1 bits of the row in the cells from cellBegin to cellEnd
+	uint64_t CountCells(const uint64_t* row, uint32_t cellBegin, uint32_t cellEnd)
+	{
+		uint64_t count = 0;
+		for(uint32_t x = cellBegin; x < cellEnd;)
+		{
+			uint32_t wordIndex = x / 64;
+			uint32_t bitBegin  = x % 64;
+			uint32_t bitEnd    = std::min(cellEnd - wordIndex * 64, 64u);
+
+			uint64_t mask = (bitEnd == 64) ? ~0ull : ((1ull << bitEnd) - 1);
+			mask &= ~((1ull << bitBegin) - 1);
+
+			uint64_t bits = row[wordIndex] & mask;
+			while(bits != 0)
+			{
+				bits &= bits - 1;
+				count++;
+			}
+
+			x = wordIndex * 64 + bitEnd;
+		}
+
+		return count;
+	}
+}
+
+CpuOutOfCoreCalculator::CpuOutOfCoreCalculator(): mCurrentFile(0), mBoardWidth(0), mBoardHeight(0), mRowWords(0), mWindowRowStride(0), mWindowRows(0), mRadius(1), mStepsPerPass(1), mMemoryUsage(0), mCurrentStep(0)
+{
+	SetInstructionSet(CpuFeatures::DetectInstructionSet());
+	SetThreadCount(0);
+}
+
+CpuOutOfCoreCalculator::~CpuOutOfCoreCalculator()
+{
+}
+
+void CpuOutOfCoreCalculator::SetInstructionSet(CpuInstructionSet instructionSet)
+{
+	mInstructionSet = std::min(instructionSet, CpuFeatures::DetectInstructionSet());
+	mKernels        = CpuKernels::SelectKernels(mInstructionSet);
+}
+
+void CpuOutOfCoreCalculator::SetThreadCount(uint32_t threadCount)
+{
+	mThreadPool.reset();
+	mThreadPool = std::make_unique<ThreadPool>(threadCount);
+}
+
+bool CpuOutOfCoreCalculator::PrepareForCalculations(const std::wstring& folder, uint32_t width, uint32_t height, const std::vector<CpuCellPosition>& litCells, const CpuClickRule* clickRule, uint64_t memoryBudget)
+{
+	mBoardWidth  = width;
+	mBoardHeight = height;
+	mRowWords    = AlignWords((width + 63) / 64);
+	mRadius      = clickRule ? std::max(clickRule->GetRadius(), 1) : 1;
+	mCurrentFile = 0;
+	mCurrentStep = 0;
+
+	const uint64_t rowBytes  = mRowWords * sizeof(uint64_t);
+	const uint64_t fileBytes = rowBytes * height;
+	for(uint32_t fileIndex = 0; fileIndex < 2; fileIndex++)
+	{
+		mStabilityFileNames[fileIndex] = folder + L"/Unstable" + std::to_wstring(fileIndex) + L".bin";
+		if(!mBoardFiles[fileIndex].Create(folder + L"/Board" + std::to_wstring(fileIndex) + L".bin", fileBytes) || !mStabilityFiles[fileIndex].Create(mStabilityFileNames[fileIndex], fileBytes))
+		{
+			return false;
+		}
+	}
+
+	for(const CpuCellPosition& cell: litCells)
+	{
+		if(cell.X >= width || cell.Y >= height)
+		{
+			continue;
+		}
+
+		CpuMappedView rowView;
+		if(!mBoardFiles[0].MapView(RowOffset((int32_t)cell.Y), rowBytes, rowView))
+		{
+			return false;
+		}
+
+		uint64_t* row = reinterpret_cast<uint64_t*>(rowView.Data);
+		row[cell.X / 64] |= 1ull << (cell.X % 64);
+
+		mBoardFiles[0].UnmapView(rowView);
+	}
+
+	mColumnMask.assign(mRowWords, 0);
+	for(uint32_t x = 0; x < width; x++)
+	{
+		mColumnMask[x / 64] |= 1ull << (x % 64);
+	}
+
+	mWindowRowStride = mRowWords + 2 * BitBoard::RowWordAlignment;
+	mWindowRows      = gBlockRows + 2 * mRadius;
+	mZeroRow.assign(mWindowRowStride, 0);
+
+	//As many generations per pass as their windows fit into the budget, next to the mapped views
+	const uint64_t viewBytes       = (gInputViewCount + gOutputViewCount) * gBlockRows * rowBytes;
+	const uint64_t generationBytes = (uint64_t)mWindowRows * (mWindowRowStride + mRowWords) * sizeof(uint64_t);
+
+	mStepsPerPass = 1;
+	if(memoryBudget > viewBytes + generationBytes)
+	{
+		mStepsPerPass = (uint32_t)std::min((memoryBudget - viewBytes) / generationBytes, (uint64_t)gMaxStepsPerPass);
+	}
+
+	mBoardWindows.assign((size_t)mStepsPerPass * mWindowRows * mWindowRowStride, 0);
+	mStabilityWindows.assign((size_t)mStepsPerPass * mWindowRows * mRowWords, 0);
+
+	mMemoryUsage = viewBytes + mStepsPerPass * generationBytes;
+	return true;
+}
+
+bool CpuOutOfCoreCalculator::StabilityNextSteps(uint32_t stepCount, const CpuClickRule* clickRule)
+{
+	while(stepCount != 0)
+	{
+		uint32_t generationCount = std::min(stepCount, mStepsPerPass);
+		if(!StreamPass(generationCount, clickRule))
+		{
+			return false;
+		}
+
+		mCurrentFile  = 1 - mCurrentFile;
+		mCurrentStep += generationCount;
+		stepCount    -= generationCount;
+	}
+
+	return true;
+}
+
+uint32_t CpuOutOfCoreCalculator::GetBoardWidth() const
+{
+	return mBoardWidth;
+}
+
+uint32_t CpuOutOfCoreCalculator::GetBoardHeight() const
+{
+	return mBoardHeight;
+}
+
+uint32_t CpuOutOfCoreCalculator::GetCurrentStep() const
+{
+	return mCurrentStep;
+}
+
+uint32_t CpuOutOfCoreCalculator::GetStepsPerPass() const
+{
+	return mStepsPerPass;
+}
+
+uint64_t CpuOutOfCoreCalculator::GetMemoryUsage() const
+{
+	return mMemoryUsage;
+}
+
+const std::wstring& CpuOutOfCoreCalculator::GetStabilityFile() const
+{
+	return mStabilityFileNames[mCurrentFile];
+}
+
+size_t CpuOutOfCoreCalculator::GetRowWords() const
+{
+	return mRowWords;
+}
+
+bool CpuOutOfCoreCalculator::CopyStabilityPreview(uint16_t* outCells, uint32_t previewWidth, uint32_t previewHeight, size_t rowPitch)
+{
+	previewWidth  = std::min(previewWidth,  mBoardWidth);
+	previewHeight = std::min(previewHeight, mBoardHeight);
+
+	CpuMappedFile& stabilityFile = mStabilityFiles[mCurrentFile];
+
+	std::vector<uint8_t> taskResults(previewHeight, 1);
+	mThreadPool->ParallelFor(previewHeight, [this, &stabilityFile, &taskResults, outCells, previewWidth, previewHeight, rowPitch](uint32_t previewY, uint32_t /*threadIndex*/)
+	{
+		uint32_t rowBegin = (uint32_t)((uint64_t)previewY       * mBoardHeight / previewHeight);
+		uint32_t rowEnd   = (uint32_t)((uint64_t)(previewY + 1) * mBoardHeight / previewHeight);
+
+		CpuMappedView rowsView;
+		if(!stabilityFile.MapView(RowOffset((int32_t)rowBegin), (rowEnd - rowBegin) * mRowWords * sizeof(uint64_t), rowsView))
+		{
+			taskResults[previewY] = 0;
+			return;
+		}
+
+		std::vector<uint64_t> unstableCounts(previewWidth, 0);
+		for(uint32_t y = rowBegin; y < rowEnd; y++)
+		{
+			const uint64_t* row = reinterpret_cast<const uint64_t*>(rowsView.Data) + (y - rowBegin) * mRowWords;
+			for(uint32_t previewX = 0; previewX < previewWidth; previewX++)
+			{
+				uint32_t cellBegin = (uint32_t)((uint64_t)previewX       * mBoardWidth / previewWidth);
+				uint32_t cellEnd   = (uint32_t)((uint64_t)(previewX + 1) * mBoardWidth / previewWidth);
+				unstableCounts[previewX] += CountCells(row, cellBegin, cellEnd);
+			}
+		}
+
+		stabilityFile.UnmapView(rowsView);
+
+		uint16_t* outRow = outCells + previewY * rowPitch;
+		for(uint32_t previewX = 0; previewX < previewWidth; previewX++)
+		{
+			uint64_t cellBegin = (uint64_t)previewX       * mBoardWidth / previewWidth;
+			uint64_t cellEnd   = (uint64_t)(previewX + 1) * mBoardWidth / previewWidth;
+			uint64_t cellCount = (cellEnd - cellBegin) * (rowEnd - rowBegin);
+
+			outRow[previewX] = (2 * unstableCounts[previewX] <= cellCount) ? 1 : 0;
+		}
+	});
+
+	return std::find(taskResults.begin(), taskResults.end(), (uint8_t)0) == taskResults.end();
+}
+
+bool CpuOutOfCoreCalculator::StreamPass(uint32_t generationCount, const CpuClickRule* clickRule)
+{
+	CpuMappedFile& inBoardFile      = mBoardFiles[mCurrentFile];
+	CpuMappedFile& inStabilityFile  = mStabilityFiles[mCurrentFile];
+	CpuMappedFile& outBoardFile     = mBoardFiles[1 - mCurrentFile];
+	CpuMappedFile& outStabilityFile = mStabilityFiles[1 - mCurrentFile];
+
+	const size_t  rowBytes = mRowWords * sizeof(uint64_t);
+	const int32_t height   = (int32_t)mBoardHeight;
+	const int32_t reach    = (int32_t)generationCount * mRadius; //The last generation lags this many rows behind the input
+
+	auto mapInputBlock = [this, &inBoardFile, &inStabilityFile, rowBytes, height](int32_t blockBegin, CpuMappedView& outBoardView, CpuMappedView& outStabilityView)
+	{
+		size_t blockBytes = std::min((int32_t)gBlockRows, height - blockBegin) * rowBytes;
+		if(!inBoardFile.MapView(RowOffset(blockBegin), blockBytes, outBoardView) || !inStabilityFile.MapView(RowOffset(blockBegin), blockBytes, outStabilityView))
+		{
+			return false;
+		}
+
+		inBoardFile.PrefetchView(outBoardView);
+		inStabilityFile.PrefetchView(outStabilityView);
+		return true;
+	};
+
+	CpuMappedView boardView;
+	CpuMappedView stabilityView;
+	if(!mapInputBlock(0, boardView, stabilityView))
+	{
+		return false;
+	}
+
+	bool result = true;
+	for(int32_t blockBegin = 0; blockBegin - reach < height && result; blockBegin += gBlockRows)
+	{
+		if(blockBegin < height)
+		{
+			//The disk reads the next block while this one is computed
+			CpuMappedView nextBoardView     = {nullptr, nullptr, 0};
+			CpuMappedView nextStabilityView = {nullptr, nullptr, 0};
+			if(blockBegin + (int32_t)gBlockRows < height && !mapInputBlock(blockBegin + gBlockRows, nextBoardView, nextStabilityView))
+			{
+				result = false;
+			}
+
+			int32_t blockEnd = std::min(blockBegin + (int32_t)gBlockRows, height);
+			for(int32_t y = blockBegin; y < blockEnd; y++)
+			{
+				memcpy(BoardWindowRow(0, y),     boardView.Data     + (y - blockBegin) * rowBytes, rowBytes);
+				memcpy(StabilityWindowRow(0, y), stabilityView.Data + (y - blockBegin) * rowBytes, rowBytes);
+			}
+
+			inBoardFile.UnmapView(boardView);
+			inStabilityFile.UnmapView(stabilityView);
+
+			boardView     = nextBoardView;
+			stabilityView = nextStabilityView;
+		}
+
+		for(uint32_t generation = 1; generation <= generationCount && result; generation++)
+		{
+			int32_t rowBegin = std::max(blockBegin - (int32_t)generation * mRadius, 0);
+			int32_t rowEnd   = std::min(blockBegin - (int32_t)generation * mRadius + (int32_t)gBlockRows, height);
+			if(rowBegin >= rowEnd)
+			{
+				continue;
+			}
+
+			//The last generation goes straight to the files
+			const bool    lastGeneration = (generation == generationCount);
+			CpuMappedView outBoardView     = {nullptr, nullptr, 0};
+			CpuMappedView outStabilityView = {nullptr, nullptr, 0};
+			if(lastGeneration)
+			{
+				size_t rowsBytes = (rowEnd - rowBegin) * rowBytes;
+				if(!outBoardFile.MapView(RowOffset(rowBegin), rowsBytes, outBoardView) || !outStabilityFile.MapView(RowOffset(rowBegin), rowsBytes, outStabilityView))
+				{
+					outBoardFile.UnmapView(outBoardView);
+					result = false;
+					break;
+				}
+			}
+
+			uint32_t taskCount = (rowEnd - rowBegin + gRowsPerTask - 1) / gRowsPerTask;
+			mThreadPool->ParallelFor(taskCount, [this, generation, rowBegin, rowEnd, lastGeneration, &outBoardView, &outStabilityView, clickRule](uint32_t taskIndex, uint32_t /*threadIndex*/)
+			{
+				int32_t taskRowBegin = rowBegin + (int32_t)(taskIndex * gRowsPerTask);
+				int32_t taskRowEnd   = std::min(taskRowBegin + (int32_t)gRowsPerTask, rowEnd);
+
+				for(int32_t y = taskRowBegin; y < taskRowEnd; y++)
+				{
+					uint64_t* outBoardRow    = lastGeneration ? reinterpret_cast<uint64_t*>(outBoardView.Data)     + (y - rowBegin) * mRowWords : BoardWindowRow(generation, y);
+					uint64_t* outUnstableRow = lastGeneration ? reinterpret_cast<uint64_t*>(outStabilityView.Data) + (y - rowBegin) * mRowWords : StabilityWindowRow(generation, y);
+					NextStepRow(generation, y, outBoardRow, outUnstableRow, clickRule);
+				}
+			});
+
+			if(lastGeneration)
+			{
+				//The writes go to the disk in the background, the next blocks don't wait for them
+				outBoardFile.FlushView(outBoardView);
+				outStabilityFile.FlushView(outStabilityView);
+
+				outBoardFile.UnmapView(outBoardView);
+				outStabilityFile.UnmapView(outStabilityView);
+			}
+		}
+	}
+
+	inBoardFile.UnmapView(boardView);
+	inStabilityFile.UnmapView(stabilityView);
+	return result;
+}
+
+void CpuOutOfCoreCalculator::NextStepRow(uint32_t generation, int32_t y, uint64_t* outBoardRow, uint64_t* outUnstableRow, const CpuClickRule* clickRule)
+{
+	const uint64_t* thisRow = InputBoardRow(generation - 1, y);
+	if(!clickRule || clickRule->IsCross())
+	{
+		mKernels.CrossRow(outBoardRow, InputBoardRow(generation - 1, y - 1), thisRow, InputBoardRow(generation - 1, y + 1), mColumnMask.data(), mRowWords);
+	}
+	else
+	{
+		std::fill(outBoardRow, outBoardRow + mRowWords, 0);
+		for(const CpuClickRuleRow& clickRuleRow: clickRule->GetRows())
+		{
+			mKernels.ConvolveRow(outBoardRow, InputBoardRow(generation - 1, y + clickRuleRow.OffsetY), clickRuleRow.MaskX, clickRuleRow.MinOffsetX, mRowWords);
+		}
+
+		mKernels.AndRow(outBoardRow, outBoardRow, mColumnMask.data(), mRowWords);
+	}
+
+	//A cell stays unstable once it changes
+	const uint64_t* prevUnstableRow = StabilityWindowRow(generation - 1, y);
+	for(size_t i = 0; i < mRowWords; i++)
+	{
+		outUnstableRow[i] = prevUnstableRow[i] | (thisRow[i] ^ outBoardRow[i]);
+	}
+}
+
+uint64_t* CpuOutOfCoreCalculator::BoardWindowRow(uint32_t generation, int32_t y)
+{
+	return mBoardWindows.data() + ((size_t)generation * mWindowRows + y % mWindowRows) * mWindowRowStride + BitBoard::RowWordAlignment;
+}
+
+const uint64_t* CpuOutOfCoreCalculator::InputBoardRow(uint32_t generation, int32_t y) const
+{
+	if(y < 0 || y >= (int32_t)mBoardHeight) //Everything outside the board is 0
+	{
+		return mZeroRow.data() + BitBoard::RowWordAlignment;
+	}
+
+	return mBoardWindows.data() + ((size_t)generation * mWindowRows + y % mWindowRows) * mWindowRowStride + BitBoard::RowWordAlignment;
+}
+
+uint64_t* CpuOutOfCoreCalculator::StabilityWindowRow(uint32_t generation, int32_t y)
+{
+	return mStabilityWindows.data() + ((size_t)generation * mWindowRows + y % mWindowRows) * mRowWords;
+}
+
+uint64_t CpuOutOfCoreCalculator::RowOffset(int32_t y) const
+{
+	return (uint64_t)y * mRowWords * sizeof(uint64_t);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+#include "CpuClickRule.hpp"
+#include "CpuFeatures.hpp"
+#include "CpuMappedFile.hpp"
+#include "NextStepKernels.hpp"
+
+class ThreadPool;
+
+//A single cell of the board
+struct CpuCellPosition
+{
+	uint32_t X;
+	uint32_t Y;
+};
+
+/*
+The class for computing the stability of boards that don't fit into the memory, up to 262143x262143.
+Input:               Working folder, board size, the lit cells of the initial board, click rule, memory budget
+Output:              The file with the last computed stability, a downscaled preview of it
+Possible expansions: Restrictions and spawn stability in files, HashLife-style compression of the empty parts
+
+The board and the stability are kept 1 bit per cell in memory-mapped files, two of each to ping-pong between.
+A pass streams through the files once, a block of rows at a time, and computes several generations per pass:
+the generation g of a row only needs the rows within the click rule radius in the generation g - 1,
+so every generation only keeps a rolling window of (block + 2 * radius) rows in memory.
+The next block of the input is prefetched while the current one is computed, and the output of each block is written back in the background.
+The number of generations per pass is as many windows as fit into the memory budget.
+
+The stability files store the unstable cells, so a freshly created (all zeros) file is the initial all-stable stability.
+*/
+
+class CpuOutOfCoreCalculator
+{
+public:
+	CpuOutOfCoreCalculator();
+	~CpuOutOfCoreCalculator();
+
+	void SetInstructionSet(CpuInstructionSet instructionSet); //Clamped to the one supported by the CPU
+	void SetThreadCount(uint32_t threadCount);                //0 means one thread per hardware thread
+
+	bool PrepareForCalculations(const std::wstring& folder, uint32_t width, uint32_t height, const std::vector<CpuCellPosition>& litCells, const CpuClickRule* clickRule, uint64_t memoryBudget); //False if the files can't be created
+	bool StabilityNextSteps(uint32_t stepCount, const CpuClickRule* clickRule);                                                                                                                    //The click rule has to be the same as in PrepareForCalculations(). False if the files can't be mapped
+
+	uint32_t GetBoardWidth()  const;
+	uint32_t GetBoardHeight() const;
+	uint32_t GetCurrentStep() const;
+
+	uint32_t GetStepsPerPass() const; //The most generations a single pass over the files computes
+	uint64_t GetMemoryUsage()  const; //The windows and the mapped views at the most, in bytes
+
+	const std::wstring& GetStabilityFile() const; //The file with the last computed unstable cells, rows of GetRowWords() 64-bit words
+	size_t              GetRowWords()      const;
+
+	bool CopyStabilityPreview(uint16_t* outCells, uint32_t previewWidth, uint32_t previewHeight, size_t rowPitch); //1 for the preview cells with at least half of their board cells stable
+
+private:
+	bool StreamPass(uint32_t generationCount, const CpuClickRule* clickRule);
+
+	void NextStepRow(uint32_t generation, int32_t y, uint64_t* outBoardRow, uint64_t* outUnstableRow, const CpuClickRule* clickRule); //The generation - 1 has to be in the windows
+
+	uint64_t*       BoardWindowRow(uint32_t generation, int32_t y);
+	const uint64_t* InputBoardRow(uint32_t generation, int32_t y) const; //The zero row for the rows outside the board
+	uint64_t*       StabilityWindowRow(uint32_t generation, int32_t y);
+
+	uint64_t RowOffset(int32_t y) const; //In bytes
+
+private:
+	std::unique_ptr<ThreadPool> mThreadPool;
+
+	NextStepKernels   mKernels;
+	CpuInstructionSet mInstructionSet;
+
+	CpuMappedFile mBoardFiles[2];
+	CpuMappedFile mStabilityFiles[2];
+	std::wstring  mStabilityFileNames[2];
+	uint32_t      mCurrentFile; //The index of the files with the current state
+
+	//Windows of mWindowRows rows for each generation computed in a pass, except the last one that goes straight to the files.
+	//The board rows have BitBoard::RowWordAlignment zero guard words on both sides
+	std::vector<uint64_t> mBoardWindows;
+	std::vector<uint64_t> mStabilityWindows;
+	std::vector<uint64_t> mZeroRow;
+	std::vector<uint64_t> mColumnMask;
+
+	uint32_t mBoardWidth;
+	uint32_t mBoardHeight;
+	size_t   mRowWords;
+	size_t   mWindowRowStride; //In words, with the guard words
+	uint32_t mWindowRows;
+	int32_t  mRadius;
+
+	uint32_t mStepsPerPass;
+	uint64_t mMemoryUsage;
+
+	uint32_t mCurrentStep;
+};
@@ -0,0 +1,748 @@
+#include "CpuPeriodSolver.hpp"
+#include "CpuStabilityCalculator.hpp"
+#include "CpuClickRule.hpp"
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <istream>
+#include <ostream>
+
+namespace
+{
+	const uint32_t gProjectionCount    = 64; //One bit of a sample per projection
+	const uint32_t gCellsPerProjection = 16;
+	const uint64_t gProjectionSeed     = 0x5354414652414ull; //Fixed, so the same board always gets the same projections
+
+	const uint32_t gMinFrames        = 256;   //The frames for the first Berlekamp-Massey pass, doubled each time until every projection is solved
+	const uint32_t gDefaultMaxFrames = 65536;
+	const uint32_t gComplexityMargin = 32;    //A projection with the linear complexity L is solved once 2 * L + gComplexityMargin frames agree with it
+
+	const uint32_t gMaxFactorDegree    = 63;         //2^d - 1 has to fit into 64 bits
+	const uint64_t gTrialDivisionBound = 1ull << 20; //For the factors of 2^d - 1
+	const uint64_t gMaxPeriod          = UINT32_MAX;
+
+	const uint64_t gFnvOffsetBasis = 0xcbf29ce484222325ull;
+	const uint64_t gFnvPrime       = 0x100000001b3ull;
+
+	//Bit (i % 64) of word (i / 64) is the coefficient of z^i. The last word is non-zero, the zero polynomial has no words
+	typedef std::vector<uint64_t> Polynomial;
+
+	uint32_t HighestBit(uint64_t word)
+	{
+		uint32_t bit = 0;
+		while(word >>= 1)
+		{
+			bit++;
+		}
+
+		return bit;
+	}
+
+	uint64_t Parity(uint64_t word)
+	{
+		word ^= word >> 32;
+		word ^= word >> 16;
+		word ^= word >> 8;
+		word ^= word >> 4;
+		word ^= word >> 2;
+		word ^= word >> 1;
+		return word & 1;
+	}
+
+	uint64_t ReadBits(const uint64_t* words, size_t bitIndex) //Reads one word past the last bit
+	{
+		size_t   wordIndex = bitIndex / 64;
+		uint32_t bitShift  = bitIndex % 64;
+		if(bitShift == 0)
+		{
+			return words[wordIndex];
+		}
+
+		return (words[wordIndex] >> bitShift) | (words[wordIndex + 1] << (64 - bitShift));
+	}
+
+	//dst ^= src * z^shift for the first srcWordCount words of src. dst has to have room for srcWordCount + 1 words after the shift
+	void XorShifted(uint64_t* dst, const uint64_t* src, size_t srcWordCount, size_t shift)
+	{
+		size_t   wordShift = shift / 64;
+		uint32_t bitShift  = shift % 64;
+		for(size_t i = 0; i < srcWordCount; i++)
+		{
+			dst[i + wordShift] ^= src[i] << bitShift;
+			if(bitShift != 0)
+			{
+				dst[i + wordShift + 1] ^= src[i] >> (64 - bitShift);
+			}
+		}
+	}
+
+	void Trim(Polynomial& p)
+	{
+		while(!p.empty() && p.back() == 0)
+		{
+			p.pop_back();
+		}
+	}
+
+	int64_t Degree(const Polynomial& p) //-1 for the zero polynomial
+	{
+		if(p.empty())
+		{
+			return -1;
+		}
+
+		return (int64_t)(p.size() - 1) * 64 + HighestBit(p.back());
+	}
+
+	bool IsOne(const Polynomial& p)
+	{
+		return p.size() == 1 && p[0] == 1;
+	}
+
+	bool GetCoefficient(const Polynomial& p, size_t power)
+	{
+		return power / 64 < p.size() && ((p[power / 64] >> (power % 64)) & 1);
+	}
+
+	void SetCoefficient(Polynomial& p, size_t power)
+	{
+		if(power / 64 >= p.size())
+		{
+			p.resize(power / 64 + 1, 0);
+		}
+
+		p[power / 64] |= 1ull << (power % 64);
+	}
+
+	void AddShifted(Polynomial& a, const Polynomial& b, size_t shift) //a += b * z^shift
+	{
+		a.resize(std::max(a.size(), b.size() + shift / 64 + 1), 0);
+		XorShifted(a.data(), b.data(), b.size(), shift);
+		Trim(a);
+	}
+
+	Polynomial Multiply(const Polynomial& a, const Polynomial& b)
+	{
+		Polynomial product;
+		for(int64_t power = 0; power <= Degree(a); power++)
+		{
+			if(GetCoefficient(a, power))
+			{
+				AddShifted(product, b, power);
+			}
+		}
+
+		return product;
+	}
+
+	Polynomial Square(const Polynomial& p) //Squaring over GF(2) only spreads the terms: p(z)^2 = p(z^2)
+	{
+		Polynomial square;
+		for(int64_t power = 0; power <= Degree(p); power++)
+		{
+			if(GetCoefficient(p, power))
+			{
+				SetCoefficient(square, power * 2);
+			}
+		}
+
+		return square;
+	}
+
+	void DivMod(const Polynomial& a, const Polynomial& b, Polynomial* outQuotient, Polynomial& outRemainder) //Null outQuotient if only the remainder is needed
+	{
+		outRemainder = a;
+		if(outQuotient)
+		{
+			outQuotient->clear();
+		}
+
+		int64_t divisorDegree = Degree(b);
+		for(int64_t remainderDegree = Degree(outRemainder); remainderDegree >= divisorDegree; remainderDegree = Degree(outRemainder))
+		{
+			size_t shift = (size_t)(remainderDegree - divisorDegree);
+			AddShifted(outRemainder, b, shift);
+
+			if(outQuotient)
+			{
+				SetCoefficient(*outQuotient, shift);
+			}
+		}
+	}
+
+	Polynomial Mod(const Polynomial& a, const Polynomial& b)
+	{
+		Polynomial remainder;
+		DivMod(a, b, nullptr, remainder);
+		return remainder;
+	}
+
+	Polynomial Divide(const Polynomial& a, const Polynomial& b)
+	{
+		Polynomial quotient;
+		Polynomial remainder;
+		DivMod(a, b, &quotient, remainder);
+		return quotient;
+	}
+
+	Polynomial Gcd(Polynomial a, Polynomial b)
+	{
+		while(!b.empty())
+		{
+			Polynomial remainder = Mod(a, b);
+			a.swap(b);
+			b.swap(remainder);
+		}
+
+		return a;
+	}
+
+	Polynomial Lcm(const Polynomial& a, const Polynomial& b)
+	{
+		return Multiply(Divide(a, Gcd(a, b)), b);
+	}
+
+	Polynomial Derivative(const Polynomial& p) //Only the odd powers survive, z^(2k + 1) becomes z^(2k)
+	{
+		Polynomial derivative(p.size(), 0);
+		for(size_t i = 0; i < p.size(); i++)
+		{
+			uint64_t nextWord = (i + 1 < p.size()) ? p[i + 1] : 0;
+			derivative[i]     = ((p[i] >> 1) | (nextWord << 63)) & 0x5555555555555555ull;
+		}
+
+		Trim(derivative);
+		return derivative;
+	}
+
+	Polynomial SquareRoot(const Polynomial& p) //For the polynomials with the zero derivative only, the inverse of Square()
+	{
+		Polynomial root;
+		for(int64_t power = 0; power <= Degree(p); power += 2)
+		{
+			if(GetCoefficient(p, power))
+			{
+				SetCoefficient(root, power / 2);
+			}
+		}
+
+		return root;
+	}
+
+	Polynomial PowerOfZ(uint64_t exponent, const Polynomial& modulus) //z^exponent mod modulus
+	{
+		Polynomial result = {1};
+		for(int32_t bit = HighestBit(exponent); bit >= 0; bit--)
+		{
+			result = Mod(Square(result), modulus);
+			if((exponent >> bit) & 1)
+			{
+				Polynomial shifted;
+				AddShifted(shifted, result, 1);
+				result = Mod(shifted, modulus);
+			}
+		}
+
+		return Mod(result, modulus);
+	}
+
+	uint64_t CappedLcm(uint64_t a, uint64_t b) //0 if either is 0 or the result is above gMaxPeriod
+	{
+		if(a == 0 || b == 0)
+		{
+			return 0;
+		}
+
+		uint64_t x = a;
+		uint64_t y = b;
+		while(y != 0)
+		{
+			uint64_t remainder = x % y;
+			x = y;
+			y = remainder;
+		}
+
+		uint64_t multiplier = a / x;
+		if(multiplier > gMaxPeriod / b)
+		{
+			return 0;
+		}
+
+		return multiplier * b;
+	}
+
+	//The order of z modulo a product of distinct irreducible polynomials of the degree, none of them z. It divides 2^degree - 1, so the prime factors of 2^degree - 1 are removed from it while they can be.
+	//If the factorization stops at gTrialDivisionBound with a composite leftover, the leftover is removed only as a whole, and the result can be a multiple of the order then
+	uint64_t OrderOfZ(const Polynomial& factorProduct, uint32_t degree)
+	{
+		uint64_t order = (1ull << degree) - 1;
+
+		std::vector<uint64_t> primeFactors;
+		uint64_t leftover = order;
+		for(uint64_t divisor = 3; divisor < gTrialDivisionBound && divisor * divisor <= leftover; divisor += 2)
+		{
+			if(leftover % divisor == 0)
+			{
+				primeFactors.push_back(divisor);
+				while(leftover % divisor == 0)
+				{
+					leftover /= divisor;
+				}
+			}
+		}
+
+		if(leftover > 1)
+		{
+			primeFactors.push_back(leftover);
+		}
+
+		for(uint64_t primeFactor: primeFactors)
+		{
+			while(order % primeFactor == 0 && IsOne(PowerOfZ(order / primeFactor, factorProduct)))
+			{
+				order /= primeFactor;
+			}
+		}
+
+		return order;
+	}
+
+	//The order of z modulo a square-free polynomial with the non-zero constant term, from its distinct degree factorization. 0 if it's above gMaxPeriod or can't be found
+	uint64_t SquareFreeOrderOfZ(const Polynomial& squareFree)
+	{
+		uint64_t order = 1;
+
+		Polynomial leftover   = squareFree;
+		Polynomial frobeniusZ = Mod(Polynomial{2}, leftover); //z^(2^degree) mod leftover
+		for(uint32_t degree = 1; Degree(leftover) >= 2 * (int64_t)degree; degree++)
+		{
+			if(degree > gMaxFactorDegree)
+			{
+				return 0;
+			}
+
+			//z^(2^d) - z is the product of all irreducible polynomials with the degree dividing d, and the ones of smaller degrees are removed already
+			frobeniusZ = Mod(Square(frobeniusZ), leftover);
+
+			Polynomial frobeniusMinusZ = frobeniusZ;
+			AddShifted(frobeniusMinusZ, Polynomial{2}, 0);
+
+			Polynomial factorProduct = Gcd(leftover, frobeniusMinusZ);
+			if(!IsOne(factorProduct))
+			{
+				order = CappedLcm(order, OrderOfZ(factorProduct, degree));
+
+				leftover   = Divide(leftover, factorProduct);
+				frobeniusZ = Mod(frobeniusZ, leftover);
+			}
+		}
+
+		//Whatever is left is a single irreducible polynomial
+		int64_t leftoverDegree = Degree(leftover);
+		if(leftoverDegree > (int64_t)gMaxFactorDegree)
+		{
+			return 0;
+		}
+		else if(leftoverDegree > 0)
+		{
+			order = CappedLcm(order, OrderOfZ(leftover, (uint32_t)leftoverDegree));
+		}
+
+		return order;
+	}
+
+	//Appends the square-free factors of p, each one being the product of all irreducible factors of p with the same multiplicity
+	void SquareFreeFactors(const Polynomial& p, uint32_t multiplicity, std::vector<std::pair<Polynomial, uint32_t>>& outFactors)
+	{
+		Polynomial derivative = Derivative(p);
+		if(derivative.empty())
+		{
+			//p(z) = r(z)^2
+			if(Degree(p) > 0)
+			{
+				SquareFreeFactors(SquareRoot(p), multiplicity * 2, outFactors);
+			}
+
+			return;
+		}
+
+		Polynomial repeated = Gcd(p, derivative);
+		Polynomial distinct = Divide(p, repeated);
+		for(uint32_t factorMultiplicity = 1; !IsOne(distinct); factorMultiplicity++)
+		{
+			Polynomial stillRepeated = Gcd(distinct, repeated);
+			Polynomial factor        = Divide(distinct, stillRepeated);
+			if(!IsOne(factor))
+			{
+				outFactors.push_back(std::make_pair(factor, factorMultiplicity * multiplicity));
+			}
+
+			distinct = stillRepeated;
+			repeated = Divide(repeated, stillRepeated);
+		}
+
+		//The multiplicities of what's left are multiples of 2
+		if(!IsOne(repeated))
+		{
+			SquareFreeFactors(SquareRoot(repeated), multiplicity * 2, outFactors);
+		}
+	}
+
+	//The order of z modulo p, p(0) = 1. 0 if it's above gMaxPeriod or can't be found
+	uint64_t PeriodOfZ(const Polynomial& p)
+	{
+		std::vector<std::pair<Polynomial, uint32_t>> factors;
+		SquareFreeFactors(p, 1, factors);
+
+		uint64_t order = 1;
+		for(const auto& factor: factors)
+		{
+			uint64_t multiplicityScale = 1;
+			while(multiplicityScale < factor.second)
+			{
+				multiplicityScale *= 2;
+			}
+
+			uint64_t factorOrder = SquareFreeOrderOfZ(factor.first);
+			if(factorOrder > gMaxPeriod / multiplicityScale)
+			{
+				return 0;
+			}
+
+			order = CappedLcm(order, factorOrder * multiplicityScale);
+		}
+
+		return order;
+	}
+
+	//The linear complexity L of the first bitCount bits of the sequence, and the connection polynomial C(z), C(0) = 1: s(t) = sum of c(i) * s(t - i) for i from 1 to L, t >= L.
+	//The minimal polynomial of the sequence is then z^L * C(1 / z)
+	uint32_t BerlekampMassey(const std::vector<uint64_t>& sequence, size_t bitCount, Polynomial& outConnection)
+	{
+		size_t wordCount = bitCount / 64 + 2;
+
+		//With the sequence reversed, the bits s(t - i) for i = 0, 1, ... go in the order of c(i)
+		std::vector<uint64_t> reversedSequence(wordCount + 1, 0);
+		for(size_t t = 0; t < bitCount; t++)
+		{
+			if((sequence[t / 64] >> (t % 64)) & 1)
+			{
+				size_t reversedIndex = bitCount - 1 - t;
+				reversedSequence[reversedIndex / 64] |= 1ull << (reversedIndex % 64);
+			}
+		}
+
+		std::vector<uint64_t> connection(wordCount, 0);
+		std::vector<uint64_t> prevConnection(wordCount, 0);
+		std::vector<uint64_t> savedConnection;
+		connection[0]     = 1;
+		prevConnection[0] = 1;
+
+		uint32_t complexity     = 0;
+		uint32_t prevComplexity = 0;
+		size_t   shift          = 1;
+		for(size_t t = 0; t < bitCount; t++)
+		{
+			size_t   sequenceOffset = bitCount - 1 - t;
+			uint64_t discrepancy    = 0;
+			for(size_t i = 0; i <= complexity / 64; i++)
+			{
+				discrepancy ^= connection[i] & ReadBits(reversedSequence.data(), sequenceOffset + i * 64);
+			}
+
+			if(Parity(discrepancy) == 0)
+			{
+				shift++;
+				continue;
+			}
+
+			size_t prevWordCount = prevComplexity / 64 + 1;
+			if(2 * (size_t)complexity <= t)
+			{
+				savedConnection.assign(connection.begin(), connection.begin() + complexity / 64 + 1);
+				XorShifted(connection.data(), prevConnection.data(), prevWordCount, shift);
+
+				std::fill(prevConnection.begin(), prevConnection.end(), 0);
+				std::copy(savedConnection.begin(), savedConnection.end(), prevConnection.begin());
+
+				prevComplexity = complexity;
+				complexity     = (uint32_t)(t + 1 - complexity);
+				shift          = 1;
+			}
+			else
+			{
+				XorShifted(connection.data(), prevConnection.data(), prevWordCount, shift);
+				shift++;
+			}
+		}
+
+		outConnection.assign(connection.begin(), connection.begin() + complexity / 64 + 1);
+		Trim(outConnection);
+		return complexity;
+	}
+
+	uint64_t HashValue(uint64_t hash, uint64_t value)
+	{
+		return (hash ^ value) * gFnvPrime;
+	}
+
+	uint64_t HashBoard(uint64_t hash, const BitBoard& board)
+	{
+		hash = HashValue(hash, board.GetWidth());
+		hash = HashValue(hash, board.GetHeight());
+		for(uint32_t y = 0; y < board.GetHeight(); y++)
+		{
+			const uint64_t* row = board.Row(y);
+			for(size_t i = 0; i < board.GetWordsPerRow(); i++)
+			{
+				hash = HashValue(hash, row[i]);
+			}
+		}
+
+		return hash;
+	}
+}
+
+uint32_t CpuSolutionPeriod::GetFinalFrame() const
+{
+	return std::max(PolynomialDegree, 1u);
+}
+
+CpuPeriodSolver::CpuPeriodSolver(): mMaxFrames(gDefaultMaxFrames)
+{
+	mCalculator = std::make_unique<CpuStabilityCalculator>();
+}
+
+CpuPeriodSolver::~CpuPeriodSolver()
+{
+}
+
+void CpuPeriodSolver::SetMaxFrames(uint32_t maxFrames)
+{
+	mMaxFrames = std::max(maxFrames, gMinFrames);
+}
+
+void CpuPeriodSolver::SetThreadCount(uint32_t threadCount)
+{
+	mCalculator->SetThreadCount(threadCount);
+}
+
+bool CpuPeriodSolver::Solve(const BitBoard& initialBoard, const CpuClickRule* clickRule, const BitBoard* restriction, CpuSolutionPeriod& outPeriod)
+{
+	uint32_t width  = initialBoard.GetWidth();
+	uint32_t height = initialBoard.GetHeight();
+
+	std::vector<uint8_t> initialCells((size_t)width * height);
+	initialBoard.ToCells(initialCells.data(), width);
+
+	mCalculator->PrepareForCalculations(initialCells.data(), width, height, width);
+	mCalculator->ReduceBySymmetry(clickRule, restriction);
+	InitProjections(width, height);
+
+	std::vector<uint64_t> samples;
+	samples.push_back(SampleProjections(mCalculator->GetLastBoardState()));
+
+	std::vector<uint64_t> projectionSequence;
+	for(uint32_t frameCount = gMinFrames; ; frameCount = std::min(frameCount * 2, mMaxFrames))
+	{
+		while(samples.size() < frameCount)
+		{
+			mCalculator->StabilityNextStep(clickRule, restriction, 0);
+			samples.push_back(SampleProjections(mCalculator->GetLastBoardState()));
+		}
+
+		bool       solved          = true;
+		uint32_t   preperiodLength = 0;
+		Polynomial periodicPart    = {1}; //The LCM of C(z) of all projections, the reverse of q(z)
+		for(uint32_t projection = 0; projection < gProjectionCount && solved; projection++)
+		{
+			projectionSequence.assign(frameCount / 64 + 1, 0);
+			for(size_t t = 0; t < frameCount; t++)
+			{
+				projectionSequence[t / 64] |= ((samples[t] >> projection) & 1) << (t % 64);
+			}
+
+			Polynomial connection;
+			uint32_t complexity = BerlekampMassey(projectionSequence, frameCount, connection);
+
+			solved          = (2 * (uint64_t)complexity + gComplexityMargin <= frameCount);
+			preperiodLength = std::max(preperiodLength, complexity - (uint32_t)Degree(connection));
+			periodicPart    = Lcm(periodicPart, connection);
+		}
+
+		if(solved && !IsAnnihilating(initialCells, width, height, clickRule, restriction, preperiodLength, periodicPart))
+		{
+			return false;
+		}
+
+		if(solved)
+		{
+			//The order of z modulo a polynomial is the same as modulo its reverse
+			outPeriod.PreperiodLength  = preperiodLength;
+			outPeriod.Period           = (uint32_t)PeriodOfZ(periodicPart);
+			outPeriod.PolynomialDegree = preperiodLength + (uint32_t)Degree(periodicPart);
+			return true;
+		}
+
+		if(frameCount >= mMaxFrames)
+		{
+			return false;
+		}
+	}
+}
+
+uint64_t CpuPeriodSolver::ComputeKey(const BitBoard& initialBoard, const CpuClickRule* clickRule, const BitBoard* restriction)
+{
+	uint64_t key = HashBoard(gFnvOffsetBasis, initialBoard);
+
+	key = HashValue(key, clickRule != nullptr);
+	if(clickRule)
+	{
+		for(const CpuClickRuleRow& row: clickRule->GetRows())
+		{
+			key = HashValue(key, (uint32_t)row.OffsetY);
+			for(int32_t offsetX: row.OffsetsX)
+			{
+				key = HashValue(key, (uint32_t)offsetX);
+			}
+		}
+	}
+
+	key = HashValue(key, restriction != nullptr);
+	if(restriction)
+	{
+		key = HashBoard(key, *restriction);
+	}
+
+	return key;
+}
+
+void CpuPeriodSolver::InitProjections(uint32_t width, uint32_t height)
+{
+	//Only the simulated part of the board is valid if it's reduced by symmetry, the rest is its mirror image anyway
+	uint32_t sampledWidth  = mCalculator->IsMirroredX() ? (width  + 1) / 2 : width;
+	uint32_t sampledHeight = mCalculator->IsMirroredY() ? (height + 1) / 2 : height;
+
+	std::mt19937_64 randomGenerator(gProjectionSeed);
+	std::uniform_int_distribution<uint32_t> xDistribution(0, sampledWidth  - 1);
+	std::uniform_int_distribution<uint32_t> yDistribution(0, sampledHeight - 1);
+
+	mProjectionCellsX.resize(gProjectionCount * gCellsPerProjection);
+	mProjectionCellsY.resize(gProjectionCount * gCellsPerProjection);
+	for(size_t i = 0; i < mProjectionCellsX.size(); i++)
+	{
+		mProjectionCellsX[i] = xDistribution(randomGenerator);
+		mProjectionCellsY[i] = yDistribution(randomGenerator);
+	}
+}
+
+bool CpuPeriodSolver::IsAnnihilating(const std::vector<uint8_t>& initialCells, uint32_t width, uint32_t height, const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t preperiodLength, const std::vector<uint64_t>& periodicPart)
+{
+	mCalculator->PrepareForCalculations(initialCells.data(), width, height, width);
+	mCalculator->ReduceBySymmetry(clickRule, restriction);
+
+	//Same as the projections, the rest of the board is the mirror image
+	uint32_t sampledWidth  = mCalculator->IsMirroredX() ? (width  + 1) / 2 : width;
+	uint32_t sampledHeight = mCalculator->IsMirroredY() ? (height + 1) / 2 : height;
+	size_t   sampledWords  = (sampledWidth + 63) / 64;
+	uint64_t lastWordMask  = (sampledWidth % 64 == 0) ? ~0ull : (1ull << (sampledWidth % 64)) - 1;
+
+	//m(z) = z^preperiodLength * q(z), and the coefficient of z^i in q(z) is the coefficient of z^(degree - preperiodLength - i) in periodicPart.
+	//m(M) applied to the initial board is the XOR of the boards t with the coefficient of z^(degree - t) in periodicPart, t from preperiodLength to degree
+	uint32_t degree = preperiodLength + (uint32_t)Degree(periodicPart);
+
+	std::vector<uint64_t> boardSum(sampledWords * sampledHeight, 0);
+	for(uint32_t t = 0; ; t++)
+	{
+		if(t >= preperiodLength && GetCoefficient(periodicPart, degree - t))
+		{
+			const BitBoard& board = mCalculator->GetLastBoardState();
+			for(uint32_t y = 0; y < sampledHeight; y++)
+			{
+				const uint64_t* row = board.Row((int32_t)y);
+				for(size_t i = 0; i < sampledWords; i++)
+				{
+					boardSum[y * sampledWords + i] ^= row[i];
+				}
+			}
+		}
+
+		if(t == degree)
+		{
+			break;
+		}
+
+		mCalculator->StabilityNextStep(clickRule, restriction, 0);
+	}
+
+	for(uint32_t y = 0; y < sampledHeight; y++)
+	{
+		boardSum[y * sampledWords + sampledWords - 1] &= lastWordMask;
+	}
+
+	return std::all_of(boardSum.begin(), boardSum.end(), [](uint64_t word) {return word == 0;});
+}
+
+uint64_t CpuPeriodSolver::SampleProjections(const BitBoard& board) const
+{
+	uint64_t sample = 0;
+	for(uint32_t projection = 0; projection < gProjectionCount; projection++)
+	{
+		uint64_t projectionValue = 0;
+		for(uint32_t i = projection * gCellsPerProjection; i < (projection + 1) * gCellsPerProjection; i++)
+		{
+			projectionValue ^= board.GetCell(mProjectionCellsX[i], mProjectionCellsY[i]);
+		}
+
+		sample |= projectionValue << projection;
+	}
+
+	return sample;
+}
+
+CpuSolutionPeriodCache::CpuSolutionPeriodCache()
+{
+}
+
+CpuSolutionPeriodCache::~CpuSolutionPeriodCache()
+{
+}
+
+bool CpuSolutionPeriodCache::Find(uint64_t key, CpuSolutionPeriod& outPeriod) const
+{
+	auto periodIt = mPeriods.find(key);
+	if(periodIt == mPeriods.end())
+	{
+		return false;
+	}
+
+	outPeriod = periodIt->second;
+	return true;
+}
+
+void CpuSolutionPeriodCache::Add(uint64_t key, const CpuSolutionPeriod& period)
+{
+	mPeriods[key] = period;
+}
+
+bool CpuSolutionPeriodCache::Write(std::ostream& stream) const
+{
+	for(const auto& keyPeriod: mPeriods)
+	{
+		stream << std::hex << keyPeriod.first << std::dec << ' ' << keyPeriod.second.PreperiodLength << ' ' << keyPeriod.second.Period << ' ' << keyPeriod.second.PolynomialDegree << '\n';
+	}
+
+	return (bool)stream;
+}
+
+bool CpuSolutionPeriodCache::Read(std::istream& stream)
+{
+	uint64_t          key = 0;
+	CpuSolutionPeriod period;
+	while(stream >> std::hex >> key >> std::dec >> period.PreperiodLength >> period.Period >> period.PolynomialDegree)
+	{
+		mPeriods[key] = period;
+	}
+
+	return stream.eof();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <memory>
+#include <iosfwd>
+#include "BitBoard.hpp"
+
+class CpuClickRule;
+class CpuStabilityCalculator;
+
+//The minimal polynomial of the board sequence b, M(b), M(M(b)), ... over GF(2) is z^PreperiodLength * q(z) with q(0) = 1
+struct CpuSolutionPeriod
+{
+	uint32_t PreperiodLength;  //The number of steps before the board sequence becomes periodic
+	uint32_t Period;           //The period of the board sequence after that, 0 if it's above UINT32_MAX or has a factor of degree above 63. The final frame doesn't need it
+	uint32_t PolynomialDegree; //The degree of the minimal polynomial
+
+	uint32_t GetFinalFrame() const; //No cell can become unstable after this frame. Never later than PreperiodLength + Period
+};
+
+/*
+The class for finding the frame the stability stops changing at, from the minimal polynomial of the board sequence.
+Input:               Initial board, click rule, restriction
+Output:              Preperiod, period and the degree of the minimal polynomial of the board sequence
+Possible expansions: Spawn stability period, block Wiedemann for boards with longer sequences
+
+Each step is linear over GF(2), so every cell (and every XOR of cells) of the board sequence satisfies the recurrence of its minimal polynomial m(z).
+A cell that stays the same for deg(m) + 1 frames satisfies the recurrence of z - 1 as well, and then it never changes again. So the stability is final at the frame deg(m).
+m(z) is the LCM of the minimal polynomials of a few random projections of the board (XORs of random cells), each one found by Berlekamp-Massey.
+Each of them divides the minimal polynomial of the board, so the LCM can only miss some of its factors. To rule that out the board sequence is computed once more
+and the LCM has to annihilate it: the XOR of the boards with the coefficients of m(z) has to be zero. Then it's exactly m(z), otherwise nothing is solved.
+The period is the order of z modulo q(z): 2^d - 1 is a multiple of the order for a product of distinct irreducible factors of degree d,
+and a factor of multiplicity k multiplies the order by the smallest power of 2 not less than k
+*/
+
+class CpuPeriodSolver
+{
+public:
+	CpuPeriodSolver();
+	~CpuPeriodSolver();
+
+	void SetMaxFrames(uint32_t maxFrames);     //Gives up on the boards with the degree of the minimal polynomial above about maxFrames / 2
+	void SetThreadCount(uint32_t threadCount); //The threads that compute the board sequence, 0 means one thread per hardware thread
+
+	bool Solve(const BitBoard& initialBoard, const CpuClickRule* clickRule, const BitBoard* restriction, CpuSolutionPeriod& outPeriod); //Null click rule is the default one, null restriction is no restriction
+
+	static uint64_t ComputeKey(const BitBoard& initialBoard, const CpuClickRule* clickRule, const BitBoard* restriction); //The hash of everything the solution period depends on
+
+private:
+	void     InitProjections(uint32_t width, uint32_t height);
+	uint64_t SampleProjections(const BitBoard& board) const; //Bit i is the projection i of the board
+
+	bool IsAnnihilating(const std::vector<uint8_t>& initialCells, uint32_t width, uint32_t height, const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t preperiodLength, const std::vector<uint64_t>& periodicPart); //True if z^preperiodLength times the reverse of periodicPart annihilates the board sequence
+
+private:
+	std::unique_ptr<CpuStabilityCalculator> mCalculator;
+
+	std::vector<uint32_t> mProjectionCellsX; //gCellsPerProjection cells for each projection
+	std::vector<uint32_t> mProjectionCellsY;
+
+	uint32_t mMaxFrames;
+};
+
+/*
+The class for storing the solved periods on disk, so that each board is solved only once.
+Input:               A stream with the saved periods, new periods
+Output:              The period for the key, if it was solved before
+Possible expansions: Limiting the size of the cache
+*/
+
+class CpuSolutionPeriodCache
+{
+public:
+	CpuSolutionPeriodCache();
+	~CpuSolutionPeriodCache();
+
+	bool Find(uint64_t key, CpuSolutionPeriod& outPeriod) const;
+	void Add(uint64_t key, const CpuSolutionPeriod& period);
+
+	bool Write(std::ostream& stream) const; //One line per period: the key in hex, then the preperiod, the period (0 if it's too long to find, see CpuSolutionPeriod) and the polynomial degree
+	bool Read(std::istream& stream);
+
+private:
+	std::map<uint64_t, CpuSolutionPeriod> mPeriods;
+};
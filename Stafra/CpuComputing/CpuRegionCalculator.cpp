@@ -0,0 +1,346 @@
+#include "CpuRegionCalculator.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	const uint32_t gRowsPerTask = 16;
+
+	size_t AlignWordsDown(size_t wordIndex)
+	{
+		return wordIndex / BitBoard::RowWordAlignment * BitBoard::RowWordAlignment;
+	}
+
+	size_t AlignWordsUp(size_t wordIndex)
+	{
+		return (wordIndex + BitBoard::RowWordAlignment - 1) / BitBoard::RowWordAlignment * BitBoard::RowWordAlignment;
+	}
+
+	//The region expanded by reach cells in every direction, clamped to width x height
+	CpuRegion ExpandRegion(const CpuRegion& region, uint64_t reach, uint32_t width, uint32_t height)
+	{
+		uint64_t left   = (region.X > reach) ? region.X - reach : 0;
+		uint64_t top    = (region.Y > reach) ? region.Y - reach : 0;
+		uint64_t right  = std::min((uint64_t)region.X + region.Width  + reach, (uint64_t)width);
+		uint64_t bottom = std::min((uint64_t)region.Y + region.Height + reach, (uint64_t)height);
+
+		CpuRegion expanded;
+		expanded.X      = (uint32_t)left;
+		expanded.Y      = (uint32_t)top;
+		expanded.Width  = (uint32_t)(right  - left);
+		expanded.Height = (uint32_t)(bottom - top);
+		return expanded;
+	}
+
+	//outRow gets wordCount words of row starting from the cell firstCell. The cells past sourceWords words are zeros
+	void CopyShiftedRow(uint64_t* outRow, const uint64_t* row, uint32_t firstCell, size_t sourceWords, size_t wordCount)
+	{
+		const uint32_t shift = firstCell % 64;
+		for(size_t i = 0; i < wordCount; i++)
+		{
+			size_t sourceIndex = firstCell / 64 + i;
+
+			uint64_t word = 0;
+			if(sourceIndex < sourceWords)
+			{
+				word = row[sourceIndex] >> shift;
+			}
+
+			if(shift != 0 && sourceIndex + 1 < sourceWords)
+			{
+				word |= row[sourceIndex + 1] << (64 - shift);
+			}
+
+			outRow[i] = word;
+		}
+	}
+}
+
+CpuRegionCalculator::CpuRegionCalculator(): mRegion{0, 0, 0, 0}, mDomain{0, 0, 0, 0}, mRadius(1), mStabilityPlaneCount(1), mComputedCellCount(0), mCurrentStep(0), mFinalStep(0)
+{
+	SetInstructionSet(CpuFeatures::DetectInstructionSet());
+	SetThreadCount(0);
+}
+
+CpuRegionCalculator::~CpuRegionCalculator()
+{
+}
+
+void CpuRegionCalculator::SetInstructionSet(CpuInstructionSet instructionSet)
+{
+	mInstructionSet = std::min(instructionSet, CpuFeatures::DetectInstructionSet());
+	mKernels        = CpuKernels::SelectKernels(mInstructionSet);
+}
+
+void CpuRegionCalculator::SetThreadCount(uint32_t threadCount)
+{
+	mThreadPool.reset();
+	mThreadPool = std::make_unique<ThreadPool>(threadCount);
+}
+
+bool CpuRegionCalculator::PrepareForCalculations(const uint8_t* initialBoard, uint32_t width, uint32_t height, size_t rowPitch, const CpuRegion& region, uint32_t finalStep, const CpuClickRule* clickRule, const BitBoard* restriction)
+{
+	mRegion            = ExpandRegion(region, 0, width, height);
+	mRadius            = clickRule ? std::max(clickRule->GetRadius(), 1) : 1;
+	mComputedCellCount = 0;
+	mCurrentStep       = 0;
+	mFinalStep         = finalStep;
+
+	if(mRegion.Width == 0 || mRegion.Height == 0)
+	{
+		mDomain = mRegion;
+		return false;
+	}
+
+	mDomain = ExpandRegion(mRegion, (uint64_t)finalStep * mRadius, width, height);
+
+	mPrevBoard.Resize(mDomain.Width, mDomain.Height);
+	mCurrBoard.Resize(mDomain.Width, mDomain.Height);
+	mPrevBoard.FromCells(initialBoard + mDomain.Y * rowPitch + mDomain.X, rowPitch);
+
+	const size_t wordsPerRow = mPrevBoard.GetWordsPerRow();
+	if(restriction)
+	{
+		mRestriction.Resize(mDomain.Width, mDomain.Height);
+		mPrevRestrictedBoard.Resize(mDomain.Width, mDomain.Height);
+		mCurrRestrictedBoard.Resize(mDomain.Width, mDomain.Height);
+
+		for(int32_t y = 0; y < (int32_t)mDomain.Height; y++)
+		{
+			uint64_t* restrictionRow = mRestriction.Row(y);
+			CopyShiftedRow(restrictionRow, restriction->Row(y + (int32_t)mDomain.Y), mDomain.X, restriction->GetWordsPerRow(), wordsPerRow);
+			mKernels.AndRow(restrictionRow, restrictionRow, mRestriction.GetColumnMask(), wordsPerRow);
+
+			mKernels.AndRow(mPrevRestrictedBoard.Row(y), mPrevBoard.Row(y), restrictionRow, wordsPerRow);
+		}
+	}
+	else
+	{
+		mRestriction.Resize(0, 0);
+		mPrevRestrictedBoard.Resize(0, 0);
+		mCurrRestrictedBoard.Resize(0, 0);
+	}
+
+	//Every cell starts stable, the same as CpuStabilityCalculator
+	mStabilityPlaneCount = 1;
+	mPrevStability.assign(wordsPerRow * mDomain.Height, 0);
+	mCurrStability.assign(wordsPerRow * mDomain.Height, 0);
+	for(uint32_t y = 0; y < mDomain.Height; y++)
+	{
+		memcpy(mPrevStability.data() + y * wordsPerRow, mPrevBoard.GetColumnMask(), wordsPerRow * sizeof(uint64_t));
+	}
+
+	return true;
+}
+
+void CpuRegionCalculator::StabilityNextSteps(uint32_t stepCount, const CpuClickRule* clickRule, uint32_t spawnPeriod)
+{
+	if(mRegion.Width == 0 || mRegion.Height == 0)
+	{
+		return;
+	}
+
+	//The values go up to spawnPeriod + 1, the same plane count as CpuStabilityCalculator uses
+	uint32_t planeCount = 1;
+	if(spawnPeriod != 0)
+	{
+		while(planeCount < 32 && ((spawnPeriod + 1) >> planeCount) != 0)
+		{
+			planeCount++;
+		}
+
+		planeCount = std::max(planeCount, mStabilityPlaneCount);
+	}
+
+	ResizeStabilityPlanes(planeCount);
+
+	stepCount = std::min(stepCount, mFinalStep - mCurrentStep);
+	for(uint32_t step = 0; step < stepCount; step++)
+	{
+		//The cells outside the light cone of the next step are left as they are, nothing in the region depends on them anymore
+		CpuRegion lightCone = GetLightCone(mCurrentStep + 1);
+
+		size_t wordBegin = AlignWordsDown(lightCone.X / 64);
+		size_t wordEnd   = std::min(AlignWordsUp((lightCone.X + lightCone.Width + 63) / 64), mPrevBoard.GetWordsPerRow());
+		size_t wordCount = wordEnd - wordBegin;
+
+		uint32_t taskCount = (lightCone.Height + gRowsPerTask - 1) / gRowsPerTask;
+		mThreadPool->ParallelFor(taskCount, [this, &lightCone, wordBegin, wordCount, clickRule, spawnPeriod](uint32_t taskIndex, uint32_t /*threadIndex*/)
+		{
+			uint32_t rowBegin = lightCone.Y + taskIndex * gRowsPerTask;
+			uint32_t rowEnd   = std::min(rowBegin + gRowsPerTask, lightCone.Y + lightCone.Height);
+
+			for(uint32_t y = rowBegin; y < rowEnd; y++)
+			{
+				NextStepRow((int32_t)y, wordBegin, wordCount, clickRule, spawnPeriod);
+			}
+		});
+
+		mPrevBoard.Swap(mCurrBoard);
+		mPrevRestrictedBoard.Swap(mCurrRestrictedBoard);
+		std::swap(mPrevStability, mCurrStability);
+
+		mComputedCellCount += (uint64_t)lightCone.Height * wordCount * 64;
+		mCurrentStep++;
+	}
+}
+
+const CpuRegion& CpuRegionCalculator::GetRegion() const
+{
+	return mRegion;
+}
+
+const CpuRegion& CpuRegionCalculator::GetDomain() const
+{
+	return mDomain;
+}
+
+uint32_t CpuRegionCalculator::GetCurrentStep() const
+{
+	return mCurrentStep;
+}
+
+uint32_t CpuRegionCalculator::GetFinalStep() const
+{
+	return mFinalStep;
+}
+
+uint64_t CpuRegionCalculator::GetComputedCellCount() const
+{
+	return mComputedCellCount;
+}
+
+void CpuRegionCalculator::CopyStabilityCells(uint16_t* outCells, size_t rowPitch) const
+{
+	const size_t wordsPerRow   = mPrevBoard.GetWordsPerRow();
+	const size_t planeRowPitch = mStabilityPlaneCount * wordsPerRow;
+
+	const uint32_t regionX   = mRegion.X - mDomain.X;
+	const uint32_t regionY   = mRegion.Y - mDomain.Y;
+	const size_t   wordBegin = AlignWordsDown(regionX / 64);
+	const size_t   wordEnd   = std::min(AlignWordsUp((regionX + mRegion.Width + 63) / 64), wordsPerRow);
+
+	uint32_t taskCount = (mRegion.Height + gRowsPerTask - 1) / gRowsPerTask;
+	mThreadPool->ParallelFor(taskCount, [this, outCells, rowPitch, planeRowPitch, wordsPerRow, regionX, regionY, wordBegin, wordEnd](uint32_t taskIndex, uint32_t /*threadIndex*/)
+	{
+		uint32_t rowBegin = taskIndex * gRowsPerTask;
+		uint32_t rowEnd   = std::min(rowBegin + gRowsPerTask, mRegion.Height);
+
+		std::vector<uint16_t> expandedRow((wordEnd - wordBegin) * 64);
+		for(uint32_t y = rowBegin; y < rowEnd; y++)
+		{
+			const uint64_t* planes = mPrevStability.data() + (regionY + y) * planeRowPitch + wordBegin;
+			if(mStabilityPlaneCount == 1)
+			{
+				mKernels.ExpandRow(expandedRow.data(), planes, wordEnd - wordBegin);
+			}
+			else
+			{
+				mKernels.ExpandPlanesRow(expandedRow.data(), planes, wordsPerRow, mStabilityPlaneCount, wordEnd - wordBegin);
+			}
+
+			memcpy(outCells + y * rowPitch, expandedRow.data() + (regionX - wordBegin * 64), mRegion.Width * sizeof(uint16_t));
+		}
+	});
+}
+
+CpuRegion CpuRegionCalculator::GetLightCone(uint32_t step) const
+{
+	CpuRegion region;
+	region.X      = mRegion.X - mDomain.X;
+	region.Y      = mRegion.Y - mDomain.Y;
+	region.Width  = mRegion.Width;
+	region.Height = mRegion.Height;
+
+	return ExpandRegion(region, (uint64_t)(mFinalStep - step) * mRadius, mDomain.Width, mDomain.Height);
+}
+
+void CpuRegionCalculator::ResizeStabilityPlanes(uint32_t planeCount)
+{
+	if(planeCount == mStabilityPlaneCount)
+	{
+		return;
+	}
+
+	const size_t wordsPerRow      = mPrevBoard.GetWordsPerRow();
+	const size_t oldPlaneRowPitch = mStabilityPlaneCount * wordsPerRow;
+	const size_t newPlaneRowPitch = planeCount * wordsPerRow;
+
+	std::vector<uint64_t> planes(newPlaneRowPitch * mDomain.Height, 0);
+	for(uint32_t y = 0; y < mDomain.Height; y++)
+	{
+		const uint64_t* oldRow = mPrevStability.data() + y * oldPlaneRowPitch;
+		uint64_t*       newRow = planes.data() + y * newPlaneRowPitch;
+
+		if(planeCount == 1)
+		{
+			//Non-zero values are stable
+			for(uint32_t plane = 0; plane < mStabilityPlaneCount; plane++)
+			{
+				for(size_t i = 0; i < wordsPerRow; i++)
+				{
+					newRow[i] |= oldRow[plane * wordsPerRow + i];
+				}
+			}
+		}
+		else
+		{
+			memcpy(newRow, oldRow, std::min(oldPlaneRowPitch, newPlaneRowPitch) * sizeof(uint64_t));
+		}
+	}
+
+	mPrevStability.swap(planes);
+	mCurrStability.assign(newPlaneRowPitch * mDomain.Height, 0);
+	mStabilityPlaneCount = planeCount;
+}
+
+void CpuRegionCalculator::NextStepRow(int32_t y, size_t wordBegin, size_t wordCount, const CpuClickRule* clickRule, uint32_t spawnPeriod)
+{
+	const bool      restricted  = (mRestriction.GetWidth() != 0);
+	const BitBoard& sourceBoard = restricted ? mPrevRestrictedBoard : mPrevBoard;
+	const uint64_t* columnMask  = mPrevBoard.GetColumnMask() + wordBegin;
+
+	uint64_t*       nextRow = mCurrBoard.Row(y) + wordBegin;
+	const uint64_t* thisRow = mPrevBoard.Row(y) + wordBegin;
+	if(!clickRule || clickRule->IsCross())
+	{
+		mKernels.CrossRow(nextRow, sourceBoard.Row(y - 1) + wordBegin, sourceBoard.Row(y) + wordBegin, sourceBoard.Row(y + 1) + wordBegin, columnMask, wordCount);
+	}
+	else
+	{
+		std::fill(nextRow, nextRow + wordCount, 0);
+		for(const CpuClickRuleRow& clickRuleRow: clickRule->GetRows())
+		{
+			int32_t sourceY = y + clickRuleRow.OffsetY;
+			if(sourceY < 0 || sourceY >= (int32_t)mDomain.Height) //Everything outside the domain is 0
+			{
+				continue;
+			}
+
+			mKernels.ConvolveRow(nextRow, sourceBoard.Row(sourceY) + wordBegin, clickRuleRow.MaskX, clickRuleRow.MinOffsetX, wordCount);
+		}
+
+		mKernels.AndRow(nextRow, nextRow, columnMask, wordCount);
+	}
+
+	const uint64_t* restrictionRow = nullptr;
+	if(restricted)
+	{
+		restrictionRow = mRestriction.Row(y) + wordBegin;
+		mKernels.AndRow(mCurrRestrictedBoard.Row(y) + wordBegin, nextRow, restrictionRow, wordCount);
+	}
+
+	const size_t    wordsPerRow   = mPrevBoard.GetWordsPerRow();
+	const size_t    planeRowPitch = mStabilityPlaneCount * wordsPerRow;
+	uint64_t*       nextPlanes    = mCurrStability.data() + y * planeRowPitch + wordBegin;
+	const uint64_t* prevPlanes    = mPrevStability.data() + y * planeRowPitch + wordBegin;
+	if(spawnPeriod == 0)
+	{
+		mKernels.StabilityRow(nextPlanes, prevPlanes, thisRow, nextRow, restrictionRow, wordCount);
+	}
+	else
+	{
+		mKernels.SpawnStabilityRow(nextPlanes, prevPlanes, wordsPerRow, mStabilityPlaneCount, thisRow, nextRow, restrictionRow, spawnPeriod, wordCount);
+	}
+}
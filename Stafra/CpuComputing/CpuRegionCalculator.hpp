@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include "BitBoard.hpp"
+#include "CpuClickRule.hpp"
+#include "CpuFeatures.hpp"
+#include "NextStepKernels.hpp"
+
+class ThreadPool;
+
+//A rectangle of board cells
+struct CpuRegion
+{
+	uint32_t X;
+	uint32_t Y;
+	uint32_t Width;
+	uint32_t Height;
+};
+
+/*
+The class for computing the stability of a part of a big board only.
+Input:               Initial board (1 byte per cell), the region, the final step, click rule, restriction
+Output:              The stability of the region at any step up to the final one
+Possible expansions: Several regions sharing the light cone, temporal blocking
+
+A cell at the final step only depends on the cells within (steps left) * (click rule radius) of it, its light cone.
+Only the light cone of the region is simulated: the domain is the region expanded by (final step) * radius and clamped to the board,
+and every step computes only the part of it that can still reach the region, so the simulated part shrinks to the region itself by the final step.
+The board border is the real one wherever the domain touches it. Elsewhere the cells outside the domain are zeros,
+and the cells that get wrong values from them are always outside the light cone.
+*/
+
+class CpuRegionCalculator
+{
+public:
+	CpuRegionCalculator();
+	~CpuRegionCalculator();
+
+	void SetInstructionSet(CpuInstructionSet instructionSet); //Clamped to the one supported by the CPU
+	void SetThreadCount(uint32_t threadCount);                //0 means one thread per hardware thread
+
+	bool PrepareForCalculations(const uint8_t* initialBoard, uint32_t width, uint32_t height, size_t rowPitch, const CpuRegion& region, uint32_t finalStep, const CpuClickRule* clickRule, const BitBoard* restriction); //The region is clamped to the board, false if nothing is left of it
+	void StabilityNextSteps(uint32_t stepCount, const CpuClickRule* clickRule, uint32_t spawnPeriod); //The click rule and the restriction have to be the same as in PrepareForCalculations(), stops at the final step
+
+	const CpuRegion& GetRegion() const;
+	const CpuRegion& GetDomain() const; //The part of the board simulated at the first step
+
+	uint32_t GetCurrentStep() const;
+	uint32_t GetFinalStep()   const;
+
+	uint64_t GetComputedCellCount() const; //Over all steps so far, rounded up to whole words
+
+	void CopyStabilityCells(uint16_t* outCells, size_t rowPitch) const; //The region only, the same values CpuStabilityCalculator::CopyStabilityCells() gives for it
+
+private:
+	CpuRegion GetLightCone(uint32_t step) const; //The cells of the domain that can still reach the region by the final step, in the domain coordinates
+
+	void ResizeStabilityPlanes(uint32_t planeCount); //A single plane is the 0/1 stability, more planes continue from it with the value 1 for the stable cells
+
+	void NextStepRow(int32_t y, size_t wordBegin, size_t wordCount, const CpuClickRule* clickRule, uint32_t spawnPeriod);
+
+private:
+	std::unique_ptr<ThreadPool> mThreadPool;
+
+	NextStepKernels   mKernels;
+	CpuInstructionSet mInstructionSet;
+
+	CpuRegion mRegion;
+	CpuRegion mDomain;
+	int32_t   mRadius;
+
+	//The domain only
+	BitBoard mPrevBoard;
+	BitBoard mCurrBoard;
+	BitBoard mPrevRestrictedBoard; //Board AND restriction, the only cells the click rule reads. Empty without the restriction
+	BitBoard mCurrRestrictedBoard;
+	BitBoard mRestriction;
+
+	//The stability as mStabilityPlaneCount bit planes per row (the plane p holds the bit p of each value)
+	std::vector<uint64_t> mPrevStability;
+	std::vector<uint64_t> mCurrStability;
+	uint32_t              mStabilityPlaneCount;
+
+	uint64_t mComputedCellCount;
+
+	uint32_t mCurrentStep;
+	uint32_t mFinalStep;
+};
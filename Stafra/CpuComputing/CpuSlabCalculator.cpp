@@ -0,0 +1,232 @@
+#include "CpuSlabCalculator.hpp"
+#include "BitBoard.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+namespace
+{
+	const uint32_t gRowsPerTask = 4;
+
+	size_t AlignWords(size_t wordCount)
+	{
+		return (wordCount + BitBoard::RowWordAlignment - 1) / BitBoard::RowWordAlignment * BitBoard::RowWordAlignment;
+	}
+}
+
+CpuSlabCalculator::CpuSlabCalculator(): mCurrentBoard(0), mBoardWidth(0), mRowBegin(0), mRowCount(0), mRowWords(0), mRowStride(0), mRadius(1), mSlabIndex(0), mSlabCount(1), mExchangedBytes(0), mCurrentStep(0)
+{
+	SetInstructionSet(CpuFeatures::DetectInstructionSet());
+	SetThreadCount(0);
+}
+
+CpuSlabCalculator::~CpuSlabCalculator()
+{
+}
+
+void CpuSlabCalculator::SetInstructionSet(CpuInstructionSet instructionSet)
+{
+	mInstructionSet = std::min(instructionSet, CpuFeatures::DetectInstructionSet());
+	mKernels        = CpuKernels::SelectKernels(mInstructionSet);
+}
+
+void CpuSlabCalculator::SetThreadCount(uint32_t threadCount)
+{
+	mThreadPool.reset();
+	mThreadPool = std::make_unique<ThreadPool>(threadCount);
+}
+
+void CpuSlabCalculator::GetSlabRows(uint32_t height, uint32_t slabIndex, uint32_t slabCount, uint32_t& outRowBegin, uint32_t& outRowEnd)
+{
+	outRowBegin = (uint32_t)((uint64_t)height * slabIndex       / slabCount);
+	outRowEnd   = (uint32_t)((uint64_t)height * (slabIndex + 1) / slabCount);
+}
+
+bool CpuSlabCalculator::PrepareForCalculations(const uint8_t* initialBoard, uint32_t width, uint32_t height, size_t rowPitch, uint32_t slabIndex, uint32_t slabCount, const CpuClickRule* clickRule)
+{
+	mRadius = clickRule ? std::max(clickRule->GetRadius(), 1) : 1;
+
+	//The halo of a slab comes from the neighbor slab only
+	if(slabCount == 0 || slabIndex >= slabCount || (slabCount > 1 && height / slabCount < (uint32_t)mRadius))
+	{
+		return false;
+	}
+
+	uint32_t rowEnd = 0;
+	GetSlabRows(height, slabIndex, slabCount, mRowBegin, rowEnd);
+
+	mBoardWidth     = width;
+	mRowCount       = rowEnd - mRowBegin;
+	mRowWords       = AlignWords((width + 63) / 64);
+	mRowStride      = mRowWords + 2 * BitBoard::RowWordAlignment;
+	mSlabIndex      = slabIndex;
+	mSlabCount      = slabCount;
+	mCurrentBoard   = 0;
+	mCurrentStep    = 0;
+	mExchangedBytes = 0;
+
+	mColumnMask.assign(mRowWords, 0);
+	for(uint32_t x = 0; x < width; x++)
+	{
+		mColumnMask[x / 64] |= 1ull << (x % 64);
+	}
+
+	for(uint32_t boardIndex = 0; boardIndex < 2; boardIndex++)
+	{
+		mBoards[boardIndex].assign((mRowCount + 2 * mRadius) * mRowStride, 0);
+	}
+
+	for(uint32_t y = 0; y < mRowCount; y++)
+	{
+		const uint8_t* cellRow  = initialBoard + (mRowBegin + y) * rowPitch;
+		uint64_t*      boardRow = BoardRow(mCurrentBoard, (int32_t)y);
+		for(uint32_t x = 0; x < width; x++)
+		{
+			if(cellRow[x] != 0)
+			{
+				boardRow[x / 64] |= 1ull << (x % 64);
+			}
+		}
+	}
+
+	mStability.resize(mRowCount * mRowWords);
+	for(uint32_t y = 0; y < mRowCount; y++)
+	{
+		std::copy(mColumnMask.begin(), mColumnMask.end(), mStability.begin() + y * mRowWords);
+	}
+
+	return true;
+}
+
+bool CpuSlabCalculator::StabilityNextSteps(uint32_t stepCount, const CpuClickRule* clickRule, CpuHaloTransport* transport)
+{
+	for(uint32_t step = 0; step < stepCount; step++)
+	{
+		if(!ExchangeHalos(transport))
+		{
+			return false;
+		}
+
+		uint32_t taskCount = (mRowCount + gRowsPerTask - 1) / gRowsPerTask;
+		mThreadPool->ParallelFor(taskCount, [this, clickRule](uint32_t taskIndex, uint32_t /*threadIndex*/)
+		{
+			uint32_t rowBegin = taskIndex * gRowsPerTask;
+			uint32_t rowEnd   = std::min(rowBegin + gRowsPerTask, mRowCount);
+			for(uint32_t y = rowBegin; y < rowEnd; y++)
+			{
+				NextStepRow((int32_t)y, clickRule);
+			}
+		});
+
+		mCurrentBoard = 1 - mCurrentBoard;
+		mCurrentStep++;
+	}
+
+	return true;
+}
+
+uint32_t CpuSlabCalculator::GetBoardWidth() const
+{
+	return mBoardWidth;
+}
+
+uint32_t CpuSlabCalculator::GetRowBegin() const
+{
+	return mRowBegin;
+}
+
+uint32_t CpuSlabCalculator::GetRowCount() const
+{
+	return mRowCount;
+}
+
+uint32_t CpuSlabCalculator::GetCurrentStep() const
+{
+	return mCurrentStep;
+}
+
+uint64_t CpuSlabCalculator::GetExchangedBytes() const
+{
+	return mExchangedBytes;
+}
+
+void CpuSlabCalculator::CopyStabilityCells(uint16_t* outCells, size_t rowPitch) const
+{
+	std::vector<uint16_t> expandedRow(mRowWords * 64);
+	for(uint32_t y = 0; y < mRowCount; y++)
+	{
+		mKernels.ExpandRow(expandedRow.data(), mStability.data() + y * mRowWords, mRowWords);
+		std::copy(expandedRow.begin(), expandedRow.begin() + mBoardWidth, outCells + y * rowPitch);
+	}
+}
+
+bool CpuSlabCalculator::ExchangeHalos(CpuHaloTransport* transport)
+{
+	if(mSlabCount == 1)
+	{
+		return true;
+	}
+
+	//Whole rows with the guard words, so both the halo and the rows sent are single blocks
+	const size_t  haloSize = mRadius * mRowStride * sizeof(uint64_t);
+	const bool    hasUpper = (mSlabIndex != 0);
+	const bool    hasLower = (mSlabIndex + 1 < mSlabCount);
+	const int32_t rowCount = (int32_t)mRowCount;
+
+	uint64_t* firstRows = BoardRow(mCurrentBoard, 0)                  - BitBoard::RowWordAlignment;
+	uint64_t* lastRows  = BoardRow(mCurrentBoard, rowCount - mRadius) - BitBoard::RowWordAlignment;
+	uint64_t* upperHalo = BoardRow(mCurrentBoard, -mRadius)           - BitBoard::RowWordAlignment;
+	uint64_t* lowerHalo = BoardRow(mCurrentBoard, rowCount)           - BitBoard::RowWordAlignment;
+
+	//The slab with the parity of the phase is the upper one of its pair in that phase: it sends first and the lower one receives first
+	for(uint32_t phase = 0; phase < 2; phase++)
+	{
+		if(mSlabIndex % 2 == phase)
+		{
+			if(hasLower && (!transport->Send(CpuSlabNeighbor::Lower, lastRows, haloSize) || !transport->Receive(CpuSlabNeighbor::Lower, lowerHalo, haloSize)))
+			{
+				return false;
+			}
+
+			mExchangedBytes += hasLower ? 2 * haloSize : 0;
+		}
+		else
+		{
+			if(hasUpper && (!transport->Receive(CpuSlabNeighbor::Upper, upperHalo, haloSize) || !transport->Send(CpuSlabNeighbor::Upper, firstRows, haloSize)))
+			{
+				return false;
+			}
+
+			mExchangedBytes += hasUpper ? 2 * haloSize : 0;
+		}
+	}
+
+	return true;
+}
+
+void CpuSlabCalculator::NextStepRow(int32_t y, const CpuClickRule* clickRule)
+{
+	uint64_t*       nextRow = BoardRow(1 - mCurrentBoard, y);
+	const uint64_t* thisRow = BoardRow(mCurrentBoard, y);
+	if(!clickRule || clickRule->IsCross())
+	{
+		mKernels.CrossRow(nextRow, BoardRow(mCurrentBoard, y - 1), thisRow, BoardRow(mCurrentBoard, y + 1), mColumnMask.data(), mRowWords);
+	}
+	else
+	{
+		std::fill(nextRow, nextRow + mRowWords, 0);
+		for(const CpuClickRuleRow& clickRuleRow: clickRule->GetRows())
+		{
+			mKernels.ConvolveRow(nextRow, BoardRow(mCurrentBoard, y + clickRuleRow.OffsetY), clickRuleRow.MaskX, clickRuleRow.MinOffsetX, mRowWords);
+		}
+
+		mKernels.AndRow(nextRow, nextRow, mColumnMask.data(), mRowWords);
+	}
+
+	uint64_t* stabilityRow = mStability.data() + y * mRowWords;
+	mKernels.StabilityRow(stabilityRow, stabilityRow, thisRow, nextRow, nullptr, mRowWords);
+}
+
+uint64_t* CpuSlabCalculator::BoardRow(uint32_t boardIndex, int32_t y)
+{
+	return mBoards[boardIndex].data() + (y + mRadius) * mRowStride + BitBoard::RowWordAlignment;
+}
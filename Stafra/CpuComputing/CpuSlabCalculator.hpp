@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include "CpuClickRule.hpp"
+#include "CpuFeatures.hpp"
+#include "CpuHaloTransport.hpp"
+#include "NextStepKernels.hpp"
+
+class ThreadPool;
+
+/*
+The class for computing the stability of a horizontal slab of a board split between several processes.
+Input:               Initial board (1 byte per cell), the index and the count of the slabs, click rule, the transport to the neighbor slabs
+Output:              The stability of the rows of the slab
+Possible expansions: Restrictions and spawn stability, deeper halos exchanged once per several steps
+
+Every slab keeps its own rows and a halo of click rule radius rows above and below them.
+Before each step the slabs send their first and last rows to the neighbors and receive the halos from them.
+The slabs next to each other exchange in two phases by the parity of the upper one, so no two slabs ever wait on each other.
+The halos outside the board are always zero, same as the board border.
+*/
+
+class CpuSlabCalculator
+{
+public:
+	CpuSlabCalculator();
+	~CpuSlabCalculator();
+
+	void SetInstructionSet(CpuInstructionSet instructionSet); //Clamped to the one supported by the CPU
+	void SetThreadCount(uint32_t threadCount);                //0 means one thread per hardware thread
+
+	static void GetSlabRows(uint32_t height, uint32_t slabIndex, uint32_t slabCount, uint32_t& outRowBegin, uint32_t& outRowEnd); //The rows owned by the slab, as even as possible
+
+	bool PrepareForCalculations(const uint8_t* initialBoard, uint32_t width, uint32_t height, size_t rowPitch, uint32_t slabIndex, uint32_t slabCount, const CpuClickRule* clickRule); //Only the rows of the slab are read. False if some slab is thinner than the click rule radius
+	bool StabilityNextSteps(uint32_t stepCount, const CpuClickRule* clickRule, CpuHaloTransport* transport);                                                                         //The click rule has to be the same as in PrepareForCalculations() and in the other slabs. False if the halo exchange fails
+
+	uint32_t GetBoardWidth()  const;
+	uint32_t GetRowBegin()    const;
+	uint32_t GetRowCount()    const;
+	uint32_t GetCurrentStep() const;
+
+	uint64_t GetExchangedBytes() const; //Sent and received over all steps so far
+
+	void CopyStabilityCells(uint16_t* outCells, size_t rowPitch) const; //The rows of the slab only, the same values CpuStabilityCalculator::CopyStabilityCells() gives for them
+
+private:
+	bool ExchangeHalos(CpuHaloTransport* transport);
+
+	void NextStepRow(int32_t y, const CpuClickRule* clickRule);
+
+	uint64_t* BoardRow(uint32_t boardIndex, int32_t y); //y from -radius to rowCount + radius - 1
+
+private:
+	std::unique_ptr<ThreadPool> mThreadPool;
+
+	NextStepKernels   mKernels;
+	CpuInstructionSet mInstructionSet;
+
+	//The rows of the slab with the halos, BitBoard::RowWordAlignment zero guard words on both sides of each row
+	std::vector<uint64_t> mBoards[2];
+	uint32_t              mCurrentBoard;
+
+	std::vector<uint64_t> mStability;
+	std::vector<uint64_t> mColumnMask;
+
+	uint32_t mBoardWidth;
+	uint32_t mRowBegin;
+	uint32_t mRowCount;
+	size_t   mRowWords;
+	size_t   mRowStride; //In words, with the guard words
+	int32_t  mRadius;
+
+	uint32_t mSlabIndex;
+	uint32_t mSlabCount;
+
+	uint64_t mExchangedBytes;
+	uint32_t mCurrentStep;
+};
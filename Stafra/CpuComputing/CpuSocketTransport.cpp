@@ -0,0 +1,358 @@
+#include "CpuSocketTransport.hpp"
+#include <cstring>
+#include <thread>
+#include <chrono>
+
+#if defined(_WIN32)
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+	#include <afunix.h>
+#else
+	#include <sys/socket.h>
+	#include <sys/un.h>
+	#include <netinet/in.h>
+	#include <netinet/tcp.h>
+	#include <netdb.h>
+	#include <poll.h>
+	#include <unistd.h>
+#endif
+
+namespace
+{
+	const uint32_t gConnectAttempts   = 600; //The neighbors may start later, a minute at the most
+	const uint32_t gConnectRetryDelay = 100; //In milliseconds
+
+	const size_t gMaxChunkSize = 1 << 30; //send() and recv() take int sizes on Windows
+
+#if defined(__linux__)
+	const int gSendFlags = MSG_NOSIGNAL; //A lost connection is reported by the return value, not by SIGPIPE
+#else
+	const int gSendFlags = 0;
+#endif
+
+	const char gUnixAddressPrefix[] = "unix:";
+
+	struct SocketAddress
+	{
+		sockaddr_storage Address;
+		socklen_t        AddressLength;
+		int              Family;
+		std::string      UnixPath; //Empty for TCP
+	};
+
+	bool ResolveAddress(const std::string& address, bool listening, SocketAddress& outAddress)
+	{
+		memset(&outAddress.Address, 0, sizeof(outAddress.Address));
+		outAddress.UnixPath.clear();
+
+		if(address.compare(0, sizeof(gUnixAddressPrefix) - 1, gUnixAddressPrefix) == 0)
+		{
+			sockaddr_un unixAddress;
+			memset(&unixAddress, 0, sizeof(unixAddress));
+
+			std::string path = address.substr(sizeof(gUnixAddressPrefix) - 1);
+			if(path.empty() || path.size() >= sizeof(unixAddress.sun_path))
+			{
+				return false;
+			}
+
+			unixAddress.sun_family = AF_UNIX;
+			memcpy(unixAddress.sun_path, path.c_str(), path.size());
+			memcpy(&outAddress.Address, &unixAddress, sizeof(unixAddress));
+
+			outAddress.AddressLength = (socklen_t)sizeof(unixAddress);
+			outAddress.Family        = AF_UNIX;
+			outAddress.UnixPath      = path;
+			return true;
+		}
+
+		size_t portSeparator = address.rfind(':');
+		if(portSeparator == std::string::npos)
+		{
+			return false;
+		}
+
+		std::string host = address.substr(0, portSeparator);
+		std::string port = address.substr(portSeparator + 1);
+
+		addrinfo hints;
+		memset(&hints, 0, sizeof(hints));
+		hints.ai_family   = AF_UNSPEC;
+		hints.ai_socktype = SOCK_STREAM;
+		hints.ai_flags    = listening ? AI_PASSIVE : 0;
+
+		addrinfo* addressList = nullptr;
+		if(getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &addressList) != 0 || addressList == nullptr)
+		{
+			return false;
+		}
+
+		memcpy(&outAddress.Address, addressList->ai_addr, addressList->ai_addrlen);
+		outAddress.AddressLength = (socklen_t)addressList->ai_addrlen;
+		outAddress.Family        = addressList->ai_family;
+
+		freeaddrinfo(addressList);
+		return true;
+	}
+
+	void CloseSocket(intptr_t& socketHandle)
+	{
+		if(socketHandle == -1)
+		{
+			return;
+		}
+
+#if defined(_WIN32)
+		closesocket((SOCKET)socketHandle);
+#else
+		close((int)socketHandle);
+#endif
+
+		socketHandle = -1;
+	}
+
+	void RemoveUnixPath(const std::string& path)
+	{
+#if defined(_WIN32)
+		DeleteFileA(path.c_str());
+#else
+		unlink(path.c_str());
+#endif
+	}
+
+	intptr_t OpenSocket(const SocketAddress& address)
+	{
+#if defined(_WIN32)
+		SOCKET socketHandle = socket(address.Family, SOCK_STREAM, 0);
+		return (socketHandle == INVALID_SOCKET) ? -1 : (intptr_t)socketHandle;
+#else
+		return (intptr_t)socket(address.Family, SOCK_STREAM, 0);
+#endif
+	}
+
+	//False if nobody connects to the listening socket by the deadline, so accept() won't block
+	bool WaitForConnection(intptr_t listenSocket, std::chrono::steady_clock::time_point deadline)
+	{
+		auto remainingTime = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+		int  timeout       = (remainingTime.count() > 0) ? (int)remainingTime.count() : 0;
+
+#if defined(_WIN32)
+		WSAPOLLFD pollSocket;
+		pollSocket.fd      = (SOCKET)listenSocket;
+		pollSocket.events  = POLLRDNORM;
+		pollSocket.revents = 0;
+		return WSAPoll(&pollSocket, 1, timeout) > 0;
+#else
+		pollfd pollSocket;
+		pollSocket.fd      = (int)listenSocket;
+		pollSocket.events  = POLLIN;
+		pollSocket.revents = 0;
+		return poll(&pollSocket, 1, timeout) > 0;
+#endif
+	}
+
+	void DisableDelay(intptr_t socketHandle, const SocketAddress& address)
+	{
+		//The halo rows are sent once per step and waited for right away, batching them only adds latency
+		if(address.Family != AF_UNIX)
+		{
+			int noDelay = 1;
+			setsockopt(socketHandle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+		}
+	}
+
+	bool SendAll(intptr_t socketHandle, const void* data, size_t size)
+	{
+		const char* bytes = reinterpret_cast<const char*>(data);
+		while(size != 0)
+		{
+			size_t chunkSize = (size < gMaxChunkSize) ? size : gMaxChunkSize;
+			auto   sentSize  = send(socketHandle, bytes, (int)chunkSize, gSendFlags);
+			if(sentSize <= 0)
+			{
+				return false;
+			}
+
+			bytes += sentSize;
+			size  -= (size_t)sentSize;
+		}
+
+		return true;
+	}
+
+	bool ReceiveAll(intptr_t socketHandle, void* data, size_t size)
+	{
+		char* bytes = reinterpret_cast<char*>(data);
+		while(size != 0)
+		{
+			size_t chunkSize    = (size < gMaxChunkSize) ? size : gMaxChunkSize;
+			auto   receivedSize = recv(socketHandle, bytes, (int)chunkSize, 0);
+			if(receivedSize <= 0)
+			{
+				return false;
+			}
+
+			bytes += receivedSize;
+			size  -= (size_t)receivedSize;
+		}
+
+		return true;
+	}
+}
+
+CpuSocketTransport::CpuSocketTransport(): mListenSocket(-1), mUpperSocket(-1), mLowerSocket(-1), mConnectTimeout(gConnectAttempts * gConnectRetryDelay)
+{
+#if defined(_WIN32)
+	WSADATA wsaData;
+	WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+}
+
+CpuSocketTransport::~CpuSocketTransport()
+{
+	Close();
+
+#if defined(_WIN32)
+	WSACleanup();
+#endif
+}
+
+void CpuSocketTransport::SetConnectTimeout(uint32_t milliseconds)
+{
+	mConnectTimeout = milliseconds;
+}
+
+bool CpuSocketTransport::Connect(uint32_t slabIndex, const std::vector<std::string>& slabAddresses)
+{
+	Close();
+
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(mConnectTimeout);
+
+	if(slabIndex >= slabAddresses.size())
+	{
+		return false;
+	}
+
+	const bool hasUpperNeighbor = (slabIndex != 0);
+	const bool hasLowerNeighbor = (slabIndex + 1 < slabAddresses.size());
+
+	//Listen before connecting, so the lower neighbor can connect while this one waits for the upper one
+	SocketAddress ownAddress;
+	if(hasLowerNeighbor)
+	{
+		if(!ResolveAddress(slabAddresses[slabIndex], true, ownAddress))
+		{
+			return false;
+		}
+
+		mListenSocket = OpenSocket(ownAddress);
+		if(mListenSocket == -1)
+		{
+			return false;
+		}
+
+		if(!ownAddress.UnixPath.empty())
+		{
+			RemoveUnixPath(ownAddress.UnixPath); //Left over from a previous run
+			mListenPath = ownAddress.UnixPath;
+		}
+		else
+		{
+			int reuseAddress = 1;
+			setsockopt(mListenSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuseAddress), sizeof(reuseAddress));
+		}
+
+		if(bind(mListenSocket, reinterpret_cast<const sockaddr*>(&ownAddress.Address), ownAddress.AddressLength) != 0 || listen(mListenSocket, 1) != 0)
+		{
+			Close();
+			return false;
+		}
+	}
+
+	if(hasUpperNeighbor)
+	{
+		SocketAddress upperAddress;
+		if(!ResolveAddress(slabAddresses[slabIndex - 1], false, upperAddress))
+		{
+			Close();
+			return false;
+		}
+
+		while(mUpperSocket == -1 && std::chrono::steady_clock::now() < deadline)
+		{
+			mUpperSocket = OpenSocket(upperAddress);
+			if(mUpperSocket != -1 && connect(mUpperSocket, reinterpret_cast<const sockaddr*>(&upperAddress.Address), upperAddress.AddressLength) != 0)
+			{
+				CloseSocket(mUpperSocket);
+				std::this_thread::sleep_for(std::chrono::milliseconds(gConnectRetryDelay));
+			}
+		}
+
+		//The upper neighbor checks it's connected to the right slab
+		if(mUpperSocket == -1 || !SendAll(mUpperSocket, &slabIndex, sizeof(slabIndex)))
+		{
+			Close();
+			return false;
+		}
+
+		DisableDelay(mUpperSocket, upperAddress);
+	}
+
+	if(hasLowerNeighbor)
+	{
+		if(!WaitForConnection(mListenSocket, deadline))
+		{
+			Close();
+			return false;
+		}
+
+#if defined(_WIN32)
+		SOCKET lowerSocket = accept(mListenSocket, nullptr, nullptr);
+		mLowerSocket = (lowerSocket == INVALID_SOCKET) ? -1 : (intptr_t)lowerSocket;
+#else
+		mLowerSocket = (intptr_t)accept((int)mListenSocket, nullptr, nullptr);
+#endif
+
+		uint32_t lowerSlabIndex = 0;
+		if(mLowerSocket == -1 || !ReceiveAll(mLowerSocket, &lowerSlabIndex, sizeof(lowerSlabIndex)) || lowerSlabIndex != slabIndex + 1)
+		{
+			Close();
+			return false;
+		}
+
+		DisableDelay(mLowerSocket, ownAddress);
+		CloseSocket(mListenSocket);
+	}
+
+	return true;
+}
+
+void CpuSocketTransport::Close()
+{
+	CloseSocket(mListenSocket);
+	CloseSocket(mUpperSocket);
+	CloseSocket(mLowerSocket);
+
+	if(!mListenPath.empty())
+	{
+		RemoveUnixPath(mListenPath);
+		mListenPath.clear();
+	}
+}
+
+bool CpuSocketTransport::Send(CpuSlabNeighbor neighbor, const void* data, size_t size)
+{
+	intptr_t socketHandle = NeighborSocket(neighbor);
+	return socketHandle != -1 && SendAll(socketHandle, data, size);
+}
+
+bool CpuSocketTransport::Receive(CpuSlabNeighbor neighbor, void* data, size_t size)
+{
+	intptr_t socketHandle = NeighborSocket(neighbor);
+	return socketHandle != -1 && ReceiveAll(socketHandle, data, size);
+}
+
+intptr_t& CpuSocketTransport::NeighborSocket(CpuSlabNeighbor neighbor)
+{
+	return (neighbor == CpuSlabNeighbor::Upper) ? mUpperSocket : mLowerSocket;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CpuHaloTransport.hpp"
+
+/*
+The class for exchanging the halo rows of the slabs over sockets, TCP for separate machines or Unix domain sockets for a single one.
+Input:               The index of the current slab, the addresses of all slabs
+Output:              Connections to the upper and the lower neighbor slabs
+Possible expansions: Several connections per neighbor, compression of the rows
+
+The address of each slab is either HOST:PORT or unix:PATH. Every slab listens on its own address for the lower neighbor
+and connects to the address of the upper one, so the slabs can be started in any order.
+Both neighbors share one connection timeout, so a slab that never starts fails Connect() instead of blocking it forever.
+*/
+
+class CpuSocketTransport: public CpuHaloTransport
+{
+public:
+	CpuSocketTransport();
+	~CpuSocketTransport();
+
+	void SetConnectTimeout(uint32_t milliseconds);                                    //A minute by default
+	bool Connect(uint32_t slabIndex, const std::vector<std::string>& slabAddresses); //Waits for both neighbors, false if they don't show up in time
+	void Close();
+
+	bool Send(CpuSlabNeighbor neighbor, const void* data, size_t size) override;
+	bool Receive(CpuSlabNeighbor neighbor, void* data, size_t size)    override;
+
+private:
+	intptr_t& NeighborSocket(CpuSlabNeighbor neighbor);
+
+private:
+	intptr_t mListenSocket; //-1 for no socket
+	intptr_t mUpperSocket;
+	intptr_t mLowerSocket;
+
+	std::string mListenPath; //The Unix domain socket file to remove on Close(), empty for TCP
+
+	uint32_t mConnectTimeout; //In milliseconds
+};
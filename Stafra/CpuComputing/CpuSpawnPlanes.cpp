@@ -0,0 +1,95 @@
+#include "CpuSpawnPlanes.hpp"
+#include <algorithm>
+#include <cstring>
+
+CpuSpawnPlanes::CpuSpawnPlanes(): mPlaneCount(0), mWordsPerRow(0), mRowPitch(0), mRowCount(0)
+{
+}
+
+CpuSpawnPlanes::~CpuSpawnPlanes()
+{
+}
+
+void CpuSpawnPlanes::Clear()
+{
+	mPrevPlanes.clear();
+	mCurrPlanes.clear();
+
+	mPlaneCount  = 0;
+	mWordsPerRow = 0;
+	mRowPitch    = 0;
+	mRowCount    = 0;
+}
+
+void CpuSpawnPlanes::Resize(uint32_t planeCount, size_t wordsPerRow, uint32_t rowCount)
+{
+	mPlaneCount  = planeCount;
+	mWordsPerRow = wordsPerRow;
+	mRowPitch    = planeCount * wordsPerRow;
+	mRowCount    = rowCount;
+
+	mPrevPlanes.assign(mRowPitch * rowCount, 0);
+	mCurrPlanes.resize(mPrevPlanes.size());
+}
+
+void CpuSpawnPlanes::AddPlanes(uint32_t planeCount)
+{
+	CpuSpawnPlanes addedPlanes;
+	addedPlanes.Resize(planeCount, mWordsPerRow, mRowCount);
+	for(uint32_t y = 0; y < mRowCount; y++)
+	{
+		memcpy(addedPlanes.PrevRow((int32_t)y), PrevRow((int32_t)y), std::min(mRowPitch, addedPlanes.mRowPitch) * sizeof(uint64_t));
+	}
+
+	Swap(addedPlanes);
+}
+
+void CpuSpawnPlanes::Swap(CpuSpawnPlanes& right)
+{
+	std::swap(mPrevPlanes,  right.mPrevPlanes);
+	std::swap(mCurrPlanes,  right.mCurrPlanes);
+	std::swap(mPlaneCount,  right.mPlaneCount);
+	std::swap(mWordsPerRow, right.mWordsPerRow);
+	std::swap(mRowPitch,    right.mRowPitch);
+	std::swap(mRowCount,    right.mRowCount);
+}
+
+void CpuSpawnPlanes::SwapSteps()
+{
+	mCurrPlanes.swap(mPrevPlanes);
+}
+
+uint32_t CpuSpawnPlanes::GetPlaneCount() const
+{
+	return mPlaneCount;
+}
+
+size_t CpuSpawnPlanes::GetWordsPerRow() const
+{
+	return mWordsPerRow;
+}
+
+size_t CpuSpawnPlanes::GetRowPitch() const
+{
+	return mRowPitch;
+}
+
+uint64_t* CpuSpawnPlanes::PrevRow(int32_t y)
+{
+	return mPrevPlanes.data() + y * mRowPitch;
+}
+
+const uint64_t* CpuSpawnPlanes::PrevRow(int32_t y) const
+{
+	return mPrevPlanes.data() + y * mRowPitch;
+}
+
+uint64_t* CpuSpawnPlanes::CurrRow(int32_t y)
+{
+	return mCurrPlanes.data() + y * mRowPitch;
+}
+
+const uint64_t* CpuSpawnPlanes::CurrRow(int32_t y) const
+{
+	return mCurrPlanes.data() + y * mRowPitch;
+}
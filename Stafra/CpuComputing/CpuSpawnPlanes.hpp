@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/*
+The class for storing the spawn stability values of the board as bit planes, for the current and the next step.
+Input:               The number of planes, the words per row and the row count of the board
+Output:              The planes of each row
+Possible expansions: Shrinking the planes when the spawn period gets shorter
+
+The plane p of the row y holds the bit p of the values of the row, words per row words at (y * plane count + p) * words per row.
+Every step updates 64 cells per word with a bitwise counter, and the memory is the bit count of the spawn period instead of 16 bits per cell
+*/
+
+class CpuSpawnPlanes
+{
+public:
+	CpuSpawnPlanes();
+	~CpuSpawnPlanes();
+
+	void Clear();                                                           //No planes, the spawn stability is allocated only when it's used
+	void Resize(uint32_t planeCount, size_t wordsPerRow, uint32_t rowCount); //Every value is zero
+	void AddPlanes(uint32_t planeCount);                                     //Keeps the values, the new planes are zero
+	void Swap(CpuSpawnPlanes& right);
+	void SwapSteps();                                                        //The next planes become the current ones
+
+	uint32_t GetPlaneCount()  const;
+	size_t   GetWordsPerRow() const;
+	size_t   GetRowPitch()    const; //In words, all planes of a row
+
+	uint64_t*       PrevRow(int32_t y); //The plane p of the row is GetWordsPerRow() * p words further
+	const uint64_t* PrevRow(int32_t y) const;
+	uint64_t*       CurrRow(int32_t y);
+	const uint64_t* CurrRow(int32_t y) const;
+
+private:
+	std::vector<uint64_t> mPrevPlanes;
+	std::vector<uint64_t> mCurrPlanes;
+
+	uint32_t mPlaneCount;
+	size_t   mWordsPerRow;
+	size_t   mRowPitch;
+	uint32_t mRowCount;
+};
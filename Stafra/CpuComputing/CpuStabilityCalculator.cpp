@@ -0,0 +1,1853 @@
+#include "CpuStabilityCalculator.hpp"
+#include "CpuClickRule.hpp"
+#include "CpuHashLife.hpp"
+#include "CpuJumpAhead.hpp"
+#include "CpuStateHash.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+	const uint32_t gDefaultTileWidth  = 4096;
+	const uint32_t gDefaultTileHeight = 64;
+
+	const uint32_t gCopyRowsPerTask = 32;
+
+	const int32_t  gTemporalBlockHalo     = 32; //In cells, the generations per tile pass are this divided by the click rule radius
+	const uint32_t gMaxTemporalBlockSteps = 32;
+
+	const int32_t gSymmetryHalo = gTemporalBlockHalo; //Mirrored cells around the fundamental region, enough for a whole temporal block
+
+	const uint32_t gMinHashLifeSteps = 16; //Shorter runs of steps don't pay for copying the state out of the quadtrees
+}
+
+CpuStabilityCalculator::CpuStabilityCalculator(): mTileWidth(gDefaultTileWidth), mTileHeight(gDefaultTileHeight), mTileWords(0), mTileCountX(0), mTileCountY(0), mLastRestriction(nullptr),
+                                                  mActivityClickRule(nullptr), mActivityRestriction(nullptr), mbTileActivityValid(false), mSummaryRestriction(nullptr), mbTrackChangeMap(false), mbTrackStats(false), mMiddleColumn(CpuGenerationCounts::NoCell), mbTrackStateHashes(false),
+                                                  mHashLifeClickRule(nullptr), mHashLifeRestriction(nullptr), mbUseHashLife(false), mbHashLifeActive(false), mbHashLifeGaveUp(false), mCurrentStep(0), mLastSpawnPeriod(0), mbFreshStability(true)
+{
+	SetInstructionSet(CpuFeatures::DetectInstructionSet());
+	SetThreadCount(0);
+
+	mHashLife = std::make_unique<CpuHashLife>();
+}
+
+CpuStabilityCalculator::~CpuStabilityCalculator()
+{
+}
+
+void CpuStabilityCalculator::SetInstructionSet(CpuInstructionSet instructionSet)
+{
+	mInstructionSet = std::min(instructionSet, CpuFeatures::DetectInstructionSet());
+	mKernels        = CpuKernels::SelectKernels(mInstructionSet);
+}
+
+CpuInstructionSet CpuStabilityCalculator::GetInstructionSet() const
+{
+	return mInstructionSet;
+}
+
+void CpuStabilityCalculator::SetThreadCount(uint32_t threadCount)
+{
+	mThreadPool.reset();
+	mThreadPool = std::make_unique<ThreadPool>(threadCount);
+
+	mTileScratches.clear();
+	mTileScratches.resize(mThreadPool->GetThreadCount());
+}
+
+void CpuStabilityCalculator::SetTileSize(uint32_t width, uint32_t height)
+{
+	mTileWidth  = width;
+	mTileHeight = std::max(height, 1u);
+
+	UpdateTiles();
+}
+
+void CpuStabilityCalculator::SetTrackChangeMap(bool track)
+{
+	mbTrackChangeMap = track;
+}
+
+void CpuStabilityCalculator::SetTrackStats(bool track)
+{
+	mbTrackStats = track;
+}
+
+void CpuStabilityCalculator::SetTrackStateHashes(bool track)
+{
+	mbTrackStateHashes = track;
+}
+
+void CpuStabilityCalculator::SetUseHashLife(bool useHashLife)
+{
+	mbUseHashLife    = useHashLife;
+	mbHashLifeActive = false;
+}
+
+uint32_t CpuStabilityCalculator::GetThreadCount() const
+{
+	return mThreadPool->GetThreadCount();
+}
+
+void CpuStabilityCalculator::PrepareForCalculations(const uint8_t* initialBoard, uint32_t width, uint32_t height, size_t rowPitch)
+{
+	mSymmetry.Reset(width, height);
+
+	mPrevBoard.Resize(width, height);
+	mCurrBoard.Resize(width, height);
+	mPrevStability.Resize(width, height);
+	mCurrStability.Resize(width, height);
+
+	mPrevRestrictedBoard.Resize(0, 0);
+	mCurrRestrictedBoard.Resize(0, 0);
+	mLastRestriction = nullptr;
+
+	mPrevBoard.FromCells(initialBoard, rowPitch);
+	mPrevStability.Fill(true);
+
+	StartImpulseResponse();
+
+	mChangeMap.Resize(mbTrackChangeMap ? width : 0, mbTrackChangeMap ? height : 0);
+	mGenerationStats.Clear();
+	mCycleDetector.Reset();
+
+	mSpawnPlanes.Clear();
+
+	UpdateTiles();
+
+	mbHashLifeActive = false;
+	mbHashLifeGaveUp = false;
+
+	mCurrentStep     = 0;
+	mLastSpawnPeriod = 0;
+	mbFreshStability = true;
+}
+
+void CpuStabilityCalculator::ReduceBySymmetry(const CpuClickRule* clickRule, const BitBoard* restriction)
+{
+	if(!mbFreshStability || mSymmetry.IsMirrored() || mbUseHashLife)
+	{
+		return;
+	}
+
+	int32_t halo = std::max(gSymmetryHalo, clickRule ? clickRule->GetRadius() : 1);
+	if(!mSymmetry.Detect(mPrevBoard, clickRule, restriction, halo))
+	{
+		return;
+	}
+
+	const uint32_t simWidth  = mSymmetry.GetSimWidth();
+	const uint32_t simHeight = mSymmetry.GetSimHeight();
+
+	//The halo cells are cropped together with the rest, so they are already valid for the first pass
+	BitBoard reducedBoard(simWidth, simHeight);
+	reducedBoard.CropFrom(mPrevBoard);
+
+	mPrevBoard.Swap(reducedBoard);
+	mCurrBoard.Resize(simWidth, simHeight);
+	mPrevStability.Resize(simWidth, simHeight);
+	mCurrStability.Resize(simWidth, simHeight);
+	mPrevStability.Fill(true);
+
+	if(mChangeMap.GetWidth() != 0)
+	{
+		mChangeMap.Resize(simWidth, simHeight);
+	}
+
+	mSpawnPlanes.Clear(); //The stability is fresh, the spawn planes start from it again anyway
+	mLastRestriction = nullptr;
+
+	UpdateTiles();
+}
+
+void CpuStabilityCalculator::StabilityNextStep(const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t spawnPeriod)
+{
+	mbHashLifeActive = false;
+
+	restriction = MatchSymmetry(clickRule, restriction);
+	if(ImpulseNextStep(clickRule, restriction, spawnPeriod))
+	{
+		return;
+	}
+
+	UpdateRestrictedBoard(restriction);
+	UpdateTileRestrictions(restriction);
+	SwitchSpawnMode(spawnPeriod);
+	BeginTileActivity(clickRule, restriction, spawnPeriod);
+
+	//Every tile only reads the previous state and writes its own part of the next one, so the only barrier is the end of ParallelFor
+	mThreadPool->ParallelFor(mTileCountX * mTileCountY, [this, clickRule, restriction, spawnPeriod](uint32_t tileIndex, uint32_t threadIndex)
+	{
+		NextStepTile(tileIndex, threadIndex, clickRule, restriction, spawnPeriod);
+	});
+
+	if(spawnPeriod == 0)
+	{
+		mCurrStability.Swap(mPrevStability);
+	}
+	else
+	{
+		mSpawnPlanes.SwapSteps();
+	}
+
+	if(restriction)
+	{
+		mCurrRestrictedBoard.Swap(mPrevRestrictedBoard);
+	}
+
+	mCurrBoard.Swap(mPrevBoard);
+	EndTileActivity(spawnPeriod);
+
+	if(TracksGenerations())
+	{
+		AppendGenerationStats(1);
+	}
+
+	mLastSpawnPeriod = spawnPeriod;
+	mbFreshStability = false;
+	mCurrentStep++;
+
+	FillSymmetryHalo();
+}
+
+void CpuStabilityCalculator::StabilityNextSteps(uint32_t stepCount, const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t spawnPeriod)
+{
+	const uint32_t blockSteps = GetTemporalBlockSteps(clickRule);
+	while(stepCount > 0)
+	{
+		uint32_t hashLifeSteps = (spawnPeriod == 0) ? HashLifeNextSteps(stepCount, clickRule, restriction) : 0;
+		if(hashLifeSteps != 0)
+		{
+			stepCount -= hashLifeSteps;
+			continue;
+		}
+
+		//Spawn stability is several bit planes, it's not worth keeping it in a tile for several generations
+		if(spawnPeriod != 0 || blockSteps <= 1 || stepCount == 1 || mImpulseResponse.IsActive())
+		{
+			StabilityNextStep(clickRule, restriction, spawnPeriod);
+			stepCount--;
+			continue;
+		}
+
+		uint32_t generationCount = std::min(stepCount, blockSteps);
+		mbHashLifeActive = false;
+
+		const BitBoard* simRestriction = MatchSymmetry(clickRule, restriction);
+
+		UpdateRestrictedBoard(simRestriction);
+		UpdateTileRestrictions(simRestriction);
+		SwitchSpawnMode(0);
+		BeginTileActivity(clickRule, simRestriction, 0);
+
+		mThreadPool->ParallelFor(mTileCountX * mTileCountY, [this, generationCount, clickRule, simRestriction](uint32_t tileIndex, uint32_t threadIndex)
+		{
+			NextStepsTile(tileIndex, threadIndex, generationCount, clickRule, simRestriction);
+		});
+
+		mCurrStability.Swap(mPrevStability);
+		if(simRestriction)
+		{
+			mCurrRestrictedBoard.Swap(mPrevRestrictedBoard);
+		}
+
+		mCurrBoard.Swap(mPrevBoard);
+		FillSymmetryTriangle();
+		MarkTransposedTileChanges();
+		EndTileActivity(0);
+
+		if(TracksGenerations())
+		{
+			AppendGenerationStats(generationCount);
+		}
+
+		mLastSpawnPeriod = 0;
+		mbFreshStability = false;
+		mCurrentStep    += generationCount;
+		stepCount       -= generationCount;
+
+		FillSymmetryHalo();
+	}
+}
+
+void CpuStabilityCalculator::JumpToStep(uint32_t step, const CpuClickRule* clickRule, const BitBoard* restriction)
+{
+	if(step <= mCurrentStep)
+	{
+		return;
+	}
+
+	mImpulseResponse.Stop(); //The impulse responses are only valid for the initial board
+	mbTileActivityValid = false;
+	mbHashLifeActive    = false;
+
+	if(CpuJumpAhead::CanJump(clickRule, restriction))
+	{
+		//The jump works on the whole board, the result is as symmetric as the board was
+		bool wasMirrored = mSymmetry.IsMirrored();
+		if(wasMirrored)
+		{
+			ExpandSymmetry();
+		}
+
+		BitBoard jumpedBoard;
+		CpuJumpAhead::JumpBoard(mPrevBoard, clickRule, step - mCurrentStep, jumpedBoard);
+		mPrevBoard.Swap(jumpedBoard);
+
+		if(wasMirrored)
+		{
+			mPrevStability.Fill(true);
+			mbFreshStability = true;
+			ReduceBySymmetry(clickRule, restriction);
+		}
+	}
+	else
+	{
+		StabilityNextSteps(step - mCurrentStep, clickRule, restriction, 0);
+	}
+
+	mPrevStability.Fill(true);
+	mChangeMap.Clear();
+	mCycleDetector.Reset();
+
+	mLastRestriction = nullptr;
+	mLastSpawnPeriod = 0;
+	mbFreshStability = true;
+	mCurrentStep     = step;
+}
+
+uint32_t CpuStabilityCalculator::GetBoardWidth() const
+{
+	return mSymmetry.GetBoardWidth();
+}
+
+uint32_t CpuStabilityCalculator::GetBoardHeight() const
+{
+	return mSymmetry.GetBoardHeight();
+}
+
+uint32_t CpuStabilityCalculator::GetCurrentStep() const
+{
+	return mCurrentStep;
+}
+
+bool CpuStabilityCalculator::IsMirroredX() const
+{
+	return mSymmetry.IsMirroredX();
+}
+
+bool CpuStabilityCalculator::IsMirroredY() const
+{
+	return mSymmetry.IsMirroredY();
+}
+
+const BitBoard& CpuStabilityCalculator::GetLastStabilityState() const
+{
+	return mPrevStability;
+}
+
+const BitBoard& CpuStabilityCalculator::GetLastBoardState() const
+{
+	return mPrevBoard;
+}
+
+void CpuStabilityCalculator::CopyLastState(std::vector<uint64_t>& outState) const
+{
+	const size_t   wordsPerRow = mPrevBoard.GetWordsPerRow();
+	const uint32_t layerCount  = (mLastSpawnPeriod == 0) ? 2 : mSpawnPlanes.GetPlaneCount() + 1;
+
+	//Same layers as in HashStateRow(), except the stability without spawn is stored as is
+	outState.resize((size_t)mSymmetry.GetFundamentalHeight() * layerCount * wordsPerRow);
+	for(uint32_t y = 0; y < mSymmetry.GetFundamentalHeight(); y++)
+	{
+		const uint64_t* countMask = GetCountMaskRow((int32_t)y);
+		for(uint32_t layer = 0; layer < layerCount; layer++)
+		{
+			const uint64_t* layerRow = nullptr;
+			if(layer == 0)
+			{
+				layerRow = mPrevBoard.Row((int32_t)y);
+			}
+			else if(mLastSpawnPeriod == 0)
+			{
+				layerRow = mPrevStability.Row((int32_t)y);
+			}
+			else
+			{
+				layerRow = mSpawnPlanes.PrevRow((int32_t)y) + (layer - 1) * wordsPerRow;
+			}
+
+			uint64_t* outRow = outState.data() + ((size_t)y * layerCount + layer) * wordsPerRow;
+			for(size_t i = 0; i < wordsPerRow; i++)
+			{
+				outRow[i] = layerRow[i] & countMask[i];
+			}
+		}
+	}
+}
+
+void CpuStabilityCalculator::CopyStabilityCells(uint16_t* outCells, size_t rowPitch) const
+{
+	const uint32_t boardWidth       = mSymmetry.GetBoardWidth();
+	const uint32_t boardHeight      = mSymmetry.GetBoardHeight();
+	const uint32_t fundamentalWidth = mSymmetry.GetFundamentalWidth();
+
+	uint32_t taskCount = (boardHeight + gCopyRowsPerTask - 1) / gCopyRowsPerTask;
+	mThreadPool->ParallelFor(taskCount, [this, outCells, rowPitch, boardWidth, boardHeight, fundamentalWidth](uint32_t taskIndex, uint32_t /*threadIndex*/)
+	{
+		uint32_t rowBegin = taskIndex * gCopyRowsPerTask;
+		uint32_t rowEnd   = std::min(rowBegin + gCopyRowsPerTask, boardHeight);
+
+		const size_t wordsPerRow = mPrevStability.GetWordsPerRow();
+
+		std::vector<uint16_t> expandedRow(wordsPerRow * 64);
+		for(uint32_t y = rowBegin; y < rowEnd; y++)
+		{
+			int32_t   simY   = (int32_t)mSymmetry.MirroredY(y);
+			uint16_t* outRow = outCells + y * rowPitch;
+
+			if(mLastSpawnPeriod != 0)
+			{
+				mKernels.ExpandPlanesRow(expandedRow.data(), mSpawnPlanes.PrevRow(simY), wordsPerRow, mSpawnPlanes.GetPlaneCount(), wordsPerRow);
+			}
+			else
+			{
+				mKernels.ExpandRow(expandedRow.data(), mPrevStability.Row(simY), wordsPerRow);
+			}
+
+			memcpy(outRow, expandedRow.data(), fundamentalWidth * sizeof(uint16_t));
+
+			//The columns past the fundamental region are its mirror image
+			for(uint32_t x = fundamentalWidth; x < boardWidth; x++)
+			{
+				outRow[x] = outRow[boardWidth - 1 - x];
+			}
+		}
+	});
+}
+
+void CpuStabilityCalculator::CopyChangeMap(CpuChangeMap& outChangeMap) const
+{
+	const uint32_t boardWidth  = mSymmetry.GetBoardWidth();
+	const uint32_t boardHeight = mSymmetry.GetBoardHeight();
+
+	outChangeMap.Resize(boardWidth, boardHeight);
+	outChangeMap.SetLastFrame(mCurrentStep);
+	if(mChangeMap.GetWidth() == 0)
+	{
+		return;
+	}
+
+	uint32_t taskCount = (boardHeight + gCopyRowsPerTask - 1) / gCopyRowsPerTask;
+	mThreadPool->ParallelFor(taskCount, [this, &outChangeMap, boardWidth, boardHeight](uint32_t taskIndex, uint32_t /*threadIndex*/)
+	{
+		uint32_t rowBegin = taskIndex * gCopyRowsPerTask;
+		uint32_t rowEnd   = std::min(rowBegin + gCopyRowsPerTask, boardHeight);
+
+		for(uint32_t y = rowBegin; y < rowEnd; y++)
+		{
+			uint32_t* outRow = outChangeMap.Row(y);
+			for(uint32_t x = 0; x < boardWidth; x++)
+			{
+				uint32_t simX = mSymmetry.MirroredX(x);
+				uint32_t simY = mSymmetry.MirroredY(y);
+				if(mSymmetry.IsMirroredDiagonal() && simX < simY)
+				{
+					std::swap(simX, simY); //The changes below the diagonal aren't recorded
+				}
+
+				outRow[x] = mChangeMap.Row(simY)[simX];
+			}
+		}
+	});
+}
+
+const CpuGenerationStats& CpuStabilityCalculator::GetGenerationStats() const
+{
+	return mGenerationStats;
+}
+
+const CpuCycleDetector& CpuStabilityCalculator::GetCycleDetector() const
+{
+	return mCycleDetector;
+}
+
+void CpuStabilityCalculator::RestartCycleDetection()
+{
+	mCycleDetector.Reset();
+}
+
+void CpuStabilityCalculator::RenderChangeMap(const CpuChangeMap& changeMap, uint32_t frame, uint16_t* outCells, size_t rowPitch) const
+{
+	uint32_t taskCount = (changeMap.GetHeight() + gCopyRowsPerTask - 1) / gCopyRowsPerTask;
+	mThreadPool->ParallelFor(taskCount, [&changeMap, frame, outCells, rowPitch](uint32_t taskIndex, uint32_t /*threadIndex*/)
+	{
+		uint32_t rowBegin = taskIndex * gCopyRowsPerTask;
+		uint32_t rowEnd   = std::min(rowBegin + gCopyRowsPerTask, changeMap.GetHeight());
+
+		for(uint32_t y = rowBegin; y < rowEnd; y++)
+		{
+			changeMap.StabilityRow(outCells + y * rowPitch, y, frame);
+		}
+	});
+}
+
+void CpuStabilityCalculator::UpdateTiles()
+{
+	const size_t wordsPerRow = mPrevBoard.GetWordsPerRow();
+	const size_t tileCells   = 64 * BitBoard::RowWordAlignment;
+
+	mTileWords = wordsPerRow;
+	if(mTileWidth != 0)
+	{
+		mTileWords = std::min(wordsPerRow, (mTileWidth + tileCells - 1) / tileCells * BitBoard::RowWordAlignment);
+	}
+
+	mTileCountX = (mTileWords == 0) ? 0 : (uint32_t)((wordsPerRow + mTileWords - 1) / mTileWords);
+	mTileCountY = (mSymmetry.GetSimHeight() + mTileHeight - 1) / mTileHeight;
+
+	mTileChanged.assign(mTileCountX * mTileCountY, 1);
+	mNextTileChanged.assign(mTileCountX * mTileCountY, 1);
+	mTileStale.assign(mTileCountX * mTileCountY, 1);
+	mbTileActivityValid = false;
+
+	mTileRestrictions.clear();
+	mSummaryRestriction = nullptr;
+
+	if(TracksGenerations())
+	{
+		mTileCounts.assign(mTileCountX * mTileCountY * gMaxTemporalBlockSteps, CpuGenerationCounts());
+		mLastTileCounts.assign(mTileCountX * mTileCountY, CpuGenerationCounts());
+
+		//A mirrored cell counts for its image too, except for the middle column of an odd width
+		mCountMask.assign(wordsPerRow, 0);
+		for(uint32_t x = 0; x < mSymmetry.GetFundamentalWidth(); x++)
+		{
+			mCountMask[x / 64] |= 1ull << (x % 64);
+		}
+
+		mMiddleColumn = (mSymmetry.IsMirroredX() && mSymmetry.GetBoardWidth() % 2 != 0) ? mSymmetry.GetFundamentalWidth() - 1 : CpuGenerationCounts::NoCell;
+
+		//A cell above the diagonal counts for its transposed image too
+		mDiagonalCountMask.Resize(0, 0);
+		if(mSymmetry.IsMirroredDiagonal())
+		{
+			mDiagonalCountMask.Resize(mSymmetry.GetSimWidth(), mSymmetry.GetFundamentalHeight());
+			for(uint32_t y = 0; y < mSymmetry.GetFundamentalHeight(); y++)
+			{
+				uint64_t* maskRow = mDiagonalCountMask.Row((int32_t)y);
+				std::copy(mCountMask.begin(), mCountMask.end(), maskRow);
+				std::fill(maskRow, maskRow + y / 64, 0);
+				maskRow[y / 64] &= ~((1ull << (y % 64)) - 1);
+			}
+		}
+	}
+}
+
+void CpuStabilityCalculator::UpdateRestrictedBoard(const BitBoard* restriction)
+{
+	if(!restriction || restriction == mLastRestriction)
+	{
+		mLastRestriction = restriction;
+		return;
+	}
+
+	//Only happens when the restriction changes, after that the restricted board is computed together with the next board
+	mPrevRestrictedBoard.Resize(mSymmetry.GetSimWidth(), mSymmetry.GetSimHeight());
+	mCurrRestrictedBoard.Resize(mSymmetry.GetSimWidth(), mSymmetry.GetSimHeight());
+
+	const size_t wordCount = mPrevBoard.GetWordsPerRow();
+	for(int32_t y = 0; y < (int32_t)mSymmetry.GetSimHeight(); y++)
+	{
+		mKernels.AndRow(mPrevRestrictedBoard.Row(y), mPrevBoard.Row(y), restriction->Row(y), wordCount);
+	}
+
+	mLastRestriction = restriction;
+}
+
+void CpuStabilityCalculator::SwitchSpawnMode(uint32_t spawnPeriod)
+{
+	const size_t   wordCount = mPrevBoard.GetWordsPerRow();
+	const uint32_t simHeight = mSymmetry.GetSimHeight();
+	if(spawnPeriod != 0)
+	{
+		//The values go up to spawnPeriod + 1. The planes only grow, so the values left from a longer period keep counting up to the plane capacity
+		uint32_t planeCount = 1;
+		while(planeCount < 32 && ((spawnPeriod + 1) >> planeCount) != 0)
+		{
+			planeCount++;
+		}
+
+		if(mLastSpawnPeriod == 0)
+		{
+			//Continue from the current 0/1 stability, the same way the stability texture gets reinterpreted on the GPU
+			mSpawnPlanes.Resize(planeCount, wordCount, simHeight);
+			for(int32_t y = 0; y < (int32_t)simHeight; y++)
+			{
+				memcpy(mSpawnPlanes.PrevRow(y), mPrevStability.Row(y), wordCount * sizeof(uint64_t));
+			}
+		}
+		else if(planeCount > mSpawnPlanes.GetPlaneCount())
+		{
+			mSpawnPlanes.AddPlanes(planeCount);
+		}
+	}
+	else if(mLastSpawnPeriod != 0)
+	{
+		//Non-zero values are stable
+		const uint32_t planeCount = mSpawnPlanes.GetPlaneCount();
+		for(int32_t y = 0; y < (int32_t)simHeight; y++)
+		{
+			uint64_t*       stabilityRow = mPrevStability.Row(y);
+			const uint64_t* planeRow     = mSpawnPlanes.PrevRow(y);
+
+			for(size_t i = 0; i < wordCount; i++)
+			{
+				uint64_t stableCells = 0;
+				for(uint32_t plane = 0; plane < planeCount; plane++)
+				{
+					stableCells |= planeRow[plane * wordCount + i];
+				}
+
+				stabilityRow[i] = stableCells;
+			}
+		}
+	}
+}
+
+const BitBoard* CpuStabilityCalculator::MatchSymmetry(const CpuClickRule* clickRule, const BitBoard* restriction)
+{
+	if(!mSymmetry.IsMirrored())
+	{
+		return restriction;
+	}
+
+	if(!mSymmetry.IsDetectedFor(clickRule, restriction))
+	{
+		ExpandSymmetry();
+		return restriction;
+	}
+
+	return mSymmetry.GetReducedRestriction();
+}
+
+void CpuStabilityCalculator::FillSymmetryHalo()
+{
+	//Only the halo cells of the board are needed for the next pass, the halo stability is never read
+	mSymmetry.FillHalo(mPrevBoard);
+	if(mLastRestriction)
+	{
+		mSymmetry.FillHalo(mPrevRestrictedBoard);
+	}
+}
+
+void CpuStabilityCalculator::FillSymmetryTriangle()
+{
+	if(!mSymmetry.IsMirroredDiagonal())
+	{
+		return;
+	}
+
+	//The other buffers got the transposed cells after the previous temporal block, so only the cells changed since then are transposed again
+	const size_t tileCount = mNextTileChanged.size();
+	mTransposeSourceChanged.resize(tileCount);
+	for(size_t tileIndex = 0; tileIndex < tileCount; tileIndex++)
+	{
+		mTransposeSourceChanged[tileIndex] = !mbTileActivityValid || mNextTileChanged[tileIndex] || mTileChanged[tileIndex];
+	}
+
+	auto isBlockChanged = [this](uint32_t blockX, uint32_t blockY)
+	{
+		return IsTransposeSourceChanged(blockX, blockY);
+	};
+
+	//Temporal blocks don't spawn, so the board and the stability are the whole state
+	mSymmetry.FillDiagonal(mThreadPool.get(), mPrevBoard.Row(0), mPrevBoard.GetRowStride(), isBlockChanged);
+	mSymmetry.FillDiagonal(mThreadPool.get(), mPrevStability.Row(0), mPrevStability.GetRowStride(), isBlockChanged);
+	if(mLastRestriction)
+	{
+		mSymmetry.FillDiagonal(mThreadPool.get(), mPrevRestrictedBoard.Row(0), mPrevRestrictedBoard.GetRowStride(), isBlockChanged);
+	}
+}
+
+bool CpuStabilityCalculator::IsTransposeSourceChanged(uint32_t blockX, uint32_t blockY) const
+{
+	//The block above the diagonal is the rows of the block X in the word of the block Y
+	uint32_t tileX     = (uint32_t)(blockY / mTileWords);
+	uint32_t tileBegin = blockX * 64 / mTileHeight;
+	uint32_t tileEnd   = (std::min(blockX * 64 + 64, mSymmetry.GetFundamentalHeight()) - 1) / mTileHeight + 1;
+	for(uint32_t tileY = tileBegin; tileY < tileEnd; tileY++)
+	{
+		if(mTransposeSourceChanged[tileY * mTileCountX + tileX])
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void CpuStabilityCalculator::ExpandSymmetry()
+{
+	const uint32_t boardWidth  = mSymmetry.GetBoardWidth();
+	const uint32_t boardHeight = mSymmetry.GetBoardHeight();
+
+	BitBoard fullBoard;
+	BitBoard fullStability;
+	mSymmetry.ExpandBoard(mPrevBoard, fullBoard);
+	mSymmetry.ExpandBoard(mPrevStability, fullStability);
+
+	if(mLastSpawnPeriod != 0)
+	{
+		CpuSpawnPlanes fullSpawnPlanes;
+		mSymmetry.ExpandPlanes(mSpawnPlanes, fullBoard.GetWordsPerRow(), fullSpawnPlanes);
+		mSpawnPlanes.Swap(fullSpawnPlanes);
+	}
+	else
+	{
+		mSpawnPlanes.Clear();
+	}
+
+	if(mChangeMap.GetWidth() != 0)
+	{
+		CpuChangeMap fullChangeMap;
+		CopyChangeMap(fullChangeMap);
+		std::swap(mChangeMap, fullChangeMap);
+	}
+
+	mPrevBoard.Swap(fullBoard);
+	mPrevStability.Swap(fullStability);
+	mCurrBoard.Resize(boardWidth, boardHeight);
+	mCurrStability.Resize(boardWidth, boardHeight);
+
+	mSymmetry.Reset(boardWidth, boardHeight);
+
+	mLastRestriction = nullptr; //The restricted board has to be recomputed in full size
+
+	UpdateTiles();
+}
+
+void CpuStabilityCalculator::StartImpulseResponse()
+{
+	mImpulseResponse.Stop();
+
+	//The impulse response rows aren't computed per tile, so they aren't counted
+	if(!mbTrackStats)
+	{
+		mImpulseResponse.Start(mPrevBoard);
+	}
+}
+
+bool CpuStabilityCalculator::ImpulseNextStep(const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t spawnPeriod)
+{
+	if(!mImpulseResponse.BeginStep(clickRule, restriction, spawnPeriod, mSymmetry))
+	{
+		//The board and the stability are exact at this point, regular steps continue from them
+		return false;
+	}
+
+	StepImpulseResponse(clickRule, mImpulseResponse.GetRadius());
+
+	//Outside of the rows and words ImpulseBoardRow() touches both the current and the next board are 0, so the stability there doesn't change
+	const uint32_t simHeight = mSymmetry.GetSimHeight();
+
+	uint32_t taskCount = (simHeight + gCopyRowsPerTask - 1) / gCopyRowsPerTask;
+	mThreadPool->ParallelFor(taskCount, [this, simHeight](uint32_t taskIndex, uint32_t threadIndex)
+	{
+		uint32_t rowBegin = taskIndex * gCopyRowsPerTask;
+		uint32_t rowEnd   = std::min(rowBegin + gCopyRowsPerTask, simHeight);
+
+		for(uint32_t y = rowBegin; y < rowEnd; y++)
+		{
+			ImpulseBoardRow((int32_t)y, mTileScratches[threadIndex]);
+		}
+	});
+
+	mImpulseResponse.EndStep();
+	mCurrBoard.Swap(mPrevBoard);
+
+	mbTileActivityValid = false;
+	mLastRestriction    = nullptr;
+	mLastSpawnPeriod    = 0;
+	mbFreshStability    = false;
+	mCurrentStep++;
+
+	return true; //The images cover the symmetry halo too, it doesn't need to be mirrored
+}
+
+void CpuStabilityCalculator::StepImpulseResponse(const CpuClickRule* clickRule, int32_t radius)
+{
+	const size_t    alignment    = BitBoard::RowWordAlignment;
+	const int32_t   center       = mImpulseResponse.GetCenter();
+	const BitBoard& prevResponse = mImpulseResponse.GetPrevResponse();
+	BitBoard&       currResponse = mImpulseResponse.GetCurrResponse();
+
+	size_t wordBegin = (size_t)(center - radius) / 64 / alignment * alignment;
+	size_t wordEnd   = std::min(((size_t)(center + radius) / 64 + alignment) / alignment * alignment, prevResponse.GetWordsPerRow());
+
+	const int32_t rowBegin  = center - radius;
+	const uint32_t rowCount = 2 * (uint32_t)radius + 1;
+
+	uint32_t taskCount = (rowCount + gCopyRowsPerTask - 1) / gCopyRowsPerTask;
+	mThreadPool->ParallelFor(taskCount, [this, clickRule, &prevResponse, &currResponse, wordBegin, wordEnd, rowBegin, rowCount](uint32_t taskIndex, uint32_t threadIndex)
+	{
+		TileScratch& scratch = mTileScratches[threadIndex];
+		ResetFactorRows(scratch, clickRule, wordEnd - wordBegin);
+
+		uint32_t taskRowEnd = std::min((taskIndex + 1) * gCopyRowsPerTask, rowCount);
+		for(uint32_t i = taskIndex * gCopyRowsPerTask; i < taskRowEnd; i++)
+		{
+			int32_t y = rowBegin + (int32_t)i;
+			NextBoardRow(currResponse.Row(y) + wordBegin, prevResponse, y, wordBegin, wordEnd - wordBegin, prevResponse.GetColumnMask() + wordBegin, clickRule, scratch);
+		}
+	});
+}
+
+void CpuStabilityCalculator::ImpulseBoardRow(int32_t y, TileScratch& scratch)
+{
+	uint64_t* nextRow = mCurrBoard.Row(y);
+
+	size_t wordBegin = 0;
+	size_t wordEnd   = 0;
+	if(!mImpulseResponse.BoardRow(nextRow, y, mPrevBoard.GetWordsPerRow(), mSymmetry.GetSimWidth(), mKernels, wordBegin, wordEnd))
+	{
+		return;
+	}
+
+	const size_t wordCount = wordEnd - wordBegin;
+
+	mKernels.AndRow(nextRow + wordBegin, nextRow + wordBegin, mCurrBoard.GetColumnMask() + wordBegin, wordCount);
+
+	uint64_t* stabilityRow = mPrevStability.Row(y) + wordBegin;
+	if(mChangeMap.GetWidth() != 0)
+	{
+		scratch.PrevStabilityRow.assign(stabilityRow, stabilityRow + wordCount);
+	}
+
+	mKernels.StabilityRow(stabilityRow, stabilityRow, mPrevBoard.Row(y) + wordBegin, nextRow + wordBegin, nullptr, wordCount);
+	if(mChangeMap.GetWidth() != 0)
+	{
+		RecordChanges(scratch.PrevStabilityRow.data(), stabilityRow, y, wordBegin, wordCount, mCurrentStep + 1);
+	}
+}
+
+void CpuStabilityCalculator::RecordChanges(const uint64_t* prevStabilityRow, const uint64_t* nextStabilityRow, int32_t y, size_t wordBegin, size_t wordCount, uint32_t frame)
+{
+	//Stability only goes from 1 to 0 without spawn, and the front of changed cells is thin, so most words are skipped
+	uint32_t*      changeRow = mChangeMap.Row((uint32_t)y);
+	const uint32_t simWidth  = mSymmetry.GetSimWidth();
+	for(size_t i = 0; i < wordCount; i++)
+	{
+		uint64_t changedBits = prevStabilityRow[i] & ~nextStabilityRow[i];
+		for(uint32_t x = (uint32_t)((wordBegin + i) * 64); changedBits != 0 && x < simWidth; x++)
+		{
+			if(changedBits & 1)
+			{
+				changeRow[x] = frame;
+			}
+
+			changedBits >>= 1;
+		}
+	}
+}
+
+CpuGenerationCounts& CpuStabilityCalculator::GetTileCounts(uint32_t tileIndex, uint32_t step)
+{
+	return mTileCounts[tileIndex * gMaxTemporalBlockSteps + step];
+}
+
+const uint64_t* CpuStabilityCalculator::GetCountMaskRow(int32_t y) const
+{
+	return mSymmetry.IsMirroredDiagonal() ? mDiagonalCountMask.Row(y) : mCountMask.data();
+}
+
+void CpuStabilityCalculator::CountRow(CpuGenerationCounts& counts, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* stableRow, int32_t y, size_t wordBegin, size_t wordCount) const
+{
+	//The halo rows are counted in their mirror images, the middle row of an odd height is its own image
+	if((uint32_t)y >= mSymmetry.GetFundamentalHeight())
+	{
+		return;
+	}
+
+	const uint64_t* countMask = GetCountMaskRow(y) + wordBegin;
+
+	uint64_t rowCounts[3];
+	mKernels.CountRow(rowCounts, thisRow, nextRow, stableRow, countMask, wordCount);
+
+	if(mSymmetry.IsMirroredX())
+	{
+		size_t middleWord = mMiddleColumn / 64;
+		for(int i = 0; i < 3; i++)
+		{
+			rowCounts[i] *= 2;
+		}
+
+		if(mMiddleColumn != CpuGenerationCounts::NoCell && middleWord >= wordBegin && middleWord < wordBegin + wordCount)
+		{
+			uint64_t middleBit = 1ull << (mMiddleColumn % 64);
+			size_t   i         = middleWord - wordBegin;
+
+			rowCounts[0] -= (stableRow[i] & middleBit) ? 1 : 0;
+			rowCounts[1] -= ((thisRow[i] ^ nextRow[i]) & middleBit) ? 1 : 0;
+			rowCounts[2] -= (nextRow[i] & middleBit) ? 1 : 0;
+		}
+	}
+
+	if(mSymmetry.IsMirroredDiagonal())
+	{
+		size_t diagonalWord = (uint32_t)y / 64;
+		for(int i = 0; i < 3; i++)
+		{
+			rowCounts[i] *= 2;
+		}
+
+		//The diagonal cell is its own transposed image, it keeps the weight of its mirror images only
+		if(diagonalWord >= wordBegin && diagonalWord < wordBegin + wordCount)
+		{
+			uint64_t diagonalBit    = 1ull << (y % 64);
+			uint64_t diagonalWeight = ((uint32_t)y == mMiddleColumn) ? 1 : 2;
+			size_t   i              = diagonalWord - wordBegin;
+
+			rowCounts[0] -= (stableRow[i] & diagonalBit) ? diagonalWeight : 0;
+			rowCounts[1] -= ((thisRow[i] ^ nextRow[i]) & diagonalBit) ? diagonalWeight : 0;
+			rowCounts[2] -= (nextRow[i] & diagonalBit) ? diagonalWeight : 0;
+		}
+	}
+
+	uint64_t rowWeight = 1;
+	if(mSymmetry.IsMirroredY() && !(mSymmetry.GetBoardHeight() % 2 != 0 && (uint32_t)y == mSymmetry.GetFundamentalHeight() - 1))
+	{
+		rowWeight = 2;
+	}
+
+	counts.StableCount  += rowCounts[0] * rowWeight;
+	counts.ChangedCount += rowCounts[1] * rowWeight;
+	counts.LitCount     += rowCounts[2] * rowWeight;
+
+	if(rowCounts[0] == 0)
+	{
+		return;
+	}
+
+	//The stable span is found from the ends of the row, it's usually wide
+	size_t firstWord = 0;
+	while((stableRow[firstWord] & countMask[firstWord]) == 0)
+	{
+		firstWord++;
+	}
+
+	size_t lastWord = wordCount - 1;
+	while((stableRow[lastWord] & countMask[lastWord]) == 0)
+	{
+		lastWord--;
+	}
+
+	uint64_t firstBits = stableRow[firstWord] & countMask[firstWord];
+	uint64_t lastBits  = stableRow[lastWord]  & countMask[lastWord];
+
+	uint32_t minX = (uint32_t)((wordBegin + firstWord) * 64);
+	while((firstBits & 1) == 0)
+	{
+		firstBits >>= 1;
+		minX++;
+	}
+
+	uint32_t maxX = (uint32_t)((wordBegin + lastWord) * 64 + 63);
+	while((lastBits >> 63) == 0)
+	{
+		lastBits <<= 1;
+		maxX--;
+	}
+
+	counts.AddStableSpan(minX, maxX, (uint32_t)y);
+}
+
+const uint64_t* CpuStabilityCalculator::SpawnStableRow(TileScratch& scratch, int32_t y, size_t wordBegin, size_t wordCount) const
+{
+	const size_t    wordsPerRow = mPrevBoard.GetWordsPerRow();
+	const uint64_t* planes      = mSpawnPlanes.CurrRow(y) + wordBegin;
+
+	scratch.StableRow.resize(wordCount);
+	for(size_t i = 0; i < wordCount; i++)
+	{
+		uint64_t stableBits = planes[i];
+		for(uint32_t plane = 1; plane < mSpawnPlanes.GetPlaneCount(); plane++)
+		{
+			stableBits &= ~planes[plane * wordsPerRow + i];
+		}
+
+		scratch.StableRow[i] = stableBits;
+	}
+
+	return scratch.StableRow.data();
+}
+
+void CpuStabilityCalculator::RepeatTileCounts(uint32_t tileIndex, uint32_t stepCount)
+{
+	CpuGenerationCounts counts = mLastTileCounts[tileIndex];
+	counts.ChangedCount = 0;
+
+	for(uint32_t step = 0; step < stepCount; step++)
+	{
+		GetTileCounts(tileIndex, step) = counts;
+	}
+}
+
+void CpuStabilityCalculator::AppendGenerationStats(uint32_t generationCount)
+{
+	const uint32_t tileCount = mTileCountX * mTileCountY;
+	for(uint32_t step = 0; step < generationCount; step++)
+	{
+		CpuGenerationCounts counts;
+		for(uint32_t tileIndex = 0; tileIndex < tileCount; tileIndex++)
+		{
+			counts.Merge(GetTileCounts(tileIndex, step));
+		}
+
+		//The bounding box of a mirrored board is mirrored too
+		if(counts.StableMinX != CpuGenerationCounts::NoCell)
+		{
+			if(mSymmetry.IsMirroredDiagonal())
+			{
+				counts.StableMinX = counts.StableMinY; //The topmost cell above the diagonal is transposed to the leftmost one
+			}
+
+			if(mSymmetry.IsMirroredX())
+			{
+				counts.StableMaxX = mSymmetry.GetBoardWidth() - 1 - counts.StableMinX;
+			}
+
+			if(mSymmetry.IsMirroredY())
+			{
+				counts.StableMaxY = mSymmetry.GetBoardHeight() - 1 - counts.StableMinY;
+			}
+		}
+
+		if(mbTrackStats)
+		{
+			mGenerationStats.Append(mCurrentStep + step + 1, counts);
+		}
+
+		if(mbTrackStateHashes)
+		{
+			mCycleDetector.AddState(mCurrentStep + step + 1, counts.StateHash);
+		}
+	}
+
+	for(uint32_t tileIndex = 0; tileIndex < tileCount; tileIndex++)
+	{
+		mLastTileCounts[tileIndex] = GetTileCounts(tileIndex, generationCount - 1);
+	}
+}
+
+void CpuStabilityCalculator::HashStateRow(CpuGenerationCounts& counts, const uint64_t* boardRow, int32_t y, size_t wordBegin, size_t wordCount, uint32_t spawnPeriod) const
+{
+	//The mirrored and the transposed parts of the board are the images of the fundamental region, so the fundamental region is the whole state
+	if((uint32_t)y >= mSymmetry.GetFundamentalHeight())
+	{
+		return;
+	}
+
+	const size_t    wordsPerRow = mPrevBoard.GetWordsPerRow();
+	const uint64_t* countMask   = GetCountMaskRow(y) + wordBegin;
+	const uint64_t  rowPosition = CpuStateHash::RowPosition(y, wordsPerRow, wordBegin);
+
+	//The layer 0 is the board, the next ones are the spawn planes
+	uint64_t       stateHash  = 0;
+	const uint32_t layerCount = (spawnPeriod == 0) ? 1 : mSpawnPlanes.GetPlaneCount() + 1;
+	for(uint32_t layer = 0; layer < layerCount; layer++)
+	{
+		const uint64_t* layerRow = (layer == 0) ? boardRow : mSpawnPlanes.CurrRow(y) + (layer - 1) * wordsPerRow + wordBegin;
+		stateHash ^= CpuStateHash::HashLayerRow(layerRow, countMask, wordCount, rowPosition, layer);
+	}
+
+	//Without spawn the stability only loses cells, so two rows of it from the same run are equal if their counts are
+	if(spawnPeriod == 0)
+	{
+		const uint64_t* stabilityRow = mCurrStability.Row(y) + wordBegin;
+
+		uint64_t rowCounts[3];
+		mKernels.CountRow(rowCounts, stabilityRow, stabilityRow, stabilityRow, countMask, wordCount);
+		stateHash ^= CpuStateHash::HashStableCount(rowCounts[0], rowPosition);
+	}
+
+	counts.StateHash ^= stateHash;
+}
+
+bool CpuStabilityCalculator::TracksGenerations() const
+{
+	return mbTrackStats || mbTrackStateHashes;
+}
+
+uint32_t CpuStabilityCalculator::GetTemporalBlockSteps(const CpuClickRule* clickRule) const
+{
+	int32_t radius = clickRule ? std::max(clickRule->GetRadius(), 1) : 1;
+	return std::min((uint32_t)std::max(gTemporalBlockHalo / radius, 1), gMaxTemporalBlockSteps);
+}
+
+uint32_t CpuStabilityCalculator::HashLifeNextSteps(uint32_t stepCount, const CpuClickRule* clickRule, const BitBoard* restriction)
+{
+	if(!mbUseHashLife || mbHashLifeGaveUp || mImpulseResponse.IsActive() || mSymmetry.IsMirrored() || mChangeMap.GetWidth() != 0 || mbTrackStats || stepCount < gMinHashLifeSteps || !CpuHashLife::IsSupported(clickRule))
+	{
+		return 0;
+	}
+
+	SwitchSpawnMode(0);
+	if(!mbHashLifeActive || clickRule != mHashLifeClickRule || restriction != mHashLifeRestriction)
+	{
+		mHashLife->Init(mPrevBoard, mPrevStability, clickRule, restriction);
+
+		mHashLifeClickRule   = clickRule;
+		mHashLifeRestriction = restriction;
+		mbHashLifeActive     = true;
+	}
+
+	uint32_t doneSteps = mHashLife->Advance(stepCount);
+	mbHashLifeGaveUp = (doneSteps < stepCount);
+
+	mHashLife->GetBoard(mPrevBoard);
+	mHashLife->GetStability(mPrevStability);
+
+	mLastRestriction    = nullptr; //The restricted board is outdated
+	mbTileActivityValid = false;
+
+	mLastSpawnPeriod = 0;
+	mbFreshStability = mbFreshStability && (doneSteps == 0);
+	mCurrentStep    += doneSteps;
+
+	return doneSteps;
+}
+
+void CpuStabilityCalculator::BeginTileActivity(const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t spawnPeriod)
+{
+	if(clickRule != mActivityClickRule || restriction != mActivityRestriction || spawnPeriod != 0)
+	{
+		mbTileActivityValid = false;
+	}
+
+	mActivityClickRule   = clickRule;
+	mActivityRestriction = restriction;
+}
+
+void CpuStabilityCalculator::EndTileActivity(uint32_t spawnPeriod)
+{
+	//Spawn stability changes every generation even where the board doesn't
+	mTileChanged.swap(mNextTileChanged);
+	mbTileActivityValid = (spawnPeriod == 0);
+}
+
+bool CpuStabilityCalculator::IsTileStatic(uint32_t tileX, uint32_t tileY, int32_t reach) const
+{
+	TileRange neighbourhood = GetTileNeighbourhood(tileX, tileY, reach);
+	for(uint32_t neighbourY = neighbourhood.BeginY; neighbourY < neighbourhood.EndY; neighbourY++)
+	{
+		for(uint32_t neighbourX = neighbourhood.BeginX; neighbourX < neighbourhood.EndX; neighbourX++)
+		{
+			if(mTileChanged[neighbourY * mTileCountX + neighbourX])
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool CpuStabilityCalculator::TouchesSymmetryHalo(uint32_t tileX, uint32_t tileY) const
+{
+	//The halo is computed with zeros outside of the simulated board and then mirrored over, so its changes are never trusted
+	size_t   tileEndX = (tileX + 1) * mTileWords * 64;
+	uint32_t tileEndY = (tileY + 1) * mTileHeight;
+	return (mSymmetry.IsMirroredX() && tileEndX > mSymmetry.GetFundamentalWidth()) || (mSymmetry.IsMirroredY() && tileEndY > mSymmetry.GetFundamentalHeight());
+}
+
+void CpuStabilityCalculator::SkipBelowDiagonalTile(uint32_t tileIndex)
+{
+	if(TracksGenerations())
+	{
+		for(uint32_t step = 0; step < gMaxTemporalBlockSteps; step++)
+		{
+			GetTileCounts(tileIndex, step) = CpuGenerationCounts();
+		}
+	}
+
+	//The cells are transposed into both buffers, MarkTransposedTileChanges() tells if they changed
+	mNextTileChanged[tileIndex] = 0;
+	mTileStale[tileIndex]       = !mbTileActivityValid;
+}
+
+void CpuStabilityCalculator::MarkTransposedTileChanges()
+{
+	if(!mSymmetry.IsMirroredDiagonal())
+	{
+		return;
+	}
+
+	//The cells a tile skipped below the diagonal changed if the transposed ones did, and those are in the tiles over the transposed tile
+	const std::vector<uint8_t> computedTileChanged = mNextTileChanged;
+	const size_t               tileCellsX          = mTileWords * 64;
+	for(uint32_t tileY = 0; tileY < mTileCountY; tileY++)
+	{
+		for(uint32_t tileX = 0; tileX < mTileCountX; tileX++)
+		{
+			if(GetTileWordBegin(tileX, tileY) == tileX * mTileWords)
+			{
+				continue;
+			}
+
+			TileRange transposedTiles;
+			transposedTiles.BeginX = (uint32_t)((size_t)tileY * mTileHeight / tileCellsX);
+			transposedTiles.BeginY = (uint32_t)(tileX * tileCellsX / mTileHeight);
+			transposedTiles.EndX   = (uint32_t)std::min<size_t>(((size_t)(tileY + 1) * mTileHeight - 1) / tileCellsX + 1, mTileCountX);
+			transposedTiles.EndY   = (uint32_t)std::min<size_t>(((tileX + 1) * tileCellsX - 1) / mTileHeight + 1, mTileCountY);
+
+			bool transposedChanged = false;
+			for(uint32_t transposedY = transposedTiles.BeginY; transposedY < transposedTiles.EndY && !transposedChanged; transposedY++)
+			{
+				for(uint32_t transposedX = transposedTiles.BeginX; transposedX < transposedTiles.EndX && !transposedChanged; transposedX++)
+				{
+					transposedChanged = computedTileChanged[transposedY * mTileCountX + transposedX];
+				}
+			}
+
+			if(transposedChanged)
+			{
+				uint32_t tileIndex = tileY * mTileCountX + tileX;
+				mNextTileChanged[tileIndex] = 1;
+				mTileStale[tileIndex]       = 1;
+			}
+		}
+	}
+}
+
+void CpuStabilityCalculator::SkipTile(uint32_t tileIndex, const BitBoard* restriction)
+{
+	mNextTileChanged[tileIndex] = 0;
+	if(!mTileStale[tileIndex])
+	{
+		return;
+	}
+
+	const size_t wordsPerRow = mPrevBoard.GetWordsPerRow();
+
+	uint32_t tileX = tileIndex % mTileCountX;
+	uint32_t tileY = tileIndex / mTileCountX;
+
+	size_t wordBegin = tileX * mTileWords;
+	size_t wordEnd   = std::min(wordBegin + mTileWords, wordsPerRow);
+
+	int32_t rowBegin = (int32_t)(tileY * mTileHeight);
+	int32_t rowEnd   = (int32_t)std::min(mSymmetry.GetSimHeight(), (tileY + 1) * mTileHeight);
+	for(int32_t y = rowBegin; y < rowEnd; y++)
+	{
+		std::copy(mPrevBoard.Row(y)     + wordBegin, mPrevBoard.Row(y)     + wordEnd, mCurrBoard.Row(y)     + wordBegin);
+		std::copy(mPrevStability.Row(y) + wordBegin, mPrevStability.Row(y) + wordEnd, mCurrStability.Row(y) + wordBegin);
+		if(restriction)
+		{
+			std::copy(mPrevRestrictedBoard.Row(y) + wordBegin, mPrevRestrictedBoard.Row(y) + wordEnd, mCurrRestrictedBoard.Row(y) + wordBegin);
+		}
+	}
+
+	mTileStale[tileIndex] = 0;
+}
+
+CpuStabilityCalculator::TileRange CpuStabilityCalculator::GetTileNeighbourhood(uint32_t tileX, uint32_t tileY, int32_t reach) const
+{
+	const uint32_t reachX = (uint32_t)(((size_t)reach + mTileWords * 64 - 1) / (mTileWords * 64));
+	const uint32_t reachY = ((uint32_t)reach + mTileHeight - 1) / mTileHeight;
+
+	TileRange neighbourhood;
+	neighbourhood.BeginX = tileX - std::min(tileX, reachX);
+	neighbourhood.BeginY = tileY - std::min(tileY, reachY);
+	neighbourhood.EndX   = std::min(tileX + reachX + 1, mTileCountX);
+	neighbourhood.EndY   = std::min(tileY + reachY + 1, mTileCountY);
+	return neighbourhood;
+}
+
+size_t CpuStabilityCalculator::GetTileWordBegin(uint32_t tileX, uint32_t tileY) const
+{
+	size_t wordBegin = tileX * mTileWords;
+	if(mSymmetry.IsMirroredDiagonal())
+	{
+		//Every cell left of the diagonal cell of the top row is below the diagonal. Whole SIMD rows are computed
+		size_t diagonalWord = (size_t)tileY * mTileHeight / 64 / BitBoard::RowWordAlignment * BitBoard::RowWordAlignment;
+		wordBegin = std::max(wordBegin, diagonalWord);
+	}
+
+	return wordBegin;
+}
+
+void CpuStabilityCalculator::UpdateTileRestrictions(const BitBoard* restriction)
+{
+	if(!restriction || restriction == mSummaryRestriction)
+	{
+		return;
+	}
+
+	const size_t wordsPerRow = mPrevBoard.GetWordsPerRow();
+
+	mTileRestrictions.resize(mTileCountX * mTileCountY);
+	mThreadPool->ParallelFor(mTileCountX * mTileCountY, [this, restriction, wordsPerRow](uint32_t tileIndex, uint32_t /*threadIndex*/)
+	{
+		uint32_t tileX = tileIndex % mTileCountX;
+		uint32_t tileY = tileIndex / mTileCountX;
+
+		size_t wordBegin = tileX * mTileWords;
+		size_t wordEnd   = std::min(wordBegin + mTileWords, wordsPerRow);
+
+		int32_t rowBegin = (int32_t)(tileY * mTileHeight);
+		int32_t rowEnd   = (int32_t)std::min(mSymmetry.GetSimHeight(), (tileY + 1) * mTileHeight);
+
+		//Only the cells inside the board count, the ones outside are never clicked anyway
+		const uint64_t* columnMask = restriction->GetColumnMask();
+
+		bool anyOpen    = false;
+		bool anyBlocked = false;
+		for(int32_t y = rowBegin; y < rowEnd && !(anyOpen && anyBlocked); y++)
+		{
+			const uint64_t* restrictionRow = restriction->Row(y);
+			for(size_t i = wordBegin; i < wordEnd; i++)
+			{
+				anyOpen    = anyOpen    || ((restrictionRow[i] & columnMask[i]) != 0);
+				anyBlocked = anyBlocked || ((restrictionRow[i] & columnMask[i]) != columnMask[i]);
+			}
+		}
+
+		if(anyOpen && anyBlocked)
+		{
+			mTileRestrictions[tileIndex] = TileRestriction::Mixed;
+		}
+		else
+		{
+			mTileRestrictions[tileIndex] = anyOpen ? TileRestriction::Open : TileRestriction::Blocked;
+		}
+	});
+
+	mSummaryRestriction = restriction;
+}
+
+CpuStabilityCalculator::TileRestriction CpuStabilityCalculator::GetTileRestriction(uint32_t tileX, uint32_t tileY, int32_t reach) const
+{
+	const TileRestriction tileRestriction = mTileRestrictions[tileY * mTileCountX + tileX];
+	if(tileRestriction == TileRestriction::Mixed)
+	{
+		return TileRestriction::Mixed;
+	}
+
+	TileRange neighbourhood = GetTileNeighbourhood(tileX, tileY, reach);
+	for(uint32_t neighbourY = neighbourhood.BeginY; neighbourY < neighbourhood.EndY; neighbourY++)
+	{
+		for(uint32_t neighbourX = neighbourhood.BeginX; neighbourX < neighbourhood.EndX; neighbourX++)
+		{
+			if(mTileRestrictions[neighbourY * mTileCountX + neighbourX] != tileRestriction)
+			{
+				return TileRestriction::Mixed;
+			}
+		}
+	}
+
+	return tileRestriction;
+}
+
+void CpuStabilityCalculator::BlockTile(uint32_t tileIndex, uint32_t spawnPeriod)
+{
+	const size_t wordsPerRow = mPrevBoard.GetWordsPerRow();
+
+	uint32_t tileX = tileIndex % mTileCountX;
+	uint32_t tileY = tileIndex / mTileCountX;
+
+	size_t wordBegin = tileX * mTileWords;
+	size_t wordCount = std::min(mTileWords, wordsPerRow - wordBegin);
+
+	int32_t rowBegin = (int32_t)(tileY * mTileHeight);
+	int32_t rowEnd   = (int32_t)std::min(mSymmetry.GetSimHeight(), (tileY + 1) * mTileHeight);
+
+	//No cell around is clicked, so the board becomes 0. A blocked cell is never stable
+	bool tileChanged = TouchesSymmetryHalo(tileX, tileY);
+
+	CpuGenerationCounts counts;
+	for(int32_t y = rowBegin; y < rowEnd; y++)
+	{
+		const uint64_t* thisRow = mPrevBoard.Row(y) + wordBegin;
+		if(!tileChanged)
+		{
+			tileChanged = std::any_of(thisRow, thisRow + wordCount, [](uint64_t word) {return word != 0;});
+		}
+
+		std::fill(mCurrBoard.Row(y) + wordBegin, mCurrBoard.Row(y) + wordBegin + wordCount, 0);
+		std::fill(mCurrRestrictedBoard.Row(y) + wordBegin, mCurrRestrictedBoard.Row(y) + wordBegin + wordCount, 0);
+
+		if(spawnPeriod == 0)
+		{
+			std::fill(mCurrStability.Row(y) + wordBegin, mCurrStability.Row(y) + wordBegin + wordCount, 0);
+			if(mChangeMap.GetWidth() != 0)
+			{
+				RecordChanges(mPrevStability.Row(y) + wordBegin, mCurrStability.Row(y) + wordBegin, y, wordBegin, wordCount, mCurrentStep + 1);
+			}
+		}
+		else
+		{
+			//Every blocked cell gets the value 2
+			uint64_t* nextSpawnPlanes = mSpawnPlanes.CurrRow(y) + wordBegin;
+			for(uint32_t plane = 0; plane < mSpawnPlanes.GetPlaneCount(); plane++)
+			{
+				std::fill(nextSpawnPlanes + plane * wordsPerRow, nextSpawnPlanes + plane * wordsPerRow + wordCount, (plane == 1) ? ~0ull : 0);
+			}
+		}
+
+		//The zero rows of the next board are also zero stable rows
+		const uint64_t* zeroRow = mCurrBoard.Row(y) + wordBegin;
+		if(mbTrackStats)
+		{
+			CountRow(counts, thisRow, zeroRow, zeroRow, y, wordBegin, wordCount);
+		}
+
+		if(mbTrackStateHashes)
+		{
+			HashStateRow(counts, zeroRow, y, wordBegin, wordCount, spawnPeriod);
+		}
+	}
+
+	//Only the first generation of a pass changes anything
+	if(TracksGenerations())
+	{
+		for(uint32_t step = 0; step < gMaxTemporalBlockSteps; step++)
+		{
+			GetTileCounts(tileIndex, step) = counts;
+			counts.ChangedCount = 0;
+		}
+	}
+
+	//The stability buffers may still differ even if the board didn't change
+	mNextTileChanged[tileIndex] = tileChanged;
+	mTileStale[tileIndex]       = 1;
+}
+
+void CpuStabilityCalculator::NextStepTile(uint32_t tileIndex, uint32_t threadIndex, const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t spawnPeriod)
+{
+	const size_t wordsPerRow = mPrevBoard.GetWordsPerRow();
+
+	uint32_t tileX = tileIndex % mTileCountX;
+	uint32_t tileY = tileIndex / mTileCountX;
+
+	size_t wordBegin = tileX * mTileWords;
+	size_t wordCount = std::min(mTileWords, wordsPerRow - wordBegin);
+
+	int32_t rowBegin = (int32_t)(tileY * mTileHeight);
+	int32_t rowEnd   = (int32_t)std::min(mSymmetry.GetSimHeight(), (tileY + 1) * mTileHeight);
+
+	const int32_t radius = clickRule ? std::max(clickRule->GetRadius(), 1) : 1;
+
+	const bool touchesHalo = TouchesSymmetryHalo(tileX, tileY);
+	if(mbTileActivityValid && spawnPeriod == 0 && !touchesHalo && IsTileStatic(tileX, tileY, radius))
+	{
+		SkipTile(tileIndex, restriction);
+		if(TracksGenerations())
+		{
+			RepeatTileCounts(tileIndex, 1);
+		}
+
+		return;
+	}
+
+	const TileRestriction tileRestriction = restriction ? GetTileRestriction(tileX, tileY, radius) : TileRestriction::Open;
+	if(tileRestriction == TileRestriction::Blocked)
+	{
+		BlockTile(tileIndex, spawnPeriod);
+		return;
+	}
+
+	TileScratch& scratch = mTileScratches[threadIndex];
+	ResetFactorRows(scratch, clickRule, wordCount);
+
+	bool tileChanged = touchesHalo;
+
+	CpuGenerationCounts counts;
+
+	//The restricted board is the same as the board in an open neighbourhood
+	uint32_t restrictionIndex = CpuStepPolicies::NoRestriction::Index;
+	if(tileRestriction == TileRestriction::Mixed)
+	{
+		restrictionIndex = CpuStepPolicies::MaskedRestriction::Index;
+	}
+	else if(restriction)
+	{
+		restrictionIndex = CpuStepPolicies::OpenRestriction::Index;
+	}
+
+	uint32_t spawnIndex    = (spawnPeriod == 0) ? CpuStepPolicies::NoSpawn::Index : CpuStepPolicies::SpawnPlanes::Index;
+	uint32_t trackingIndex = (mbTrackStats || mbTrackStateHashes || mChangeMap.GetWidth() != 0) ? CpuStepPolicies::Tracked::Index : CpuStepPolicies::Untracked::Index;
+
+	TileStep tileStep;
+	tileStep.RowBegin    = rowBegin;
+	tileStep.RowEnd      = rowEnd;
+	tileStep.WordBegin   = wordBegin;
+	tileStep.WordCount   = wordCount;
+	tileStep.ClickRule   = clickRule;
+	tileStep.Restriction = restriction;
+	tileStep.SpawnPeriod = spawnPeriod;
+
+	TileRowsFunction tileRows = TileRowsVariants[CpuStepPolicies::VariantIndex(StencilIndex(clickRule), restrictionIndex, spawnIndex, trackingIndex)];
+	(this->*tileRows)(tileStep, scratch, counts, tileChanged);
+
+	if(TracksGenerations())
+	{
+		GetTileCounts(tileIndex, 0) = counts;
+	}
+
+	//An unchanged tile leaves both buffers equal. Without valid tracking the other buffer holds an unknown older state
+	mNextTileChanged[tileIndex] = tileChanged;
+	mTileStale[tileIndex]       = tileChanged || !mbTileActivityValid;
+}
+
+template<typename StencilPolicy, typename RestrictionPolicy, typename SpawnPolicy, typename TrackingPolicy>
+void CpuStabilityCalculator::NextStepTileRows(const TileStep& tileStep, TileScratch& scratch, CpuGenerationCounts& counts, bool& inoutTileChanged)
+{
+	const size_t wordsPerRow = mPrevBoard.GetWordsPerRow();
+	const size_t wordBegin   = tileStep.WordBegin;
+	const size_t wordCount   = tileStep.WordCount;
+
+	const BitBoard& sourceBoard = RestrictionPolicy::MasksCells ? mPrevRestrictedBoard : mPrevBoard;
+	const uint64_t* columnMask  = sourceBoard.GetColumnMask() + wordBegin;
+	for(int32_t y = tileStep.RowBegin; y < tileStep.RowEnd; y++)
+	{
+		NextBoardRow<StencilPolicy>(mCurrBoard.Row(y) + wordBegin, sourceBoard, y, wordBegin, wordCount, columnMask, tileStep.ClickRule, scratch);
+
+		const uint64_t* thisRow        = mPrevBoard.Row(y) + wordBegin;
+		const uint64_t* nextRow        = mCurrBoard.Row(y) + wordBegin;
+		const uint64_t* restrictionRow = nullptr;
+		if(!inoutTileChanged)
+		{
+			inoutTileChanged = (memcmp(thisRow, nextRow, wordCount * sizeof(uint64_t)) != 0);
+		}
+
+		if constexpr(RestrictionPolicy::MasksCells)
+		{
+			restrictionRow = tileStep.Restriction->Row(y) + wordBegin;
+			mKernels.AndRow(mCurrRestrictedBoard.Row(y) + wordBegin, nextRow, restrictionRow, wordCount);
+		}
+		else if constexpr(RestrictionPolicy::WritesRestrictedBoard)
+		{
+			std::copy(nextRow, nextRow + wordCount, mCurrRestrictedBoard.Row(y) + wordBegin);
+		}
+
+		if constexpr(!SpawnPolicy::Spawns)
+		{
+			mKernels.StabilityRow(mCurrStability.Row(y) + wordBegin, mPrevStability.Row(y) + wordBegin, thisRow, nextRow, restrictionRow, wordCount);
+			if constexpr(TrackingPolicy::Tracks)
+			{
+				if(mChangeMap.GetWidth() != 0)
+				{
+					RecordChanges(mPrevStability.Row(y) + wordBegin, mCurrStability.Row(y) + wordBegin, y, wordBegin, wordCount, mCurrentStep + 1);
+				}
+			}
+		}
+		else
+		{
+			uint64_t*       nextSpawnPlanes = mSpawnPlanes.CurrRow(y) + wordBegin;
+			const uint64_t* prevSpawnPlanes = mSpawnPlanes.PrevRow(y) + wordBegin;
+			mKernels.SpawnStabilityRow(nextSpawnPlanes, prevSpawnPlanes, wordsPerRow, mSpawnPlanes.GetPlaneCount(), thisRow, nextRow, restrictionRow, tileStep.SpawnPeriod, wordCount);
+		}
+
+		if constexpr(TrackingPolicy::Tracks)
+		{
+			if(mbTrackStats)
+			{
+				const uint64_t* stableRow = SpawnPolicy::Spawns ? SpawnStableRow(scratch, y, wordBegin, wordCount) : mCurrStability.Row(y) + wordBegin;
+				CountRow(counts, thisRow, nextRow, stableRow, y, wordBegin, wordCount);
+			}
+
+			if(mbTrackStateHashes)
+			{
+				HashStateRow(counts, nextRow, y, wordBegin, wordCount, tileStep.SpawnPeriod);
+			}
+		}
+	}
+}
+
+template<size_t... Variants>
+std::array<CpuStabilityCalculator::TileRowsFunction, sizeof...(Variants)> CpuStabilityCalculator::MakeTileRowsVariants(std::index_sequence<Variants...>)
+{
+	return {{&CpuStabilityCalculator::NextStepTileRows<typename CpuStepPolicies::Policies<Variants>::Stencil, typename CpuStepPolicies::Policies<Variants>::Restriction, typename CpuStepPolicies::Policies<Variants>::Spawn, typename CpuStepPolicies::Policies<Variants>::Tracking>...}};
+}
+
+const std::array<CpuStabilityCalculator::TileRowsFunction, CpuStepPolicies::VariantCount> CpuStabilityCalculator::TileRowsVariants = CpuStabilityCalculator::MakeTileRowsVariants(std::make_index_sequence<CpuStepPolicies::VariantCount>());
+
+void CpuStabilityCalculator::NextStepsTile(uint32_t tileIndex, uint32_t threadIndex, uint32_t stepCount, const CpuClickRule* clickRule, const BitBoard* restriction)
+{
+	const size_t  wordsPerRow = mPrevBoard.GetWordsPerRow();
+	const int32_t radius      = clickRule ? std::max(clickRule->GetRadius(), 1) : 1;
+
+	uint32_t tileX = tileIndex % mTileCountX;
+	uint32_t tileY = tileIndex / mTileCountX;
+
+	size_t wordBegin = GetTileWordBegin(tileX, tileY);
+	size_t wordEnd   = std::min((tileX + 1) * mTileWords, wordsPerRow);
+	if(wordBegin >= wordEnd)
+	{
+		SkipBelowDiagonalTile(tileIndex);
+		return;
+	}
+
+	size_t wordCount = wordEnd - wordBegin;
+
+	int32_t rowBegin = (int32_t)(tileY * mTileHeight);
+	int32_t rowEnd   = (int32_t)std::min(mSymmetry.GetSimHeight(), (tileY + 1) * mTileHeight);
+
+	//Nothing within stepCount * radius cells changed, so none of the next stepCount generations change anything in the tile
+	const bool touchesHalo = TouchesSymmetryHalo(tileX, tileY);
+	if(mbTileActivityValid && !touchesHalo && IsTileStatic(tileX, tileY, (int32_t)stepCount * radius))
+	{
+		SkipTile(tileIndex, restriction);
+		if(TracksGenerations())
+		{
+			RepeatTileCounts(tileIndex, stepCount);
+		}
+
+		return;
+	}
+
+	const TileRestriction tileRestriction = restriction ? GetTileRestriction(tileX, tileY, (int32_t)stepCount * radius) : TileRestriction::Open;
+	if(tileRestriction == TileRestriction::Blocked)
+	{
+		BlockTile(tileIndex, 0);
+		return;
+	}
+
+	//Nothing in the halo of an open tile is restricted, so the generations are computed without the restriction
+	const bool maskTile = (tileRestriction == TileRestriction::Mixed);
+
+	//The tile is loaded with a halo of stepCount * radius cells, after each generation the outermost radius cells of it become invalid.
+	//The horizontal halo is rounded up to whole SIMD rows
+	const int32_t haloRows  = (int32_t)stepCount * radius;
+	const size_t  haloWords = ((size_t)haloRows + 64 * BitBoard::RowWordAlignment - 1) / (64 * BitBoard::RowWordAlignment) * BitBoard::RowWordAlignment;
+
+	const int32_t   localHeight    = (rowEnd - rowBegin) + 2 * haloRows;
+	const size_t    localWords     = wordCount + 2 * haloWords;
+	const int32_t   localRowOffset = rowBegin - haloRows;           //Global y of the local row 0
+	const ptrdiff_t localWordShift = (ptrdiff_t)wordBegin - (ptrdiff_t)haloWords; //Global word of the local word 0
+
+	TileScratch& scratch = mTileScratches[threadIndex];
+	for(int i = 0; i < 2; i++)
+	{
+		scratch.Boards[i].Resize((uint32_t)(localWords * 64), (uint32_t)localHeight);
+		if(maskTile)
+		{
+			scratch.RestrictedBoards[i].Resize((uint32_t)(localWords * 64), (uint32_t)localHeight);
+		}
+	}
+
+	if(maskTile)
+	{
+		scratch.Restriction.Resize((uint32_t)(localWords * 64), (uint32_t)localHeight);
+	}
+
+	//Everything outside the board stays 0 in the local buffers: such rows are never computed and such columns are masked out
+	size_t copyWordBegin = (size_t)std::max<ptrdiff_t>(localWordShift, 0);
+	size_t copyWordEnd   = (size_t)std::min<ptrdiff_t>(localWordShift + (ptrdiff_t)localWords, (ptrdiff_t)wordsPerRow);
+
+	scratch.ColumnMask.assign(localWords, 0);
+	std::copy(mPrevBoard.GetColumnMask() + copyWordBegin, mPrevBoard.GetColumnMask() + copyWordEnd, scratch.ColumnMask.begin() + (copyWordBegin - localWordShift));
+
+	int32_t localRowBegin = std::max(0, -localRowOffset);                            //First local row inside the board
+	int32_t localRowEnd   = std::min(localHeight, (int32_t)mSymmetry.GetSimHeight() - localRowOffset); //Last local row inside the board + 1
+	for(int32_t localY = localRowBegin; localY < localRowEnd; localY++)
+	{
+		int32_t globalY = localY + localRowOffset;
+		size_t  localX  = copyWordBegin - localWordShift;
+
+		std::copy(mPrevBoard.Row(globalY) + copyWordBegin, mPrevBoard.Row(globalY) + copyWordEnd, scratch.Boards[0].Row(localY) + localX);
+		if(maskTile)
+		{
+			std::copy(mPrevRestrictedBoard.Row(globalY) + copyWordBegin, mPrevRestrictedBoard.Row(globalY) + copyWordEnd, scratch.RestrictedBoards[0].Row(localY) + localX);
+			std::copy(restriction->Row(globalY)          + copyWordBegin, restriction->Row(globalY)          + copyWordEnd, scratch.Restriction.Row(localY)         + localX);
+		}
+	}
+
+	for(uint32_t step = 0; step < stepCount; step++)
+	{
+		CpuGenerationCounts counts;
+
+		const BitBoard& thisBoard   = scratch.Boards[step % 2];
+		BitBoard&       nextBoard   = scratch.Boards[(step + 1) % 2];
+		const BitBoard& sourceBoard = maskTile ? scratch.RestrictedBoards[step % 2] : thisBoard;
+
+		ResetFactorRows(scratch, clickRule, localWords);
+
+		int32_t validRowBegin = std::max(localRowBegin, (int32_t)(step + 1) * radius);
+		int32_t validRowEnd   = std::min(localRowEnd,   localHeight - (int32_t)(step + 1) * radius);
+		for(int32_t localY = validRowBegin; localY < validRowEnd; localY++)
+		{
+			uint64_t* nextRow = nextBoard.Row(localY);
+			NextBoardRow(nextRow, sourceBoard, localY, 0, localWords, scratch.ColumnMask.data(), clickRule, scratch);
+
+			const uint64_t* restrictionRow = nullptr;
+			if(maskTile)
+			{
+				restrictionRow = scratch.Restriction.Row(localY);
+				mKernels.AndRow(scratch.RestrictedBoards[(step + 1) % 2].Row(localY), nextRow, restrictionRow, localWords);
+			}
+
+			int32_t globalY = localY + localRowOffset;
+			if(globalY >= rowBegin && globalY < rowEnd)
+			{
+				//The stability of every intermediate generation is ANDed into the tile of the next stability right away
+				const uint64_t* prevStabilityRow = (step == 0) ? mPrevStability.Row(globalY) + wordBegin : mCurrStability.Row(globalY) + wordBegin;
+				const uint64_t* coreRestriction  = restrictionRow ? restrictionRow + haloWords : nullptr;
+				if(mChangeMap.GetWidth() != 0)
+				{
+					scratch.PrevStabilityRow.assign(prevStabilityRow, prevStabilityRow + wordCount);
+					prevStabilityRow = scratch.PrevStabilityRow.data();
+				}
+
+				mKernels.StabilityRow(mCurrStability.Row(globalY) + wordBegin, prevStabilityRow, thisBoard.Row(localY) + haloWords, nextRow + haloWords, coreRestriction, wordCount);
+				if(mChangeMap.GetWidth() != 0)
+				{
+					RecordChanges(prevStabilityRow, mCurrStability.Row(globalY) + wordBegin, globalY, wordBegin, wordCount, mCurrentStep + step + 1);
+				}
+
+				if(mbTrackStats)
+				{
+					CountRow(counts, thisBoard.Row(localY) + haloWords, nextRow + haloWords, mCurrStability.Row(globalY) + wordBegin, globalY, wordBegin, wordCount);
+				}
+
+				if(mbTrackStateHashes)
+				{
+					HashStateRow(counts, nextRow + haloWords, globalY, wordBegin, wordCount, 0);
+				}
+			}
+		}
+
+		if(TracksGenerations())
+		{
+			GetTileCounts(tileIndex, step) = counts;
+		}
+	}
+
+	bool tileChanged = touchesHalo;
+	for(int32_t globalY = rowBegin; globalY < rowEnd; globalY++)
+	{
+		int32_t localY = globalY - localRowOffset;
+
+		const uint64_t* finalRow       = scratch.Boards[stepCount % 2].Row(localY)       + haloWords;
+		const uint64_t* penultimateRow = scratch.Boards[(stepCount - 1) % 2].Row(localY) + haloWords;
+		if(!tileChanged)
+		{
+			tileChanged = (memcmp(penultimateRow, finalRow, wordCount * sizeof(uint64_t)) != 0);
+		}
+
+		std::copy(finalRow, finalRow + wordCount, mCurrBoard.Row(globalY) + wordBegin);
+
+		if(restriction)
+		{
+			const uint64_t* finalRestrictedRow = maskTile ? scratch.RestrictedBoards[stepCount % 2].Row(localY) + haloWords : finalRow;
+			std::copy(finalRestrictedRow, finalRestrictedRow + wordCount, mCurrRestrictedBoard.Row(globalY) + wordBegin);
+		}
+	}
+
+	//Only the last generation of the pass is compared, the buffers themselves hold generations stepCount apart
+	mNextTileChanged[tileIndex] = tileChanged;
+	mTileStale[tileIndex]       = 1;
+}
+
+void CpuStabilityCalculator::ResetFactorRows(TileScratch& scratch, const CpuClickRule* clickRule, size_t wordCount) const
+{
+	if(!clickRule || clickRule->IsCross() || !clickRule->IsSeparable())
+	{
+		return;
+	}
+
+	size_t slotCount = clickRule->GetFactors().size() * (2 * clickRule->GetRadius() + 1);
+	scratch.FactorRows.resize(slotCount * wordCount);
+	scratch.FactorRowSources.assign(slotCount, -1);
+}
+
+uint32_t CpuStabilityCalculator::StencilIndex(const CpuClickRule* clickRule)
+{
+	if(!clickRule || clickRule->IsCross())
+	{
+		return CpuStepPolicies::CrossStencil::Index;
+	}
+
+	return clickRule->IsSeparable() ? CpuStepPolicies::SeparableStencil::Index : CpuStepPolicies::RowsStencil::Index;
+}
+
+void CpuStabilityCalculator::NextBoardRow(uint64_t* nextRow, const BitBoard& sourceBoard, int32_t y, size_t wordBegin, size_t wordCount, const uint64_t* columnMask, const CpuClickRule* clickRule, TileScratch& scratch) const
+{
+	switch(StencilIndex(clickRule))
+	{
+	case CpuStepPolicies::CrossStencil::Index:
+		NextBoardRow<CpuStepPolicies::CrossStencil>(nextRow, sourceBoard, y, wordBegin, wordCount, columnMask, clickRule, scratch);
+		break;
+	case CpuStepPolicies::SeparableStencil::Index:
+		NextBoardRow<CpuStepPolicies::SeparableStencil>(nextRow, sourceBoard, y, wordBegin, wordCount, columnMask, clickRule, scratch);
+		break;
+	default:
+		NextBoardRow<CpuStepPolicies::RowsStencil>(nextRow, sourceBoard, y, wordBegin, wordCount, columnMask, clickRule, scratch);
+		break;
+	}
+}
+
+template<typename StencilPolicy>
+void CpuStabilityCalculator::NextBoardRow(uint64_t* nextRow, const BitBoard& sourceBoard, int32_t y, size_t wordBegin, size_t wordCount, const uint64_t* columnMask, const CpuClickRule* clickRule, TileScratch& scratch) const
+{
+	if constexpr(std::is_same_v<StencilPolicy, CpuStepPolicies::CrossStencil>)
+	{
+		mKernels.CrossRow(nextRow, sourceBoard.Row(y - 1) + wordBegin, sourceBoard.Row(y) + wordBegin, sourceBoard.Row(y + 1) + wordBegin, columnMask, wordCount);
+	}
+	else if constexpr(std::is_same_v<StencilPolicy, CpuStepPolicies::SeparableStencil>)
+	{
+		std::fill(nextRow, nextRow + wordCount, 0);
+
+		//Each horizontal pass row is computed once and reused by the next 2 * radius rows: the rows go in increasing order and the ring holds all the rows one output row needs
+		const int32_t ringSize = 2 * clickRule->GetRadius() + 1;
+
+		const std::vector<CpuClickRuleFactor>& factors = clickRule->GetFactors();
+		for(size_t factorIndex = 0; factorIndex < factors.size(); factorIndex++)
+		{
+			const CpuClickRuleFactor& factor = factors[factorIndex];
+			for(int32_t offsetY: factor.OffsetsY)
+			{
+				int32_t sourceY = y + offsetY;
+				if(sourceY < 0 || sourceY >= (int32_t)sourceBoard.GetHeight())
+				{
+					continue;
+				}
+
+				size_t    slot      = factorIndex * ringSize + sourceY % ringSize;
+				uint64_t* factorRow = scratch.FactorRows.data() + slot * wordCount;
+				if(scratch.FactorRowSources[slot] != sourceY)
+				{
+					std::fill(factorRow, factorRow + wordCount, 0);
+					mKernels.ConvolveRow(factorRow, sourceBoard.Row(sourceY) + wordBegin, factor.MaskX, factor.MinOffsetX, wordCount);
+					scratch.FactorRowSources[slot] = sourceY;
+				}
+
+				mKernels.XorShiftedRow(nextRow, factorRow, 0, wordCount);
+			}
+		}
+
+		mKernels.AndRow(nextRow, nextRow, columnMask, wordCount);
+	}
+	else
+	{
+		static_assert(std::is_same_v<StencilPolicy, CpuStepPolicies::RowsStencil>, "Unknown stencil policy");
+
+		std::fill(nextRow, nextRow + wordCount, 0);
+		for(const CpuClickRuleRow& clickRuleRow: clickRule->GetRows())
+		{
+			int32_t sourceY = y + clickRuleRow.OffsetY;
+			if(sourceY < 0 || sourceY >= (int32_t)sourceBoard.GetHeight()) //Everything outside the board is 0
+			{
+				continue;
+			}
+
+			//The whole click rule row at once: one pass over the row instead of one pass per cell of the click rule
+			mKernels.ConvolveRow(nextRow, sourceBoard.Row(sourceY) + wordBegin, clickRuleRow.MaskX, clickRuleRow.MinOffsetX, wordCount);
+		}
+
+		mKernels.AndRow(nextRow, nextRow, columnMask, wordCount);
+	}
+}
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <array>
+#include <utility>
+#include "BitBoard.hpp"
+#include "CpuChangeMap.hpp"
+#include "CpuGenerationStats.hpp"
+#include "CpuCycleDetector.hpp"
+#include "CpuBoardSymmetry.hpp"
+#include "CpuImpulseResponse.hpp"
+#include "CpuSpawnPlanes.hpp"
+#include "CpuFeatures.hpp"
+#include "CpuStepPolicies.hpp"
+#include "NextStepKernels.hpp"
+
+class CpuClickRule;
+class CpuHashLife;
+class ThreadPool;
+
+/*
+The class for computing stability fractal iterations on the CPU, with the board and the stability packed 1 bit per cell.
+Input:               Initial board (1 byte per cell), click rule, restriction
+Output:              Last computed stability iteration
+Possible expansions: More variants of computations
+*/
+
+class CpuStabilityCalculator
+{
+	//Per-thread buffers for temporal blocking: a tile with its halo, ping-ponged between generations
+	struct TileScratch
+	{
+		BitBoard Boards[2];
+		BitBoard RestrictedBoards[2];
+		BitBoard Restriction;
+
+		std::vector<uint64_t> ColumnMask;
+
+		//Horizontal passes of the separable click rule factors, a ring of (2 * radius + 1) rows per factor
+		std::vector<uint64_t> FactorRows;
+		std::vector<int32_t>  FactorRowSources; //The source row each ring slot was computed from
+
+		std::vector<uint64_t> PrevStabilityRow; //The stability row before it gets updated in place, to find the cells that changed
+		std::vector<uint64_t> StableRow;        //The cells with the spawn stability value of 1
+	};
+
+	struct TileRange
+	{
+		uint32_t BeginX;
+		uint32_t BeginY;
+		uint32_t EndX;
+		uint32_t EndY;
+	};
+
+	enum class TileRestriction: uint8_t
+	{
+		Blocked, //The restriction is 0 in every cell
+		Open,    //The restriction is 1 in every cell
+		Mixed
+	};
+
+	//The rows of a tile for one generation, everything the runtime parts of the step depend on
+	struct TileStep
+	{
+		int32_t RowBegin;
+		int32_t RowEnd;
+		size_t  WordBegin;
+		size_t  WordCount;
+
+		const CpuClickRule* ClickRule;
+		const BitBoard*     Restriction;
+		uint32_t            SpawnPeriod;
+	};
+
+	using TileRowsFunction = void (CpuStabilityCalculator::*)(const TileStep& tileStep, TileScratch& scratch, CpuGenerationCounts& counts, bool& inoutTileChanged);
+
+public:
+	CpuStabilityCalculator();
+	~CpuStabilityCalculator();
+
+	void SetInstructionSet(CpuInstructionSet instructionSet); //Clamped to the one supported by the CPU
+	CpuInstructionSet GetInstructionSet() const;
+
+	void SetThreadCount(uint32_t threadCount);         //0 means one thread per hardware thread
+	void SetTileSize(uint32_t width, uint32_t height); //In cells. The width is rounded up to the multiple of 64 * BitBoard::RowWordAlignment, 0 width means whole rows
+	uint32_t GetThreadCount() const;
+
+	void SetTrackChangeMap(bool track); //Records the frame each cell first became unstable at. Takes effect from the next PrepareForCalculations(), steps with spawn are not recorded
+	void SetTrackStats(bool track);     //Counts the stable, changed and lit cells of every computed generation while computing it. Takes effect from the next PrepareForCalculations(), turns off the impulse responses and Hashlife
+	void SetTrackStateHashes(bool track); //Hashes the board and the stability of every generation computed tile by tile and looks for the first repeated state. Takes effect from the next PrepareForCalculations()
+	void SetUseHashLife(bool useHashLife); //Lets StabilityNextSteps() compute long runs of steps with memoized quadtrees while the board is self-similar enough. Turns off the symmetry reduction, the quadtrees share the mirrored parts anyway
+
+	void PrepareForCalculations(const uint8_t* initialBoard, uint32_t width, uint32_t height, size_t rowPitch);
+	void ReduceBySymmetry(const CpuClickRule* clickRule, const BitBoard* restriction); //Before the first step (or right after a jump) only. Simulates only a half or a quarter of the board if it's mirror symmetric together with the click rule and the restriction, and only an eighth if the quarter is also symmetric around the diagonal
+	void StabilityNextStep(const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t spawnPeriod); //Null click rule is the default one, null restriction is no restriction
+	void StabilityNextSteps(uint32_t stepCount, const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t spawnPeriod); //Same as calling StabilityNextStep() stepCount times, but each tile is loaded only once per several generations
+	void JumpToStep(uint32_t step, const CpuClickRule* clickRule, const BitBoard* restriction); //Computes the board at the step without the steps in between when possible. The stability restarts from that board, as if it was the initial one
+
+	uint32_t GetBoardWidth()  const;
+	uint32_t GetBoardHeight() const;
+
+	uint32_t GetCurrentStep() const;
+
+	bool IsMirroredX() const; //True if only the left part of the board is simulated
+	bool IsMirroredY() const; //True if only the top part of the board is simulated
+
+	const BitBoard& GetLastStabilityState() const; //Only valid if the last step was computed without spawn. Only the simulated part of the board if it's reduced by symmetry
+	const BitBoard& GetLastBoardState()     const;
+
+	void CopyStabilityCells(uint16_t* outCells, size_t rowPitch) const; //Same values StabilityCalculator would have in its stability texture, rowPitch is in cells
+	void CopyLastState(std::vector<uint64_t>& outState)          const; //The board and the stability of the fundamental region, the exact state the state hashes are computed from
+
+	void CopyChangeMap(CpuChangeMap& outChangeMap) const;                                                           //The whole board, even if it's reduced by symmetry
+	void RenderChangeMap(const CpuChangeMap& changeMap, uint32_t frame, uint16_t* outCells, size_t rowPitch) const; //The non-spawn stability of the frame, computed from the change map only
+
+	const CpuGenerationStats& GetGenerationStats() const; //The whole board, even if it's reduced by symmetry
+	const CpuCycleDetector&   GetCycleDetector()   const; //The frames computed with the impulse responses or Hashlife aren't hashed, the detection restarts after them
+	void                      RestartCycleDetection();      //Forgets the found cycle, for when the repeated hash turns out to be a collision
+
+private:
+	void UpdateTiles();
+	void UpdateRestrictedBoard(const BitBoard* restriction);
+	void SwitchSpawnMode(uint32_t spawnPeriod);
+
+	const BitBoard* MatchSymmetry(const CpuClickRule* clickRule, const BitBoard* restriction); //Returns the restriction to simulate with, expands the board back to full size if the click rule or the restriction changed
+	void            FillSymmetryHalo();
+	void            FillSymmetryTriangle();                                           //After a temporal block: the cells below the diagonal it skipped
+	bool            IsTransposeSourceChanged(uint32_t blockX, uint32_t blockY) const; //The cells transposed into the 64x64 block (blockX, blockY) below the diagonal changed since the other buffer got them
+	void            ExpandSymmetry();
+
+	void StartImpulseResponse(); //Starts the impulse response mode if the board has only a few lit cells
+	bool ImpulseNextStep(const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t spawnPeriod); //Returns false and leaves the impulse response mode if it can't be used or isn't cheaper than a regular step anymore
+	void StepImpulseResponse(const CpuClickRule* clickRule, int32_t radius);
+	void ImpulseBoardRow(int32_t y, TileScratch& scratch); //Builds the next board row from the images and updates the stability row in place
+
+	void RecordChanges(const uint64_t* prevStabilityRow, const uint64_t* nextStabilityRow, int32_t y, size_t wordBegin, size_t wordCount, uint32_t frame); //Writes the frame for the cells that became unstable
+
+	CpuGenerationCounts& GetTileCounts(uint32_t tileIndex, uint32_t step); //The counts of the tile in the step of the current pass
+	const uint64_t*      GetCountMaskRow(int32_t y) const;                  //The cells of the row in the fundamental region
+	void                 CountRow(CpuGenerationCounts& counts, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* stableRow, int32_t y, size_t wordBegin, size_t wordCount) const;
+	const uint64_t*      SpawnStableRow(TileScratch& scratch, int32_t y, size_t wordBegin, size_t wordCount) const; //The cells with the spawn stability value of 1 in the next spawn planes
+	void                 RepeatTileCounts(uint32_t tileIndex, uint32_t stepCount); //For the tiles that didn't change: the last counts with no changed cells
+	void                 AppendGenerationStats(uint32_t generationCount);          //Merges the counts of all tiles, before the step counter is advanced
+	void                 HashStateRow(CpuGenerationCounts& counts, const uint64_t* boardRow, int32_t y, size_t wordBegin, size_t wordCount, uint32_t spawnPeriod) const; //Adds the next board row and the next stability row to the state hash
+	bool                 TracksGenerations() const; //Either the stats or the state hashes are accumulated per tile
+
+	uint32_t GetTemporalBlockSteps(const CpuClickRule* clickRule) const; //How many generations fit into the halo of a tile
+
+	uint32_t HashLifeNextSteps(uint32_t stepCount, const CpuClickRule* clickRule, const BitBoard* restriction); //Returns the number of steps computed with CpuHashLife, 0 if it can't be used
+
+	void BeginTileActivity(const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t spawnPeriod); //Forgets which tiles changed if the step doesn't continue the previous one
+	void EndTileActivity(uint32_t spawnPeriod);
+	bool IsTileStatic(uint32_t tileX, uint32_t tileY, int32_t reach) const; //True if no tile within reach cells of the tile changed in the last computed generation
+	bool TouchesSymmetryHalo(uint32_t tileX, uint32_t tileY) const;
+	void SkipBelowDiagonalTile(uint32_t tileIndex);                        //Every cell of the tile is below the diagonal, it's transposed from the computed ones after the temporal block
+	void MarkTransposedTileChanges();                                      //After a temporal block: marks the tiles whose skipped cells below the diagonal changed
+	void SkipTile(uint32_t tileIndex, const BitBoard* restriction);         //Makes the next state of a static tile the same as the current one
+
+	TileRange       GetTileNeighbourhood(uint32_t tileX, uint32_t tileY, int32_t reach) const; //The tiles within reach cells of the tile, including itself
+	size_t          GetTileWordBegin(uint32_t tileX, uint32_t tileY) const;                   //The first word of the tile to compute. With the diagonal symmetry the words below the diagonal are skipped
+	void            UpdateTileRestrictions(const BitBoard* restriction);
+	TileRestriction GetTileRestriction(uint32_t tileX, uint32_t tileY, int32_t reach) const;  //The restriction over all cells within reach cells of the tile
+	void            BlockTile(uint32_t tileIndex, uint32_t spawnPeriod); //Makes the next state of a tile with a fully blocked neighbourhood, nothing in it can be clicked
+
+	void NextStepTile(uint32_t tileIndex, uint32_t threadIndex, const CpuClickRule* clickRule, const BitBoard* restriction, uint32_t spawnPeriod);
+	void NextStepsTile(uint32_t tileIndex, uint32_t threadIndex, uint32_t stepCount, const CpuClickRule* clickRule, const BitBoard* restriction);
+
+	void ResetFactorRows(TileScratch& scratch, const CpuClickRule* clickRule, size_t wordCount) const; //Has to be called before computing rows from another source board or word range
+	void NextBoardRow(uint64_t* nextRow, const BitBoard& sourceBoard, int32_t y, size_t wordBegin, size_t wordCount, const uint64_t* columnMask, const CpuClickRule* clickRule, TileScratch& scratch) const; //Rows have to go in increasing order
+
+	//One variant of the step for every combination of the policies, with no runtime checks of them in the row loop
+	template<typename StencilPolicy, typename RestrictionPolicy, typename SpawnPolicy, typename TrackingPolicy>
+	void NextStepTileRows(const TileStep& tileStep, TileScratch& scratch, CpuGenerationCounts& counts, bool& inoutTileChanged);
+
+	template<typename StencilPolicy>
+	void NextBoardRow(uint64_t* nextRow, const BitBoard& sourceBoard, int32_t y, size_t wordBegin, size_t wordCount, const uint64_t* columnMask, const CpuClickRule* clickRule, TileScratch& scratch) const;
+
+	template<size_t... Variants>
+	static std::array<TileRowsFunction, sizeof...(Variants)> MakeTileRowsVariants(std::index_sequence<Variants...>);
+
+	static uint32_t StencilIndex(const CpuClickRule* clickRule);
+
+	static const std::array<TileRowsFunction, CpuStepPolicies::VariantCount> TileRowsVariants; //Indexed by CpuStepPolicies::VariantIndex()
+
+private:
+	std::unique_ptr<ThreadPool> mThreadPool;
+	std::vector<TileScratch>    mTileScratches;
+
+	uint32_t mTileWidth;
+	uint32_t mTileHeight;
+	size_t   mTileWords;     //Tile width in words
+	uint32_t mTileCountX;
+	uint32_t mTileCountY;
+
+	NextStepKernels   mKernels;
+	CpuInstructionSet mInstructionSet;
+
+	BitBoard mPrevStability;
+	BitBoard mCurrStability;
+
+	BitBoard mPrevBoard;
+	BitBoard mCurrBoard;
+
+	BitBoard        mPrevRestrictedBoard; //Board AND restriction, the only cells restricted steps can read. Computed together with the next board, so restricted steps don't need an extra pass
+	BitBoard        mCurrRestrictedBoard;
+	const BitBoard* mLastRestriction;     //The restriction mPrevRestrictedBoard was computed with
+
+	CpuSpawnPlanes mSpawnPlanes; //The spawn stability, allocated only when it's used
+
+	//The temporal blocks skip the words below the diagonal of the fundamental region and the cells there are transposed after each block.
+	//Single generations compute the whole simulated part instead, the transpose costs more than the half of one generation
+	CpuBoardSymmetry mSymmetry;
+
+	CpuImpulseResponse mImpulseResponse;
+
+	//A tile with no changes in its neighbourhood in the last generation stays the same, so it can be skipped until a change reaches it
+	std::vector<uint8_t> mTileChanged;            //The board of the tile changed in the last computed generation
+	std::vector<uint8_t> mNextTileChanged;
+	std::vector<uint8_t> mTileStale;              //The next state buffers of the tile may differ from the current ones
+	std::vector<uint8_t> mTransposeSourceChanged; //The tile changed in the last two temporal blocks, with the diagonal symmetry
+	const CpuClickRule*  mActivityClickRule;
+	const BitBoard*      mActivityRestriction;
+	bool                 mbTileActivityValid;
+
+	//Restriction summaries per tile. Nothing can be clicked around a blocked tile, so its next state is known without computing it, and an open tile is computed without the restriction
+	std::vector<TileRestriction> mTileRestrictions;
+	const BitBoard*              mSummaryRestriction; //The restriction mTileRestrictions were computed for
+
+	bool         mbTrackChangeMap;
+	CpuChangeMap mChangeMap; //The simulated part of the board only
+
+	//The counts are accumulated per tile and per generation of the pass while the rows are computed, then merged once per pass
+	bool                             mbTrackStats;
+	CpuGenerationStats               mGenerationStats;
+	std::vector<CpuGenerationCounts> mTileCounts;        //gMaxTemporalBlockSteps per tile
+	std::vector<CpuGenerationCounts> mLastTileCounts;    //The last computed generation of each tile
+	std::vector<uint64_t>            mCountMask;         //The columns of the fundamental region
+	BitBoard                         mDiagonalCountMask; //The cells on and above the diagonal of the fundamental region, only with the diagonal symmetry
+	uint32_t                         mMiddleColumn;      //The column that is its own mirror image, NoCell if there's none
+
+	bool             mbTrackStateHashes;
+	CpuCycleDetector mCycleDetector;
+
+	std::unique_ptr<CpuHashLife> mHashLife;
+	const CpuClickRule*          mHashLifeClickRule;  //The click rule and the restriction the quadtrees were built for
+	const BitBoard*              mHashLifeRestriction;
+	bool                         mbUseHashLife;
+	bool                         mbHashLifeActive;    //The quadtrees hold the current state, no other steps were computed since
+	bool                         mbHashLifeGaveUp;    //The memoized results stopped being reused, the rest of the steps are computed as usual
+
+	uint32_t mCurrentStep;
+	uint32_t mLastSpawnPeriod;
+	bool     mbFreshStability; //True if the stability is all ones and no steps were computed since
+};
@@ -0,0 +1,39 @@
+#include "CpuStateHash.hpp"
+
+namespace
+{
+	const uint64_t gStateHashMultiplier = 0x9e3779b97f4a7c15ull;
+
+	const uint32_t gStableCountLayer = 0xff;
+
+	//A single multiply, the hashes of the words are XORed together anyway
+	uint64_t HashStateWord(uint64_t word, uint64_t position)
+	{
+		uint64_t hash = word ^ (position * gStateHashMultiplier);
+		hash ^= hash >> 32;
+		hash *= 0xd6e8feb86659fd93ull;
+		hash ^= hash >> 32;
+		return hash;
+	}
+}
+
+uint64_t CpuStateHash::RowPosition(int32_t y, size_t wordsPerRow, size_t wordBegin)
+{
+	return ((uint64_t)y * wordsPerRow + wordBegin) << 8; //The low 8 bits are the layer
+}
+
+uint64_t CpuStateHash::HashLayerRow(const uint64_t* layerRow, const uint64_t* countMask, size_t wordCount, uint64_t rowPosition, uint32_t layer)
+{
+	uint64_t stateHash = 0;
+	for(size_t i = 0; i < wordCount; i++)
+	{
+		stateHash ^= HashStateWord(layerRow[i] & countMask[i], rowPosition + ((uint64_t)i << 8) + layer);
+	}
+
+	return stateHash;
+}
+
+uint64_t CpuStateHash::HashStableCount(uint64_t stableCount, uint64_t rowPosition)
+{
+	return HashStateWord(stableCount, rowPosition + gStableCountLayer);
+}
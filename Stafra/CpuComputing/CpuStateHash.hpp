@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/*
+The functions for hashing the board and the stability of a generation, for finding the repeated states.
+Input:               The rows of the state layers (the board, the stability or the spawn planes) and the cells to count
+Output:              64-bit hashes that are XORed together into the hash of the whole state
+Possible expansions: Hashes with a wider output, to make the collisions rarer
+
+Each word is mixed with its position and layer, so equal words in different places hash differently.
+The hash of the state is the XOR of the hashes of its words, so every tile can hash its part of the state independently and in any order
+*/
+
+namespace CpuStateHash
+{
+	uint64_t RowPosition(int32_t y, size_t wordsPerRow, size_t wordBegin); //The position of the first word of the row part, the layers of the row are hashed on the same positions
+
+	uint64_t HashLayerRow(const uint64_t* layerRow, const uint64_t* countMask, size_t wordCount, uint64_t rowPosition, uint32_t layer); //Only the cells of countMask are hashed, the layer is below 255
+	uint64_t HashStableCount(uint64_t stableCount, uint64_t rowPosition);                                                                  //The number of the stable cells of the row part, in place of the stability itself
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+/*
+Compile-time policies the tile step of CpuStabilityCalculator is instantiated with, one variant per combination.
+Every policy type of a family has the Index of its position in the family tuple, a variant is picked at runtime from the table of all of them.
+A new kind of step (a boundary mode, another stencil) is one more policy type in its family, not a copy of every variant.
+
+The board word type is not a policy: BitBoard and NextStepKernels store 64 cells per uint64_t word.
+*/
+
+namespace CpuStepPolicies
+{
+	//How the next board row is computed from the rows around it
+	struct CrossStencil     { static constexpr uint32_t Index = 0; }; //Without a click rule or with the cross one: a single kernel call
+	struct RowsStencil      { static constexpr uint32_t Index = 1; }; //One ConvolveRow() per click rule row
+	struct SeparableStencil { static constexpr uint32_t Index = 2; }; //The horizontal passes of the click rule factors, reused by the next rows
+
+	//What the tile reads the board from and how it updates the restricted board
+	struct NoRestriction
+	{
+		static constexpr uint32_t Index                 = 0;
+		static constexpr bool     WritesRestrictedBoard = false;
+		static constexpr bool     MasksCells            = false;
+	};
+
+	struct OpenRestriction //Nothing within reach of the tile is restricted, the restricted board is a copy of the board
+	{
+		static constexpr uint32_t Index                 = 1;
+		static constexpr bool     WritesRestrictedBoard = true;
+		static constexpr bool     MasksCells            = false;
+	};
+
+	struct MaskedRestriction //Reads the restricted board, writes the next board AND the restriction and passes the restriction to the stability kernels
+	{
+		static constexpr uint32_t Index                 = 2;
+		static constexpr bool     WritesRestrictedBoard = true;
+		static constexpr bool     MasksCells            = true;
+	};
+
+	//How the stability is stored
+	struct NoSpawn     { static constexpr uint32_t Index = 0; static constexpr bool Spawns = false; }; //One bit per cell
+	struct SpawnPlanes { static constexpr uint32_t Index = 1; static constexpr bool Spawns = true;  }; //Bit planes of the spawn stability values
+
+	//Whether the rows are counted, hashed and recorded in the change map. Each of them is still checked when tracking
+	struct Untracked { static constexpr uint32_t Index = 0; static constexpr bool Tracks = false; };
+	struct Tracked   { static constexpr uint32_t Index = 1; static constexpr bool Tracks = true;  };
+
+	using Stencils     = std::tuple<CrossStencil,  RowsStencil,     SeparableStencil>;
+	using Restrictions = std::tuple<NoRestriction, OpenRestriction, MaskedRestriction>;
+	using Spawns       = std::tuple<NoSpawn,       SpawnPlanes>;
+	using Trackings    = std::tuple<Untracked,     Tracked>;
+
+	template<typename Family, size_t... Indices>
+	constexpr bool IsInOrder(std::index_sequence<Indices...>)
+	{
+		return ((std::tuple_element_t<Indices, Family>::Index == Indices) && ...);
+	}
+
+	template<typename Family>
+	constexpr bool IsInOrder()
+	{
+		return IsInOrder<Family>(std::make_index_sequence<std::tuple_size_v<Family>>());
+	}
+
+	static_assert(IsInOrder<Stencils>() && IsInOrder<Restrictions>() && IsInOrder<Spawns>() && IsInOrder<Trackings>(), "The Index of a policy has to be its position in the family");
+
+	constexpr size_t StencilCount     = std::tuple_size_v<Stencils>;
+	constexpr size_t RestrictionCount = std::tuple_size_v<Restrictions>;
+	constexpr size_t SpawnCount       = std::tuple_size_v<Spawns>;
+	constexpr size_t TrackingCount    = std::tuple_size_v<Trackings>;
+	constexpr size_t VariantCount     = StencilCount * RestrictionCount * SpawnCount * TrackingCount;
+
+	constexpr size_t VariantIndex(uint32_t stencilIndex, uint32_t restrictionIndex, uint32_t spawnIndex, uint32_t trackingIndex)
+	{
+		return ((stencilIndex * RestrictionCount + restrictionIndex) * SpawnCount + spawnIndex) * TrackingCount + trackingIndex;
+	}
+
+	//The policies of the variant with the index VariantIndex(Stencil::Index, Restriction::Index, Spawn::Index, Tracking::Index)
+	template<size_t Variant>
+	struct Policies
+	{
+		using Stencil     = std::tuple_element_t<Variant / (RestrictionCount * SpawnCount * TrackingCount), Stencils>;
+		using Restriction = std::tuple_element_t<Variant / (SpawnCount * TrackingCount) % RestrictionCount, Restrictions>;
+		using Spawn       = std::tuple_element_t<Variant / TrackingCount % SpawnCount,                      Spawns>;
+		using Tracking    = std::tuple_element_t<Variant % TrackingCount,                                   Trackings>;
+	};
+}
@@ -0,0 +1,215 @@
+#include "NextStepKernels.hpp"
+
+namespace
+{
+	void CrossRowScalar(uint64_t* nextRow, const uint64_t* topRow, const uint64_t* thisRow, const uint64_t* bottomRow, const uint64_t* columnMask, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i++)
+		{
+			uint64_t leftCells  = (thisRow[i] << 1) | (thisRow[i - 1] >> 63);
+			uint64_t rightCells = (thisRow[i] >> 1) | (thisRow[i + 1] << 63);
+
+			nextRow[i] = (thisRow[i] ^ leftCells ^ rightCells ^ topRow[i] ^ bottomRow[i]) & columnMask[i];
+		}
+	}
+
+	void XorShiftedRowScalar(uint64_t* outRow, const uint64_t* row, int32_t shift, size_t wordCount)
+	{
+		if(shift == 0)
+		{
+			for(size_t i = 0; i < wordCount; i++)
+			{
+				outRow[i] ^= row[i];
+			}
+		}
+		else if(shift > 0)
+		{
+			for(size_t i = 0; i < wordCount; i++)
+			{
+				outRow[i] ^= (row[i] >> shift) | (row[i + 1] << (64 - shift));
+			}
+		}
+		else
+		{
+			for(size_t i = 0; i < wordCount; i++)
+			{
+				outRow[i] ^= (row[i] << -shift) | (row[i - 1] >> (64 + shift));
+			}
+		}
+	}
+
+	void ConvolveRowScalar(uint64_t* outRow, const uint64_t* row, uint64_t shiftMask, int32_t minShift, size_t wordCount)
+	{
+		for(uint32_t bit = 0; bit < 64; bit++)
+		{
+			if(shiftMask & (1ull << bit))
+			{
+				XorShiftedRowScalar(outRow, row, minShift + (int32_t)bit, wordCount);
+			}
+		}
+	}
+
+	void AndRowScalar(uint64_t* outRow, const uint64_t* rowA, const uint64_t* rowB, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i++)
+		{
+			outRow[i] = rowA[i] & rowB[i];
+		}
+	}
+
+	void XorRowScalar(uint64_t* outRow, const uint64_t* row, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i++)
+		{
+			outRow[i] ^= row[i];
+		}
+	}
+
+	void StabilityRowScalar(uint64_t* nextStabilityRow, const uint64_t* prevStabilityRow, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* restrictionRow, size_t wordCount)
+	{
+		if(restrictionRow)
+		{
+			for(size_t i = 0; i < wordCount; i++)
+			{
+				nextStabilityRow[i] = prevStabilityRow[i] & ~(thisRow[i] ^ nextRow[i]) & restrictionRow[i];
+			}
+		}
+		else
+		{
+			for(size_t i = 0; i < wordCount; i++)
+			{
+				nextStabilityRow[i] = prevStabilityRow[i] & ~(thisRow[i] ^ nextRow[i]);
+			}
+		}
+	}
+
+	uint64_t CountBits(uint64_t bits)
+	{
+		bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+		bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+		bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0full;
+		return (bits * 0x0101010101010101ull) >> 56;
+	}
+
+	void SpawnStabilityRowScalar(uint64_t* nextPlanes, const uint64_t* prevPlanes, size_t planeStride, uint32_t planeCount, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* restrictionRow, uint32_t spawnPeriod, size_t wordCount)
+	{
+		const uint32_t lastValue = spawnPeriod + 1; //Wraps to 0 on the next increment
+		for(size_t i = 0; i < wordCount; i++)
+		{
+			uint64_t unchangedCells = ~(thisRow[i] ^ nextRow[i]);
+			if(restrictionRow)
+			{
+				unchangedCells &= restrictionRow[i];
+			}
+
+			uint64_t stableCells = ~0ull; //1 stands for "stable" and won't change until the cell state changes
+			uint64_t lastCells   = ~0ull;
+			for(uint32_t plane = 0; plane < planeCount; plane++)
+			{
+				uint64_t valueBits = prevPlanes[plane * planeStride + i];
+				stableCells &= (plane == 0)               ? valueBits : ~valueBits;
+				lastCells   &= ((lastValue >> plane) & 1) ? valueBits : ~valueBits;
+			}
+
+			uint64_t keptCells        = unchangedCells & stableCells;
+			uint64_t incrementedCells = unchangedCells & ~(stableCells | lastCells);
+			uint64_t resetCells       = ~unchangedCells; //2 stands for "the cell state just have changed"
+
+			//Ripple-carry increment, the wrapped cells get neither kept nor incremented bits, so they become 0
+			uint64_t carryBits = ~0ull;
+			for(uint32_t plane = 0; plane < planeCount; plane++)
+			{
+				uint64_t valueBits = prevPlanes[plane * planeStride + i];
+				uint64_t sumBits   = valueBits ^ carryBits;
+				carryBits &= valueBits;
+
+				uint64_t nextBits = (keptCells & valueBits) | (incrementedCells & sumBits);
+				if(plane == 1)
+				{
+					nextBits |= resetCells;
+				}
+
+				nextPlanes[plane * planeStride + i] = nextBits;
+			}
+		}
+	}
+
+	void ExpandRowScalar(uint16_t* outCells, const uint64_t* row, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i++)
+		{
+			for(uint32_t bit = 0; bit < 64; bit++)
+			{
+				outCells[i * 64 + bit] = (uint16_t)((row[i] >> bit) & 1);
+			}
+		}
+	}
+
+	void ExpandPlanesRowScalar(uint16_t* outCells, const uint64_t* planes, size_t planeStride, uint32_t planeCount, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i++)
+		{
+			for(uint32_t bit = 0; bit < 64; bit++)
+			{
+				uint32_t cellValue = 0;
+				for(uint32_t plane = 0; plane < planeCount; plane++)
+				{
+					cellValue |= (uint32_t)((planes[plane * planeStride + i] >> bit) & 1) << plane;
+				}
+
+				outCells[i * 64 + bit] = (uint16_t)cellValue;
+			}
+		}
+	}
+
+	void CountRowScalar(uint64_t* outCounts, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* stableRow, const uint64_t* countMask, size_t wordCount)
+	{
+		uint64_t stableCount  = 0;
+		uint64_t changedCount = 0;
+		uint64_t litCount     = 0;
+		for(size_t i = 0; i < wordCount; i++)
+		{
+			stableCount  += CountBits(stableRow[i]             & countMask[i]);
+			changedCount += CountBits((thisRow[i] ^ nextRow[i]) & countMask[i]);
+			litCount     += CountBits(nextRow[i]               & countMask[i]);
+		}
+
+		outCounts[0] = stableCount;
+		outCounts[1] = changedCount;
+		outCounts[2] = litCount;
+	}
+}
+
+NextStepKernels CpuKernels::ScalarKernels()
+{
+	NextStepKernels kernels;
+	kernels.CrossRow          = CrossRowScalar;
+	kernels.XorShiftedRow     = XorShiftedRowScalar;
+	kernels.ConvolveRow       = ConvolveRowScalar;
+	kernels.AndRow            = AndRowScalar;
+	kernels.XorRow            = XorRowScalar;
+	kernels.StabilityRow      = StabilityRowScalar;
+	kernels.SpawnStabilityRow = SpawnStabilityRowScalar;
+	kernels.ExpandRow         = ExpandRowScalar;
+	kernels.ExpandPlanesRow   = ExpandPlanesRowScalar;
+	kernels.CountRow          = CountRowScalar;
+
+	return kernels;
+}
+
+NextStepKernels CpuKernels::SelectKernels(CpuInstructionSet instructionSet)
+{
+	switch(instructionSet)
+	{
+	case CpuInstructionSet::AVX512:
+		return AVX512Kernels();
+	case CpuInstructionSet::AVX2:
+		return AVX2Kernels();
+	case CpuInstructionSet::SSE2:
+		return SSE2Kernels();
+	default:
+		break;
+	}
+
+	return ScalarKernels();
+}
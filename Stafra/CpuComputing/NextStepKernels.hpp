@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "CpuFeatures.hpp"
+
+/*
+The set of row kernels the CPU stability calculator is built from, one implementation per instruction set.
+Every kernel works on the rows of a BitBoard (64 cells per word, wordCount is a multiple of BitBoard::RowWordAlignment)
+and can read one word to the left and to the right of the row, that's what the guard words are for.
+Every implementation gives bit-identical results.
+*/
+
+struct NextStepKernels
+{
+	//nextRow = (thisRow ^ left ^ right ^ topRow ^ bottomRow) & columnMask
+	void (*CrossRow)(uint64_t* nextRow, const uint64_t* topRow, const uint64_t* thisRow, const uint64_t* bottomRow, const uint64_t* columnMask, size_t wordCount);
+
+	//outRow ^= row shifted so that the cell x of outRow gets the cell (x + shift) of row, |shift| < 64
+	void (*XorShiftedRow)(uint64_t* outRow, const uint64_t* row, int32_t shift, size_t wordCount);
+
+	//Same as XorShiftedRow() for every shift (minShift + i) with the bit i of shiftMask set, at once. All the shifts are in (-64, 64)
+	void (*ConvolveRow)(uint64_t* outRow, const uint64_t* row, uint64_t shiftMask, int32_t minShift, size_t wordCount);
+
+	//outRow = rowA & rowB
+	void (*AndRow)(uint64_t* outRow, const uint64_t* rowA, const uint64_t* rowB, size_t wordCount);
+
+	//outRow ^= row, word by word. The rows don't have to be aligned
+	void (*XorRow)(uint64_t* outRow, const uint64_t* row, size_t wordCount);
+
+	//nextStabilityRow = prevStabilityRow & ~(thisRow ^ nextRow) & restrictionRow, restrictionRow can be null
+	void (*StabilityRow)(uint64_t* nextStabilityRow, const uint64_t* prevStabilityRow, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* restrictionRow, size_t wordCount);
+
+	//Same as StabilityNextStepSpawnCS for 64 * wordCount cells, with the stability values stored as planeCount bit planes planeStride words apart (the plane p holds the bit p of each value).
+	//planeCount has to fit spawnPeriod + 1, restrictionRow can be null
+	void (*SpawnStabilityRow)(uint64_t* nextPlanes, const uint64_t* prevPlanes, size_t planeStride, uint32_t planeCount, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* restrictionRow, uint32_t spawnPeriod, size_t wordCount);
+
+	//Writes 64 * wordCount 16-bit cell values, 0 or 1 each
+	void (*ExpandRow)(uint16_t* outCells, const uint64_t* row, size_t wordCount);
+
+	//Writes 64 * wordCount 16-bit cell values gathered from planeCount bit planes planeStride words apart
+	void (*ExpandPlanesRow)(uint16_t* outCells, const uint64_t* planes, size_t planeStride, uint32_t planeCount, size_t wordCount);
+
+	//outCounts[0..2] = the number of 1 bits in stableRow, thisRow ^ nextRow and nextRow, within countMask
+	void (*CountRow)(uint64_t* outCounts, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* stableRow, const uint64_t* countMask, size_t wordCount);
+};
+
+namespace CpuKernels
+{
+	NextStepKernels ScalarKernels();
+	NextStepKernels SSE2Kernels();
+	NextStepKernels AVX2Kernels();
+	NextStepKernels AVX512Kernels();
+
+	NextStepKernels SelectKernels(CpuInstructionSet instructionSet);
+}
@@ -0,0 +1,341 @@
+#include "NextStepKernels.hpp"
+
+#if defined(STAFRA_CPU_X86)
+
+#include <immintrin.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+	#define STAFRA_TARGET_AVX2 __attribute__((target("avx2,pclmul"))) //Every AVX2 CPU has PCLMULQDQ too, DetectInstructionSet() checks it anyway
+#else
+	#define STAFRA_TARGET_AVX2
+#endif
+
+//4 words (256 cells) per iteration
+namespace
+{
+	STAFRA_TARGET_AVX2 inline __m256i Load(const uint64_t* ptr)
+	{
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+	}
+
+	STAFRA_TARGET_AVX2 inline void Store(uint64_t* ptr, __m256i val)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), val);
+	}
+
+	STAFRA_TARGET_AVX2 inline __m256i BitSelector()
+	{
+		return _mm256_setr_epi16(0x0001, 0x0002, 0x0004, 0x0008, 0x0010, 0x0020, 0x0040, 0x0080,
+		                         0x0100, 0x0200, 0x0400, 0x0800, 0x1000, 0x2000, 0x4000, (short)0x8000);
+	}
+
+	STAFRA_TARGET_AVX2 inline __m256i CellMask(uint32_t cellBits, __m256i bitSelector)
+	{
+		//0xffff in each 16-bit lane with the corresponding bit of cellBits set
+		__m256i broadcastBits = _mm256_set1_epi16((short)cellBits);
+		return _mm256_cmpeq_epi16(_mm256_and_si256(broadcastBits, bitSelector), bitSelector);
+	}
+
+	STAFRA_TARGET_AVX2 void CrossRowAVX2(uint64_t* nextRow, const uint64_t* topRow, const uint64_t* thisRow, const uint64_t* bottomRow, const uint64_t* columnMask, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i += 4)
+		{
+			__m256i thisCells  = Load(thisRow + i);
+			__m256i leftWords  = Load(thisRow + i - 1);
+			__m256i rightWords = Load(thisRow + i + 1);
+
+			__m256i leftCells  = _mm256_or_si256(_mm256_slli_epi64(thisCells, 1), _mm256_srli_epi64(leftWords,  63));
+			__m256i rightCells = _mm256_or_si256(_mm256_srli_epi64(thisCells, 1), _mm256_slli_epi64(rightWords, 63));
+
+			__m256i nextCells = _mm256_xor_si256(_mm256_xor_si256(thisCells, leftCells), _mm256_xor_si256(rightCells, _mm256_xor_si256(Load(topRow + i), Load(bottomRow + i))));
+			Store(nextRow + i, _mm256_and_si256(nextCells, Load(columnMask + i)));
+		}
+	}
+
+	STAFRA_TARGET_AVX2 void XorShiftedRowAVX2(uint64_t* outRow, const uint64_t* row, int32_t shift, size_t wordCount)
+	{
+		if(shift == 0)
+		{
+			for(size_t i = 0; i < wordCount; i += 4)
+			{
+				Store(outRow + i, _mm256_xor_si256(Load(outRow + i), Load(row + i)));
+			}
+		}
+		else if(shift > 0)
+		{
+			__m128i thisShift = _mm_cvtsi32_si128(shift);
+			__m128i nextShift = _mm_cvtsi32_si128(64 - shift);
+			for(size_t i = 0; i < wordCount; i += 4)
+			{
+				__m256i shiftedCells = _mm256_or_si256(_mm256_srl_epi64(Load(row + i), thisShift), _mm256_sll_epi64(Load(row + i + 1), nextShift));
+				Store(outRow + i, _mm256_xor_si256(Load(outRow + i), shiftedCells));
+			}
+		}
+		else
+		{
+			__m128i thisShift = _mm_cvtsi32_si128(-shift);
+			__m128i prevShift = _mm_cvtsi32_si128(64 + shift);
+			for(size_t i = 0; i < wordCount; i += 4)
+			{
+				__m256i shiftedCells = _mm256_or_si256(_mm256_sll_epi64(Load(row + i), thisShift), _mm256_srl_epi64(Load(row + i - 1), prevShift));
+				Store(outRow + i, _mm256_xor_si256(Load(outRow + i), shiftedCells));
+			}
+		}
+	}
+
+	STAFRA_TARGET_AVX2 inline __m128i ProductWords(const __m128i& rowWords, __m128i multiplier, __m128i& prevProduct)
+	{
+		//Two words of the row times the multiplier: each product word is the low half of its own product XOR the high half of the previous one
+		__m128i thisProduct = _mm_clmulepi64_si128(rowWords, multiplier, 0x00);
+		__m128i nextProduct = _mm_clmulepi64_si128(rowWords, multiplier, 0x01);
+
+		__m128i productWords = _mm_xor_si128(_mm_unpacklo_epi64(thisProduct, nextProduct), _mm_unpackhi_epi64(prevProduct, thisProduct));
+		prevProduct = nextProduct;
+
+		return productWords;
+	}
+
+	STAFRA_TARGET_AVX2 void ConvolveRowAVX2(uint64_t* outRow, const uint64_t* row, uint64_t shiftMask, int32_t minShift, size_t wordCount)
+	{
+		if(shiftMask == 0)
+		{
+			return;
+		}
+
+		//The carry-less product of the row and the reversed mask has the XOR of the row cells (p - topBit + i) for every set bit i in the cell p,
+		//so the cell x of the result is the cell (x + minShift + topBit) of the product. One multiplication per word instead of one shift per set bit
+		uint32_t topBit = 63;
+		while(!(shiftMask >> topBit))
+		{
+			topBit--;
+		}
+
+		uint64_t reversedMask = 0;
+		for(uint32_t bit = 0; bit <= topBit; bit++)
+		{
+			if(shiftMask & (1ull << bit))
+			{
+				reversedMask |= 1ull << (topBit - bit);
+			}
+		}
+
+		const int32_t shift      = minShift + (int32_t)topBit;
+		const __m128i multiplier = _mm_set_epi64x(0, (long long)reversedMask);
+
+		//The product word -1 only needs the row word -1, the higher half of the product of the row word -2 never gets shifted into the result
+		__m128i prevProduct = _mm_clmulepi64_si128(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row - 1)), multiplier, 0x00);
+		if(shift >= 0)
+		{
+			__m128i thisShift = _mm_cvtsi32_si128(shift);
+			__m128i nextShift = _mm_cvtsi32_si128(64 - shift); //Zeroes everything for the zero shift
+
+			__m128i thisWords = ProductWords(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row)), multiplier, prevProduct);
+			for(size_t i = 0; i < wordCount; i += 2)
+			{
+				//Only the guard word is read past the end of the row
+				__m128i nextRowWords = (i + 2 < wordCount) ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i + 2)) : _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + i + 2));
+				__m128i nextWords    = ProductWords(nextRowWords, multiplier, prevProduct);
+
+				__m128i followingWords = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(thisWords), _mm_castsi128_pd(nextWords), 0x01));
+				__m128i shiftedCells   = _mm_or_si128(_mm_srl_epi64(thisWords, thisShift), _mm_sll_epi64(followingWords, nextShift));
+
+				__m128i outWords = _mm_loadu_si128(reinterpret_cast<const __m128i*>(outRow + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(outRow + i), _mm_xor_si128(outWords, shiftedCells));
+
+				thisWords = nextWords;
+			}
+		}
+		else
+		{
+			__m128i thisShift = _mm_cvtsi32_si128(-shift);
+			__m128i prevShift = _mm_cvtsi32_si128(64 + shift);
+
+			__m128i prevWords = _mm_slli_si128(prevProduct, 8);
+			for(size_t i = 0; i < wordCount; i += 2)
+			{
+				__m128i thisWords = ProductWords(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i)), multiplier, prevProduct);
+
+				__m128i precedingWords = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(prevWords), _mm_castsi128_pd(thisWords), 0x01));
+				__m128i shiftedCells   = _mm_or_si128(_mm_sll_epi64(thisWords, thisShift), _mm_srl_epi64(precedingWords, prevShift));
+
+				__m128i outWords = _mm_loadu_si128(reinterpret_cast<const __m128i*>(outRow + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(outRow + i), _mm_xor_si128(outWords, shiftedCells));
+
+				prevWords = thisWords;
+			}
+		}
+	}
+
+	STAFRA_TARGET_AVX2 void AndRowAVX2(uint64_t* outRow, const uint64_t* rowA, const uint64_t* rowB, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i += 4)
+		{
+			Store(outRow + i, _mm256_and_si256(Load(rowA + i), Load(rowB + i)));
+		}
+	}
+
+	STAFRA_TARGET_AVX2 void XorRowAVX2(uint64_t* outRow, const uint64_t* row, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i += 4)
+		{
+			Store(outRow + i, _mm256_xor_si256(Load(outRow + i), Load(row + i)));
+		}
+	}
+
+	STAFRA_TARGET_AVX2 void StabilityRowAVX2(uint64_t* nextStabilityRow, const uint64_t* prevStabilityRow, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* restrictionRow, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i += 4)
+		{
+			__m256i changedCells  = _mm256_xor_si256(Load(thisRow + i), Load(nextRow + i));
+			__m256i nextStability = _mm256_andnot_si256(changedCells, Load(prevStabilityRow + i));
+			if(restrictionRow)
+			{
+				nextStability = _mm256_and_si256(nextStability, Load(restrictionRow + i));
+			}
+
+			Store(nextStabilityRow + i, nextStability);
+		}
+	}
+
+	STAFRA_TARGET_AVX2 void SpawnStabilityRowAVX2(uint64_t* nextPlanes, const uint64_t* prevPlanes, size_t planeStride, uint32_t planeCount, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* restrictionRow, uint32_t spawnPeriod, size_t wordCount)
+	{
+		const uint32_t lastValue = spawnPeriod + 1;
+		const __m256i  allCells  = _mm256_set1_epi32(-1);
+		for(size_t i = 0; i < wordCount; i += 4)
+		{
+			__m256i unchangedCells = _mm256_xor_si256(_mm256_xor_si256(Load(thisRow + i), Load(nextRow + i)), allCells);
+			if(restrictionRow)
+			{
+				unchangedCells = _mm256_and_si256(unchangedCells, Load(restrictionRow + i));
+			}
+
+			__m256i stableCells = allCells;
+			__m256i lastCells   = allCells;
+			for(uint32_t plane = 0; plane < planeCount; plane++)
+			{
+				__m256i valueBits    = Load(prevPlanes + plane * planeStride + i);
+				__m256i invertedBits = _mm256_xor_si256(valueBits, allCells);
+
+				stableCells = _mm256_and_si256(stableCells, (plane == 0)               ? valueBits : invertedBits);
+				lastCells   = _mm256_and_si256(lastCells,   ((lastValue >> plane) & 1) ? valueBits : invertedBits);
+			}
+
+			__m256i keptCells        = _mm256_and_si256(unchangedCells, stableCells);
+			__m256i incrementedCells = _mm256_andnot_si256(_mm256_or_si256(stableCells, lastCells), unchangedCells);
+			__m256i resetCells       = _mm256_xor_si256(unchangedCells, allCells);
+
+			__m256i carryBits = allCells;
+			for(uint32_t plane = 0; plane < planeCount; plane++)
+			{
+				__m256i valueBits = Load(prevPlanes + plane * planeStride + i);
+				__m256i sumBits   = _mm256_xor_si256(valueBits, carryBits);
+				carryBits       = _mm256_and_si256(carryBits, valueBits);
+
+				__m256i nextBits = _mm256_or_si256(_mm256_and_si256(keptCells, valueBits), _mm256_and_si256(incrementedCells, sumBits));
+				if(plane == 1)
+				{
+					nextBits = _mm256_or_si256(nextBits, resetCells);
+				}
+
+				Store(nextPlanes + plane * planeStride + i, nextBits);
+			}
+		}
+	}
+
+	STAFRA_TARGET_AVX2 void ExpandRowAVX2(uint16_t* outCells, const uint64_t* row, size_t wordCount)
+	{
+		const __m256i bitSelector = BitSelector();
+		for(size_t i = 0; i < wordCount; i++)
+		{
+			for(uint32_t lane = 0; lane < 4; lane++)
+			{
+				__m256i cellMask = CellMask((uint32_t)(row[i] >> (lane * 16)) & 0xffff, bitSelector);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(outCells + i * 64 + lane * 16), _mm256_srli_epi16(cellMask, 15));
+			}
+		}
+	}
+
+	STAFRA_TARGET_AVX2 void ExpandPlanesRowAVX2(uint16_t* outCells, const uint64_t* planes, size_t planeStride, uint32_t planeCount, size_t wordCount)
+	{
+		const __m256i bitSelector = BitSelector();
+		for(size_t i = 0; i < wordCount; i++)
+		{
+			for(uint32_t lane = 0; lane < 4; lane++)
+			{
+				__m256i cellValues = _mm256_setzero_si256();
+				for(uint32_t plane = 0; plane < planeCount; plane++)
+				{
+					__m256i cellMask = CellMask((uint32_t)(planes[plane * planeStride + i] >> (lane * 16)) & 0xffff, bitSelector);
+					cellValues       = _mm256_or_si256(cellValues, _mm256_and_si256(cellMask, _mm256_set1_epi16((short)(1 << plane))));
+				}
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(outCells + i * 64 + lane * 16), cellValues);
+			}
+		}
+	}
+
+	STAFRA_TARGET_AVX2 inline __m256i CountBits(__m256i bits)
+	{
+		//Nibble lookup, summed into each 64-bit lane
+		const __m256i nibbleCounts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+		                                              0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		const __m256i nibbleMask   = _mm256_set1_epi8(0x0f);
+
+		__m256i lowCounts  = _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(bits, nibbleMask));
+		__m256i highCounts = _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(_mm256_srli_epi16(bits, 4), nibbleMask));
+		return _mm256_sad_epu8(_mm256_add_epi8(lowCounts, highCounts), _mm256_setzero_si256());
+	}
+
+	STAFRA_TARGET_AVX2 inline uint64_t SumWords(__m256i words)
+	{
+		uint64_t sums[4];
+		Store(sums, words);
+		return sums[0] + sums[1] + sums[2] + sums[3];
+	}
+
+	STAFRA_TARGET_AVX2 void CountRowAVX2(uint64_t* outCounts, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* stableRow, const uint64_t* countMask, size_t wordCount)
+	{
+		__m256i stableCounts  = _mm256_setzero_si256();
+		__m256i changedCounts = _mm256_setzero_si256();
+		__m256i litCounts     = _mm256_setzero_si256();
+		for(size_t i = 0; i < wordCount; i += 4)
+		{
+			__m256i maskBits = Load(countMask + i);
+			__m256i nextBits = Load(nextRow + i);
+
+			stableCounts  = _mm256_add_epi64(stableCounts,  CountBits(_mm256_and_si256(Load(stableRow + i), maskBits)));
+			changedCounts = _mm256_add_epi64(changedCounts, CountBits(_mm256_and_si256(_mm256_xor_si256(Load(thisRow + i), nextBits), maskBits)));
+			litCounts     = _mm256_add_epi64(litCounts,     CountBits(_mm256_and_si256(nextBits, maskBits)));
+		}
+
+		outCounts[0] = SumWords(stableCounts);
+		outCounts[1] = SumWords(changedCounts);
+		outCounts[2] = SumWords(litCounts);
+	}
+}
+
+NextStepKernels CpuKernels::AVX2Kernels()
+{
+	NextStepKernels kernels;
+	kernels.CrossRow          = CrossRowAVX2;
+	kernels.XorShiftedRow     = XorShiftedRowAVX2;
+	kernels.ConvolveRow       = ConvolveRowAVX2;
+	kernels.AndRow            = AndRowAVX2;
+	kernels.XorRow            = XorRowAVX2;
+	kernels.StabilityRow      = StabilityRowAVX2;
+	kernels.SpawnStabilityRow = SpawnStabilityRowAVX2;
+	kernels.ExpandRow         = ExpandRowAVX2;
+	kernels.ExpandPlanesRow   = ExpandPlanesRowAVX2;
+	kernels.CountRow          = CountRowAVX2;
+
+	return kernels;
+}
+
+#else
+
+NextStepKernels CpuKernels::AVX2Kernels()
+{
+	return ScalarKernels();
+}
+
+#endif
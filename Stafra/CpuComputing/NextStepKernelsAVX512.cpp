@@ -0,0 +1,269 @@
+#include "NextStepKernels.hpp"
+
+#if defined(STAFRA_CPU_X86)
+
+#include <immintrin.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+	#define STAFRA_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#else
+	#define STAFRA_TARGET_AVX512
+#endif
+
+//8 words (512 cells) per iteration, which is exactly BitBoard::RowWordAlignment
+namespace
+{
+	const int     gXor3     = 0x96; //Ternary logic truth table for a ^ b ^ c
+	const int     gXorOr    = 0x1e; //Ternary logic truth table for a ^ (b | c)
+	const __mmask8 gAllWords = 0xff;
+
+	STAFRA_TARGET_AVX512 inline __m512i Load(const uint64_t* ptr)
+	{
+		return _mm512_loadu_si512(ptr);
+	}
+
+	STAFRA_TARGET_AVX512 inline void Store(uint64_t* ptr, __m512i val)
+	{
+		_mm512_storeu_si512(ptr, val);
+	}
+
+	//The zero-masked forms of the shifts and the and-not, the unmasked ones fill their unused source with _mm512_undefined_epi32() that GCC warns about
+	STAFRA_TARGET_AVX512 inline __m512i ShiftLeft(__m512i val, __m128i shift)
+	{
+		return _mm512_maskz_sll_epi64(gAllWords, val, shift);
+	}
+
+	STAFRA_TARGET_AVX512 inline __m512i ShiftRight(__m512i val, __m128i shift)
+	{
+		return _mm512_maskz_srl_epi64(gAllWords, val, shift);
+	}
+
+	STAFRA_TARGET_AVX512 inline __m512i AndNot(__m512i notVal, __m512i val)
+	{
+		return _mm512_maskz_andnot_epi64(gAllWords, notVal, val);
+	}
+
+	STAFRA_TARGET_AVX512 void CrossRowAVX512(uint64_t* nextRow, const uint64_t* topRow, const uint64_t* thisRow, const uint64_t* bottomRow, const uint64_t* columnMask, size_t wordCount)
+	{
+		const __m128i oneShift  = _mm_cvtsi32_si128(1);
+		const __m128i wordShift = _mm_cvtsi32_si128(63);
+		for(size_t i = 0; i < wordCount; i += 8)
+		{
+			__m512i thisCells  = Load(thisRow + i);
+			__m512i leftWords  = Load(thisRow + i - 1);
+			__m512i rightWords = Load(thisRow + i + 1);
+
+			__m512i leftCells  = _mm512_or_si512(ShiftLeft(thisCells,  oneShift), ShiftRight(leftWords,  wordShift));
+			__m512i rightCells = _mm512_or_si512(ShiftRight(thisCells, oneShift), ShiftLeft(rightWords,  wordShift));
+
+			__m512i nextCells = _mm512_ternarylogic_epi64(thisCells, leftCells, rightCells, gXor3);
+			nextCells         = _mm512_ternarylogic_epi64(nextCells, Load(topRow + i), Load(bottomRow + i), gXor3);
+
+			Store(nextRow + i, _mm512_and_si512(nextCells, Load(columnMask + i)));
+		}
+	}
+
+	STAFRA_TARGET_AVX512 void XorShiftedRowAVX512(uint64_t* outRow, const uint64_t* row, int32_t shift, size_t wordCount)
+	{
+		if(shift == 0)
+		{
+			for(size_t i = 0; i < wordCount; i += 8)
+			{
+				Store(outRow + i, _mm512_xor_si512(Load(outRow + i), Load(row + i)));
+			}
+		}
+		else if(shift > 0)
+		{
+			__m128i thisShift = _mm_cvtsi32_si128(shift);
+			__m128i nextShift = _mm_cvtsi32_si128(64 - shift);
+			for(size_t i = 0; i < wordCount; i += 8)
+			{
+				__m512i thisPart = ShiftRight(Load(row + i),    thisShift);
+				__m512i nextPart = ShiftLeft(Load(row + i + 1), nextShift);
+				Store(outRow + i, _mm512_ternarylogic_epi64(Load(outRow + i), thisPart, nextPart, gXorOr));
+			}
+		}
+		else
+		{
+			__m128i thisShift = _mm_cvtsi32_si128(-shift);
+			__m128i prevShift = _mm_cvtsi32_si128(64 + shift);
+			for(size_t i = 0; i < wordCount; i += 8)
+			{
+				__m512i thisPart = ShiftLeft(Load(row + i),      thisShift);
+				__m512i prevPart = ShiftRight(Load(row + i - 1), prevShift);
+				Store(outRow + i, _mm512_ternarylogic_epi64(Load(outRow + i), thisPart, prevPart, gXorOr));
+			}
+		}
+	}
+
+	STAFRA_TARGET_AVX512 void AndRowAVX512(uint64_t* outRow, const uint64_t* rowA, const uint64_t* rowB, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i += 8)
+		{
+			Store(outRow + i, _mm512_and_si512(Load(rowA + i), Load(rowB + i)));
+		}
+	}
+
+	STAFRA_TARGET_AVX512 void XorRowAVX512(uint64_t* outRow, const uint64_t* row, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i += 8)
+		{
+			Store(outRow + i, _mm512_xor_si512(Load(outRow + i), Load(row + i)));
+		}
+	}
+
+	STAFRA_TARGET_AVX512 void StabilityRowAVX512(uint64_t* nextStabilityRow, const uint64_t* prevStabilityRow, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* restrictionRow, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i += 8)
+		{
+			__m512i changedCells  = _mm512_xor_si512(Load(thisRow + i), Load(nextRow + i));
+			__m512i nextStability = AndNot(changedCells, Load(prevStabilityRow + i));
+			if(restrictionRow)
+			{
+				nextStability = _mm512_and_si512(nextStability, Load(restrictionRow + i));
+			}
+
+			Store(nextStabilityRow + i, nextStability);
+		}
+	}
+
+	STAFRA_TARGET_AVX512 void SpawnStabilityRowAVX512(uint64_t* nextPlanes, const uint64_t* prevPlanes, size_t planeStride, uint32_t planeCount, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* restrictionRow, uint32_t spawnPeriod, size_t wordCount)
+	{
+		const uint32_t lastValue = spawnPeriod + 1;
+		const __m512i  allCells  = _mm512_set1_epi32(-1);
+		for(size_t i = 0; i < wordCount; i += 8)
+		{
+			__m512i unchangedCells = _mm512_xor_si512(_mm512_xor_si512(Load(thisRow + i), Load(nextRow + i)), allCells);
+			if(restrictionRow)
+			{
+				unchangedCells = _mm512_and_si512(unchangedCells, Load(restrictionRow + i));
+			}
+
+			__m512i stableCells = allCells;
+			__m512i lastCells   = allCells;
+			for(uint32_t plane = 0; plane < planeCount; plane++)
+			{
+				__m512i valueBits    = Load(prevPlanes + plane * planeStride + i);
+				__m512i invertedBits = _mm512_xor_si512(valueBits, allCells);
+
+				stableCells = _mm512_and_si512(stableCells, (plane == 0)               ? valueBits : invertedBits);
+				lastCells   = _mm512_and_si512(lastCells,   ((lastValue >> plane) & 1) ? valueBits : invertedBits);
+			}
+
+			__m512i keptCells        = _mm512_and_si512(unchangedCells, stableCells);
+			__m512i incrementedCells = AndNot(_mm512_or_si512(stableCells, lastCells), unchangedCells);
+			__m512i resetCells       = _mm512_xor_si512(unchangedCells, allCells);
+
+			__m512i carryBits = allCells;
+			for(uint32_t plane = 0; plane < planeCount; plane++)
+			{
+				__m512i valueBits = Load(prevPlanes + plane * planeStride + i);
+				__m512i sumBits   = _mm512_xor_si512(valueBits, carryBits);
+				carryBits       = _mm512_and_si512(carryBits, valueBits);
+
+				__m512i nextBits = _mm512_or_si512(_mm512_and_si512(keptCells, valueBits), _mm512_and_si512(incrementedCells, sumBits));
+				if(plane == 1)
+				{
+					nextBits = _mm512_or_si512(nextBits, resetCells);
+				}
+
+				Store(nextPlanes + plane * planeStride + i, nextBits);
+			}
+		}
+	}
+
+	STAFRA_TARGET_AVX512 void ExpandRowAVX512(uint16_t* outCells, const uint64_t* row, size_t wordCount)
+	{
+		const __m512i ones = _mm512_set1_epi16(1);
+		for(size_t i = 0; i < wordCount; i++)
+		{
+			_mm512_storeu_si512(outCells + i * 64,      _mm512_maskz_mov_epi16((__mmask32)(row[i]),       ones));
+			_mm512_storeu_si512(outCells + i * 64 + 32, _mm512_maskz_mov_epi16((__mmask32)(row[i] >> 32), ones));
+		}
+	}
+
+	STAFRA_TARGET_AVX512 void ExpandPlanesRowAVX512(uint16_t* outCells, const uint64_t* planes, size_t planeStride, uint32_t planeCount, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i++)
+		{
+			for(uint32_t lane = 0; lane < 2; lane++)
+			{
+				__m512i cellValues = _mm512_setzero_si512();
+				for(uint32_t plane = 0; plane < planeCount; plane++)
+				{
+					__mmask32 cellMask = (__mmask32)(planes[plane * planeStride + i] >> (lane * 32));
+					cellValues         = _mm512_mask_add_epi16(cellValues, cellMask, cellValues, _mm512_set1_epi16((short)(1 << plane)));
+				}
+
+				_mm512_storeu_si512(outCells + i * 64 + lane * 32, cellValues);
+			}
+		}
+	}
+
+	STAFRA_TARGET_AVX512 inline __m512i CountBits(__m512i bits)
+	{
+		//Nibble lookup, summed into each 64-bit lane. VPOPCNTQ is a separate extension, AVX-512BW is enough for this
+		const __m512i nibbleCounts = _mm512_set4_epi32(0x04030302, 0x03020201, 0x03020201, 0x02010100);
+		const __m512i nibbleMask   = _mm512_set1_epi8(0x0f);
+
+		__m512i lowCounts  = _mm512_shuffle_epi8(nibbleCounts, _mm512_and_si512(bits, nibbleMask));
+		__m512i highCounts = _mm512_shuffle_epi8(nibbleCounts, _mm512_and_si512(_mm512_srli_epi16(bits, 4), nibbleMask));
+		return _mm512_sad_epu8(_mm512_add_epi8(lowCounts, highCounts), _mm512_setzero_si512());
+	}
+
+	STAFRA_TARGET_AVX512 void CountRowAVX512(uint64_t* outCounts, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* stableRow, const uint64_t* countMask, size_t wordCount)
+	{
+		__m512i stableCounts  = _mm512_setzero_si512();
+		__m512i changedCounts = _mm512_setzero_si512();
+		__m512i litCounts     = _mm512_setzero_si512();
+		for(size_t i = 0; i < wordCount; i += 8)
+		{
+			__m512i maskBits = Load(countMask + i);
+			__m512i nextBits = Load(nextRow + i);
+
+			stableCounts  = _mm512_add_epi64(stableCounts,  CountBits(_mm512_and_si512(Load(stableRow + i), maskBits)));
+			changedCounts = _mm512_add_epi64(changedCounts, CountBits(_mm512_and_si512(_mm512_xor_si512(Load(thisRow + i), nextBits), maskBits)));
+			litCounts     = _mm512_add_epi64(litCounts,     CountBits(_mm512_and_si512(nextBits, maskBits)));
+		}
+
+		alignas(64) uint64_t laneCounts[3][8];
+		_mm512_store_si512(laneCounts[0], stableCounts);
+		_mm512_store_si512(laneCounts[1], changedCounts);
+		_mm512_store_si512(laneCounts[2], litCounts);
+
+		for(uint32_t countIndex = 0; countIndex < 3; countIndex++)
+		{
+			outCounts[countIndex] = 0;
+			for(uint32_t lane = 0; lane < 8; lane++)
+			{
+				outCounts[countIndex] += laneCounts[countIndex][lane];
+			}
+		}
+	}
+}
+
+NextStepKernels CpuKernels::AVX512Kernels()
+{
+	NextStepKernels kernels;
+	kernels.CrossRow          = CrossRowAVX512;
+	kernels.XorShiftedRow     = XorShiftedRowAVX512;
+	kernels.ConvolveRow       = AVX2Kernels().ConvolveRow; //128-bit PCLMULQDQ, the 512-bit one needs VPCLMULQDQ which is not a part of AVX-512F/BW
+	kernels.AndRow            = AndRowAVX512;
+	kernels.XorRow            = XorRowAVX512;
+	kernels.StabilityRow      = StabilityRowAVX512;
+	kernels.SpawnStabilityRow = SpawnStabilityRowAVX512;
+	kernels.ExpandRow         = ExpandRowAVX512;
+	kernels.ExpandPlanesRow   = ExpandPlanesRowAVX512;
+	kernels.CountRow          = CountRowAVX512;
+
+	return kernels;
+}
+
+#else
+
+NextStepKernels CpuKernels::AVX512Kernels()
+{
+	return ScalarKernels();
+}
+
+#endif
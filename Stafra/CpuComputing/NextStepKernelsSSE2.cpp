@@ -0,0 +1,265 @@
+#include "NextStepKernels.hpp"
+
+#if defined(STAFRA_CPU_X86)
+
+#include <emmintrin.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+	#define STAFRA_TARGET_SSE2 __attribute__((target("sse2")))
+#else
+	#define STAFRA_TARGET_SSE2
+#endif
+
+//2 words (128 cells) per iteration
+namespace
+{
+	STAFRA_TARGET_SSE2 inline __m128i Load(const uint64_t* ptr)
+	{
+		return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+	}
+
+	STAFRA_TARGET_SSE2 inline void Store(uint64_t* ptr, __m128i val)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), val);
+	}
+
+	STAFRA_TARGET_SSE2 inline __m128i CellMask(uint32_t cellBits, __m128i bitSelector)
+	{
+		//0xffff in each 16-bit lane with the corresponding bit of cellBits set
+		__m128i broadcastBits = _mm_set1_epi16((short)cellBits);
+		return _mm_cmpeq_epi16(_mm_and_si128(broadcastBits, bitSelector), bitSelector);
+	}
+
+	STAFRA_TARGET_SSE2 void CrossRowSSE2(uint64_t* nextRow, const uint64_t* topRow, const uint64_t* thisRow, const uint64_t* bottomRow, const uint64_t* columnMask, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i += 2)
+		{
+			__m128i thisCells  = Load(thisRow + i);
+			__m128i leftWords  = Load(thisRow + i - 1);
+			__m128i rightWords = Load(thisRow + i + 1);
+
+			__m128i leftCells  = _mm_or_si128(_mm_slli_epi64(thisCells, 1), _mm_srli_epi64(leftWords,  63));
+			__m128i rightCells = _mm_or_si128(_mm_srli_epi64(thisCells, 1), _mm_slli_epi64(rightWords, 63));
+
+			__m128i nextCells = _mm_xor_si128(_mm_xor_si128(thisCells, leftCells), _mm_xor_si128(rightCells, _mm_xor_si128(Load(topRow + i), Load(bottomRow + i))));
+			Store(nextRow + i, _mm_and_si128(nextCells, Load(columnMask + i)));
+		}
+	}
+
+	STAFRA_TARGET_SSE2 void XorShiftedRowSSE2(uint64_t* outRow, const uint64_t* row, int32_t shift, size_t wordCount)
+	{
+		if(shift == 0)
+		{
+			for(size_t i = 0; i < wordCount; i += 2)
+			{
+				Store(outRow + i, _mm_xor_si128(Load(outRow + i), Load(row + i)));
+			}
+		}
+		else if(shift > 0)
+		{
+			__m128i thisShift = _mm_cvtsi32_si128(shift);
+			__m128i nextShift = _mm_cvtsi32_si128(64 - shift);
+			for(size_t i = 0; i < wordCount; i += 2)
+			{
+				__m128i shiftedCells = _mm_or_si128(_mm_srl_epi64(Load(row + i), thisShift), _mm_sll_epi64(Load(row + i + 1), nextShift));
+				Store(outRow + i, _mm_xor_si128(Load(outRow + i), shiftedCells));
+			}
+		}
+		else
+		{
+			__m128i thisShift = _mm_cvtsi32_si128(-shift);
+			__m128i prevShift = _mm_cvtsi32_si128(64 + shift);
+			for(size_t i = 0; i < wordCount; i += 2)
+			{
+				__m128i shiftedCells = _mm_or_si128(_mm_sll_epi64(Load(row + i), thisShift), _mm_srl_epi64(Load(row + i - 1), prevShift));
+				Store(outRow + i, _mm_xor_si128(Load(outRow + i), shiftedCells));
+			}
+		}
+	}
+
+	STAFRA_TARGET_SSE2 void ConvolveRowSSE2(uint64_t* outRow, const uint64_t* row, uint64_t shiftMask, int32_t minShift, size_t wordCount)
+	{
+		//No carry-less multiplication in SSE2
+		for(uint32_t bit = 0; bit < 64; bit++)
+		{
+			if(shiftMask & (1ull << bit))
+			{
+				XorShiftedRowSSE2(outRow, row, minShift + (int32_t)bit, wordCount);
+			}
+		}
+	}
+
+	STAFRA_TARGET_SSE2 void AndRowSSE2(uint64_t* outRow, const uint64_t* rowA, const uint64_t* rowB, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i += 2)
+		{
+			Store(outRow + i, _mm_and_si128(Load(rowA + i), Load(rowB + i)));
+		}
+	}
+
+	STAFRA_TARGET_SSE2 void XorRowSSE2(uint64_t* outRow, const uint64_t* row, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i += 2)
+		{
+			Store(outRow + i, _mm_xor_si128(Load(outRow + i), Load(row + i)));
+		}
+	}
+
+	STAFRA_TARGET_SSE2 void StabilityRowSSE2(uint64_t* nextStabilityRow, const uint64_t* prevStabilityRow, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* restrictionRow, size_t wordCount)
+	{
+		for(size_t i = 0; i < wordCount; i += 2)
+		{
+			__m128i changedCells  = _mm_xor_si128(Load(thisRow + i), Load(nextRow + i));
+			__m128i nextStability = _mm_andnot_si128(changedCells, Load(prevStabilityRow + i));
+			if(restrictionRow)
+			{
+				nextStability = _mm_and_si128(nextStability, Load(restrictionRow + i));
+			}
+
+			Store(nextStabilityRow + i, nextStability);
+		}
+	}
+
+	STAFRA_TARGET_SSE2 void SpawnStabilityRowSSE2(uint64_t* nextPlanes, const uint64_t* prevPlanes, size_t planeStride, uint32_t planeCount, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* restrictionRow, uint32_t spawnPeriod, size_t wordCount)
+	{
+		const uint32_t lastValue = spawnPeriod + 1;
+		const __m128i  allCells  = _mm_set1_epi32(-1);
+		for(size_t i = 0; i < wordCount; i += 2)
+		{
+			__m128i unchangedCells = _mm_xor_si128(_mm_xor_si128(Load(thisRow + i), Load(nextRow + i)), allCells);
+			if(restrictionRow)
+			{
+				unchangedCells = _mm_and_si128(unchangedCells, Load(restrictionRow + i));
+			}
+
+			__m128i stableCells = allCells;
+			__m128i lastCells   = allCells;
+			for(uint32_t plane = 0; plane < planeCount; plane++)
+			{
+				__m128i valueBits    = Load(prevPlanes + plane * planeStride + i);
+				__m128i invertedBits = _mm_xor_si128(valueBits, allCells);
+
+				stableCells = _mm_and_si128(stableCells, (plane == 0)               ? valueBits : invertedBits);
+				lastCells   = _mm_and_si128(lastCells,   ((lastValue >> plane) & 1) ? valueBits : invertedBits);
+			}
+
+			__m128i keptCells        = _mm_and_si128(unchangedCells, stableCells);
+			__m128i incrementedCells = _mm_andnot_si128(_mm_or_si128(stableCells, lastCells), unchangedCells);
+			__m128i resetCells       = _mm_xor_si128(unchangedCells, allCells);
+
+			__m128i carryBits = allCells;
+			for(uint32_t plane = 0; plane < planeCount; plane++)
+			{
+				__m128i valueBits = Load(prevPlanes + plane * planeStride + i);
+				__m128i sumBits   = _mm_xor_si128(valueBits, carryBits);
+				carryBits       = _mm_and_si128(carryBits, valueBits);
+
+				__m128i nextBits = _mm_or_si128(_mm_and_si128(keptCells, valueBits), _mm_and_si128(incrementedCells, sumBits));
+				if(plane == 1)
+				{
+					nextBits = _mm_or_si128(nextBits, resetCells);
+				}
+
+				Store(nextPlanes + plane * planeStride + i, nextBits);
+			}
+		}
+	}
+
+	STAFRA_TARGET_SSE2 void ExpandRowSSE2(uint16_t* outCells, const uint64_t* row, size_t wordCount)
+	{
+		const __m128i bitSelector = _mm_setr_epi16(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80);
+		for(size_t i = 0; i < wordCount; i++)
+		{
+			for(uint32_t lane = 0; lane < 8; lane++)
+			{
+				__m128i cellMask = CellMask((uint32_t)(row[i] >> (lane * 8)) & 0xff, bitSelector);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(outCells + i * 64 + lane * 8), _mm_srli_epi16(cellMask, 15));
+			}
+		}
+	}
+
+	STAFRA_TARGET_SSE2 void ExpandPlanesRowSSE2(uint16_t* outCells, const uint64_t* planes, size_t planeStride, uint32_t planeCount, size_t wordCount)
+	{
+		const __m128i bitSelector = _mm_setr_epi16(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80);
+		for(size_t i = 0; i < wordCount; i++)
+		{
+			for(uint32_t lane = 0; lane < 8; lane++)
+			{
+				__m128i cellValues = _mm_setzero_si128();
+				for(uint32_t plane = 0; plane < planeCount; plane++)
+				{
+					__m128i cellMask = CellMask((uint32_t)(planes[plane * planeStride + i] >> (lane * 8)) & 0xff, bitSelector);
+					cellValues       = _mm_or_si128(cellValues, _mm_and_si128(cellMask, _mm_set1_epi16((short)(1 << plane))));
+				}
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(outCells + i * 64 + lane * 8), cellValues);
+			}
+		}
+	}
+
+	STAFRA_TARGET_SSE2 inline __m128i CountBits(__m128i bits)
+	{
+		//Bit counts of the bytes, summed into each 64-bit half
+		const __m128i mask55 = _mm_set1_epi8(0x55);
+		const __m128i mask33 = _mm_set1_epi8(0x33);
+		const __m128i mask0f = _mm_set1_epi8(0x0f);
+
+		bits = _mm_sub_epi8(bits, _mm_and_si128(_mm_srli_epi16(bits, 1), mask55));
+		bits = _mm_add_epi8(_mm_and_si128(bits, mask33), _mm_and_si128(_mm_srli_epi16(bits, 2), mask33));
+		bits = _mm_and_si128(_mm_add_epi8(bits, _mm_srli_epi16(bits, 4)), mask0f);
+		return _mm_sad_epu8(bits, _mm_setzero_si128());
+	}
+
+	STAFRA_TARGET_SSE2 inline uint64_t SumWords(__m128i words)
+	{
+		uint64_t sums[2];
+		Store(sums, words);
+		return sums[0] + sums[1];
+	}
+
+	STAFRA_TARGET_SSE2 void CountRowSSE2(uint64_t* outCounts, const uint64_t* thisRow, const uint64_t* nextRow, const uint64_t* stableRow, const uint64_t* countMask, size_t wordCount)
+	{
+		__m128i stableCounts  = _mm_setzero_si128();
+		__m128i changedCounts = _mm_setzero_si128();
+		__m128i litCounts     = _mm_setzero_si128();
+		for(size_t i = 0; i < wordCount; i += 2)
+		{
+			__m128i maskBits = Load(countMask + i);
+			__m128i nextBits = Load(nextRow + i);
+
+			stableCounts  = _mm_add_epi64(stableCounts,  CountBits(_mm_and_si128(Load(stableRow + i), maskBits)));
+			changedCounts = _mm_add_epi64(changedCounts, CountBits(_mm_and_si128(_mm_xor_si128(Load(thisRow + i), nextBits), maskBits)));
+			litCounts     = _mm_add_epi64(litCounts,     CountBits(_mm_and_si128(nextBits, maskBits)));
+		}
+
+		outCounts[0] = SumWords(stableCounts);
+		outCounts[1] = SumWords(changedCounts);
+		outCounts[2] = SumWords(litCounts);
+	}
+}
+
+NextStepKernels CpuKernels::SSE2Kernels()
+{
+	NextStepKernels kernels;
+	kernels.CrossRow          = CrossRowSSE2;
+	kernels.XorShiftedRow     = XorShiftedRowSSE2;
+	kernels.ConvolveRow       = ConvolveRowSSE2;
+	kernels.AndRow            = AndRowSSE2;
+	kernels.XorRow            = XorRowSSE2;
+	kernels.StabilityRow      = StabilityRowSSE2;
+	kernels.SpawnStabilityRow = SpawnStabilityRowSSE2;
+	kernels.ExpandRow         = ExpandRowSSE2;
+	kernels.ExpandPlanesRow   = ExpandPlanesRowSSE2;
+	kernels.CountRow          = CountRowSSE2;
+
+	return kernels;
+}
+
+#else
+
+NextStepKernels CpuKernels::SSE2Kernels()
+{
+	return ScalarKernels();
+}
+
+#endif
@@ -0,0 +1,159 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(uint32_t threadCount): mCurrentTask(nullptr), mJobIndex(0), mRemainingTasks(0), mThreadCount(threadCount), mbStopping(false)
+{
+	if(mThreadCount == 0)
+	{
+		mThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	for(uint32_t i = 0; i < mThreadCount; i++)
+	{
+		mQueues.push_back(std::make_unique<WorkerQueue>());
+	}
+
+	for(uint32_t i = 1; i < mThreadCount; i++)
+	{
+		mWorkers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mJobMutex);
+		mbStopping = true;
+	}
+
+	mJobStartedCondition.notify_all();
+	for(std::thread& worker: mWorkers)
+	{
+		worker.join();
+	}
+}
+
+uint32_t ThreadPool::GetThreadCount() const
+{
+	return mThreadCount;
+}
+
+void ThreadPool::ParallelFor(uint32_t taskCount, const TaskFunc& task)
+{
+	if(taskCount == 0)
+	{
+		return;
+	}
+
+	if(mThreadCount == 1 || taskCount == 1)
+	{
+		for(uint32_t i = 0; i < taskCount; i++)
+		{
+			task(i, 0);
+		}
+
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mJobMutex);
+
+		mCurrentTask = &task;
+		mRemainingTasks.store(taskCount);
+
+		//Contiguous ranges keep neighbouring tiles on the same thread as long as nobody steals them
+		for(uint32_t i = 0; i < mThreadCount; i++)
+		{
+			uint32_t rangeBegin = (uint32_t)((uint64_t)taskCount *  i      / mThreadCount);
+			uint32_t rangeEnd   = (uint32_t)((uint64_t)taskCount * (i + 1) / mThreadCount);
+
+			std::lock_guard<std::mutex> queueLock(mQueues[i]->Mutex);
+			for(uint32_t taskIndex = rangeBegin; taskIndex < rangeEnd; taskIndex++)
+			{
+				mQueues[i]->Tasks.push_back(taskIndex);
+			}
+		}
+
+		mJobIndex++;
+	}
+
+	mJobStartedCondition.notify_all();
+
+	while(RunOneTask(0))
+	{
+	}
+
+	std::unique_lock<std::mutex> lock(mJobMutex);
+	mJobFinishedCondition.wait(lock, [this]() {return mRemainingTasks.load() == 0;});
+
+	mCurrentTask = nullptr;
+}
+
+void ThreadPool::WorkerLoop(uint32_t threadIndex)
+{
+	uint64_t lastJobIndex = 0;
+	while(true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mJobMutex);
+			mJobStartedCondition.wait(lock, [this, lastJobIndex]() {return mbStopping || mJobIndex != lastJobIndex;});
+
+			if(mbStopping)
+			{
+				return;
+			}
+
+			lastJobIndex = mJobIndex;
+		}
+
+		while(RunOneTask(threadIndex))
+		{
+		}
+	}
+}
+
+bool ThreadPool::RunOneTask(uint32_t threadIndex)
+{
+	uint32_t taskIndex = 0;
+	bool     taskFound = false;
+
+	{
+		WorkerQueue& ownQueue = *mQueues[threadIndex];
+
+		std::lock_guard<std::mutex> queueLock(ownQueue.Mutex);
+		if(!ownQueue.Tasks.empty())
+		{
+			taskIndex = ownQueue.Tasks.front();
+			ownQueue.Tasks.pop_front();
+			taskFound = true;
+		}
+	}
+
+	for(uint32_t i = 1; i < mThreadCount && !taskFound; i++)
+	{
+		WorkerQueue& victimQueue = *mQueues[(threadIndex + i) % mThreadCount];
+
+		std::lock_guard<std::mutex> queueLock(victimQueue.Mutex);
+		if(!victimQueue.Tasks.empty())
+		{
+			taskIndex = victimQueue.Tasks.back();
+			victimQueue.Tasks.pop_back();
+			taskFound = true;
+		}
+	}
+
+	if(!taskFound)
+	{
+		return false;
+	}
+
+	(*mCurrentTask)(taskIndex, threadIndex);
+
+	if(mRemainingTasks.fetch_sub(1) == 1)
+	{
+		std::lock_guard<std::mutex> lock(mJobMutex);
+		mJobFinishedCondition.notify_all();
+	}
+
+	return true;
+}
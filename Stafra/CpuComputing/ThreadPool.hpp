@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/*
+The class for running a batch of independent tasks on all CPU cores.
+Input:               Task count and the task function
+Output:              The task function called once for every task index, ParallelFor() returns when all of them are finished
+Possible expansions: Task priorities
+*/
+
+class ThreadPool
+{
+	//Each thread takes the tasks from the front of its own queue and steals from the back of the others' queues when it runs out of them
+	struct WorkerQueue
+	{
+		std::mutex           Mutex;
+		std::deque<uint32_t> Tasks;
+	};
+
+public:
+	typedef std::function<void(uint32_t taskIndex, uint32_t threadIndex)> TaskFunc;
+
+	ThreadPool(uint32_t threadCount); //0 means one thread per hardware thread, the calling thread is counted too
+	~ThreadPool();
+
+	uint32_t GetThreadCount() const;
+
+	void ParallelFor(uint32_t taskCount, const TaskFunc& task); //threadIndex is in [0, GetThreadCount()), the calling thread is always 0
+
+private:
+	void WorkerLoop(uint32_t threadIndex);
+	bool RunOneTask(uint32_t threadIndex);
+
+private:
+	std::vector<std::thread>                  mWorkers;
+	std::vector<std::unique_ptr<WorkerQueue>> mQueues;
+
+	std::mutex              mJobMutex;
+	std::condition_variable mJobStartedCondition;
+	std::condition_variable mJobFinishedCondition;
+
+	const TaskFunc*       mCurrentTask;
+	uint64_t              mJobIndex;
+	std::atomic<uint32_t> mRemainingTasks;
+
+	uint32_t mThreadCount;
+	bool     mbStopping;
+};
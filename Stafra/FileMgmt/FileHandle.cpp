@@ -2,7 +2,11 @@
 
 FileHandle::FileHandle(const std::wstring& filename, const std::wstring& readMode): mFile(nullptr)
 {
+#if defined(_WIN32)
 	errno_t fileOpenErr = _wfopen_s(&mFile, filename.c_str(), readMode.c_str());
+#else
+	mFile = fopen(std::string(filename.begin(), filename.end()).c_str(), std::string(readMode.begin(), readMode.end()).c_str());
+#endif
 }
 
 FileHandle::~FileHandle()
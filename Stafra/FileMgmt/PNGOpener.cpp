@@ -53,6 +53,55 @@ bool PngOpener::GetImageSize(const std::wstring& filename, size_t& width, size_t
 	return true;
 }
 
+bool PngOpener::ReadRgbaImage(const std::wstring& filename, size_t& width, size_t& height, std::vector<uint8_t>& rgbaData)
+{
+	width  = 0;
+	height = 0;
+	rgbaData.clear();
+
+	FileHandle fin(filename, L"rb");
+	if(!fin || !mPngStruct || !mPngInfo)
+	{
+		return false;
+	}
+
+	std::vector<png_bytep> rowPointers;
+	if(setjmp(png_jmpbuf(mPngStruct)) != 0) //Corrupted file
+	{
+		rgbaData.clear();
+		return false;
+	}
+
+	png_init_io(mPngStruct, fin.GetFilePointer());
+
+	png_read_info(mPngStruct, mPngInfo);
+
+	png_set_expand(mPngStruct);
+	png_set_strip_16(mPngStruct);
+	png_set_gray_to_rgb(mPngStruct);
+	png_set_filler(mPngStruct, 0xff, PNG_FILLER_AFTER);
+	png_set_interlace_handling(mPngStruct);
+
+	png_read_update_info(mPngStruct, mPngInfo);
+
+	png_uint_32 pngWidth  = png_get_image_width(mPngStruct,  mPngInfo);
+	png_uint_32 pngHeight = png_get_image_height(mPngStruct, mPngInfo);
+
+	rgbaData.resize((size_t)pngWidth * pngHeight * 4);
+	rowPointers.resize(pngHeight);
+	for(size_t i = 0; i < pngHeight; i++)
+	{
+		rowPointers[i] = &rgbaData[i * pngWidth * 4];
+	}
+
+	png_read_image(mPngStruct, rowPointers.data());
+	png_read_end(mPngStruct, nullptr);
+
+	width  = pngWidth;
+	height = pngHeight;
+	return true;
+}
+
 bool PngOpener::operator!() const
 {
 	return mPngStruct == nullptr || mPngInfo == nullptr;
@@ -4,7 +4,7 @@
 #include <string>
 #include <vector>
 
-class PngOpener //This class is needed just to get PNG image size
+class PngOpener //This class is needed to get PNG image size and to read the image where WIC isn't available
 {
 public:
 	PngOpener();
@@ -17,6 +17,7 @@ public:
 	PngOpener operator=(const PngOpener&&) = delete;
 
 	bool GetImageSize(const std::wstring& filename, size_t& width, size_t& height);
+	bool ReadRgbaImage(const std::wstring& filename, size_t& width, size_t& height, std::vector<uint8_t>& rgbaData); //Any PNG format is converted to 8 bits per channel RGBA, rows are tightly packed
 
 	bool operator!() const;
 
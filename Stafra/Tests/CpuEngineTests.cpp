@@ -0,0 +1,1811 @@
+#include "../Computing/FractalGen.hpp"
+#include "../Computing/CpuComputeBackend.hpp"
+#include "../CpuComputing/CpuStabilityCalculator.hpp"
+#include "../CpuComputing/CpuBatchCalculator.hpp"
+#include "../CpuComputing/CpuRegionCalculator.hpp"
+#include "../CpuComputing/CpuOutOfCoreCalculator.hpp"
+#include "../CpuComputing/CpuSlabCalculator.hpp"
+#include "../CpuComputing/CpuHaloTransport.hpp"
+#include "../CpuComputing/CpuSocketTransport.hpp"
+#include "../CpuComputing/CpuPeriodSolver.hpp"
+#include "../CpuComputing/CpuCycleDetector.hpp"
+#include "../CpuComputing/CpuClickRuleSearch.hpp"
+#include "../CpuComputing/CpuChangeMap.hpp"
+#include "../CpuComputing/CpuClickRule.hpp"
+#include "../CpuComputing/CpuFeatures.hpp"
+#include "../CpuComputing/CpuGenerationStats.hpp"
+#include "../CpuComputing/BitBoard.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+Differential tests of the CPU engines against the plain stepping path.
+Input:               The name of the engine to test
+Output:              The mismatches with the plain stepping, exit code 0 if there are none
+Possible expansions: Random boards and click rules
+
+The plain stepping is computed cell by cell, the same way StabilityNextStep*CS.hlsl do.
+Every engine computes the same small boards (psize 6-8) with the cross, a symmetric and a skewed click rule,
+with and without a restriction and spawn, and has to give exactly the same stability.
+*/
+
+namespace
+{
+	const uint32_t gClickRuleSize = 32; //Same as BoardLoader accepts
+
+	enum class TestClickRule
+	{
+		Cross,  //The default one, null click rule
+		Knight, //The knight moves and the cell itself, symmetric in all 8 ways
+		Skewed  //No symmetry at all
+	};
+
+	enum class TestBoard
+	{
+		Center, //A single lit cell, computed with the impulse responses
+		Dense,  //Rings of lit cells, symmetric in all 8 ways
+		Skewed  //Diagonal stripes, no symmetry at all
+	};
+
+	struct TestScenario
+	{
+		uint32_t      PowSize;
+		TestClickRule ClickRule;
+		TestBoard     Board;
+		bool          Restricted; //A disk with holes, symmetric in all 8 ways
+		uint32_t      SpawnPeriod;
+	};
+
+	//The board, the click rule and the restriction of a scenario
+	struct TestInputs
+	{
+		uint32_t             Size;
+		uint32_t             StepCount;
+		std::vector<uint8_t> BoardCells;
+		std::vector<uint8_t> RestrictionCells; //Empty if not restricted
+		CpuClickRule         ClickRule;
+		BitBoard             Restriction;
+		bool                 bDefaultClickRule;
+		bool                 bRestricted;
+
+		std::vector<int32_t> ReadOffsetsX; //The cell (x, y) reads the cells (x + ReadOffsetsX[i], y + ReadOffsetsY[i])
+		std::vector<int32_t> ReadOffsetsY;
+
+		const CpuClickRule* GetClickRule()   const { return bDefaultClickRule ? nullptr : &ClickRule; }
+		const BitBoard*     GetRestriction() const { return bRestricted ? &Restriction : nullptr; }
+	};
+
+	//The state of the plain stepping
+	struct ReferenceState
+	{
+		uint32_t              Size;
+		std::vector<uint8_t>  Board;
+		std::vector<uint16_t> Stability;
+	};
+
+	std::vector<uint8_t> MakeBoardCells(TestBoard board, uint32_t size)
+	{
+		std::vector<uint8_t> cells((size_t)size * size, 0);
+		const int32_t center = (int32_t)size / 2;
+
+		for(uint32_t y = 0; y < size; y++)
+		{
+			for(uint32_t x = 0; x < size; x++)
+			{
+				int32_t dx = std::abs((int32_t)x - center);
+				int32_t dy = std::abs((int32_t)y - center);
+
+				switch(board)
+				{
+				case TestBoard::Center:
+					cells[(size_t)y * size + x] = (dx == 0 && dy == 0);
+					break;
+				case TestBoard::Dense:
+					cells[(size_t)y * size + x] = ((dx * dx + dy * dy) % 5 == 0);
+					break;
+				case TestBoard::Skewed:
+					cells[(size_t)y * size + x] = ((3 * x + 7 * y) % 11 == 0);
+					break;
+				}
+			}
+		}
+
+		return cells;
+	}
+
+	std::vector<uint8_t> MakeRestrictionCells(uint32_t size)
+	{
+		std::vector<uint8_t> cells((size_t)size * size, 0);
+		const int32_t center = (int32_t)size / 2;
+		const int32_t radius = center - 3;
+
+		for(uint32_t y = 0; y < size; y++)
+		{
+			for(uint32_t x = 0; x < size; x++)
+			{
+				int32_t distanceSq = ((int32_t)x - center) * ((int32_t)x - center) + ((int32_t)y - center) * ((int32_t)y - center);
+				cells[(size_t)y * size + x] = (distanceSq <= radius * radius && distanceSq % 13 != 7);
+			}
+		}
+
+		return cells;
+	}
+
+	std::vector<uint8_t> MakeClickRuleCells(TestClickRule clickRule)
+	{
+		std::vector<uint8_t> cells(gClickRuleSize * gClickRuleSize, 0);
+		const int32_t center = (gClickRuleSize - 1) / 2;
+
+		auto enableCell = [&cells, center](int32_t offsetX, int32_t offsetY)
+		{
+			cells[(center + offsetY) * gClickRuleSize + (center + offsetX)] = 1;
+		};
+
+		switch(clickRule)
+		{
+		case TestClickRule::Cross:
+			enableCell( 0,  0);
+			enableCell(-1,  0);
+			enableCell( 1,  0);
+			enableCell( 0, -1);
+			enableCell( 0,  1);
+			break;
+		case TestClickRule::Knight:
+			enableCell(0, 0);
+			for(int32_t signX: {-1, 1})
+			{
+				for(int32_t signY: {-1, 1})
+				{
+					enableCell(1 * signX, 2 * signY);
+					enableCell(2 * signX, 1 * signY);
+				}
+			}
+			break;
+		case TestClickRule::Skewed:
+			enableCell( 0,  0);
+			enableCell( 1,  0);
+			enableCell(-2,  1);
+			enableCell( 0, -1);
+			enableCell( 3,  2);
+			enableCell(-1, -3);
+			break;
+		}
+
+		return cells;
+	}
+
+	void InitInputs(const TestScenario& scenario, TestInputs& outInputs)
+	{
+		outInputs.Size       = (1u << scenario.PowSize) - 1;
+		outInputs.StepCount  = outInputs.Size + outInputs.Size / 2 + 5; //Not a multiple of the temporal block
+		outInputs.BoardCells = MakeBoardCells(scenario.Board, outInputs.Size);
+
+		outInputs.bRestricted = scenario.Restricted;
+		outInputs.RestrictionCells.clear();
+		if(scenario.Restricted)
+		{
+			outInputs.RestrictionCells = MakeRestrictionCells(outInputs.Size);
+			outInputs.Restriction.Resize(outInputs.Size, outInputs.Size);
+			outInputs.Restriction.FromCells(outInputs.RestrictionCells.data(), outInputs.Size);
+		}
+
+		//Same as BakeClickRuleCS: the click rule cell (x, y) makes the board cell (x0, y0) read the cell (x0 - (x - center), y0 + (y - center))
+		std::vector<uint8_t> clickRuleCells = MakeClickRuleCells(scenario.ClickRule);
+		outInputs.ClickRule.InitFromCells(clickRuleCells.data(), gClickRuleSize, gClickRuleSize, gClickRuleSize);
+		outInputs.bDefaultClickRule = (scenario.ClickRule == TestClickRule::Cross);
+
+		const int32_t center = (gClickRuleSize - 1) / 2;
+		outInputs.ReadOffsetsX.clear();
+		outInputs.ReadOffsetsY.clear();
+		for(int32_t y = 0; y < (int32_t)gClickRuleSize; y++)
+		{
+			for(int32_t x = 0; x < (int32_t)gClickRuleSize; x++)
+			{
+				if(clickRuleCells[y * gClickRuleSize + x] != 0)
+				{
+					outInputs.ReadOffsetsX.push_back(center - x);
+					outInputs.ReadOffsetsY.push_back(y - center);
+				}
+			}
+		}
+	}
+
+	void InitReference(const TestInputs& inputs, const std::vector<uint8_t>& boardCells, ReferenceState& outState)
+	{
+		outState.Size  = inputs.Size;
+		outState.Board = boardCells;
+		outState.Stability.assign(boardCells.size(), 1);
+	}
+
+	//Same as StabilityNextStep*CS.hlsl
+	void ReferenceNextStep(const TestInputs& inputs, uint32_t spawnPeriod, ReferenceState& state)
+	{
+		const int32_t size = (int32_t)state.Size;
+
+		std::vector<uint8_t>  nextBoard(state.Board.size());
+		std::vector<uint16_t> nextStability(state.Stability.size());
+		for(int32_t y = 0; y < size; y++)
+		{
+			for(int32_t x = 0; x < size; x++)
+			{
+				uint32_t sum = 0;
+				for(size_t i = 0; i < inputs.ReadOffsetsX.size(); i++)
+				{
+					int32_t readX = x + inputs.ReadOffsetsX[i];
+					int32_t readY = y + inputs.ReadOffsetsY[i];
+					if(readX < 0 || readY < 0 || readX >= size || readY >= size)
+					{
+						continue;
+					}
+
+					size_t readIndex = (size_t)readY * size + readX;
+					sum += state.Board[readIndex] * (inputs.bRestricted ? inputs.RestrictionCells[readIndex] : 1);
+				}
+
+				size_t   cellIndex     = (size_t)y * size + x;
+				uint8_t  thisCellState = state.Board[cellIndex];
+				uint8_t  nextCellState = sum % 2;
+				uint16_t prevStability = state.Stability[cellIndex];
+				bool     clickable     = !inputs.bRestricted || inputs.RestrictionCells[cellIndex] != 0;
+
+				if(spawnPeriod == 0)
+				{
+					nextStability[cellIndex] = (prevStability && thisCellState == nextCellState && clickable);
+				}
+				else if(thisCellState == nextCellState && clickable)
+				{
+					nextStability[cellIndex] = (prevStability == 1) ? 1 : (prevStability + 1) % (2 + spawnPeriod);
+				}
+				else
+				{
+					nextStability[cellIndex] = 2;
+				}
+
+				nextBoard[cellIndex] = nextCellState;
+			}
+		}
+
+		state.Board.swap(nextBoard);
+		state.Stability.swap(nextStability);
+	}
+
+	void ReferenceNextSteps(const TestInputs& inputs, uint32_t stepCount, uint32_t spawnPeriod, ReferenceState& state)
+	{
+		for(uint32_t step = 0; step < stepCount; step++)
+		{
+			ReferenceNextStep(inputs, spawnPeriod, state);
+		}
+	}
+
+	std::string ScenarioName(const TestScenario& scenario)
+	{
+		const char* clickRuleNames[] = {"cross", "knight", "skewed"};
+		const char* boardNames[]     = {"center", "dense", "skewed"};
+
+		std::ostringstream name;
+		name << "psize " << scenario.PowSize << ", " << clickRuleNames[(int)scenario.ClickRule] << " click rule, " << boardNames[(int)scenario.Board] << " board";
+		name << (scenario.Restricted ? ", restricted" : "") << ", spawn " << scenario.SpawnPeriod;
+		return name.str();
+	}
+
+	//Prints the first mismatch
+	bool CompareCells(const std::string& what, const std::vector<uint16_t>& expected, const std::vector<uint16_t>& actual, uint32_t width)
+	{
+		auto mismatch = std::mismatch(expected.begin(), expected.end(), actual.begin());
+		if(mismatch.first == expected.end())
+		{
+			return true;
+		}
+
+		size_t cellIndex = mismatch.first - expected.begin();
+		std::printf("FAILED %s: the cell (%u, %u) is %u instead of %u\n", what.c_str(), (uint32_t)(cellIndex % width), (uint32_t)(cellIndex / width), (uint32_t)*mismatch.second, (uint32_t)*mismatch.first);
+		return false;
+	}
+
+	std::vector<uint16_t> CopyStability(const CpuStabilityCalculator& calculator)
+	{
+		std::vector<uint16_t> cells((size_t)calculator.GetBoardWidth() * calculator.GetBoardHeight());
+		calculator.CopyStabilityCells(cells.data(), calculator.GetBoardWidth());
+		return cells;
+	}
+
+	void PrepareCalculator(CpuStabilityCalculator& calculator, const TestInputs& inputs, uint32_t threadCount, uint32_t tileWidth, uint32_t tileHeight)
+	{
+		calculator.SetThreadCount(threadCount);
+		calculator.SetTileSize(tileWidth, tileHeight);
+		calculator.PrepareForCalculations(inputs.BoardCells.data(), inputs.Size, inputs.Size, inputs.Size);
+	}
+
+	//Steps with StabilityNextSteps() in chunks of the sizes in turn, the chunk of 1 is a single StabilityNextStep()
+	void StepInChunks(CpuStabilityCalculator& calculator, const TestInputs& inputs, uint32_t stepCount, uint32_t spawnPeriod, const std::vector<uint32_t>& chunkSizes)
+	{
+		for(uint32_t step = 0, chunkIndex = 0; step < stepCount; chunkIndex++)
+		{
+			uint32_t chunkSize = std::min(chunkSizes[chunkIndex % chunkSizes.size()], stepCount - step);
+			if(chunkSize == 1)
+			{
+				calculator.StabilityNextStep(inputs.GetClickRule(), inputs.GetRestriction(), spawnPeriod);
+			}
+			else
+			{
+				calculator.StabilityNextSteps(chunkSize, inputs.GetClickRule(), inputs.GetRestriction(), spawnPeriod);
+			}
+
+			step += chunkSize;
+		}
+	}
+
+	//The plain stepping path of CpuStabilityCalculator: no SIMD, a single thread, a generation at a time
+	bool TestPlain(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& reference)
+	{
+		CpuStabilityCalculator calculator;
+		calculator.SetInstructionSet(CpuInstructionSet::SCALAR);
+		PrepareCalculator(calculator, inputs, 1, 0, 1);
+		StepInChunks(calculator, inputs, inputs.StepCount, scenario.SpawnPeriod, {1});
+
+		return CompareCells(ScenarioName(scenario), reference.Stability, CopyStability(calculator), inputs.Size);
+	}
+
+	bool TestSimd(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& reference)
+	{
+		bool result = true;
+		for(CpuInstructionSet instructionSet: {CpuInstructionSet::SCALAR, CpuInstructionSet::SSE2, CpuInstructionSet::AVX2, CpuInstructionSet::AVX512})
+		{
+			CpuStabilityCalculator calculator;
+			calculator.SetInstructionSet(instructionSet);
+			if(calculator.GetInstructionSet() != instructionSet) //Not supported by this CPU
+			{
+				continue;
+			}
+
+			PrepareCalculator(calculator, inputs, 1, 0, 1);
+			StepInChunks(calculator, inputs, inputs.StepCount, scenario.SpawnPeriod, {1, 64});
+
+			result = CompareCells(ScenarioName(scenario) + ", " + CpuFeatures::InstructionSetName(instructionSet), reference.Stability, CopyStability(calculator), inputs.Size) && result;
+		}
+
+		return result;
+	}
+
+	bool TestTiles(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& reference)
+	{
+		const uint32_t tileSizes[][3] = {{512, 1, 1}, {512, 7, 3}, {1024, 64, 2}, {0, 16, 2}}; //Width, height, threads
+
+		bool result = true;
+		for(const uint32_t* tileSize: tileSizes)
+		{
+			CpuStabilityCalculator calculator;
+			PrepareCalculator(calculator, inputs, tileSize[2], tileSize[0], tileSize[1]);
+			StepInChunks(calculator, inputs, inputs.StepCount, scenario.SpawnPeriod, {1});
+
+			result = CompareCells(ScenarioName(scenario) + ", tiles " + std::to_string(tileSize[0]) + "x" + std::to_string(tileSize[1]), reference.Stability, CopyStability(calculator), inputs.Size) && result;
+		}
+
+		return result;
+	}
+
+	bool TestTemporal(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& reference)
+	{
+		const std::vector<std::vector<uint32_t>> chunkSizes = {{2}, {7}, {64}, {inputs.StepCount}, {1, 33, 5}};
+
+		bool result = true;
+		for(const std::vector<uint32_t>& chunks: chunkSizes)
+		{
+			CpuStabilityCalculator calculator;
+			PrepareCalculator(calculator, inputs, 2, 512, 16);
+			StepInChunks(calculator, inputs, inputs.StepCount, scenario.SpawnPeriod, chunks);
+
+			result = CompareCells(ScenarioName(scenario) + ", " + std::to_string(chunks.front()) + " steps at once", reference.Stability, CopyStability(calculator), inputs.Size) && result;
+		}
+
+		return result;
+	}
+
+	bool TestSymmetry(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& reference)
+	{
+		const uint32_t tileSizes[][3] = {{0, 64, 1}, {512, 8, 3}, {512, 1, 2}}; //Width, height, threads
+
+		bool result = true;
+		for(const uint32_t* tileSize: tileSizes)
+		{
+			CpuStabilityCalculator calculator;
+			PrepareCalculator(calculator, inputs, tileSize[2], tileSize[0], tileSize[1]);
+			calculator.ReduceBySymmetry(inputs.GetClickRule(), inputs.GetRestriction());
+			StepInChunks(calculator, inputs, inputs.StepCount, scenario.SpawnPeriod, {1, 64, 5, 33});
+
+			result = CompareCells(ScenarioName(scenario) + ", reduced by symmetry, tiles " + std::to_string(tileSize[0]) + "x" + std::to_string(tileSize[1]), reference.Stability, CopyStability(calculator), inputs.Size) && result;
+		}
+
+		return result;
+	}
+
+	//The separable factors of the click rule XOR back into it, and there are no more of them than the distinct rows of the rule
+	bool TestFactors(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& /*reference*/)
+	{
+		std::vector<std::pair<int32_t, int32_t>> expectedOffsets;
+		for(size_t i = 0; i < inputs.ReadOffsetsX.size(); i++)
+		{
+			expectedOffsets.push_back({inputs.ReadOffsetsX[i], inputs.ReadOffsetsY[i]});
+		}
+
+		std::vector<std::pair<int32_t, int32_t>> factorOffsets;
+		for(const CpuClickRuleFactor& factor: inputs.ClickRule.GetFactors())
+		{
+			for(int32_t bitIndex = 0; bitIndex < 64; bitIndex++)
+			{
+				if(!(factor.MaskX & (1ull << bitIndex)))
+				{
+					continue;
+				}
+
+				for(int32_t offsetY: factor.OffsetsY)
+				{
+					std::pair<int32_t, int32_t> offset = {factor.MinOffsetX + bitIndex, offsetY};
+
+					auto existing = std::find(factorOffsets.begin(), factorOffsets.end(), offset);
+					if(existing == factorOffsets.end())
+					{
+						factorOffsets.push_back(offset);
+					}
+					else
+					{
+						factorOffsets.erase(existing);
+					}
+				}
+			}
+		}
+
+		std::sort(expectedOffsets.begin(), expectedOffsets.end());
+		std::sort(factorOffsets.begin(), factorOffsets.end());
+		if(factorOffsets != expectedOffsets)
+		{
+			std::printf("FAILED %s: the XOR of the %u click rule factors isn't the click rule\n", ScenarioName(scenario).c_str(), (uint32_t)inputs.ClickRule.GetFactors().size());
+			return false;
+		}
+
+		std::vector<uint64_t> distinctRows;
+		for(const CpuClickRuleRow& clickRuleRow: inputs.ClickRule.GetRows())
+		{
+			uint64_t rowMask = clickRuleRow.MaskX << (clickRuleRow.MinOffsetX + 32);
+			if(std::find(distinctRows.begin(), distinctRows.end(), rowMask) == distinctRows.end())
+			{
+				distinctRows.push_back(rowMask);
+			}
+		}
+
+		if(inputs.ClickRule.GetFactors().size() > distinctRows.size())
+		{
+			std::printf("FAILED %s: %u click rule factors for %u distinct rows\n", ScenarioName(scenario).c_str(), (uint32_t)inputs.ClickRule.GetFactors().size(), (uint32_t)distinctRows.size());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool TestJumpAhead(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& /*reference*/)
+	{
+		//The jump computes the board without the stability, the stability restarts from the board at the step
+		const uint32_t jumpStep = inputs.StepCount / 2 + 3;
+
+		ReferenceState state;
+		InitReference(inputs, inputs.BoardCells, state);
+		ReferenceNextSteps(inputs, jumpStep, 0, state);
+		state.Stability.assign(state.Stability.size(), 1);
+		ReferenceNextSteps(inputs, inputs.StepCount - jumpStep, scenario.SpawnPeriod, state);
+
+		bool result = true;
+		for(bool reduce: {false, true})
+		{
+			CpuStabilityCalculator calculator;
+			PrepareCalculator(calculator, inputs, 2, 512, 16);
+			if(reduce)
+			{
+				calculator.ReduceBySymmetry(inputs.GetClickRule(), inputs.GetRestriction());
+			}
+
+			calculator.JumpToStep(jumpStep, inputs.GetClickRule(), inputs.GetRestriction());
+			StepInChunks(calculator, inputs, inputs.StepCount - jumpStep, scenario.SpawnPeriod, {1, 64});
+
+			result = CompareCells(ScenarioName(scenario) + (reduce ? ", reduced by symmetry" : "") + ", jumped to " + std::to_string(jumpStep), state.Stability, CopyStability(calculator), inputs.Size) && result;
+		}
+
+		return result;
+	}
+
+	bool TestChangeMap(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& /*reference*/)
+	{
+		const uint32_t renderedFrames[] = {1, inputs.StepCount / 3, inputs.StepCount - 1, inputs.StepCount};
+
+		std::vector<std::vector<uint16_t>> expectedFrames;
+		ReferenceState state;
+		InitReference(inputs, inputs.BoardCells, state);
+		for(uint32_t frame = 1; frame <= inputs.StepCount; frame++)
+		{
+			ReferenceNextStep(inputs, 0, state);
+			if(std::find(std::begin(renderedFrames), std::end(renderedFrames), frame) != std::end(renderedFrames))
+			{
+				expectedFrames.push_back(state.Stability);
+			}
+		}
+
+		bool result = true;
+		for(bool reduce: {false, true})
+		{
+			CpuStabilityCalculator calculator;
+			calculator.SetTrackChangeMap(true);
+			PrepareCalculator(calculator, inputs, 2, 512, 8);
+			if(reduce)
+			{
+				calculator.ReduceBySymmetry(inputs.GetClickRule(), inputs.GetRestriction());
+			}
+
+			StepInChunks(calculator, inputs, inputs.StepCount, 0, {1, 17, 64});
+
+			CpuChangeMap changeMap;
+			calculator.CopyChangeMap(changeMap);
+
+			std::vector<uint16_t> renderedCells((size_t)inputs.Size * inputs.Size);
+			for(size_t i = 0; i < expectedFrames.size(); i++)
+			{
+				calculator.RenderChangeMap(changeMap, renderedFrames[i], renderedCells.data(), inputs.Size);
+				result = CompareCells(ScenarioName(scenario) + (reduce ? ", reduced by symmetry" : "") + ", change map frame " + std::to_string(renderedFrames[i]), expectedFrames[i], renderedCells, inputs.Size) && result;
+			}
+		}
+
+		return result;
+	}
+
+	//A few scattered lit cells are computed from the impulse responses until a regular step gets cheaper
+	bool TestImpulse(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& /*reference*/)
+	{
+		std::vector<uint8_t> boardCells((size_t)inputs.Size * inputs.Size, 0);
+		for(uint32_t i = 0; i < 6; i++)
+		{
+			uint32_t x = (inputs.Size * (2 * i + 1) / 13 + 3 * i) % inputs.Size;
+			uint32_t y = (inputs.Size * (3 * i + 2) / 11 + i)     % inputs.Size;
+			boardCells[(size_t)y * inputs.Size + x] = 1;
+		}
+
+		const uint32_t checkedSteps[] = {1, 5, 20, inputs.StepCount};
+
+		CpuStabilityCalculator calculator;
+		calculator.SetThreadCount(2);
+		calculator.PrepareForCalculations(boardCells.data(), inputs.Size, inputs.Size, inputs.Size);
+
+		ReferenceState state;
+		InitReference(inputs, boardCells, state);
+
+		bool     result = true;
+		uint32_t step   = 0;
+		for(uint32_t checkedStep: checkedSteps)
+		{
+			StepInChunks(calculator, inputs, checkedStep - step, scenario.SpawnPeriod, {1, 3, 64});
+			ReferenceNextSteps(inputs, checkedStep - step, scenario.SpawnPeriod, state);
+			step = checkedStep;
+
+			result = CompareCells(ScenarioName(scenario) + ", scattered cells, step " + std::to_string(step), state.Stability, CopyStability(calculator), inputs.Size) && result;
+		}
+
+		return result;
+	}
+
+	//The tiles that didn't change are skipped, until the restriction changes and every tile has to be computed again
+	bool TestActivity(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& /*reference*/)
+	{
+		TestInputs switchedInputs = inputs;
+		switchedInputs.bRestricted = !inputs.bRestricted;
+		if(switchedInputs.bRestricted)
+		{
+			switchedInputs.RestrictionCells = MakeRestrictionCells(inputs.Size);
+			switchedInputs.Restriction.Resize(inputs.Size, inputs.Size);
+			switchedInputs.Restriction.FromCells(switchedInputs.RestrictionCells.data(), inputs.Size);
+		}
+
+		const TestInputs* runInputs[] = {&inputs, &switchedInputs, &inputs};
+		const uint32_t    runSteps    = inputs.StepCount / 3;
+
+		bool result = true;
+		for(uint32_t chunkSize: {1u, 64u})
+		{
+			CpuStabilityCalculator calculator;
+			PrepareCalculator(calculator, inputs, 2, 512, 4);
+
+			ReferenceState state;
+			InitReference(inputs, inputs.BoardCells, state);
+			for(const TestInputs* run: runInputs)
+			{
+				StepInChunks(calculator, *run, runSteps, scenario.SpawnPeriod, {chunkSize});
+				ReferenceNextSteps(*run, runSteps, scenario.SpawnPeriod, state);
+			}
+
+			result = CompareCells(ScenarioName(scenario) + ", restriction switched twice, " + std::to_string(chunkSize) + " steps at once", state.Stability, CopyStability(calculator), inputs.Size) && result;
+		}
+
+		return result;
+	}
+
+	bool TestHashLife(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& reference)
+	{
+		bool result = true;
+		for(uint32_t chunkSize: {inputs.StepCount, 64u})
+		{
+			CpuStabilityCalculator calculator;
+			calculator.SetUseHashLife(true);
+			PrepareCalculator(calculator, inputs, 2, 0, 64);
+			StepInChunks(calculator, inputs, inputs.StepCount, scenario.SpawnPeriod, {chunkSize});
+
+			result = CompareCells(ScenarioName(scenario) + ", Hashlife, " + std::to_string(chunkSize) + " steps at once", reference.Stability, CopyStability(calculator), inputs.Size) && result;
+		}
+
+		return result;
+	}
+
+	bool TestStats(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& /*reference*/)
+	{
+		CpuGenerationStats expectedStats;
+		ReferenceState state;
+		InitReference(inputs, inputs.BoardCells, state);
+		for(uint32_t frame = 1; frame <= inputs.StepCount; frame++)
+		{
+			std::vector<uint8_t> prevBoard = state.Board;
+			ReferenceNextStep(inputs, scenario.SpawnPeriod, state);
+
+			CpuGenerationCounts counts;
+			for(uint32_t y = 0; y < inputs.Size; y++)
+			{
+				for(uint32_t x = 0; x < inputs.Size; x++)
+				{
+					size_t cellIndex = (size_t)y * inputs.Size + x;
+					counts.ChangedCount += (state.Board[cellIndex] != prevBoard[cellIndex]);
+					counts.LitCount     += state.Board[cellIndex];
+					if(state.Stability[cellIndex] == 1)
+					{
+						counts.StableCount++;
+						counts.AddStableSpan(x, x, y);
+					}
+				}
+			}
+
+			expectedStats.Append(frame, counts);
+		}
+
+		std::ostringstream expectedCsv;
+		expectedStats.WriteCsv(expectedCsv);
+
+		bool result = true;
+		for(bool reduce: {false, true})
+		{
+			CpuStabilityCalculator calculator;
+			calculator.SetTrackStats(true);
+			PrepareCalculator(calculator, inputs, 3, 512, 8);
+			if(reduce)
+			{
+				calculator.ReduceBySymmetry(inputs.GetClickRule(), inputs.GetRestriction());
+			}
+
+			StepInChunks(calculator, inputs, inputs.StepCount, scenario.SpawnPeriod, {1, 64, 9});
+
+			std::ostringstream actualCsv;
+			calculator.GetGenerationStats().WriteCsv(actualCsv);
+			if(actualCsv.str() != expectedCsv.str())
+			{
+				std::printf("FAILED %s%s: the stats differ\n", ScenarioName(scenario).c_str(), reduce ? ", reduced by symmetry" : "");
+				result = false;
+			}
+		}
+
+		return result;
+	}
+
+	//The degree of the minimal polynomial of the board sequence is the dimension of its span: the first board that is the XOR of some of the previous ones. 0 if it's above maxDegree
+	uint32_t ReferenceMinimalDegree(const TestInputs& inputs, uint32_t maxDegree)
+	{
+		const size_t wordCount = ((size_t)inputs.Size * inputs.Size + 63) / 64;
+
+		std::vector<std::vector<uint64_t>> basis; //Each one is zero in the pivots of the previous ones
+		std::vector<size_t>                pivots;
+
+		ReferenceState state;
+		InitReference(inputs, inputs.BoardCells, state);
+		for(uint32_t degree = 0; degree <= maxDegree; degree++)
+		{
+			std::vector<uint64_t> boardBits(wordCount, 0);
+			for(size_t cellIndex = 0; cellIndex < state.Board.size(); cellIndex++)
+			{
+				boardBits[cellIndex / 64] |= (uint64_t)state.Board[cellIndex] << (cellIndex % 64);
+			}
+
+			for(size_t i = 0; i < basis.size(); i++)
+			{
+				if(boardBits[pivots[i] / 64] & (1ull << (pivots[i] % 64)))
+				{
+					for(size_t wordIndex = 0; wordIndex < wordCount; wordIndex++)
+					{
+						boardBits[wordIndex] ^= basis[i][wordIndex];
+					}
+				}
+			}
+
+			auto pivotWord = std::find_if(boardBits.begin(), boardBits.end(), [](uint64_t word) {return word != 0;});
+			if(pivotWord == boardBits.end())
+			{
+				return degree;
+			}
+
+			size_t pivot = (size_t)(pivotWord - boardBits.begin()) * 64;
+			while(!(boardBits[pivot / 64] & (1ull << (pivot % 64))))
+			{
+				pivot++;
+			}
+
+			basis.push_back(std::move(boardBits));
+			pivots.push_back(pivot);
+
+			ReferenceNextStep(inputs, 0, state);
+		}
+
+		return 0;
+	}
+
+	//The solved polynomial degree is exactly the one of the board sequence, the stability doesn't change after the final frame, and the board repeats with the solved period and preperiod
+	bool TestPeriod(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& /*reference*/)
+	{
+		const uint32_t maxCheckedPeriod = 4096; //Longer periods are only checked through the polynomial degree
+
+		BitBoard initialBoard(inputs.Size, inputs.Size);
+		initialBoard.FromCells(inputs.BoardCells.data(), inputs.Size);
+
+		//Every projection is solved once twice its linear complexity and a margin of frames agree with it, and it's never above the degree of the board sequence
+		const uint32_t maxFrames      = 4 * inputs.StepCount;
+		const uint32_t solvableDegree = (maxFrames - 32) / 2;
+
+		CpuPeriodSolver   periodSolver;
+		CpuSolutionPeriod solutionPeriod;
+		periodSolver.SetThreadCount(2);
+		periodSolver.SetMaxFrames(maxFrames);
+		if(!periodSolver.Solve(initialBoard, inputs.GetClickRule(), inputs.GetRestriction(), solutionPeriod))
+		{
+			uint32_t degree = ReferenceMinimalDegree(inputs, solvableDegree);
+			if(degree != 0)
+			{
+				std::printf("FAILED %s: the period isn't solved, the degree of the minimal polynomial is only %u\n", ScenarioName(scenario).c_str(), degree);
+				return false;
+			}
+
+			return true;
+		}
+
+		uint32_t expectedDegree = ReferenceMinimalDegree(inputs, solutionPeriod.PolynomialDegree + 1);
+		if(solutionPeriod.PolynomialDegree != expectedDegree)
+		{
+			std::printf("FAILED %s: the degree of the minimal polynomial is %u instead of %u\n", ScenarioName(scenario).c_str(), solutionPeriod.PolynomialDegree, expectedDegree);
+			return false;
+		}
+
+		const uint32_t finalFrame = solutionPeriod.GetFinalFrame();
+
+		ReferenceState state;
+		InitReference(inputs, inputs.BoardCells, state);
+		ReferenceNextSteps(inputs, finalFrame, 0, state);
+
+		std::vector<uint16_t> finalStability = state.Stability;
+		ReferenceNextSteps(inputs, finalFrame + 2, 0, state);
+		if(!CompareCells(ScenarioName(scenario) + ", stability after the final frame " + std::to_string(finalFrame), finalStability, state.Stability, inputs.Size))
+		{
+			return false;
+		}
+
+		if(solutionPeriod.Period == 0 || solutionPeriod.PreperiodLength + solutionPeriod.Period > maxCheckedPeriod)
+		{
+			return true;
+		}
+
+		//The boards the sequence can repeat at: every one from the preperiod on, and the one right before it if the preperiod is too long
+		std::vector<std::vector<uint8_t>> boards;
+		InitReference(inputs, inputs.BoardCells, state);
+		for(uint32_t frame = 0; frame <= solutionPeriod.PreperiodLength + solutionPeriod.Period; frame++)
+		{
+			if(frame + 1 >= solutionPeriod.PreperiodLength)
+			{
+				boards.push_back(state.Board);
+			}
+
+			ReferenceNextStep(inputs, 0, state);
+		}
+
+		const std::vector<uint8_t>& periodStart = boards[boards.size() - 1 - solutionPeriod.Period];
+		bool repeats          = (boards.back() == periodStart);
+		bool repeatsEarlier   = std::find(boards.end() - solutionPeriod.Period, boards.end() - 1, periodStart) != boards.end() - 1;
+		bool preperiodTooLong = solutionPeriod.PreperiodLength != 0 && boards[boards.size() - 2] == boards.front();
+		if(!repeats || repeatsEarlier || preperiodTooLong)
+		{
+			std::printf("FAILED %s: the board sequence doesn't have the preperiod %u and the period %u\n", ScenarioName(scenario).c_str(), solutionPeriod.PreperiodLength, solutionPeriod.Period);
+			return false;
+		}
+
+		return true;
+	}
+
+	//The board and the stability of the reference as one value per cell
+	std::vector<uint16_t> ReferenceStateCells(const ReferenceState& state)
+	{
+		std::vector<uint16_t> cells(state.Stability);
+		for(size_t cellIndex = 0; cellIndex < cells.size(); cellIndex++)
+		{
+			cells[cellIndex] |= (uint16_t)(state.Board[cellIndex] << 15);
+		}
+
+		return cells;
+	}
+
+	//The found period is the exact period of the reference states, found as soon as the detection guarantees it. The last state of the calculator repeats after exactly the period, and not before
+	bool TestCycle(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& /*reference*/)
+	{
+		//The first repeated state of the reference, frame 0 is not hashed
+		uint32_t referenceRepeatFrame = 0;
+		uint32_t referencePeriod      = 0;
+
+		std::map<std::vector<uint16_t>, uint32_t> seenStates;
+
+		ReferenceState state;
+		InitReference(inputs, inputs.BoardCells, state);
+		for(uint32_t frame = 1; frame <= inputs.StepCount && referencePeriod == 0; frame++)
+		{
+			ReferenceNextStep(inputs, scenario.SpawnPeriod, state);
+
+			auto inserted = seenStates.insert({ReferenceStateCells(state), frame});
+			if(!inserted.second)
+			{
+				referenceRepeatFrame = frame;
+				referencePeriod      = frame - inserted.first->second;
+			}
+		}
+
+		bool result = true;
+		for(bool reduceBySymmetry: {false, true})
+		{
+			CpuStabilityCalculator calculator;
+			calculator.SetTrackStateHashes(true);
+			PrepareCalculator(calculator, inputs, 2, 512, 4);
+			if(reduceBySymmetry)
+			{
+				calculator.ReduceBySymmetry(inputs.GetClickRule(), inputs.GetRestriction());
+			}
+
+			StepInChunks(calculator, inputs, inputs.StepCount, scenario.SpawnPeriod, {1, 64});
+
+			const std::string name = ScenarioName(scenario) + (reduceBySymmetry ? ", reduced by symmetry" : "");
+
+			const CpuCycleDetector& cycleDetector = calculator.GetCycleDetector();
+			if(!cycleDetector.IsCycleFound())
+			{
+				//Brent's detection finds the cycle within 3 * max(preperiod, period) frames
+				if(referencePeriod != 0 && referenceRepeatFrame * 4 <= inputs.StepCount)
+				{
+					std::printf("FAILED %s: the state first repeats at the frame %u with the period %u, but no cycle is found\n", name.c_str(), referenceRepeatFrame, referencePeriod);
+					result = false;
+				}
+
+				continue;
+			}
+
+			if(cycleDetector.GetPeriod() != referencePeriod || cycleDetector.GetRepeatFrame() < referenceRepeatFrame)
+			{
+				std::printf("FAILED %s: the period %u is found at the frame %u, the state first repeats at the frame %u with the period %u\n", name.c_str(), cycleDetector.GetPeriod(), cycleDetector.GetRepeatFrame(), referenceRepeatFrame, referencePeriod);
+				result = false;
+				continue;
+			}
+
+			//The state compared to confirm the period changes within the period and comes back after it
+			std::vector<uint64_t> periodStartState;
+			calculator.CopyLastState(periodStartState);
+
+			std::vector<uint64_t> periodState;
+			for(uint32_t step = 1; step <= referencePeriod; step++)
+			{
+				calculator.StabilityNextStep(inputs.GetClickRule(), inputs.GetRestriction(), scenario.SpawnPeriod);
+				calculator.CopyLastState(periodState);
+				if((periodState == periodStartState) != (step == referencePeriod))
+				{
+					std::printf("FAILED %s: the state %s %u steps after the frame %u with the period %u\n", name.c_str(), (step == referencePeriod) ? "doesn't repeat" : "repeats", step, inputs.StepCount, referencePeriod);
+					result = false;
+					break;
+				}
+			}
+		}
+
+		return result;
+	}
+
+	//Every board of the batch is stepped together with the others and has to get its own stability
+	bool TestBatch(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& reference)
+	{
+		const TestBoard otherBoards[] = {TestBoard::Center, TestBoard::Dense, TestBoard::Skewed};
+
+		CpuBatchCalculator calculator;
+		calculator.SetThreadCount(2);
+		calculator.PrepareForCalculations(inputs.Size, inputs.Size);
+		calculator.AddBoard(inputs.BoardCells.data(), inputs.Size);
+
+		std::vector<ReferenceState> otherReferences;
+		for(TestBoard otherBoard: otherBoards)
+		{
+			if(otherBoard != scenario.Board)
+			{
+				std::vector<uint8_t> boardCells = MakeBoardCells(otherBoard, inputs.Size);
+				calculator.AddBoard(boardCells.data(), inputs.Size);
+
+				otherReferences.emplace_back();
+				InitReference(inputs, boardCells, otherReferences.back());
+				ReferenceNextSteps(inputs, inputs.StepCount, scenario.SpawnPeriod, otherReferences.back());
+			}
+		}
+
+		for(uint32_t step = 0; step < inputs.StepCount; step += 64)
+		{
+			calculator.StabilityNextSteps(std::min(inputs.StepCount - step, 64u), inputs.GetClickRule(), inputs.GetRestriction(), scenario.SpawnPeriod);
+		}
+
+		bool result = true;
+		std::vector<uint16_t> stabilityCells((size_t)inputs.Size * inputs.Size);
+		for(uint32_t boardIndex = 0; boardIndex < calculator.GetBoardCount(); boardIndex++)
+		{
+			calculator.CopyStabilityCells(boardIndex, stabilityCells.data(), inputs.Size);
+
+			const ReferenceState& boardReference = (boardIndex == 0) ? reference : otherReferences[boardIndex - 1];
+			result = CompareCells(ScenarioName(scenario) + ", batch board " + std::to_string(boardIndex), boardReference.Stability, stabilityCells, inputs.Size) && result;
+		}
+
+		return result;
+	}
+
+	//Only the light cone of the region is stepped, at the edges and in the middle of the board, and the whole board as a region
+	bool TestRegion(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& reference)
+	{
+		const uint32_t  size      = inputs.Size;
+		const CpuRegion regions[] = {{0, 0, size / 3, size / 4}, {size / 2 - 5, size / 3, 17, 40}, {size - 20, size - 9, 20, 9}, {0, 0, size, size}};
+
+		bool result = true;
+		for(const CpuRegion& region: regions)
+		{
+			CpuRegionCalculator calculator;
+			calculator.SetThreadCount(2);
+			calculator.PrepareForCalculations(inputs.BoardCells.data(), size, size, size, region, inputs.StepCount, inputs.GetClickRule(), inputs.GetRestriction());
+			while(calculator.GetCurrentStep() != calculator.GetFinalStep())
+			{
+				calculator.StabilityNextSteps(64, inputs.GetClickRule(), scenario.SpawnPeriod);
+			}
+
+			std::vector<uint16_t> regionCells((size_t)region.Width * region.Height);
+			calculator.CopyStabilityCells(regionCells.data(), region.Width);
+
+			std::vector<uint16_t> expectedCells;
+			for(uint32_t y = region.Y; y < region.Y + region.Height; y++)
+			{
+				expectedCells.insert(expectedCells.end(), reference.Stability.begin() + (size_t)y * size + region.X, reference.Stability.begin() + (size_t)y * size + region.X + region.Width);
+			}
+
+			std::string regionName = std::to_string(region.X) + "," + std::to_string(region.Y) + "," + std::to_string(region.Width) + "x" + std::to_string(region.Height);
+			result = CompareCells(ScenarioName(scenario) + ", region " + regionName, expectedCells, regionCells, region.Width) && result;
+		}
+
+		return result;
+	}
+
+	//The board and the stability only live in the files, computed a single generation per pass and several generations per pass
+	bool TestOutOfCore(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& reference)
+	{
+		std::filesystem::path folder = std::filesystem::temp_directory_path() / "StafraOutOfCoreTest";
+		std::filesystem::create_directories(folder);
+
+		std::vector<CpuCellPosition> litCells;
+		for(uint32_t y = 0; y < inputs.Size; y++)
+		{
+			for(uint32_t x = 0; x < inputs.Size; x++)
+			{
+				if(inputs.BoardCells[(size_t)y * inputs.Size + x] != 0)
+				{
+					litCells.push_back({x, y});
+				}
+			}
+		}
+
+		bool result = true;
+		for(uint64_t memoryBudget: {0ull, 1024ull * 1024ull}) //A single generation per pass, and many
+		{
+			CpuOutOfCoreCalculator calculator;
+			calculator.SetThreadCount(2);
+			if(!calculator.PrepareForCalculations(folder.wstring(), inputs.Size, inputs.Size, litCells, inputs.GetClickRule(), memoryBudget) || !calculator.StabilityNextSteps(inputs.StepCount, inputs.GetClickRule()))
+			{
+				std::printf("FAILED %s: can't compute out of core in %s\n", ScenarioName(scenario).c_str(), folder.string().c_str());
+				result = false;
+				continue;
+			}
+
+			//A preview of the full size is the stability itself
+			std::vector<uint16_t> stabilityCells((size_t)inputs.Size * inputs.Size);
+			calculator.CopyStabilityPreview(stabilityCells.data(), inputs.Size, inputs.Size, inputs.Size);
+
+			result = CompareCells(ScenarioName(scenario) + ", out of core, " + std::to_string(calculator.GetStepsPerPass()) + " steps per pass", reference.Stability, stabilityCells, inputs.Size) && result;
+		}
+
+		std::filesystem::remove_all(folder);
+		return result;
+	}
+
+	//The slabs of a single process, each one in its own thread
+	class LoopbackNetwork
+	{
+	public:
+		LoopbackNetwork(uint32_t slabCount): mLinks(2 * (size_t)slabCount)
+		{
+		}
+
+		void Send(uint32_t fromSlab, uint32_t toSlab, const void* data, size_t size)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			std::deque<uint8_t>& link = mLinks[LinkIndex(fromSlab, toSlab)];
+			link.insert(link.end(), bytes, bytes + size);
+			mCondition.notify_all();
+		}
+
+		void Receive(uint32_t fromSlab, uint32_t toSlab, void* data, size_t size)
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			std::deque<uint8_t>& link = mLinks[LinkIndex(fromSlab, toSlab)];
+			mCondition.wait(lock, [&link, size]() { return link.size() >= size; });
+
+			std::copy(link.begin(), link.begin() + size, static_cast<uint8_t*>(data));
+			link.erase(link.begin(), link.begin() + size);
+		}
+
+	private:
+		size_t LinkIndex(uint32_t fromSlab, uint32_t toSlab) const
+		{
+			return 2 * (size_t)fromSlab + (toSlab > fromSlab);
+		}
+
+		std::vector<std::deque<uint8_t>> mLinks; //Two per slab: to the upper one and to the lower one
+		std::mutex                       mMutex;
+		std::condition_variable          mCondition;
+	};
+
+	class LoopbackTransport: public CpuHaloTransport
+	{
+	public:
+		LoopbackTransport(LoopbackNetwork* network, uint32_t slabIndex): mNetwork(network), mSlabIndex(slabIndex)
+		{
+		}
+
+		bool Send(CpuSlabNeighbor neighbor, const void* data, size_t size) override
+		{
+			mNetwork->Send(mSlabIndex, NeighborIndex(neighbor), data, size);
+			return true;
+		}
+
+		bool Receive(CpuSlabNeighbor neighbor, void* data, size_t size) override
+		{
+			mNetwork->Receive(NeighborIndex(neighbor), mSlabIndex, data, size);
+			return true;
+		}
+
+	private:
+		uint32_t NeighborIndex(CpuSlabNeighbor neighbor) const
+		{
+			return (neighbor == CpuSlabNeighbor::Upper) ? mSlabIndex - 1 : mSlabIndex + 1;
+		}
+
+		LoopbackNetwork* mNetwork;
+		uint32_t         mSlabIndex;
+	};
+
+	//The rows of the board split into 2, 3 and 5 slabs, each one computed in its own thread and exchanging its halo rows in memory
+	bool TestSlab(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& reference)
+	{
+		bool result = true;
+		for(uint32_t slabCount: {2u, 3u, 5u})
+		{
+			LoopbackNetwork network(slabCount);
+
+			std::vector<uint16_t> stabilityCells((size_t)inputs.Size * inputs.Size);
+			std::vector<uint8_t>  slabResults(slabCount, 0);
+			std::vector<std::thread> slabThreads;
+			for(uint32_t slabIndex = 0; slabIndex < slabCount; slabIndex++)
+			{
+				slabThreads.emplace_back([&inputs, &network, &stabilityCells, &slabResults, slabIndex, slabCount]()
+				{
+					CpuSlabCalculator calculator;
+					LoopbackTransport transport(&network, slabIndex);
+
+					calculator.SetThreadCount(1);
+					if(!calculator.PrepareForCalculations(inputs.BoardCells.data(), inputs.Size, inputs.Size, inputs.Size, slabIndex, slabCount, inputs.GetClickRule()))
+					{
+						return;
+					}
+
+					for(uint32_t step = 0; step < inputs.StepCount; step += 64)
+					{
+						calculator.StabilityNextSteps(std::min(inputs.StepCount - step, 64u), inputs.GetClickRule(), &transport);
+					}
+
+					calculator.CopyStabilityCells(stabilityCells.data() + (size_t)calculator.GetRowBegin() * inputs.Size, inputs.Size);
+					slabResults[slabIndex] = 1;
+				});
+			}
+
+			for(std::thread& slabThread: slabThreads)
+			{
+				slabThread.join();
+			}
+
+			if(std::find(slabResults.begin(), slabResults.end(), 0) != slabResults.end())
+			{
+				std::printf("FAILED %s: can't split the board into %u slabs\n", ScenarioName(scenario).c_str(), slabCount);
+				result = false;
+				continue;
+			}
+
+			result = CompareCells(ScenarioName(scenario) + ", " + std::to_string(slabCount) + " slabs", reference.Stability, stabilityCells, inputs.Size) && result;
+		}
+
+		return result;
+	}
+
+	//Every cell counts the spawn stability all the way up to the spawn period and wraps around, which takes the most bit planes at the largest period -spawn accepts
+	bool CheckLargeSpawn()
+	{
+		const uint32_t spawnPeriods[] = {300, 9999};
+
+		bool result = true;
+		for(TestClickRule clickRule: {TestClickRule::Cross, TestClickRule::Knight})
+		{
+			for(uint32_t spawnPeriod: spawnPeriods)
+			{
+				TestScenario scenario = {5, clickRule, TestBoard::Dense, true, spawnPeriod};
+
+				TestInputs restrictedInputs;
+				InitInputs(scenario, restrictedInputs);
+
+				//Nothing is clickable for a step, so the board dies out and every cell restarts from 2. It wraps around to 0 exactly spawnPeriod steps later
+				TestInputs blockedInputs = restrictedInputs;
+				blockedInputs.RestrictionCells.assign(blockedInputs.RestrictionCells.size(), 0);
+				blockedInputs.Restriction.FromCells(blockedInputs.RestrictionCells.data(), blockedInputs.Size);
+
+				TestInputs freeInputs = restrictedInputs;
+				freeInputs.bRestricted = false;
+
+				const std::pair<const TestInputs*, uint32_t> runs[] = {{&restrictedInputs, 20}, {&blockedInputs, 1}, {&freeInputs, spawnPeriod / 2}, {&freeInputs, spawnPeriod - spawnPeriod / 2}, {&freeInputs, 5}};
+
+				CpuStabilityCalculator calculator;
+				PrepareCalculator(calculator, restrictedInputs, 2, 512, 8);
+
+				ReferenceState state;
+				InitReference(restrictedInputs, restrictedInputs.BoardCells, state);
+				for(const std::pair<const TestInputs*, uint32_t>& run: runs)
+				{
+					StepInChunks(calculator, *run.first, run.second, spawnPeriod, {1, 64});
+					ReferenceNextSteps(*run.first, run.second, spawnPeriod, state);
+
+					result = CompareCells(ScenarioName(scenario) + ", step " + std::to_string(calculator.GetCurrentStep()), state.Stability, CopyStability(calculator), restrictedInputs.Size) && result;
+				}
+			}
+		}
+
+		return result;
+	}
+
+	typedef std::vector<std::pair<int32_t, int32_t>> ClickRuleOffsets;
+
+	//The smallest of the 8 images of the offsets of the click rule under the symmetries of the square, same for every rule of the class
+	ClickRuleOffsets CanonicalClickRuleOffsets(const std::vector<uint8_t>& clickRuleCells)
+	{
+		const int32_t center = (gClickRuleSize - 1) / 2;
+
+		ClickRuleOffsets canonicalOffsets;
+		for(uint32_t symmetryIndex = 0; symmetryIndex < 8; symmetryIndex++)
+		{
+			ClickRuleOffsets image;
+			for(int32_t y = 0; y < (int32_t)gClickRuleSize; y++)
+			{
+				for(int32_t x = 0; x < (int32_t)gClickRuleSize; x++)
+				{
+					if(clickRuleCells[y * gClickRuleSize + x] == 0)
+					{
+						continue;
+					}
+
+					int32_t offsetX = (symmetryIndex & 1) ? x - center : center - x;
+					int32_t offsetY = (symmetryIndex & 2) ? center - y : y - center;
+					if(symmetryIndex & 4)
+					{
+						std::swap(offsetX, offsetY);
+					}
+
+					image.push_back({offsetX, offsetY});
+				}
+			}
+
+			std::sort(image.begin(), image.end());
+			if(symmetryIndex == 0 || image < canonicalOffsets)
+			{
+				canonicalOffsets = image;
+			}
+		}
+
+		return canonicalOffsets;
+	}
+
+	std::string ClickRuleName(const ClickRuleOffsets& offsets)
+	{
+		std::ostringstream name;
+		for(const std::pair<int32_t, int32_t>& offset: offsets)
+		{
+			name << "(" << offset.first << ", " << offset.second << ")";
+		}
+
+		return name.str();
+	}
+
+	//The result the rule search should give for the rule on the "4 corners" board, except the frame the repeat is found at: the first repeated state, or the last frame if there's none. False if the rule is trivial
+	bool ReferenceRuleSearchResult(const std::vector<uint8_t>& clickRuleCells, const CpuClickRuleSearchParams& params, CpuClickRuleSearchResult& outResult)
+	{
+		const int32_t center = (gClickRuleSize - 1) / 2;
+
+		TestInputs inputs;
+		inputs.Size              = params.BoardSize;
+		inputs.bDefaultClickRule = false;
+		inputs.bRestricted       = false;
+		for(int32_t y = 0; y < (int32_t)gClickRuleSize; y++)
+		{
+			for(int32_t x = 0; x < (int32_t)gClickRuleSize; x++)
+			{
+				if(clickRuleCells[y * gClickRuleSize + x] != 0)
+				{
+					inputs.ReadOffsetsX.push_back(center - x);
+					inputs.ReadOffsetsY.push_back(y - center);
+				}
+			}
+		}
+
+		const uint32_t size = params.BoardSize;
+
+		std::vector<uint8_t> boardCells((size_t)size * size, 0);
+		boardCells[0]                                    = 1;
+		boardCells[size - 1]                             = 1;
+		boardCells[(size_t)(size - 1) * size]            = 1;
+		boardCells[(size_t)(size - 1) * size + size - 1] = 1;
+
+		ReferenceState state;
+		InitReference(inputs, boardCells, state);
+
+		//Once the state repeats, the search can stop at any later frame with the same stability
+		std::map<std::vector<uint16_t>, uint32_t> seenStates;
+
+		uint32_t frame  = 0;
+		uint32_t period = 0;
+		while(frame < params.MaxFrames && period == 0)
+		{
+			ReferenceNextStep(inputs, 0, state);
+			frame++;
+
+			auto inserted = seenStates.insert({ReferenceStateCells(state), frame});
+			if(!inserted.second)
+			{
+				period = frame - inserted.first->second;
+			}
+		}
+
+		//A dead board stays dead and the stability only loses cells, so the ones the search drops on the way are still empty here
+		bool boardEmpty = std::all_of(state.Board.begin(), state.Board.end(), [](uint8_t cell) {return cell == 0;});
+
+		uint64_t stableCount          = 0;
+		uint64_t mirrorMatchCounts[4] = {0, 0, 0, 0};
+		for(uint32_t y = 0; y < size; y++)
+		{
+			for(uint32_t x = 0; x < size; x++)
+			{
+				if(state.Stability[y * size + x] != 0)
+				{
+					stableCount++;
+					mirrorMatchCounts[0] += (state.Stability[y * size + (size - 1 - x)] != 0);
+					mirrorMatchCounts[1] += (state.Stability[(size - 1 - y) * size + x] != 0);
+					mirrorMatchCounts[2] += (state.Stability[x * size + y] != 0);
+					mirrorMatchCounts[3] += (state.Stability[(size - 1 - x) * size + (size - 1 - y)] != 0);
+				}
+			}
+		}
+
+		if(boardEmpty || stableCount == 0 || stableCount == (uint64_t)size * size)
+		{
+			return false;
+		}
+
+		outResult.Cells          = clickRuleCells;
+		outResult.RepeatFrame    = frame;
+		outResult.Period         = period;
+		outResult.StableFraction = (float)((double)stableCount / ((double)size * size));
+		outResult.Symmetry       = (float)((double)(mirrorMatchCounts[0] + mirrorMatchCounts[1] + mirrorMatchCounts[2] + mirrorMatchCounts[3]) / (4.0 * (double)stableCount));
+		return true;
+	}
+
+	//Every class of the rules within the radius is evaluated once, and every non-trivial one is found with the period and the stability the per-cell reference gives, in the order of the scores. The rules of a symmetry class have that symmetry
+	bool CheckRuleSearch()
+	{
+		const float tolerance = 1e-5f;
+
+		CpuClickRuleSearchParams params;
+		params.Radius      = 1;
+		params.Symmetry    = CpuRuleSymmetry::None;
+		params.SampleCount = 0;
+		params.BoardSize   = 31;
+		params.MaxFrames   = 128;
+		params.ResultCount = 1024; //All of them
+
+		const int32_t center = (gClickRuleSize - 1) / 2;
+
+		uint32_t                                             ruleClassCount = 0;
+		std::map<ClickRuleOffsets, CpuClickRuleSearchResult> expectedResults;
+		std::set<ClickRuleOffsets>                           ruleClasses;
+		for(uint32_t ruleMask = 1; ruleMask < (1u << 9); ruleMask++)
+		{
+			std::vector<uint8_t> clickRuleCells(gClickRuleSize * gClickRuleSize, 0);
+			for(int32_t bitIndex = 0; bitIndex < 9; bitIndex++)
+			{
+				clickRuleCells[(center + bitIndex / 3 - 1) * gClickRuleSize + (center + bitIndex % 3 - 1)] = (ruleMask >> bitIndex) & 1;
+			}
+
+			ClickRuleOffsets canonicalOffsets = CanonicalClickRuleOffsets(clickRuleCells);
+			if(!ruleClasses.insert(canonicalOffsets).second)
+			{
+				continue;
+			}
+
+			ruleClassCount++;
+
+			CpuClickRuleSearchResult expectedResult;
+			if(ReferenceRuleSearchResult(clickRuleCells, params, expectedResult))
+			{
+				expectedResults[canonicalOffsets] = expectedResult;
+			}
+		}
+
+		CpuClickRuleSearch ruleSearch;
+		ruleSearch.SetThreadCount(2);
+
+		bool     result         = true;
+		uint32_t evaluatedCount = ruleSearch.Search(params);
+		if(evaluatedCount != ruleClassCount || ruleSearch.GetResults().size() != expectedResults.size())
+		{
+			std::printf("FAILED rule search: %u rules evaluated and %u found instead of %u and %u\n", evaluatedCount, (uint32_t)ruleSearch.GetResults().size(), ruleClassCount, (uint32_t)expectedResults.size());
+			result = false;
+		}
+
+		std::set<ClickRuleOffsets> foundRules;
+		std::vector<float>         searchScores; //Best first
+		for(size_t resultIndex = 0; resultIndex < ruleSearch.GetResults().size(); resultIndex++)
+		{
+			const CpuClickRuleSearchResult& searchResult     = ruleSearch.GetResults()[resultIndex];
+			ClickRuleOffsets                canonicalOffsets = CanonicalClickRuleOffsets(searchResult.Cells);
+
+			const std::string ruleName = ClickRuleName(canonicalOffsets);
+			if(!foundRules.insert(canonicalOffsets).second)
+			{
+				std::printf("FAILED rule search: the rule %s is found twice\n", ruleName.c_str());
+				result = false;
+				continue;
+			}
+
+			if(resultIndex != 0 && searchResult.Score > ruleSearch.GetResults()[resultIndex - 1].Score)
+			{
+				std::printf("FAILED rule search: the rule %s scores more than the one before it\n", ruleName.c_str());
+				result = false;
+			}
+
+			auto expectedResult = expectedResults.find(canonicalOffsets);
+			if(expectedResult == expectedResults.end())
+			{
+				std::printf("FAILED rule search: the trivial rule %s is found\n", ruleName.c_str());
+				result = false;
+				continue;
+			}
+
+			//The cycle is found within 3 * max(preperiod, period) frames from the first hashed one, at the period exactly
+			const CpuClickRuleSearchResult& expected = expectedResult->second;
+
+			bool periodFound   = (searchResult.Period == expected.Period && searchResult.RepeatFrame >= expected.RepeatFrame) || (searchResult.Period == 0 && expected.RepeatFrame * 4 > params.MaxFrames);
+			bool framesInRange = searchResult.RepeatFrame <= params.MaxFrames && (searchResult.Period != 0 || searchResult.RepeatFrame == params.MaxFrames);
+			if(!periodFound || !framesInRange || std::abs(searchResult.StableFraction - expected.StableFraction) > tolerance || std::abs(searchResult.Symmetry - expected.Symmetry) > tolerance)
+			{
+				std::printf("FAILED rule search %s: repeats at the frame %u with the period %u, %f stable, %f symmetry instead of %u, %u, %f, %f\n", ruleName.c_str(),
+				            searchResult.RepeatFrame, searchResult.Period, searchResult.StableFraction, searchResult.Symmetry, expected.RepeatFrame, expected.Period, expected.StableFraction, expected.Symmetry);
+				result = false;
+			}
+
+			double balance       = 1.0 - std::abs(2.0 * searchResult.StableFraction - 1.0);
+			float  expectedScore = (float)(balance * std::log2(2.0 + (searchResult.RepeatFrame - searchResult.Period)) * searchResult.Symmetry);
+			if(std::abs(searchResult.Score - expectedScore) > tolerance)
+			{
+				std::printf("FAILED rule search %s: the score is %f instead of %f\n", ruleName.c_str(), searchResult.Score, expectedScore);
+				result = false;
+			}
+
+			searchScores.push_back(searchResult.Score);
+		}
+
+		//Only the best ones are kept
+		params.ResultCount = 8;
+		ruleSearch.Search(params);
+		for(size_t resultIndex = 0; resultIndex < params.ResultCount; resultIndex++)
+		{
+			if(resultIndex >= ruleSearch.GetResults().size() || ruleSearch.GetResults()[resultIndex].Score != searchScores[resultIndex])
+			{
+				std::printf("FAILED rule search: the best result %u isn't the one with the score %f\n", (uint32_t)resultIndex, searchScores[resultIndex]);
+				result = false;
+				break;
+			}
+		}
+
+		//The offset (x, y) of a symmetric rule comes with all of its 8 images
+		params.Radius      = 2;
+		params.Symmetry    = CpuRuleSymmetry::Full;
+		params.ResultCount = 1024;
+		ruleSearch.Search(params);
+		for(const CpuClickRuleSearchResult& searchResult: ruleSearch.GetResults())
+		{
+			for(int32_t y = 0; y < (int32_t)gClickRuleSize; y++)
+			{
+				for(int32_t x = 0; x < (int32_t)gClickRuleSize; x++)
+				{
+					int32_t mirroredX = 2 * center - x;
+					int32_t mirroredY = 2 * center - y;
+					if(searchResult.Cells[y * gClickRuleSize + x] == 0)
+					{
+						continue;
+					}
+
+					bool outsideRadius = std::abs(x - center) > params.Radius || std::abs(y - center) > params.Radius;
+					bool notSymmetric  = !searchResult.Cells[y * gClickRuleSize + mirroredX] || !searchResult.Cells[mirroredY * gClickRuleSize + x] || !searchResult.Cells[x * gClickRuleSize + y];
+					if(outsideRadius || notSymmetric)
+					{
+						std::printf("FAILED rule search: the rule %s isn't symmetric within the radius %d\n", ClickRuleName(CanonicalClickRuleOffsets(searchResult.Cells)).c_str(), params.Radius);
+						return false;
+					}
+				}
+			}
+		}
+
+		return result;
+	}
+
+	//The slabs of a board computed in threads, connected with Unix domain sockets in the temporary folder
+	bool CheckSocket()
+	{
+		const uint32_t slabCount   = 3;
+		const size_t   payloadSize = 100000; //Several send() and recv() calls on the way, still within the socket buffers
+
+		std::vector<std::string> slabAddresses;
+		for(uint32_t slabIndex = 0; slabIndex < slabCount; slabIndex++)
+		{
+			slabAddresses.push_back("unix:" + (std::filesystem::temp_directory_path() / ("StafraSocketTest" + std::to_string(slabIndex))).string());
+		}
+
+		TestScenario scenario = {7, TestClickRule::Knight, TestBoard::Dense, false, 0};
+
+		TestInputs inputs;
+		InitInputs(scenario, inputs);
+
+		ReferenceState reference;
+		InitReference(inputs, inputs.BoardCells, reference);
+		ReferenceNextSteps(inputs, inputs.StepCount, 0, reference);
+
+		//Each slab sends its index to both neighbors first, then computes its rows
+		std::vector<uint16_t>    stabilityCells((size_t)inputs.Size * inputs.Size);
+		std::vector<std::string> slabErrors(slabCount);
+		std::vector<std::thread> slabThreads;
+		for(uint32_t slabIndex = 0; slabIndex < slabCount; slabIndex++)
+		{
+			slabThreads.emplace_back([&inputs, &slabAddresses, &stabilityCells, &slabErrors, slabIndex]()
+			{
+				CpuSocketTransport transport;
+				transport.SetConnectTimeout(10000);
+				if(!transport.Connect(slabIndex, slabAddresses))
+				{
+					slabErrors[slabIndex] = "can't connect";
+					return;
+				}
+
+				const CpuSlabNeighbor neighbors[] = {CpuSlabNeighbor::Upper, CpuSlabNeighbor::Lower};
+				for(CpuSlabNeighbor neighbor: neighbors)
+				{
+					uint32_t neighborIndex = (neighbor == CpuSlabNeighbor::Upper) ? slabIndex - 1 : slabIndex + 1;
+					if(neighborIndex < slabCount && !transport.Send(neighbor, std::vector<uint8_t>(payloadSize, (uint8_t)slabIndex).data(), payloadSize))
+					{
+						slabErrors[slabIndex] = "can't send to the slab " + std::to_string(neighborIndex);
+						return;
+					}
+				}
+
+				for(CpuSlabNeighbor neighbor: neighbors)
+				{
+					uint32_t neighborIndex = (neighbor == CpuSlabNeighbor::Upper) ? slabIndex - 1 : slabIndex + 1;
+					if(neighborIndex >= slabCount)
+					{
+						continue;
+					}
+
+					std::vector<uint8_t> payload(payloadSize);
+					if(!transport.Receive(neighbor, payload.data(), payloadSize) || std::count(payload.begin(), payload.end(), (uint8_t)neighborIndex) != (ptrdiff_t)payloadSize)
+					{
+						slabErrors[slabIndex] = "can't receive from the slab " + std::to_string(neighborIndex);
+						return;
+					}
+				}
+
+				CpuSlabCalculator calculator;
+				calculator.SetThreadCount(1);
+				if(!calculator.PrepareForCalculations(inputs.BoardCells.data(), inputs.Size, inputs.Size, inputs.Size, slabIndex, slabCount, inputs.GetClickRule()) || !calculator.StabilityNextSteps(inputs.StepCount, inputs.GetClickRule(), &transport))
+				{
+					slabErrors[slabIndex] = "can't compute the slab";
+					return;
+				}
+
+				calculator.CopyStabilityCells(stabilityCells.data() + (size_t)calculator.GetRowBegin() * inputs.Size, inputs.Size);
+			});
+		}
+
+		for(std::thread& slabThread: slabThreads)
+		{
+			slabThread.join();
+		}
+
+		bool result = true;
+		for(uint32_t slabIndex = 0; slabIndex < slabCount; slabIndex++)
+		{
+			if(!slabErrors[slabIndex].empty())
+			{
+				std::printf("FAILED sockets, slab %u: %s\n", slabIndex, slabErrors[slabIndex].c_str());
+				result = false;
+			}
+		}
+
+		if(result)
+		{
+			result = CompareCells(ScenarioName(scenario) + ", " + std::to_string(slabCount) + " slabs over sockets", reference.Stability, stabilityCells, inputs.Size);
+		}
+
+		//A neighbor that never starts fails the connection in time, both waiting for it to connect and trying to connect to it
+		for(uint32_t slabIndex: {0u, 1u})
+		{
+			CpuSocketTransport transport;
+			transport.SetConnectTimeout(300);
+
+			auto connectStart = std::chrono::steady_clock::now();
+			bool connected    = transport.Connect(slabIndex, {slabAddresses[0], slabAddresses[1]});
+			auto connectTime  = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - connectStart).count();
+			if(connected || connectTime > 5000)
+			{
+				std::printf("FAILED sockets, slab %u of 2 alone: %s after %d ms\n", slabIndex, connected ? "connected" : "gave up", (int)connectTime);
+				result = false;
+			}
+		}
+
+		return result;
+	}
+
+	//The stability cells CPU compute moves into the backend come back as storage for the next cells, so a change map frame rendered into them right after an upload is the computed one
+	bool CheckHandoff()
+	{
+		const uint32_t size            = 63;
+		const uint32_t framesPerUpload = 10;
+
+		bool result = true;
+
+		CpuComputeBackend uploadBackend(1);
+		uploadBackend.PrepareForUpload(size, size);
+		for(uint32_t upload = 0; upload < 2; upload++)
+		{
+			std::vector<uint16_t> stabilityCells((size_t)size * size, 1);
+			uploadBackend.UploadStability(std::move(stabilityCells));
+			if(stabilityCells.size() != (size_t)size * size)
+			{
+				std::printf("FAILED handoff: the upload %u handed back %u cells instead of %u\n", upload, (uint32_t)stabilityCells.size(), size * size);
+				result = false;
+			}
+		}
+
+		std::unique_ptr<CpuComputeBackend> computeBackend = std::make_unique<CpuComputeBackend>(2);
+		CpuComputeBackend*                 backend        = computeBackend.get();
+
+		FractalGen fractalGen(std::move(computeBackend));
+		fractalGen.SetUseCpuCompute(true);
+		fractalGen.SetCpuThreadCount(2);
+		fractalGen.SetTrackChangeMap(true);
+		fractalGen.InitDefaultClickRule();
+		fractalGen.Init4CornersBoard(size, size);
+		fractalGen.InitDefaultRestriction();
+		fractalGen.ResetComputingParameters();
+
+		//The first upload gets the cells the backend had before, none. The frames after it are computed but not uploaded
+		fractalGen.TickSteps(framesPerUpload);
+		fractalGen.UpdateTransform();
+
+		uint32_t             width  = 0;
+		uint32_t             height = 0;
+		std::vector<uint8_t> computedImage;
+		backend->ReadbackTransform(computedImage, width, height);
+
+		fractalGen.TickSteps(framesPerUpload);
+
+		std::filesystem::path changeMapFile = std::filesystem::temp_directory_path() / "StafraHandoffTest.bin";
+		if(!fractalGen.SaveChangeMap(changeMapFile.wstring()) || !fractalGen.LoadChangeMap(changeMapFile.wstring()))
+		{
+			std::printf("FAILED handoff: can't save and load the change map %s\n", changeMapFile.string().c_str());
+			return false;
+		}
+
+		std::filesystem::remove(changeMapFile);
+
+		fractalGen.RenderChangeMapFrame(framesPerUpload);
+		fractalGen.UpdateTransform();
+
+		std::vector<uint8_t> renderedImage;
+		backend->ReadbackTransform(renderedImage, width, height);
+		if(renderedImage != computedImage)
+		{
+			std::printf("FAILED handoff: the change map frame %u isn't the computed one\n", framesPerUpload);
+			result = false;
+		}
+
+		return result;
+	}
+
+	using EngineTestFunction = bool(*)(const TestScenario& scenario, const TestInputs& inputs, const ReferenceState& reference);
+
+	struct EngineTest
+	{
+		const char*        Name;
+		EngineTestFunction Function;
+		bool               bRestrictions; //The engine supports the restrictions
+		bool               bSpawn;        //The engine supports the spawn stability
+	};
+
+	const EngineTest gEngineTests[] =
+	{
+		{"Plain",     TestPlain,     true,  true},
+		{"Simd",      TestSimd,      true,  true},
+		{"Tiles",     TestTiles,     true,  true},
+		{"Temporal",  TestTemporal,  true,  true},
+		{"Symmetry",  TestSymmetry,  true,  true},
+		{"Factors",   TestFactors,   true,  true},
+		{"JumpAhead", TestJumpAhead, true,  true},
+		{"ChangeMap", TestChangeMap, true,  false},
+		{"Impulse",   TestImpulse,   true,  true},
+		{"Activity",  TestActivity,  true,  true},
+		{"HashLife",  TestHashLife,  true,  true},
+		{"Stats",     TestStats,     true,  true},
+		{"Period",    TestPeriod,    true,  false},
+		{"Cycle",     TestCycle,     true,  true},
+		{"Batch",     TestBatch,     true,  true},
+		{"Region",    TestRegion,    true,  true},
+		{"OutOfCore", TestOutOfCore, false, false},
+		{"Slab",      TestSlab,      false, false},
+	};
+
+	//The checks that don't compute the scenarios
+	struct CheckTest
+	{
+		const char* Name;
+		bool        (*Function)();
+	};
+
+	const CheckTest gCheckTests[] =
+	{
+		{"LargeSpawn", CheckLargeSpawn},
+		{"RuleSearch", CheckRuleSearch},
+		{"Socket",     CheckSocket},
+		{"Handoff",    CheckHandoff},
+	};
+
+	std::vector<TestScenario> MakeScenarios()
+	{
+		std::vector<TestScenario> scenarios;
+		for(uint32_t powSize = 6; powSize <= 8; powSize++)
+		{
+			scenarios.push_back({powSize, TestClickRule::Cross,  TestBoard::Center, false,    0});
+			scenarios.push_back({powSize, TestClickRule::Cross,  TestBoard::Dense,  false,    0});
+			scenarios.push_back({powSize, TestClickRule::Cross,  TestBoard::Dense,  true,     0});
+			scenarios.push_back({powSize, TestClickRule::Cross,  TestBoard::Center, false,    3});
+			scenarios.push_back({powSize, TestClickRule::Cross,  TestBoard::Dense,  false,  300});
+			scenarios.push_back({powSize, TestClickRule::Knight, TestBoard::Dense,  false,    0});
+			scenarios.push_back({powSize, TestClickRule::Knight, TestBoard::Dense,  true,     0});
+			scenarios.push_back({powSize, TestClickRule::Knight, TestBoard::Center, false,    4});
+			scenarios.push_back({powSize, TestClickRule::Knight, TestBoard::Skewed, false, 9999});
+			scenarios.push_back({powSize, TestClickRule::Cross,  TestBoard::Skewed, false,    0});
+			scenarios.push_back({powSize, TestClickRule::Skewed, TestBoard::Skewed, false,    0});
+			scenarios.push_back({powSize, TestClickRule::Skewed, TestBoard::Dense,  true,     3});
+		}
+
+		return scenarios;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	for(const CheckTest& test: gCheckTests)
+	{
+		if(argc == 2 && std::strcmp(argv[1], test.Name) == 0)
+		{
+			bool result = test.Function();
+			std::printf("%s: %s\n", test.Name, result ? "passed" : "FAILED");
+			return result ? 0 : 1;
+		}
+	}
+
+	const EngineTest* engineTest = nullptr;
+	for(const EngineTest& test: gEngineTests)
+	{
+		if(argc == 2 && std::strcmp(argv[1], test.Name) == 0)
+		{
+			engineTest = &test;
+		}
+	}
+
+	if(!engineTest)
+	{
+		std::printf("Usage: StafraCpuTests ENGINE, the engines are:");
+		for(const EngineTest& test: gEngineTests)
+		{
+			std::printf(" %s", test.Name);
+		}
+
+		for(const CheckTest& test: gCheckTests)
+		{
+			std::printf(" %s", test.Name);
+		}
+
+		std::printf("\n");
+		return 2;
+	}
+
+	uint32_t testedCount = 0;
+	uint32_t failedCount = 0;
+	for(const TestScenario& scenario: MakeScenarios())
+	{
+		if((scenario.Restricted && !engineTest->bRestrictions) || (scenario.SpawnPeriod != 0 && !engineTest->bSpawn))
+		{
+			continue;
+		}
+
+		TestInputs inputs;
+		InitInputs(scenario, inputs);
+
+		ReferenceState reference;
+		InitReference(inputs, inputs.BoardCells, reference);
+		ReferenceNextSteps(inputs, inputs.StepCount, scenario.SpawnPeriod, reference);
+
+		testedCount++;
+		if(!engineTest->Function(scenario, inputs, reference))
+		{
+			failedCount++;
+		}
+	}
+
+	std::printf("%s: %u of %u scenarios match the plain stepping\n", engineTest->Name, testedCount - failedCount, testedCount);
+	return (failedCount == 0) ? 0 : 1;
+}
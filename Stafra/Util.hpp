@@ -1,11 +1,15 @@
 #pragma once
 
+#if defined(_WIN32)
 #include <Windows.h>
 #include <d3d11.h>
+#endif
+
 #include <string>
 
 namespace Utils
 {
+#if defined(_WIN32)
 	class DXException
 	{
 	public:
@@ -26,6 +30,7 @@ namespace Utils
 	HRESULT LoadShaderFromFile(ID3D11Device* device, const std::wstring& path, ID3D11ComputeShader** shader);
 	HRESULT LoadShaderFromFile(ID3D11Device* device, const std::wstring& path, ID3D11VertexShader**  shader);
 	HRESULT LoadShaderFromFile(ID3D11Device* device, const std::wstring& path, ID3D11PixelShader**   shader);
+#endif
 
 	enum class BoardLoadError
 	{
@@ -36,6 +41,7 @@ namespace Utils
 	};
 }
 
+#if defined(_WIN32)
 #ifndef ThrowIfFailed
 #define ThrowIfFailed(x)                                          \
 {                                                                 \
@@ -61,4 +67,5 @@ namespace Utils
 
 		dc->Unmap(destBuf, 0);
 	}
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -1,7 +1,10 @@
-﻿#include "App/WindowApp.hpp"
-#include "App/ConsoleApp.hpp"
+﻿#include "App/ConsoleApp.hpp"
 #include "App/CommandLineArguments.hpp"
 
+#if defined(_WIN32)
+	#include "App/WindowApp.hpp"
+#endif
+
 #include <iostream>
 
 int main(int argc, char* argv[])
@@ -9,7 +12,9 @@ int main(int argc, char* argv[])
 	CommandLineArguments cmdArgs(argc, argv);
 	cmdArgs.ParseArgs();
 
+#if defined(_WIN32)
 	if(cmdArgs.SilentMode())
+#endif
 	{
 		if(cmdArgs.HelpOnly())
 		{
@@ -26,6 +31,7 @@ int main(int argc, char* argv[])
 
 		return 0;
 	}
+#if defined(_WIN32)
 	else
 	{
 		fclose(stdin);
@@ -45,4 +51,5 @@ int main(int argc, char* argv[])
 			return app.Run();
 		}
 	}
+#endif
 }
\ No newline at end of file